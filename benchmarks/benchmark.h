@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dlstreamer::bench {
+
+// Number of heap allocations made by process so far, by all threads. Counted only on glibc, 0 on other platforms
+size_t allocation_count();
+
+/**
+ * @brief Benchmark state passed to benchmark function. Function performs one-time setup, then runs measured code in
+ * loop 'while (state.keep_running())'. Loop runs until minimal time elapsed and minimal number iterations done.
+ * Heap allocations made while loop runs are counted and reported as allocations per iteration.
+ */
+class State {
+  public:
+    State(double min_time_sec, size_t min_iterations) : _min_time_sec(min_time_sec), _min_iterations(min_iterations) {
+    }
+
+    bool keep_running() {
+        auto now = std::chrono::steady_clock::now();
+        if (!_iterations) {
+            _start = now;
+            _start_allocations = allocation_count();
+        } else if (_iterations >= _min_iterations &&
+                   std::chrono::duration<double>(now - _start).count() >= _min_time_sec) {
+            _elapsed_ns = std::chrono::duration<double, std::nano>(now - _start).count();
+            _allocations = allocation_count() - _start_allocations;
+            return false;
+        }
+        _iterations++;
+        return true;
+    }
+
+    // Custom per-iteration counter reported in output (for example, number of objects per frame)
+    void set_counter(const std::string &name, double value) {
+        _counters[name] = value;
+    }
+
+    size_t iterations() const {
+        return _iterations;
+    }
+    double elapsed_ns() const {
+        return _elapsed_ns;
+    }
+    size_t allocations() const {
+        return _allocations;
+    }
+    const std::map<std::string, double> &counters() const {
+        return _counters;
+    }
+
+  private:
+    double _min_time_sec;
+    size_t _min_iterations;
+    size_t _iterations = 0;
+    double _elapsed_ns = 0;
+    size_t _start_allocations = 0;
+    size_t _allocations = 0;
+    std::chrono::steady_clock::time_point _start;
+    std::map<std::string, double> _counters;
+};
+
+using BenchmarkFunction = std::function<void(State &)>;
+
+struct Benchmark {
+    std::string name;
+    BenchmarkFunction function;
+};
+
+std::vector<Benchmark> &registry();
+
+inline bool register_benchmark(const std::string &name, BenchmarkFunction function) {
+    registry().push_back({name, std::move(function)});
+    return true;
+}
+
+// Prevents compiler from optimizing out value computed in benchmark loop
+template <typename T>
+inline void do_not_optimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace dlstreamer::bench
+
+#define DLS_BENCHMARK_CONCAT_(a, b) a##b
+#define DLS_BENCHMARK_CONCAT(a, b) DLS_BENCHMARK_CONCAT_(a, b)
+
+// Registers benchmark function 'void func(dlstreamer::bench::State &)' under given name
+#define DLS_BENCHMARK(name, func)                                                                                      \
+    [[maybe_unused]] static bool DLS_BENCHMARK_CONCAT(_dls_benchmark_registered_, __LINE__) =                         \
+        dlstreamer::bench::register_benchmark(name, func)
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "benchmark.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <regex>
+
+namespace {
+std::atomic<size_t> allocations{0};
+} // namespace
+
+// glibc allows application to replace malloc. Replacement counts allocations and forwards them to glibc allocator, so
+// allocations made by GLib and GStreamer are counted as well as operator new
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (!ptr)
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+    if (!alignment || (alignment & (alignment - 1)) || alignment % sizeof(void *))
+        return EINVAL;
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    *ptr = __libc_memalign(alignment, size);
+    return *ptr ? 0 : ENOMEM;
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+}
+#endif
+
+namespace dlstreamer::bench {
+
+std::vector<Benchmark> &registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+size_t allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace dlstreamer::bench
+
+using namespace dlstreamer::bench;
+
+namespace {
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    double ns_per_iteration;
+    double allocs_per_iteration;
+    std::map<std::string, double> counters;
+};
+
+void print_usage(const char *app) {
+    std::cout << "Usage: " << app << " [--filter=REGEX] [--min-time=SECONDS] [--json=FILE] [--list]" << std::endl;
+}
+
+void write_json(const std::string &path, const std::vector<Result> &results) {
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Can't open file " + path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_iteration\": " << r.ns_per_iteration
+            << ", \"allocs_per_iteration\": " << r.allocs_per_iteration;
+        for (auto &counter : r.counters)
+            out << ", \"" << counter.first << "\": " << counter.second;
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string filter = ".*";
+    std::string json_path;
+    double min_time_sec = 1.0;
+    bool list_only = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(strlen("--filter="));
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            min_time_sec = std::stod(arg.substr(strlen("--min-time=")));
+        } else if (arg.rfind("--json=", 0) == 0) {
+            json_path = arg.substr(strlen("--json="));
+        } else if (arg == "--list") {
+            list_only = true;
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::regex filter_regex(filter);
+    std::vector<Result> results;
+    printf("%-60s %12s %16s %16s\n", "Benchmark", "Iterations", "ns/iteration", "allocs/iteration");
+    for (auto &benchmark : registry()) {
+        if (!std::regex_search(benchmark.name, filter_regex))
+            continue;
+        if (list_only) {
+            printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        State state(min_time_sec, 1);
+        benchmark.function(state);
+        if (!state.iterations())
+            continue;
+        Result result = {benchmark.name, state.iterations(), state.elapsed_ns() / state.iterations(),
+                         static_cast<double>(state.allocations()) / state.iterations(), state.counters()};
+        printf("%-60s %12zu %16.0f %16.1f", result.name.c_str(), result.iterations, result.ns_per_iteration,
+               result.allocs_per_iteration);
+        for (auto &counter : result.counters)
+            printf("  %s=%g", counter.first.c_str(), counter.second);
+        printf("\n");
+        results.push_back(std::move(result));
+    }
+
+    if (!json_path.empty())
+        write_json(json_path, results);
+    return 0;
+}
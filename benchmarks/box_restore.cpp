@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Coordinates restoration of detections as done by gvadetect post-processing for frames with N boxes: per-box
+// restoration reading and writing GstStructure fields (absolute coordinates passed to meta attacher through the
+// structure) versus BoxBatch gathering boxes once, transforming and clipping them in one pass.
+
+#include "benchmark.h"
+
+#include "box_batch.h"
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double frame_width = 1920;
+constexpr double frame_height = 1080;
+
+// Letterboxed 1080p frame in 640x640 model input, and back. Iterations alternate them so coordinates stay in range
+const BoxTransform model_to_frame = BoxTransform::scale(1.0, 640.0 / 360, 0.0, -140.0 / 360);
+const BoxTransform frame_to_model = BoxTransform::scale(1.0, 360.0 / 640, 0.0, 140.0 / 640);
+
+struct Detections {
+    std::vector<GstStructure *> structures;
+
+    explicit Detections(int n) {
+        for (int i = 0; i < n; i++) {
+            const double x = (i % 40) / 41.0, y = 0.25 + (i / 40 % 30) / 75.0;
+            structures.push_back(gst_structure_new("detection", "x_min", G_TYPE_DOUBLE, x, "y_min", G_TYPE_DOUBLE, y,
+                                                   "x_max", G_TYPE_DOUBLE, x + 0.03, "y_max", G_TYPE_DOUBLE,
+                                                   y + 0.05, "confidence", G_TYPE_DOUBLE, 0.8, NULL));
+        }
+    }
+
+    ~Detections() {
+        for (GstStructure *s : structures)
+            gst_structure_free(s);
+    }
+};
+
+void restore_per_box(Detections &detections, const BoxTransform &transform) {
+    const auto &m = transform.m;
+    for (GstStructure *s : detections.structures) {
+        double x_min, y_min, x_max, y_max;
+        gst_structure_get(s, "x_min", G_TYPE_DOUBLE, &x_min, "x_max", G_TYPE_DOUBLE, &x_max, "y_min", G_TYPE_DOUBLE,
+                          &y_min, "y_max", G_TYPE_DOUBLE, &y_max, NULL);
+        x_min = std::clamp(m[0] * x_min + m[2], 0., 1.);
+        y_min = std::clamp(m[4] * y_min + m[5], 0., 1.);
+        x_max = std::clamp(m[0] * x_max + m[2], 0., 1.);
+        y_max = std::clamp(m[4] * y_max + m[5], 0., 1.);
+        const uint32_t x_abs = static_cast<uint32_t>(x_min * frame_width + 0.5);
+        const uint32_t y_abs = static_cast<uint32_t>(y_min * frame_height + 0.5);
+        const uint32_t w_abs = static_cast<uint32_t>((x_max - x_min) * frame_width + 0.5);
+        const uint32_t h_abs = static_cast<uint32_t>((y_max - y_min) * frame_height + 0.5);
+        gst_structure_set(s, "x_min", G_TYPE_DOUBLE, x_min, "x_max", G_TYPE_DOUBLE, x_max, "y_min", G_TYPE_DOUBLE,
+                          y_min, "y_max", G_TYPE_DOUBLE, y_max, "x_abs", G_TYPE_UINT, x_abs, "y_abs", G_TYPE_UINT,
+                          y_abs, "w_abs", G_TYPE_UINT, w_abs, "h_abs", G_TYPE_UINT, h_abs, NULL);
+    }
+
+    // meta attacher side
+    for (GstStructure *s : detections.structures) {
+        uint32_t box[4] = {};
+        double coords[4] = {};
+        gst_structure_get_uint(s, "x_abs", &box[0]);
+        gst_structure_get_uint(s, "y_abs", &box[1]);
+        gst_structure_get_uint(s, "w_abs", &box[2]);
+        gst_structure_get_uint(s, "h_abs", &box[3]);
+        gst_structure_get(s, "x_min", G_TYPE_DOUBLE, &coords[0], "y_min", G_TYPE_DOUBLE, &coords[1], "x_max",
+                          G_TYPE_DOUBLE, &coords[2], "y_max", G_TYPE_DOUBLE, &coords[3], NULL);
+        dlstreamer::bench::do_not_optimize(box);
+        dlstreamer::bench::do_not_optimize(coords);
+        gst_structure_remove_fields(s, "x_abs", "y_abs", "w_abs", "h_abs", NULL);
+    }
+}
+
+void restore_batched(Detections &detections, const BoxTransform &transform, BoxBatch &boxes) {
+    const size_t n = detections.structures.size();
+    boxes.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        gst_structure_get(detections.structures[i], "x_min", G_TYPE_DOUBLE, &boxes.x_min[i], "x_max", G_TYPE_DOUBLE,
+                          &boxes.x_max[i], "y_min", G_TYPE_DOUBLE, &boxes.y_min[i], "y_max", G_TYPE_DOUBLE,
+                          &boxes.y_max[i], NULL);
+    }
+    transform_and_clip(boxes, transform);
+    to_absolute(boxes, frame_width, frame_height);
+    for (size_t i = 0; i < n; i++) {
+        gst_structure_set(detections.structures[i], "x_min", G_TYPE_DOUBLE, boxes.x_min[i], "x_max", G_TYPE_DOUBLE,
+                          boxes.x_max[i], "y_min", G_TYPE_DOUBLE, boxes.y_min[i], "y_max", G_TYPE_DOUBLE,
+                          boxes.y_max[i], NULL);
+    }
+
+    // meta attacher side
+    for (size_t i = 0; i < n; i++) {
+        uint32_t box[4] = {boxes.x[i], boxes.y[i], boxes.w[i], boxes.h[i]};
+        double coords[4] = {boxes.x_min[i], boxes.y_min[i], boxes.x_max[i], boxes.y_max[i]};
+        dlstreamer::bench::do_not_optimize(box);
+        dlstreamer::bench::do_not_optimize(coords);
+    }
+}
+
+dlstreamer::bench::BenchmarkFunction restore_benchmark(int n, bool batched) {
+    return [=](dlstreamer::bench::State &state) {
+        Detections detections(n);
+        BoxBatch boxes;
+        bool forward = true;
+        while (state.keep_running()) {
+            const BoxTransform &transform = forward ? model_to_frame : frame_to_model;
+            if (batched)
+                restore_batched(detections, transform, boxes);
+            else
+                restore_per_box(detections, transform);
+            forward = !forward;
+        }
+        if (state.iterations() > 0)
+            state.set_counter("ns_per_box", state.elapsed_ns() / (state.iterations() * n));
+    };
+}
+
+bool register_all() {
+    for (int n : {10, 100, 1000, 5000}) {
+        std::string suffix = "/" + std::to_string(n);
+        dlstreamer::bench::register_benchmark("box_restore/per_box" + suffix, restore_benchmark(n, false));
+        dlstreamer::bench::register_benchmark("box_restore/batched" + suffix, restore_benchmark(n, true));
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// DynamicPool (pool of VA-API images) with mock allocator instead of VA surfaces:
+//  * uncontended - cost of acquire/release pair, with shrink check every 64 acquisitions
+//  * burst_shrink - pool grows to hold burst of items, then shrinks back to min size while only one item is used
+//  * backpressure - producer threads acquire items and queue them to single slow consumer (as pre-processing threads
+//    feeding inference), so waiting for free item is normal state. With short grow wait pool grows to max size, which
+//    only adds latency since consumer throughput doesn't change.
+// 'double_acquires' counts items handed out while already in use and must be 0.
+
+#include "benchmark.h"
+
+#include "dynamic_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using InferenceBackend::DynamicPool;
+
+std::atomic<size_t> live_items{0};
+std::atomic<size_t> double_acquires{0};
+
+struct Item {
+    Item() {
+        live_items++;
+    }
+    ~Item() {
+        live_items--;
+    }
+    std::atomic<int> users{0};
+    std::chrono::steady_clock::time_point queued;
+};
+
+// Allocation takes time, as creation of VA surface does
+class MockAllocator : public DynamicPool<Item>::Allocator {
+  public:
+    explicit MockAllocator(std::chrono::microseconds cost) : _cost(cost) {
+    }
+    std::unique_ptr<Item> Allocate() override {
+        if (_cost.count())
+            std::this_thread::sleep_for(_cost);
+        return std::unique_ptr<Item>(new Item());
+    }
+
+  private:
+    std::chrono::microseconds _cost;
+};
+
+Item *acquire(DynamicPool<Item> &pool) {
+    Item *item = pool.Acquire();
+    if (item->users++ != 0)
+        double_acquires++;
+    return item;
+}
+
+void release(DynamicPool<Item> &pool, Item *item) {
+    item->users--;
+    pool.Release(item);
+}
+
+void set_pool_counters(dlstreamer::bench::State &state, const DynamicPool<Item>::Stats &stats) {
+    state.set_counter("size", stats.size);
+    state.set_counter("peak_in_use", stats.peak_in_use);
+    state.set_counter("allocations", stats.allocations);
+    state.set_counter("deallocations", stats.deallocations);
+    state.set_counter("waits", stats.waits);
+    state.set_counter("live_items", live_items.load());
+    state.set_counter("double_acquires", double_acquires.load());
+}
+
+void uncontended_benchmark(dlstreamer::bench::State &state) {
+    DynamicPool<Item>::Params params;
+    params.initial_size = params.min_size = 4;
+    params.max_size = 16;
+    params.shrink_window = 64;
+    DynamicPool<Item> pool(std::unique_ptr<MockAllocator>(new MockAllocator(0us)), params);
+
+    while (state.keep_running())
+        release(pool, acquire(pool));
+
+    set_pool_counters(state, pool.GetStats());
+}
+
+void burst_shrink_benchmark(dlstreamer::bench::State &state) {
+    constexpr size_t burst = 16;
+    DynamicPool<Item>::Params params;
+    params.initial_size = params.min_size = 2;
+    params.max_size = burst;
+    params.grow_wait = 0us;
+    params.shrink_window = 256;
+    DynamicPool<Item> pool(std::unique_ptr<MockAllocator>(new MockAllocator(0us)), params);
+
+    size_t size_after_idle = 0;
+    std::vector<Item *> held;
+    while (state.keep_running()) {
+        // pool has to grow to hold all items of burst at once
+        for (size_t i = 0; i < burst; i++)
+            held.push_back(acquire(pool));
+        for (Item *item : held)
+            release(pool, item);
+        held.clear();
+        // one item in use during two windows, items idle during the whole second window are destroyed
+        for (uint64_t i = 0; i < 2 * params.shrink_window; i++)
+            release(pool, acquire(pool));
+        size_after_idle += pool.GetStats().size;
+    }
+
+    set_pool_counters(state, pool.GetStats());
+    state.set_counter("size_after_idle", static_cast<double>(size_after_idle) / state.iterations());
+}
+
+dlstreamer::bench::BenchmarkFunction backpressure_benchmark(std::chrono::microseconds grow_wait) {
+    return [=](dlstreamer::bench::State &state) {
+        constexpr size_t producers = 4; // including benchmark thread
+        constexpr auto service_time = 500us;
+        DynamicPool<Item>::Params params;
+        params.initial_size = params.min_size = producers;
+        params.max_size = 64;
+        params.grow_wait = grow_wait;
+        DynamicPool<Item> pool(std::unique_ptr<MockAllocator>(new MockAllocator(100us)), params);
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::deque<Item *> queue;
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> served{0};
+        std::atomic<uint64_t> latency_us{0};
+
+        auto produce = [&] {
+            Item *item = acquire(pool);
+            item->queued = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(item);
+            }
+            cond.notify_one();
+        };
+
+        std::thread consumer([&] {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stop || !queue.empty()) {
+                if (queue.empty()) {
+                    cond.wait_for(lock, 1ms);
+                    continue;
+                }
+                Item *item = queue.front();
+                queue.pop_front();
+                lock.unlock();
+                std::this_thread::sleep_for(service_time);
+                latency_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                    item->queued)
+                                  .count();
+                served++;
+                release(pool, item);
+                lock.lock();
+            }
+        });
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < producers; i++)
+            threads.emplace_back([&] {
+                while (!stop)
+                    produce();
+            });
+
+        while (state.keep_running())
+            produce();
+
+        stop = true;
+        for (auto &thread : threads)
+            thread.join();
+        consumer.join();
+
+        set_pool_counters(state, pool.GetStats());
+        state.set_counter("latency_us", served ? static_cast<double>(latency_us) / served : 0);
+    };
+}
+
+bool register_all() {
+    dlstreamer::bench::register_benchmark("dynamic_pool/uncontended", uncontended_benchmark);
+    dlstreamer::bench::register_benchmark("dynamic_pool/burst_shrink", burst_shrink_benchmark);
+    dlstreamer::bench::register_benchmark("dynamic_pool/backpressure/grow_wait_1ms", backpressure_benchmark(1ms));
+    dlstreamer::bench::register_benchmark(
+        "dynamic_pool/backpressure/grow_wait_default",
+        backpressure_benchmark(std::chrono::microseconds(DynamicPool<Item>::DEFAULT_GROW_WAIT_US)));
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
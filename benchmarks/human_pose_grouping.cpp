@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Synthetic crowd benchmark for tensor_postproc_human_pose: peak finding, PAF limb scoring and grouping on heat maps
+// and PAFs rendered from N skeletons (no model required).
+
+#include "benchmark.h"
+#include "peak.h"
+
+#include <opencv2/core.hpp>
+
+#include <cmath>
+
+namespace {
+
+constexpr int keypoints_number = 18;
+constexpr int map_width = 456; // 4x upsampled 114x64 feature map
+constexpr int map_height = 256;
+
+constexpr int min_joints_number = 3;
+constexpr float min_peaks_distance = 3.0;
+constexpr float mid_points_score_threshold = 0.05;
+constexpr float found_mid_points_ratio_threshold = 0.8;
+constexpr float min_subset_score = 0.2;
+
+// Same limb tables as GroupPeaksToPoses
+const std::pair<int, int> limb_ids_heatmap[] = {{1, 2}, {1, 5},  {2, 3},   {3, 4},  {5, 6},   {6, 7},
+                                                {1, 8}, {8, 9},  {9, 10},  {1, 11}, {11, 12}, {12, 13},
+                                                {1, 0}, {0, 14}, {14, 16}, {0, 15}, {15, 17}};
+const std::pair<int, int> limb_ids_paf[] = {{12, 13}, {20, 21}, {14, 15}, {16, 17}, {22, 23}, {24, 25},
+                                            {0, 1},   {2, 3},   {4, 5},   {6, 7},   {8, 9},   {10, 11},
+                                            {28, 29}, {30, 31}, {34, 35}, {32, 33}, {36, 37}};
+
+// Standing person skeleton, relative to hips center, in units of person height
+const cv::Point2f skeleton[keypoints_number] = {
+    {0.f, -0.45f},    {0.f, -0.35f},   {-0.1f, -0.35f}, {-0.15f, -0.2f}, {-0.17f, -0.05f}, {0.1f, -0.35f},
+    {0.15f, -0.2f},   {0.17f, -0.05f}, {-0.06f, 0.f},   {-0.07f, 0.22f}, {-0.07f, 0.45f},  {0.06f, 0.f},
+    {0.07f, 0.22f},   {0.07f, 0.45f},  {-0.03f, -0.5f}, {0.03f, -0.5f},  {-0.06f, -0.47f}, {0.06f, -0.47f}};
+
+struct SyntheticCrowd {
+    std::vector<cv::Mat> heat_maps;
+    std::vector<cv::Mat> pafs;
+};
+
+void render_peak(cv::Mat &heat_map, cv::Point2f pos) {
+    constexpr int radius = 3;
+    constexpr float sigma = 1.5f;
+    for (int y = std::max(0, int(pos.y) - radius); y <= std::min(heat_map.rows - 1, int(pos.y) + radius); y++) {
+        for (int x = std::max(0, int(pos.x) - radius); x <= std::min(heat_map.cols - 1, int(pos.x) + radius); x++) {
+            float d2 = (x - pos.x) * (x - pos.x) + (y - pos.y) * (y - pos.y);
+            float &v = heat_map.at<float>(y, x);
+            v = std::max(v, std::exp(-d2 / (2 * sigma * sigma)));
+        }
+    }
+}
+
+void render_limb(cv::Mat &paf_x, cv::Mat &paf_y, cv::Point2f a, cv::Point2f b) {
+    constexpr float width = 1.5f;
+    cv::Point2f vec = b - a;
+    float len = std::sqrt(vec.dot(vec));
+    if (len == 0)
+        return;
+    cv::Point2f u = vec / len;
+    int x0 = std::max(0, int(std::min(a.x, b.x) - width));
+    int x1 = std::min(paf_x.cols - 1, int(std::max(a.x, b.x) + width));
+    int y0 = std::max(0, int(std::min(a.y, b.y) - width));
+    int y1 = std::min(paf_x.rows - 1, int(std::max(a.y, b.y) + width));
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            cv::Point2f p = cv::Point2f(x, y) - a;
+            float along = p.dot(u);
+            float across = std::abs(p.x * u.y - p.y * u.x);
+            if (along >= 0 && along <= len && across <= width) {
+                paf_x.at<float>(y, x) = u.x;
+                paf_y.at<float>(y, x) = u.y;
+            }
+        }
+    }
+}
+
+SyntheticCrowd make_crowd(int persons) {
+    SyntheticCrowd crowd;
+    for (int i = 0; i < keypoints_number + 1; i++)
+        crowd.heat_maps.push_back(cv::Mat::zeros(map_height, map_width, CV_32FC1));
+    for (int i = 0; i < 38; i++)
+        crowd.pafs.push_back(cv::Mat::zeros(map_height, map_width, CV_32FC1));
+
+    // persons on grid with aspect ratio of the map, with deterministic jitter
+    int cols = static_cast<int>(std::ceil(std::sqrt(persons * float(map_width) / map_height)));
+    int rows = (persons + cols - 1) / cols;
+    float cell_w = float(map_width) / cols;
+    float cell_h = float(map_height) / rows;
+    float height = std::min(cell_h * 0.9f, cell_w * 2.5f);
+    cv::RNG rng(12345);
+    for (int p = 0; p < persons; p++) {
+        cv::Point2f center((p % cols + 0.5f) * cell_w, (p / cols + 0.5f) * cell_h);
+        center += cv::Point2f(rng.uniform(-0.1f, 0.1f) * cell_w, rng.uniform(-0.05f, 0.05f) * cell_h);
+        cv::Point2f keypoints[keypoints_number];
+        for (int k = 0; k < keypoints_number; k++) {
+            keypoints[k] = center + skeleton[k] * height;
+            render_peak(crowd.heat_maps[k], keypoints[k]);
+        }
+        for (size_t l = 0; l < sizeof(limb_ids_heatmap) / sizeof(limb_ids_heatmap[0]); l++) {
+            render_limb(crowd.pafs[limb_ids_paf[l].first], crowd.pafs[limb_ids_paf[l].second],
+                        keypoints[limb_ids_heatmap[l].first], keypoints[limb_ids_heatmap[l].second]);
+        }
+    }
+    return crowd;
+}
+
+HumanPoses find_poses(const SyntheticCrowd &crowd, float mid_point_prune_threshold) {
+    std::vector<std::vector<Peak>> peaks(keypoints_number);
+    std::vector<cv::Mat> heat_maps(crowd.heat_maps.begin(), crowd.heat_maps.begin() + keypoints_number);
+    FindPeaksBody find_peaks_body(heat_maps, min_peaks_distance, peaks);
+    cv::parallel_for_(cv::Range(0, keypoints_number), find_peaks_body);
+    int peaks_before = 0;
+    for (size_t i = 1; i < peaks.size(); i++) {
+        peaks_before += static_cast<int>(peaks[i - 1].size());
+        for (auto &peak : peaks[i])
+            peak.id += peaks_before;
+    }
+    return GroupPeaksToPoses(peaks, crowd.pafs, keypoints_number, mid_points_score_threshold,
+                             found_mid_points_ratio_threshold, min_joints_number, min_subset_score,
+                             mid_point_prune_threshold);
+}
+
+dlstreamer::bench::BenchmarkFunction pose_benchmark(int persons, int threads, float mid_point_prune_threshold) {
+    return [=](dlstreamer::bench::State &state) {
+        SyntheticCrowd crowd = make_crowd(persons);
+        int prev_threads = cv::getNumThreads();
+        cv::setNumThreads(threads);
+        size_t poses = 0;
+        while (state.keep_running()) {
+            poses = find_poses(crowd, mid_point_prune_threshold).size();
+            dlstreamer::bench::do_not_optimize(poses);
+        }
+        cv::setNumThreads(prev_threads);
+        state.set_counter("persons", persons);
+        state.set_counter("poses", poses);
+    };
+}
+
+bool register_all() {
+    for (int persons : {10, 50, 100}) {
+        std::string suffix = "/" + std::to_string(persons);
+        dlstreamer::bench::register_benchmark("human_pose/serial" + suffix,
+                                              pose_benchmark(persons, 1, DEFAULT_MID_POINT_PRUNE_THRESHOLD));
+        dlstreamer::bench::register_benchmark("human_pose/parallel" + suffix,
+                                              pose_benchmark(persons, -1, DEFAULT_MID_POINT_PRUNE_THRESHOLD));
+        dlstreamer::bench::register_benchmark("human_pose/parallel_pruned" + suffix, pose_benchmark(persons, -1, 0.f));
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Soak run of MemoryMapperCache (create_mapper with use_cache=true): frames come from buffer pool of N buffers which
+// is re-allocated every 'pool_lifetime' frames, and every few pools with new frame size, as in long-running pipeline
+// with renegotiations. Pools take addresses (handles) from few ranges in turn, so new pool often has the same handles
+// and frame size as some destroyed one. Context of sources reports release of pool memory to cache. Benchmark throws
+// (fails) if number of mapped objects alive exceeds cache capacity, if objects mapped from destroyed pool stay alive
+// after its release or if mapping of frame returns object mapped from destroyed pool with the same handle.
+// Cache starts with default capacity and grows to fit larger pools (up to max capacity), so 'hit_ratio' is close to 1
+// unless pool is larger than max capacity.
+
+#include "benchmark.h"
+
+#include <dlstreamer/base/frame.h>
+#include <dlstreamer/base/memory_mapper.h>
+#include <dlstreamer/cpu/tensor.h>
+#include <dlstreamer/image_info.h>
+#include <dlstreamer/memory_mapper_factory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace dlstreamer;
+
+constexpr size_t pool_lifetime = 10000;
+constexpr size_t pools_per_resolution = 5;
+constexpr size_t address_ranges = 4;
+
+std::atomic<size_t> live_mapped{0};
+
+// Mapped tensor holding memory of its own, as mapping to other device would. Remembers pool of its source
+class MappedTensor : public CPUTensor {
+  public:
+    MappedTensor(const TensorInfo &info, size_t pool) : CPUTensor(info, nullptr), pool(pool), _memory(4096) {
+        live_mapped++;
+    }
+    ~MappedTensor() {
+        live_mapped--;
+    }
+
+    const size_t pool;
+
+  private:
+    std::vector<uint8_t> _memory;
+};
+
+// Context of pool memory, calls release callbacks when pool is destroyed
+class PoolContext : public BaseContext {
+  public:
+    PoolContext() : BaseContext(MemoryType::CPU) {
+    }
+
+    bool watch_release(const TensorPtr & /*tensor*/, std::function<void()> callback) override {
+        _callbacks.push_back(std::move(callback));
+        return true;
+    }
+
+    void destroy_pool() {
+        std::vector<std::function<void()>> callbacks;
+        callbacks.swap(_callbacks);
+        for (auto &callback : callbacks)
+            callback();
+        pool++;
+    }
+
+    size_t pool = 0;
+
+  private:
+    std::vector<std::function<void()>> _callbacks;
+};
+
+class CountingMapper : public BaseMemoryMapper {
+  public:
+    using BaseMemoryMapper::map;
+
+    CountingMapper(std::shared_ptr<PoolContext> context) : BaseMemoryMapper(context, nullptr), _context(context) {
+    }
+
+    TensorPtr map(TensorPtr src, AccessMode /*mode*/) override {
+        auto dst = std::make_shared<MappedTensor>(src->info(), _context->pool);
+        dst->set_parent(src);
+        return dst;
+    }
+
+  private:
+    std::shared_ptr<PoolContext> _context;
+};
+
+dlstreamer::bench::BenchmarkFunction soak_benchmark(size_t pool_size) {
+    return [=](dlstreamer::bench::State &state) {
+        auto context = std::make_shared<PoolContext>();
+        auto cache = std::make_shared<MemoryMapperCache>(std::make_shared<CountingMapper>(context));
+        std::vector<uint8_t> memory(pool_size * address_ranges);
+        size_t frame_index = 0;
+        size_t max_live = 0;
+
+        while (state.keep_running()) {
+            // Handle of source tensor is address of its memory. New pool takes next range of addresses, ranges are reused
+            const size_t pool_index = frame_index / pool_lifetime;
+            if (pool_index != context->pool) {
+                if (live_mapped > cache->statistics().capacity)
+                    throw std::runtime_error("mapper_cache_soak: more mapped objects alive than cache capacity");
+                context->destroy_pool();
+                if (live_mapped != 0)
+                    throw std::runtime_error("mapper_cache_soak: objects mapped from destroyed pool are alive");
+            }
+            const size_t buffer_index = pool_index % address_ranges * pool_size + frame_index % pool_size;
+            const size_t width = 1920 >> (pool_index / pools_per_resolution % 2);
+            TensorInfo info({1080, width, 3});
+            TensorPtr tensor = std::make_shared<CPUTensor>(info, &memory[buffer_index]);
+            FramePtr src = std::make_shared<BaseFrame>(MediaType::Image, static_cast<Format>(ImageFormat::RGB),
+                                                       TensorVector{tensor});
+
+            FramePtr mapped = cache->map(src, AccessMode::Read);
+            dlstreamer::bench::do_not_optimize(mapped);
+            if (std::static_pointer_cast<MappedTensor>(mapped->tensor(0))->pool != pool_index)
+                throw std::runtime_error("mapper_cache_soak: frame mapped from destroyed pool returned");
+            max_live = std::max(max_live, live_mapped.load());
+            frame_index++;
+        }
+
+        const auto stats = cache->statistics();
+        state.set_counter("frames", frame_index);
+        state.set_counter("hit_ratio", frame_index ? static_cast<double>(stats.hits) / frame_index : 0);
+        state.set_counter("evictions", stats.evictions);
+        state.set_counter("invalidations", stats.invalidations);
+        state.set_counter("releases", stats.releases);
+        state.set_counter("cache_size", stats.size);
+        state.set_counter("capacity", stats.capacity);
+        state.set_counter("grows", stats.grows);
+        state.set_counter("live_mapped", live_mapped.load());
+        state.set_counter("max_live_mapped", max_live);
+        if (state.elapsed_ns() > 0)
+            state.set_counter("ns_per_frame", state.elapsed_ns() / frame_index);
+    };
+}
+
+bool register_all() {
+    for (size_t pool_size : {8, 32, 128, 2048}) {
+        dlstreamer::bench::register_benchmark("mapper_cache_soak/pool_" + std::to_string(pool_size),
+                                              soak_benchmark(pool_size));
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
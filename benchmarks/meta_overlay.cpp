@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Overlay drawing of opencv_meta_overlay on 1080p and 4K frames with N detections, each with label, 18 keypoints and
+// 17 limb lines: serial drawing of all primitives on whole image (as before OpencvOverlayRenderer) versus drawing
+// in parallel horizontal bands with per-band culling and cached text rasters.
+
+#include "benchmark.h"
+#include "overlay_renderer.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace {
+
+using namespace dlstreamer::overlay;
+
+constexpr int keypoints_number = 18;
+constexpr int lines_thickness = 2;
+const char *labels[] = {"person", "car", "bicycle", "bus", "truck", "dog"};
+
+struct Prims {
+    std::vector<prims::Rect> rects;
+    std::vector<prims::Text> texts;
+    std::vector<prims::Circle> circles;
+    std::vector<prims::Line> lines;
+};
+
+Prims make_prims(int width, int height, int objects) {
+    Prims prims;
+    cv::RNG rng(42);
+    for (int i = 0; i < objects; i++) {
+        const int w = rng.uniform(width / 40, width / 8);
+        const int h = rng.uniform(height / 20, height / 4);
+        const int x = rng.uniform(0, width - w);
+        const int y = rng.uniform(0, height - h);
+        const uint32_t color = rng.next() | 0xff000000;
+        prims.rects.push_back({x, y, w, h, color, lines_thickness});
+        // Labels repeat as in real streams: class name and confidence with few distinct values
+        std::string label = std::string(labels[i % 6]) + " 0." + std::to_string(50 + i % 10);
+        prims.texts.push_back({label, x, y - 5, color, static_cast<uint32_t>(i)});
+        cv::Point points[keypoints_number];
+        for (auto &point : points) {
+            point = {x + rng.uniform(0, w), y + rng.uniform(0, h)};
+            prims.circles.push_back({point.x, point.y, 3, color});
+        }
+        for (int k = 1; k < keypoints_number; k++)
+            prims.lines.push_back({points[k - 1].x, points[k - 1].y, points[k].x, points[k].y, color, lines_thickness});
+    }
+    return prims;
+}
+
+// Drawing code of opencv_meta_overlay before banded renderer
+void draw_serial(cv::Mat &mat, const Prims &prims, const OpencvOverlayRenderer::Font &font) {
+    for (auto &rect : prims.rects) {
+        cv::rectangle(mat, {rect.x, rect.y}, {rect.x + rect.width, rect.y + rect.height},
+                      OpencvOverlayRenderer::color_to_cv(rect.color), rect.thickness, font.line_type);
+    }
+    for (auto &text : prims.texts) {
+        cv::putText(mat, text.str, {text.x, text.y}, font.face, font.scale,
+                    OpencvOverlayRenderer::color_to_cv(text.color), font.thickness, font.line_type);
+    }
+    for (auto &circle : prims.circles) {
+        cv::circle(mat, {circle.x, circle.y}, circle.radius, OpencvOverlayRenderer::color_to_cv(circle.color),
+                   cv::FILLED);
+    }
+    for (auto &line : prims.lines) {
+        cv::line(mat, {line.x1, line.y1}, {line.x2, line.y2}, OpencvOverlayRenderer::color_to_cv(line.color),
+                 line.thickness);
+    }
+}
+
+dlstreamer::bench::BenchmarkFunction overlay_benchmark(int width, int height, int objects, bool banded) {
+    return [=](dlstreamer::bench::State &state) {
+        const Prims prims = make_prims(width, height, objects);
+        OpencvOverlayRenderer::Font font;
+        OpencvOverlayRenderer renderer(font, 0);
+        cv::Mat mat(height, width, CV_8UC4, cv::Scalar::all(0));
+        while (state.keep_running()) {
+            if (banded)
+                renderer.render(mat, prims.rects, prims.texts, prims.circles, prims.lines);
+            else
+                draw_serial(mat, prims, font);
+            dlstreamer::bench::do_not_optimize(mat.data);
+        }
+        state.set_counter("objects", objects);
+        state.set_counter("threads", cv::getNumThreads());
+    };
+}
+
+bool register_all() {
+    const std::pair<const char *, cv::Size> resolutions[] = {{"1080p", {1920, 1080}}, {"4K", {3840, 2160}}};
+    for (auto &resolution : resolutions) {
+        for (int objects : {10, 100, 1000}) {
+            std::string suffix = "/" + std::string(resolution.first) + "/" + std::to_string(objects);
+            const cv::Size size = resolution.second;
+            dlstreamer::bench::register_benchmark("meta_overlay/serial" + suffix,
+                                                  overlay_benchmark(size.width, size.height, objects, false));
+            dlstreamer::bench::register_benchmark("meta_overlay/banded" + suffix,
+                                                  overlay_benchmark(size.width, size.height, objects, true));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
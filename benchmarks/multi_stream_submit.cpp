@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Many-stream submission benchmark: N streams share one pool of inference requests (as elements with the same
+// model-instance-id do) and pre-process 1080p frames into request input blobs with the OpenCV pre-processor.
+// 'serialized' holds one lock for the whole submission, as InferenceImpl::TransformFrameIp and
+// OpenVINOImageInference::SubmitImage did, 'concurrent' only waits for free request in the queue. Inference itself is
+// not run.
+
+#include "benchmark.h"
+#include "priority_safe_queue.h"
+
+#include "inference_backend/image.h"
+#include "inference_backend/input_image_layer_descriptor.h"
+#include "inference_backend/pre_proc.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace InferenceBackend;
+
+constexpr uint32_t src_width = 1920;
+constexpr uint32_t src_height = 1080;
+constexpr uint32_t dst_width = 300;
+constexpr uint32_t dst_height = 300;
+constexpr int nireq = 8;
+constexpr int frames_per_stream = 8;
+
+struct Request {
+    std::vector<uint8_t> blob;
+    Image image;
+};
+
+class SharedInstance {
+  public:
+    explicit SharedInstance(bool serialized)
+        : _serialized(serialized), _pre_proc(ImagePreprocessor::Create(ImagePreprocessorType::OPENCV)) {
+        for (int i = 0; i < nireq; i++) {
+            auto &request = _requests.emplace_back(std::make_unique<Request>());
+            request->blob.resize(dst_width * dst_height * 3);
+            request->image.type = MemoryType::SYSTEM;
+            request->image.format = FOURCC_RGBP;
+            request->image.width = dst_width;
+            request->image.height = dst_height;
+            for (uint32_t p = 0; p < Image::MAX_PLANES_NUMBER; p++) {
+                request->image.planes[p] = p < 3 ? request->blob.data() + p * dst_width * dst_height : nullptr;
+                request->image.stride[p] = p < 3 ? dst_width : 0;
+            }
+            _free_requests.push(request.get());
+        }
+    }
+
+    void Submit(const Image &src) {
+        std::unique_lock<std::mutex> submit_lock(_submit_mutex, std::defer_lock);
+        if (_serialized)
+            submit_lock.lock();
+
+        Request *request = _free_requests.pop(0);
+        Image dst = request->image;
+        _pre_proc->Convert(src, dst, nullptr, std::make_shared<ImageTransformationParams>());
+        dlstreamer::bench::do_not_optimize(request->blob[0]);
+        // request completes immediately
+        _free_requests.push(request);
+    }
+
+  private:
+    bool _serialized;
+    std::unique_ptr<ImagePreprocessor> _pre_proc;
+    std::vector<std::unique_ptr<Request>> _requests;
+    PrioritySafeQueue<Request *> _free_requests;
+    std::mutex _submit_mutex;
+};
+
+struct SourceFrame {
+    std::vector<uint8_t> data;
+    Image image;
+
+    explicit SourceFrame(int seed) : data(src_width * src_height * 4) {
+        for (size_t i = 0; i < data.size(); i++)
+            data[i] = static_cast<uint8_t>(i * 7 + seed);
+        image.type = MemoryType::SYSTEM;
+        image.format = FOURCC_BGRX;
+        image.width = src_width;
+        image.height = src_height;
+        image.size = static_cast<uint32_t>(data.size());
+        for (uint32_t p = 0; p < Image::MAX_PLANES_NUMBER; p++)
+            image.planes[p] = p == 0 ? data.data() : nullptr;
+        image.stride[0] = src_width * 4;
+    }
+};
+
+dlstreamer::bench::BenchmarkFunction submit_benchmark(int streams, bool serialized) {
+    return [=](dlstreamer::bench::State &state) {
+        SharedInstance instance(serialized);
+        std::vector<std::unique_ptr<SourceFrame>> sources;
+        for (int i = 0; i < streams; i++)
+            sources.push_back(std::make_unique<SourceFrame>(i));
+
+        while (state.keep_running()) {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < streams; i++) {
+                threads.emplace_back([&instance, &source = *sources[i]] {
+                    for (int f = 0; f < frames_per_stream; f++)
+                        instance.Submit(source.image);
+                });
+            }
+            for (auto &thread : threads)
+                thread.join();
+        }
+        state.set_counter("streams", streams);
+        if (state.elapsed_ns() > 0)
+            state.set_counter("fps", 1e9 * state.iterations() * streams * frames_per_stream / state.elapsed_ns());
+    };
+}
+
+bool register_all() {
+    for (int streams : {1, 2, 4, 8, 16}) {
+        std::string suffix = "/" + std::to_string(streams);
+        dlstreamer::bench::register_benchmark("multi_stream_submit/serialized" + suffix,
+                                              submit_benchmark(streams, true));
+        dlstreamer::bench::register_benchmark("multi_stream_submit/concurrent" + suffix,
+                                              submit_benchmark(streams, false));
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Output log of inference elements ('record-outputs' / 'replay-outputs' properties) in temporary file:
+//  * write - OutputLogWriter appending records with one output blob of SIZE, file is re-created every 256 records
+//  * read, read_no_index - OutputLogReader getting records of log and reading their blob data, with index and with
+//    index rebuilt by scanning records (log of interrupted recording)
+//  * replay - ReplayImageInference completing submitted frames with records of log, which has records in submission
+//    order, in completion order different from it (pairs of records swapped) and is replayed with every 10th frame
+//    skipped by pipeline. In 'regions' case log has records of 4 regions per frame in reverse order, and every 7th
+//    region is skipped. Replay finds record of frame by its PTS and region position in all cases except first one
+//    ('resynced_batches').
+// Record of every frame (region) has blob filled with its number, 'corrupted_records' and 'misassigned_frames' counters
+// compare it (and frame ids of record) with frame which got it and must be 0.
+
+#include "benchmark.h"
+
+#include "output_log.h"
+#include "replay_image_inference.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+using namespace InferenceBackend;
+
+constexpr size_t log_records = 256;
+constexpr uint64_t frame_duration_ns = 33333333;
+constexpr auto blob_name = "output";
+
+class FrameBlob : public OutputBlob {
+  public:
+    FrameBlob(size_t frame, size_t size) : dims{1, size / sizeof(float)}, data(dims[1], static_cast<float>(frame)) {
+    }
+    const std::vector<size_t> &GetDims() const override {
+        return dims;
+    }
+    Layout GetLayout() const override {
+        return Layout::NC;
+    }
+    Precision GetPrecision() const override {
+        return Precision::FP32;
+    }
+    const void *GetData() const override {
+        return data.data();
+    }
+
+  private:
+    std::vector<size_t> dims;
+    std::vector<float> data;
+};
+
+// Frame number is number of region for log with several regions per frame
+OutputLogFrameId frame_id(size_t frame, size_t regions = 1) {
+    OutputLogFrameId id = {};
+    id.timestamp = frame / regions * frame_duration_ns;
+    id.roi_index = regions > 1 ? static_cast<int32_t>(frame % regions) : -1;
+    return id;
+}
+
+std::string temp_log_path() {
+    return (std::filesystem::temp_directory_path() /
+            ("dlstreamer_bench_output_log_" + std::to_string(getpid()) + ".olog"))
+        .string();
+}
+
+OutputLogModelInfo model_info(size_t blob_size) {
+    OutputLogModelInfo info;
+    info.name = "synthetic";
+    info.width = info.height = 416;
+    info.batch_size = 1;
+    info.outputs[blob_name] = {1, blob_size / sizeof(float)};
+    return info;
+}
+
+// Writes record of every frame in given order
+void write_log(const std::string &path, size_t blob_size, const std::vector<size_t> &frames, size_t regions = 1) {
+    OutputLogWriter writer(path, model_info(blob_size));
+    for (size_t frame : frames)
+        writer.Write({{blob_name, std::make_shared<FrameBlob>(frame, blob_size)}}, {frame_id(frame, regions)});
+}
+
+std::vector<size_t> frames_in_order() {
+    std::vector<size_t> frames(log_records);
+    std::iota(frames.begin(), frames.end(), 0);
+    return frames;
+}
+
+// Blob of record is filled with number of frame it was recorded for
+bool is_record_of(const std::map<std::string, OutputBlob::Ptr> &blobs, size_t frame) {
+    auto it = blobs.find(blob_name);
+    if (it == blobs.end())
+        return false;
+    const auto *data = static_cast<const float *>(it->second->GetData());
+    const size_t size = it->second->GetSize();
+    return size && data[0] == frame && data[size - 1] == frame &&
+           std::accumulate(data, data + size, 0.0) == static_cast<double>(frame) * size;
+}
+
+dlstreamer::bench::BenchmarkFunction write_benchmark(size_t blob_size) {
+    return [=](dlstreamer::bench::State &state) {
+        const std::string path = temp_log_path();
+        std::unique_ptr<OutputLogWriter> writer;
+        std::map<std::string, OutputBlob::Ptr> blobs = {{blob_name, std::make_shared<FrameBlob>(0, blob_size)}};
+        size_t frame = 0;
+        while (state.keep_running()) {
+            if (frame % log_records == 0) {
+                writer.reset();
+                writer.reset(new OutputLogWriter(path, model_info(blob_size)));
+            }
+            writer->Write(blobs, {frame_id(frame++)});
+        }
+        writer.reset();
+        std::remove(path.c_str());
+        state.set_counter("MB_per_s", static_cast<double>(blob_size) * state.iterations() * 1e3 / state.elapsed_ns());
+    };
+}
+
+dlstreamer::bench::BenchmarkFunction read_benchmark(size_t blob_size, bool no_index) {
+    return [=](dlstreamer::bench::State &state) {
+        const std::string path = temp_log_path();
+        write_log(path, blob_size, frames_in_order());
+        if (no_index) {
+            // Drop index and trailer, as if recording was interrupted
+            const auto size = std::filesystem::file_size(path);
+            std::filesystem::resize_file(path, size - sizeof(OutputLogTrailer) -
+                                                   log_records * sizeof(OutputLogIndexEntry));
+        }
+
+        size_t corrupted_records = 0;
+        {
+            OutputLogReader reader(path);
+            size_t record_index = 0;
+            while (state.keep_running()) {
+                OutputLogReader::Record record = reader.GetRecord(record_index);
+                if (record.frames.size() != 1 || record.frames[0].timestamp != frame_id(record_index).timestamp ||
+                    !is_record_of(record.blobs, record_index))
+                    corrupted_records++;
+                record_index = (record_index + 1) % reader.GetRecordsNumber();
+            }
+            state.set_counter("records", reader.GetRecordsNumber());
+            state.set_counter("index_rebuilt", reader.IsIndexRebuilt());
+        }
+        std::remove(path.c_str());
+        state.set_counter("corrupted_records", corrupted_records);
+        state.set_counter("MB_per_s", static_cast<double>(blob_size) * state.iterations() * 1e3 / state.elapsed_ns());
+    };
+}
+
+struct ReplayFrame : public ImageInference::IFrameBase {
+    void SetImage(ImagePtr) override {
+    }
+    ImagePtr GetImage() const override {
+        return nullptr;
+    }
+    size_t frame = 0;
+};
+
+enum class ReplayCase { InOrder, OutOfOrder, Skipped, Regions };
+
+dlstreamer::bench::BenchmarkFunction replay_benchmark(size_t blob_size, ReplayCase replay_case) {
+    return [=](dlstreamer::bench::State &state) {
+        const std::string path = temp_log_path();
+        const size_t regions = replay_case == ReplayCase::Regions ? 4 : 1;
+        std::vector<size_t> frames = frames_in_order();
+        if (replay_case == ReplayCase::OutOfOrder) {
+            for (size_t i = 0; i + 1 < frames.size(); i += 2)
+                std::swap(frames[i], frames[i + 1]);
+        }
+        if (replay_case == ReplayCase::Regions) {
+            for (size_t i = 0; i + regions <= frames.size(); i += regions)
+                std::reverse(frames.begin() + i, frames.begin() + i + regions);
+        }
+        write_log(path, blob_size, frames, regions);
+
+        size_t misassigned_frames = 0;
+        {
+            ReplayImageInference replay(
+                path,
+                [&](std::map<std::string, OutputBlob::Ptr> blobs, std::vector<ImageInference::IFrameBase::Ptr> done) {
+                    for (auto &frame : done) {
+                        if (!is_record_of(blobs, static_cast<ReplayFrame &>(*frame).frame))
+                            misassigned_frames++;
+                    }
+                },
+                [](std::vector<ImageInference::IFrameBase::Ptr>) {},
+                [=](const ImageInference::IFrameBase &frame) {
+                    return frame_id(static_cast<const ReplayFrame &>(frame).frame, regions);
+                });
+
+            size_t frame = 0;
+            while (state.keep_running()) {
+                auto replay_frame = std::make_shared<ReplayFrame>();
+                replay_frame->frame = frame;
+                replay.SubmitImage(replay_frame, {});
+                frame = (frame + 1) % log_records;
+                if ((replay_case == ReplayCase::Skipped && frame % 10 == 9) ||
+                    (replay_case == ReplayCase::Regions && frame % 7 == 6))
+                    frame = (frame + 1) % log_records;
+            }
+            replay.Flush();
+            state.set_counter("resynced_batches", replay.GetResyncedBatches());
+            state.set_counter("mismatched_batches", replay.GetMismatchedBatches());
+        }
+        std::remove(path.c_str());
+        state.set_counter("misassigned_frames", misassigned_frames);
+    };
+}
+
+bool register_all() {
+    using dlstreamer::bench::register_benchmark;
+    for (size_t size_kb : {64, 1024}) {
+        const std::string suffix = "/" + std::to_string(size_kb) + "KB";
+        const size_t size = size_kb * 1024;
+        register_benchmark("output_log/write" + suffix, write_benchmark(size));
+        register_benchmark("output_log/read" + suffix, read_benchmark(size, false));
+        register_benchmark("output_log/read_no_index" + suffix, read_benchmark(size, true));
+    }
+    const size_t replay_size = 64 * 1024;
+    register_benchmark("output_log/replay/in_order", replay_benchmark(replay_size, ReplayCase::InOrder));
+    register_benchmark("output_log/replay/out_of_order", replay_benchmark(replay_size, ReplayCase::OutOfOrder));
+    register_benchmark("output_log/replay/skipped", replay_benchmark(replay_size, ReplayCase::Skipped));
+    register_benchmark("output_log/replay/regions", replay_benchmark(replay_size, ReplayCase::Regions));
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -0,0 +1,547 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Multi-stream pipeline benchmark runner. Runs N parallel streams 'source ! gvainference ! fakesink' in one process
+// with model generated at runtime by OpenVINO™ API, so no models, video files or network access needed. Sweeps number
+// of streams, batch-size, nireq and pre-process-backend and writes throughput, per-stream latency percentiles, CPU
+// utilization and memory usage of every configuration into JSON report. With '--replay-outputs' inference element
+// replays model outputs recorded with its 'record-outputs' property instead of running model, which measures
+// post-processing and metadata handling of the pipeline at rates not limited by inference.
+
+#include <gst/gst.h>
+
+#include <openvino/openvino.hpp>
+#include <openvino/opsets/opset8.hpp>
+#include <openvino/pass/serialize.hpp>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<int> streams = {1, 2, 4};
+    std::vector<int> batch_sizes = {1};
+    std::vector<int> nireqs = {2};
+    std::vector<std::string> backends = {"ie", "opencv"};
+    int frames = 300;       // per stream
+    int warmup_frames = 30; // per stream, not included into statistics
+    int width = 1280;
+    int height = 720;
+    std::string format = "BGRx";
+    std::string source = "videotestsrc"; // or 'raw'
+    int model_size = 224;
+    std::string model; // generated if not set
+    std::string model_proc;
+    std::string replay_outputs; // model isn't used if set
+    std::string element = "gvainference";
+    std::string device = "CPU";
+    std::string json_path;
+};
+
+struct Config {
+    int streams;
+    int batch_size;
+    int nireq;
+    std::string backend;
+};
+
+struct Latency {
+    double p50 = 0, p90 = 0, p99 = 0, max = 0; // milliseconds
+};
+
+struct Result {
+    Config config;
+    std::string error;
+    size_t frames = 0; // measured frames of all streams
+    double seconds = 0;
+    double fps = 0;
+    Latency latency;
+    std::vector<Latency> stream_latency;
+    double cpu_cores_used = 0;
+    double cpu_utilization = 0; // percent of all cores
+    double rss_peak_mb = 0;
+    double rss_end_mb = 0;
+};
+
+void print_usage(const char *app) {
+    std::cout << "Usage: " << app << " [OPTIONS]\n"
+              << "  --streams=LIST              numbers of streams, default 1,2,4\n"
+              << "  --batch-size=LIST           batch-size values, default 1\n"
+              << "  --nireq=LIST                nireq values, default 2\n"
+              << "  --pre-process-backend=LIST  pre-process-backend values, default ie,opencv\n"
+              << "  --frames=N                  frames per stream, default 300\n"
+              << "  --warmup-frames=N           first frames of each stream excluded from statistics, default 30\n"
+              << "  --resolution=WxH            source resolution, default 1280x720\n"
+              << "  --format=FORMAT             source video format, default BGRx\n"
+              << "  --source=videotestsrc|raw   frames generated by videotestsrc on the fly, or read from raw video "
+                 "file generated before run\n"
+              << "  --model-size=N              input size of generated model, default 224\n"
+              << "  --model=PATH                use existing model instead of generated one\n"
+              << "  --model-proc=PATH           model-proc file of inference element\n"
+              << "  --replay-outputs=PATH       replay model outputs recorded with 'record-outputs' property instead "
+                 "of running inference\n"
+              << "  --element=NAME              inference element, gvainference (default) or gvadetect\n"
+              << "  --device=DEVICE             inference device, default CPU\n"
+              << "  --json=FILE                 write report into JSON file\n";
+}
+
+template <typename T>
+std::vector<T> parse_list(const std::string &value) {
+    std::vector<T> list;
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::istringstream item_stream(item);
+        T parsed;
+        if (!(item_stream >> parsed))
+            throw std::invalid_argument("Invalid value: " + value);
+        list.push_back(parsed);
+    }
+    if (list.empty())
+        throw std::invalid_argument("Empty list");
+    return list;
+}
+
+bool parse_options(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "--streams")
+            options.streams = parse_list<int>(value);
+        else if (key == "--batch-size")
+            options.batch_sizes = parse_list<int>(value);
+        else if (key == "--nireq")
+            options.nireqs = parse_list<int>(value);
+        else if (key == "--pre-process-backend")
+            options.backends = parse_list<std::string>(value);
+        else if (key == "--frames")
+            options.frames = std::stoi(value);
+        else if (key == "--warmup-frames")
+            options.warmup_frames = std::stoi(value);
+        else if (key == "--resolution" && sscanf(value.c_str(), "%dx%d", &options.width, &options.height) == 2)
+            continue;
+        else if (key == "--format")
+            options.format = value;
+        else if (key == "--source" && (value == "videotestsrc" || value == "raw"))
+            options.source = value;
+        else if (key == "--model-size")
+            options.model_size = std::stoi(value);
+        else if (key == "--model")
+            options.model = value;
+        else if (key == "--model-proc")
+            options.model_proc = value;
+        else if (key == "--replay-outputs")
+            options.replay_outputs = value;
+        else if (key == "--element" && (value == "gvainference" || value == "gvadetect"))
+            options.element = value;
+        else if (key == "--device")
+            options.device = value;
+        else if (key == "--json")
+            options.json_path = value;
+        else
+            return false;
+    }
+    return options.frames > options.warmup_frames && options.warmup_frames >= 0;
+}
+
+// Small classification network: three strided 3x3 convolutions, global pooling and fully connected layer
+void generate_model(const std::string &xml_path, const std::string &bin_path, size_t size) {
+    using namespace ov;
+    std::mt19937 random(42);
+    std::normal_distribution<float> distribution(0.f, 0.1f);
+    auto weights = [&](const Shape &shape) {
+        std::vector<float> values(shape_size(shape));
+        std::generate(values.begin(), values.end(), [&] { return distribution(random); });
+        return opset8::Constant::create(element::f32, shape, values);
+    };
+
+    auto input = std::make_shared<opset8::Parameter>(element::f32, Shape{1, 3, size, size});
+    input->output(0).get_tensor().set_names({"input"});
+    Output<Node> x = input;
+    size_t channels = 3;
+    for (size_t out_channels : {16, 32, 64}) {
+        auto conv = std::make_shared<opset8::Convolution>(x, weights({out_channels, channels, 3, 3}), Strides{2, 2},
+                                                          CoordinateDiff{1, 1}, CoordinateDiff{1, 1}, Strides{1, 1});
+        x = std::make_shared<opset8::Relu>(conv);
+        channels = out_channels;
+    }
+    auto axes = opset8::Constant::create(element::i64, Shape{2}, std::vector<int64_t>{2, 3});
+    auto pooled = std::make_shared<opset8::ReduceMean>(x, axes, false);
+    auto logits = std::make_shared<opset8::MatMul>(pooled, weights({channels, 10}));
+    auto prob = std::make_shared<opset8::Softmax>(logits, 1);
+    prob->output(0).get_tensor().set_names({"prob"});
+
+    auto model = std::make_shared<Model>(OutputVector{prob}, ParameterVector{input}, "synthetic_classifier");
+    pass::Serialize(xml_path, bin_path).run_on_model(model);
+}
+
+// Runs pipeline till EOS, returns error message or empty string
+std::string run_to_eos(GstElement *pipeline) {
+    std::string error;
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+        error = "Failed to start pipeline";
+    GstBus *bus = gst_element_get_bus(pipeline);
+    while (error.empty()) {
+        GstMessage *msg = gst_bus_timed_pop_filtered(bus, GST_CLOCK_TIME_NONE,
+                                                     static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+        if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+            GError *err = nullptr;
+            gst_message_parse_error(msg, &err, nullptr);
+            error = std::string(GST_OBJECT_NAME(msg->src)) + ": " + err->message;
+            g_error_free(err);
+        }
+        const bool eos = GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS;
+        gst_message_unref(msg);
+        if (eos)
+            break;
+    }
+    gst_object_unref(bus);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    return error;
+}
+
+GstElement *launch(const std::string &description, std::string &error) {
+    GError *err = nullptr;
+    GstElement *pipeline = gst_parse_launch(description.c_str(), &err);
+    if (err) {
+        error = err->message;
+        g_error_free(err);
+        if (pipeline)
+            gst_object_unref(pipeline);
+        return nullptr;
+    }
+    return pipeline;
+}
+
+std::string video_caps(const Options &options) {
+    return "video/x-raw,format=" + options.format + ",width=" + std::to_string(options.width) +
+           ",height=" + std::to_string(options.height) + ",framerate=30/1";
+}
+
+// Frames for '--source=raw': short clip which streams read in loop, so frames aren't generated during measurement
+constexpr int raw_clip_frames = 30;
+
+void generate_raw_clip(const Options &options, const std::string &path) {
+    std::string error;
+    GstElement *pipeline = launch("videotestsrc num-buffers=" + std::to_string(raw_clip_frames) + " pattern=ball ! " +
+                                      video_caps(options) + " ! filesink location=" + path,
+                                  error);
+    if (pipeline) {
+        error = run_to_eos(pipeline);
+        gst_object_unref(pipeline);
+    }
+    if (!error.empty())
+        throw std::runtime_error("Failed to generate raw video: " + error);
+}
+
+double current_rss_mb() {
+    long pages = 0, resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+        resident = 0;
+    fclose(statm);
+    return static_cast<double>(resident) * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+double cpu_seconds() {
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    auto seconds = [](const timeval &t) { return t.tv_sec + t.tv_usec * 1e-6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+// Shared by streaming threads of all streams. Measurement starts with first frame after warm-up of any stream
+struct Measurement {
+    std::mutex mutex;
+    bool started = false;
+    Clock::time_point start;
+    Clock::time_point end;
+    double start_cpu_seconds = 0;
+    size_t frames = 0;
+};
+
+// Frames leave gvainference in the order they entered it, so timestamps of frames in flight are kept in FIFO
+struct Stream {
+    Measurement *measurement;
+    int warmup_frames;
+    std::mutex mutex;
+    std::deque<Clock::time_point> in_flight;
+    size_t output_frames = 0;
+    std::vector<double> latencies_ms;
+};
+
+GstPadProbeReturn on_source_buffer(GstPad *, GstPadProbeInfo *, gpointer user_data) {
+    auto *stream = static_cast<Stream *>(user_data);
+    std::lock_guard<std::mutex> lock(stream->mutex);
+    stream->in_flight.push_back(Clock::now());
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn on_sink_buffer(GstPad *, GstPadProbeInfo *, gpointer user_data) {
+    auto *stream = static_cast<Stream *>(user_data);
+    const auto now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (stream->in_flight.empty())
+            return GST_PAD_PROBE_OK;
+        const auto input_time = stream->in_flight.front();
+        stream->in_flight.pop_front();
+        if (static_cast<int>(stream->output_frames++) < stream->warmup_frames)
+            return GST_PAD_PROBE_OK;
+        stream->latencies_ms.push_back(std::chrono::duration<double, std::milli>(now - input_time).count());
+    }
+
+    Measurement &measurement = *stream->measurement;
+    std::lock_guard<std::mutex> lock(measurement.mutex);
+    if (!measurement.started) {
+        measurement.started = true;
+        measurement.start = now;
+        measurement.start_cpu_seconds = cpu_seconds();
+    } else {
+        measurement.frames++;
+    }
+    measurement.end = now;
+    return GST_PAD_PROBE_OK;
+}
+
+Latency percentiles(std::vector<double> values) {
+    Latency latency;
+    if (values.empty())
+        return latency;
+    std::sort(values.begin(), values.end());
+    auto at = [&](double p) { return values[static_cast<size_t>(p * (values.size() - 1) + 0.5)]; };
+    latency.p50 = at(0.5);
+    latency.p90 = at(0.9);
+    latency.p99 = at(0.99);
+    latency.max = values.back();
+    return latency;
+}
+
+std::string stream_description(const Options &options, const Config &config, const std::string &model,
+                               const std::string &raw_clip, int index) {
+    const std::string frames = std::to_string(options.frames);
+    std::string source;
+    if (raw_clip.empty()) {
+        source = "videotestsrc num-buffers=" + frames + " pattern=ball";
+    } else {
+        source = "multifilesrc location=" + raw_clip + " loop=true caps=\"" + video_caps(options) +
+                 "\" ! rawvideoparse use-sink-caps=true ! identity eos-after=" + frames;
+    }
+    const std::string id = std::to_string(index);
+    std::string inference = options.element + " model-instance-id=inf0 ";
+    inference += options.replay_outputs.empty() ? "model=" + model : "replay-outputs=" + options.replay_outputs;
+    if (!options.model_proc.empty())
+        inference += " model-proc=" + options.model_proc;
+    return source + " ! capsfilter name=source" + id + " caps=\"" + video_caps(options) + "\" ! " + inference +
+           " device=" + options.device + " batch-size=" + std::to_string(config.batch_size) +
+           " nireq=" + std::to_string(config.nireq) + " pre-process-backend=" + config.backend +
+           " ! fakesink name=sink" + id + " sync=false async=false ";
+}
+
+Result run(const Options &options, const Config &config, const std::string &model, const std::string &raw_clip) {
+    Result result;
+    result.config = config;
+
+    std::string description;
+    for (int i = 0; i < config.streams; i++)
+        description += stream_description(options, config, model, raw_clip, i);
+    GstElement *pipeline = launch(description, result.error);
+    if (!pipeline)
+        return result;
+
+    Measurement measurement;
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (int i = 0; i < config.streams; i++) {
+        streams.push_back(std::make_unique<Stream>());
+        streams.back()->measurement = &measurement;
+        streams.back()->warmup_frames = options.warmup_frames;
+        for (auto probe : {std::make_pair("source", on_source_buffer), std::make_pair("sink", on_sink_buffer)}) {
+            const std::string name = probe.first + std::to_string(i);
+            GstElement *element = gst_bin_get_by_name(GST_BIN(pipeline), name.c_str());
+            GstPad *pad = gst_element_get_static_pad(element, probe.first == std::string("sink") ? "sink" : "src");
+            gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, probe.second, streams.back().get(), nullptr);
+            gst_object_unref(pad);
+            gst_object_unref(element);
+        }
+    }
+
+    std::atomic<bool> running{true};
+    double rss_peak_mb = 0;
+    std::thread rss_sampler([&] {
+        while (running) {
+            rss_peak_mb = std::max(rss_peak_mb, current_rss_mb());
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+
+    result.error = run_to_eos(pipeline);
+    const double end_cpu_seconds = cpu_seconds();
+    running = false;
+    rss_sampler.join();
+    result.rss_peak_mb = rss_peak_mb;
+    result.rss_end_mb = current_rss_mb();
+    gst_object_unref(pipeline);
+
+    std::vector<double> all_latencies;
+    for (auto &stream : streams) {
+        result.stream_latency.push_back(percentiles(stream->latencies_ms));
+        all_latencies.insert(all_latencies.end(), stream->latencies_ms.begin(), stream->latencies_ms.end());
+    }
+    result.latency = percentiles(std::move(all_latencies));
+    result.frames = measurement.frames;
+    result.seconds = std::chrono::duration<double>(measurement.end - measurement.start).count();
+    if (result.seconds > 0) {
+        result.fps = measurement.frames / result.seconds;
+        result.cpu_cores_used = (end_cpu_seconds - measurement.start_cpu_seconds) / result.seconds;
+        result.cpu_utilization = 100 * result.cpu_cores_used / std::thread::hardware_concurrency();
+    }
+    return result;
+}
+
+void write_latency(std::ostream &out, const Latency &latency) {
+    out << "{\"p50\": " << latency.p50 << ", \"p90\": " << latency.p90 << ", \"p99\": " << latency.p99
+        << ", \"max\": " << latency.max << "}";
+}
+
+void write_json(const std::string &path, const Options &options, const std::string &model,
+                const std::vector<Result> &results) {
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Can't open file " + path);
+    out << "{\n  \"cpu_count\": " << std::thread::hardware_concurrency() << ",\n  \"model\": \"" << model
+        << "\",\n  \"replay_outputs\": \"" << options.replay_outputs << "\",\n  \"element\": \"" << options.element
+        << "\",\n  \"device\": \"" << options.device << "\",\n  \"source\": \"" << options.source
+        << "\",\n  \"resolution\": \"" << options.width << "x" << options.height << "\",\n  \"format\": \""
+        << options.format << "\",\n  \"frames_per_stream\": " << options.frames
+        << ",\n  \"warmup_frames\": " << options.warmup_frames << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        out << "    {\"streams\": " << r.config.streams << ", \"batch_size\": " << r.config.batch_size
+            << ", \"nireq\": " << r.config.nireq << ", \"pre_process_backend\": \"" << r.config.backend << "\"";
+        if (!r.error.empty()) {
+            std::string error = r.error;
+            std::replace(error.begin(), error.end(), '"', '\'');
+            out << ", \"error\": \"" << error << "\"}";
+        } else {
+            out << ", \"frames\": " << r.frames << ", \"seconds\": " << r.seconds << ", \"fps\": " << r.fps
+                << ", \"fps_per_stream\": " << r.fps / r.config.streams << ", \"latency_ms\": ";
+            write_latency(out, r.latency);
+            out << ", \"stream_latency_ms\": [";
+            for (size_t s = 0; s < r.stream_latency.size(); s++) {
+                write_latency(out, r.stream_latency[s]);
+                out << (s + 1 < r.stream_latency.size() ? ", " : "");
+            }
+            out << "], \"cpu_cores_used\": " << r.cpu_cores_used << ", \"cpu_utilization\": " << r.cpu_utilization
+                << ", \"rss_peak_mb\": " << r.rss_peak_mb << ", \"rss_end_mb\": " << r.rss_end_mb << "}";
+        }
+        out << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Temporary directory for generated model and raw video, removed on exit
+class TempDir {
+  public:
+    TempDir() {
+        char path[] = "/tmp/dlstreamer_pipeline_benchmark_XXXXXX";
+        if (!mkdtemp(path))
+            throw std::runtime_error("Failed to create temporary directory");
+        _path = path;
+    }
+    ~TempDir() {
+        for (const char *file : {"model.xml", "model.bin", "source.raw"})
+            unlink((_path + "/" + file).c_str());
+        rmdir(_path.c_str());
+    }
+    std::string file(const std::string &name) const {
+        return _path + "/" + name;
+    }
+
+  private:
+    std::string _path;
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    gst_init(&argc, &argv);
+    Options options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        TempDir temp_dir;
+        std::string model = options.model;
+        if (model.empty() && options.replay_outputs.empty()) {
+            model = temp_dir.file("model.xml");
+            generate_model(model, temp_dir.file("model.bin"), options.model_size);
+        }
+        std::string raw_clip;
+        if (options.source == "raw") {
+            raw_clip = temp_dir.file("source.raw");
+            generate_raw_clip(options, raw_clip);
+        }
+
+        std::vector<Result> results;
+        printf("%8s %6s %6s %10s %10s %10s %10s %10s %10s %8s %10s\n", "streams", "batch", "nireq", "backend", "fps",
+               "p50_ms", "p90_ms", "p99_ms", "max_ms", "cpu_%", "rss_mb");
+        for (int streams : options.streams) {
+            for (int batch_size : options.batch_sizes) {
+                for (int nireq : options.nireqs) {
+                    for (const std::string &backend : options.backends) {
+                        Result r = run(options, {streams, batch_size, nireq, backend}, model, raw_clip);
+                        printf("%8d %6d %6d %10s ", streams, batch_size, nireq, backend.c_str());
+                        if (r.error.empty())
+                            printf("%10.1f %10.2f %10.2f %10.2f %10.2f %8.1f %10.1f\n", r.fps, r.latency.p50,
+                                   r.latency.p90, r.latency.p99, r.latency.max, r.cpu_utilization, r.rss_peak_mb);
+                        else
+                            printf("error: %s\n", r.error.c_str());
+                        fflush(stdout);
+                        results.push_back(std::move(r));
+                    }
+                }
+            }
+        }
+
+        if (!options.json_path.empty())
+            write_json(options.json_path, options, model, results);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,397 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Post-processing converters of gvadetect/gvaclassify/gvainference fed with synthetic output blobs of real models
+// shapes, one iteration is one frame: convert() of all output blobs and release of produced structures, as meta
+// attacher would. Blobs contain N objects placed at random with fixed seed, so results are reproducible. YOLO outputs
+// have every object seen by several anchors and cells on every scale, so NMS has clusters of candidates to suppress.
+// Same outputs are also processed by tensor_postproc_* elements of dlstreamer_cpu plugin (in-place transforms on CPU
+// tensors attaching metadata to frame), one iteration is process() of one frame and removal of attached metadata.
+
+#include "benchmark.h"
+
+#include "post_processor/blob_to_meta_converter.h"
+
+#include <dlstreamer/base/frame.h>
+#include <dlstreamer/cpu/elements/tensor_postproc_detection.h>
+#include <dlstreamer/cpu/elements/tensor_postproc_label.h>
+#include <dlstreamer/cpu/elements/tensor_postproc_text.h>
+#include <dlstreamer/cpu/elements/tensor_postproc_yolo.h>
+#include <dlstreamer/cpu/tensor.h>
+#include <dlstreamer/image_metadata.h>
+#include <dlstreamer/utils.h>
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace post_processing;
+using InferenceBackend::OutputBlob;
+
+constexpr double confidence_threshold = 0.5;
+
+class SyntheticBlob : public OutputBlob {
+  public:
+    explicit SyntheticBlob(std::vector<size_t> dims)
+        : _dims(std::move(dims)),
+          _data(std::accumulate(_dims.begin(), _dims.end(), size_t(1), std::multiplies<size_t>())) {
+    }
+
+    const std::vector<size_t> &GetDims() const override {
+        return _dims;
+    }
+    Layout GetLayout() const override {
+        return _dims.size() == 4 ? Layout::NCHW : Layout::ANY;
+    }
+    Precision GetPrecision() const override {
+        return Precision::FP32;
+    }
+    const void *GetData() const override {
+        return _data.data();
+    }
+    float *data() {
+        return _data.data();
+    }
+
+  private:
+    std::vector<size_t> _dims;
+    std::vector<float> _data;
+};
+
+struct Model {
+    size_t width;
+    size_t height;
+    GstStructure *model_proc; // ownership is passed to converter
+    std::vector<std::string> labels;
+    ConverterType converter_type = ConverterType::TO_ROI;
+    std::map<std::string, std::shared_ptr<SyntheticBlob>> outputs;
+};
+
+void set_array(GstStructure *s, const char *field, const std::vector<double> &values, bool integers) {
+    GValueArray *array = g_value_array_new(values.size());
+    GValue value = G_VALUE_INIT;
+    g_value_init(&value, integers ? G_TYPE_INT : G_TYPE_DOUBLE);
+    for (double v : values) {
+        if (integers)
+            g_value_set_int(&value, static_cast<int>(v));
+        else
+            g_value_set_double(&value, v);
+        g_value_array_append(array, &value);
+    }
+    gst_structure_set_array(s, field, array);
+    g_value_array_free(array);
+    g_value_unset(&value);
+}
+
+// Anchors and masks as in samples/gstreamer/model_proc/public/yolo-v3-tf.json and yolo-v5.json
+const std::vector<double> yolo_anchors = {10, 13, 16, 30, 33, 23, 30, 61, 62, 45, 59, 119, 116, 90, 156, 198, 373, 326};
+const std::vector<double> yolo_masks = {6, 7, 8, 3, 4, 5, 0, 1, 2};
+constexpr size_t yolo_classes = 80;
+constexpr size_t yolo_boxes_on_cell = 3;
+
+// YOLOv3 (activated=true) has sigmoid and softmax in model, outputs are probabilities. YOLOv5 outputs are logits
+Model yolo_model(const char *converter, size_t input_size, bool activated, size_t objects) {
+    GstStructure *model_proc = gst_structure_new(
+        "detection", "converter", G_TYPE_STRING, converter, "confidence_threshold", G_TYPE_DOUBLE, confidence_threshold,
+        "iou_threshold", G_TYPE_DOUBLE, 0.4, "classes", G_TYPE_INT, static_cast<int>(yolo_classes), "do_cls_softmax",
+        G_TYPE_BOOLEAN, !activated, "output_sigmoid_activation", G_TYPE_BOOLEAN, !activated, NULL);
+    Model model{input_size, input_size, model_proc};
+    set_array(model.model_proc, "anchors", yolo_anchors, false);
+    set_array(model.model_proc, "masks", yolo_masks, true);
+
+    const float background = activated ? 0.001f : -8.f;
+    const float high = activated ? 0.95f : 8.f;
+    const float center = activated ? 0.5f : 0.f; // cell center after activation
+    const size_t entries = yolo_classes + 5;
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0.05f, 0.95f);
+    std::uniform_int_distribution<size_t> label(0, yolo_classes - 1);
+    std::vector<std::pair<float, float>> centers(objects);
+    std::vector<size_t> labels(objects);
+    for (size_t i = 0; i < objects; i++) {
+        centers[i] = {position(random), position(random)};
+        labels[i] = label(random);
+    }
+
+    for (size_t side = input_size / 32; side <= input_size / 8; side *= 2) {
+        auto blob = std::make_shared<SyntheticBlob>(std::vector<size_t>{1, yolo_boxes_on_cell * entries, side, side});
+        float *data = blob->data();
+        const size_t side_square = side * side;
+        std::fill(data, data + blob->GetSize(), 0.f);
+        for (size_t box = 0; box < yolo_boxes_on_cell; box++)
+            std::fill_n(data + side_square * (box * entries + 4), side_square, background);
+
+        // Object is detected in its cell and nearest horizontal neighbour by all anchors
+        for (size_t i = 0; i < objects; i++) {
+            const size_t col = static_cast<size_t>(centers[i].first * side);
+            const size_t row = static_cast<size_t>(centers[i].second * side);
+            const size_t neighbour = centers[i].first * side - col < 0.5f ? std::max(col, size_t(1)) - 1
+                                                                          : std::min(col + 1, side - 1);
+            for (size_t cell : {row * side + col, row * side + neighbour}) {
+                for (size_t box = 0; box < yolo_boxes_on_cell; box++) {
+                    float *entry = data + side_square * box * entries + cell;
+                    entry[0] = entry[side_square] = center;
+                    entry[2 * side_square] = entry[3 * side_square] = 0.f; // anchor size
+                    entry[4 * side_square] = high;
+                    entry[(5 + labels[i]) * side_square] = high;
+                }
+            }
+        }
+        model.outputs["yolo_" + std::to_string(side)] = blob;
+    }
+    return model;
+}
+
+// SSD-like DetectionOutput layer [1, 1, 200, 7], half of detections are below confidence threshold
+Model detection_output_model(size_t objects) {
+    Model model{300, 300,
+                gst_structure_new("detection", "converter", G_TYPE_STRING, "detection_output", "confidence_threshold",
+                                  G_TYPE_DOUBLE, confidence_threshold, NULL)};
+    constexpr size_t max_proposals = 200;
+    auto blob = std::make_shared<SyntheticBlob>(std::vector<size_t>{1, 1, max_proposals, 7});
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0.f, 0.8f);
+    float *data = blob->data();
+    for (size_t i = 0; i < max_proposals; i++) {
+        float *proposal = data + i * 7;
+        const float x = position(random), y = position(random);
+        const float confidence = i % 2 ? 0.3f : 0.9f;
+        const float image_id = i < objects ? 0.f : -1.f;
+        const float values[7] = {image_id, 1.f, confidence, x, y, x + 0.1f, y + 0.2f};
+        std::copy_n(values, 7, proposal);
+    }
+    model.outputs["detection_out"] = blob;
+    return model;
+}
+
+// Text detection probability map [1, 1, 640, 640] with N rectangular regions
+Model heatmap_boxes_model(size_t objects) {
+    constexpr size_t size = 640;
+    Model model{size, size,
+                gst_structure_new("detection", "converter", G_TYPE_STRING, "heatmap_boxes", "confidence_threshold",
+                                  G_TYPE_DOUBLE, confidence_threshold, NULL)};
+    auto blob = std::make_shared<SyntheticBlob>(std::vector<size_t>{1, 1, size, size});
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> position(0, size - 64);
+    std::uniform_int_distribution<size_t> extent(8, 60);
+    float *data = blob->data();
+    std::fill(data, data + blob->GetSize(), 0.05f);
+    for (size_t i = 0; i < objects; i++) {
+        const size_t x = position(random), y = position(random), w = extent(random), h = extent(random) / 3 + 6;
+        for (size_t row = y; row < y + h; row++)
+            std::fill_n(data + row * size + x, w, 0.9f);
+    }
+    model.outputs["heatmap"] = blob;
+    return model;
+}
+
+// ImageNet classifier [1, 1000] with softmax
+Model label_model() {
+    constexpr size_t classes = 1000;
+    Model model{224, 224,
+                gst_structure_new("classification", "converter", G_TYPE_STRING, "label", "method", G_TYPE_STRING,
+                                  "softmax", NULL)};
+    model.converter_type = ConverterType::TO_TENSOR;
+    for (size_t i = 0; i < classes; i++)
+        model.labels.push_back("class_" + std::to_string(i));
+    auto blob = std::make_shared<SyntheticBlob>(std::vector<size_t>{1, classes});
+    std::mt19937 random(42);
+    std::normal_distribution<float> logit(0.f, 2.f);
+    std::generate_n(blob->data(), classes, [&] { return logit(random); });
+    model.outputs["prob"] = blob;
+    return model;
+}
+
+// HRNet-like heatmaps of 17 keypoints [1, 17, 64, 48]
+Model keypoints_hrnet_model() {
+    Model model{192, 256, gst_structure_new("keypoints", "converter", G_TYPE_STRING, "keypoints_hrnet", NULL)};
+    model.converter_type = ConverterType::TO_TENSOR;
+    auto blob = std::make_shared<SyntheticBlob>(std::vector<size_t>{1, 17, 64, 48});
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> heat(0.f, 1.f);
+    std::generate_n(blob->data(), blob->GetSize(), [&] { return heat(random); });
+    model.outputs["heatmaps"] = blob;
+    return model;
+}
+
+dlstreamer::bench::BenchmarkFunction converter_benchmark(std::function<Model()> make_model) {
+    return [=](dlstreamer::bench::State &state) {
+        gst_init(nullptr, nullptr);
+        Model model = make_model();
+
+        BlobToMetaConverter::Initializer initializer;
+        initializer.model_name = "synthetic";
+        initializer.input_image_info.width = model.width;
+        initializer.input_image_info.height = model.height;
+        initializer.input_image_info.batch_size = 1;
+        initializer.model_proc_output_info = GstStructureUniquePtr(model.model_proc, gst_structure_free);
+        initializer.labels = std::make_shared<const std::vector<std::string>>(model.labels);
+        OutputBlobs blobs;
+        for (auto &output : model.outputs) {
+            initializer.outputs_info[output.first] = output.second->GetDims();
+            blobs[output.first] = output.second;
+        }
+        auto converter = BlobToMetaConverter::create(std::move(initializer), model.converter_type,
+                                                     model.outputs.begin()->first);
+
+        size_t results = 0;
+        while (state.keep_running()) {
+            TensorsTable tensors = converter->convert(blobs);
+            for (auto &frame_tensors : tensors) {
+                results += frame_tensors.size();
+                for (GstStructure *s : frame_tensors)
+                    gst_structure_free(s);
+            }
+        }
+        if (state.iterations() > 0)
+            state.set_counter("results_per_frame", static_cast<double>(results) / state.iterations());
+    };
+}
+
+std::vector<int> to_ints(const std::vector<double> &values) {
+    return std::vector<int>(values.begin(), values.end());
+}
+
+// Element parameters with defaults from element description, as set by GStreamer bridge for unset properties
+dlstreamer::AnyMap element_params(const dlstreamer::ElementDesc &desc, const dlstreamer::AnyMap &params) {
+    dlstreamer::AnyMap result;
+    for (auto &param : *desc.params)
+        result[param.name] = param.default_value;
+    for (auto &param : params) {
+        if (!result.count(param.first))
+            throw std::invalid_argument("Unknown parameter of " + std::string(desc.name) + ": " + param.first);
+        result[param.first] = param.second;
+    }
+    // logger with this name is not registered, so elements log into null sink instead of default logger
+    result[dlstreamer::param::logger_name] = std::string("post_proc_benchmark");
+    return result;
+}
+
+dlstreamer::bench::BenchmarkFunction element_benchmark(const dlstreamer::ElementDesc &desc,
+                                                       std::function<dlstreamer::AnyMap(const Model &)> make_params,
+                                                       std::function<Model()> make_model) {
+    return [=, &desc](dlstreamer::bench::State &state) {
+        gst_init(nullptr, nullptr);
+        Model model = make_model();
+        gst_structure_free(model.model_proc);
+
+        auto params = std::make_shared<dlstreamer::BaseDictionary>(element_params(desc, make_params(model)));
+        std::unique_ptr<dlstreamer::Element> element(desc.create(params, nullptr));
+        auto transform = dynamic_cast<dlstreamer::TransformInplace *>(element.get());
+        if (!transform)
+            throw std::runtime_error("Error on dynamic_cast<TransformInplace*>");
+
+        dlstreamer::TensorVector tensors;
+        dlstreamer::TensorInfoVector outputs_info;
+        std::vector<std::string> output_layers;
+        for (auto &output : model.outputs) {
+            dlstreamer::TensorInfo info(output.second->GetDims(), dlstreamer::DataType::Float32);
+            tensors.push_back(std::make_shared<dlstreamer::CPUTensor>(info, output.second->data()));
+            outputs_info.push_back(info);
+            output_layers.push_back(output.first);
+        }
+        transform->set_info(dlstreamer::FrameInfo(dlstreamer::MediaType::Tensors, dlstreamer::MemoryType::CPU,
+                                                  outputs_info));
+        transform->init();
+
+        dlstreamer::FramePtr frame =
+            std::make_shared<dlstreamer::BaseFrame>(dlstreamer::MediaType::Tensors, 0, std::move(tensors));
+        auto model_info = dlstreamer::add_metadata<dlstreamer::ModelInfoMetadata>(*frame);
+        model_info.set_model_name("synthetic");
+        model_info.set_info("input", dlstreamer::FrameInfo(dlstreamer::MediaType::Tensors, dlstreamer::MemoryType::CPU,
+                                                           {{{1, 3, model.height, model.width}}}));
+        model_info.set_info("output", dlstreamer::FrameInfo(dlstreamer::MediaType::Tensors,
+                                                            dlstreamer::MemoryType::CPU, outputs_info));
+        model_info.set_layer_names("output", output_layers);
+
+        size_t results = 0;
+        auto &metadata = frame->metadata();
+        while (state.keep_running()) {
+            transform->process(frame);
+            for (auto it = metadata.begin(); it != metadata.end();) {
+                if ((*it)->name() == dlstreamer::ModelInfoMetadata::name) {
+                    ++it;
+                    continue;
+                }
+                it = metadata.erase(it);
+                results++;
+            }
+        }
+        if (state.iterations() > 0)
+            state.set_counter("results_per_frame", static_cast<double>(results) / state.iterations());
+    };
+}
+
+dlstreamer::AnyMap yolo_params(int version, bool activated) {
+    return {{"version", version},
+            {"threshold", confidence_threshold},
+            {"iou-threshold", 0.4},
+            {"classes", static_cast<int>(yolo_classes)},
+            {"anchors", yolo_anchors},
+            {"masks", to_ints(yolo_masks)},
+            {"do-cls-softmax", !activated},
+            {"output-sigmoid-activation", !activated}};
+}
+
+bool register_all() {
+    using dlstreamer::bench::register_benchmark;
+    for (size_t objects : {10, 100}) {
+        const std::string suffix = "/" + std::to_string(objects);
+        register_benchmark("post_proc/yolo_v3/416x416" + suffix,
+                           converter_benchmark([=] { return yolo_model("yolo_v3", 416, true, objects); }));
+        register_benchmark("post_proc/yolo_v5/640x640" + suffix,
+                           converter_benchmark([=] { return yolo_model("yolo_v5", 640, false, objects); }));
+        register_benchmark("post_proc/detection_output" + suffix,
+                           converter_benchmark([=] { return detection_output_model(objects); }));
+        register_benchmark("post_proc/heatmap_boxes" + suffix,
+                           converter_benchmark([=] { return heatmap_boxes_model(objects); }));
+    }
+    register_benchmark("post_proc/label/1000", converter_benchmark(label_model));
+    register_benchmark("post_proc/keypoints_hrnet/17", converter_benchmark(keypoints_hrnet_model));
+
+    for (size_t objects : {10, 100}) {
+        const std::string suffix = "/" + std::to_string(objects);
+        register_benchmark("post_proc/tensor_postproc_yolo/yolo_v3/416x416" + suffix,
+                           element_benchmark(
+                               tensor_postproc_yolo, [](const Model &) { return yolo_params(3, true); },
+                               [=] { return yolo_model("yolo_v3", 416, true, objects); }));
+        register_benchmark("post_proc/tensor_postproc_yolo/yolo_v5/640x640" + suffix,
+                           element_benchmark(
+                               tensor_postproc_yolo, [](const Model &) { return yolo_params(5, false); },
+                               [=] { return yolo_model("yolo_v5", 640, false, objects); }));
+        register_benchmark("post_proc/tensor_postproc_detection/detection_output" + suffix,
+                           element_benchmark(
+                               tensor_postproc_detection,
+                               [](const Model &) { return dlstreamer::AnyMap{{"threshold", confidence_threshold}}; },
+                               [=] { return detection_output_model(objects); }));
+    }
+    register_benchmark("post_proc/tensor_postproc_label/1000",
+                       element_benchmark(
+                           tensor_postproc_label,
+                           [](const Model &model) {
+                               return dlstreamer::AnyMap{{"method", std::string("softmax")}, {"labels", model.labels}};
+                           },
+                           label_model));
+    register_benchmark("post_proc/tensor_postproc_text/1000",
+                       element_benchmark(
+                           tensor_postproc_text, [](const Model &) { return dlstreamer::AnyMap(); }, label_model));
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
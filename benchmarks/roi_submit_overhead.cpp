@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Per-ROI bookkeeping of InferenceImpl::SubmitImages, without pre-processing and inference. 'allocating' creates
+// result and frame objects with std::make_shared, copies GstVideoInfo and builds input layer descriptors for each ROI,
+// as SubmitImages did. 'pooled' takes objects from BlockPool, shares one GstVideoInfo and reuses cached descriptors.
+
+#include "benchmark.h"
+#include "pool_allocator.h"
+
+#include "inference_backend/image_inference.h"
+
+#include <gst/video/video.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace InferenceBackend;
+
+constexpr int frames_per_iteration = 16;
+
+// Same layout as InferenceFrame and InferenceImpl::InferenceResult
+struct Frame {
+    GstBuffer *buffer = nullptr;
+    GstVideoRegionOfInterestMeta roi;
+    std::vector<GstStructure *> roi_classifications;
+    std::shared_ptr<GstVideoInfo> info;
+    std::shared_ptr<void> image_transform_info;
+};
+
+struct Result {
+    virtual ~Result() = default;
+    std::shared_ptr<Frame> inference_frame;
+    std::shared_ptr<void> output_frame;
+    void *model = nullptr;
+    std::shared_ptr<void> image;
+};
+
+using Descriptors = std::map<std::string, InputLayerDesc::Ptr>;
+
+Descriptors make_descriptors() {
+    // Model with image input and image_info input, as Faster R-CNN like models
+    Descriptors descriptors;
+    for (const char *format : {"image", "image_info"}) {
+        auto desc = std::make_shared<InputLayerDesc>();
+        desc->name = std::string(format) + "_layer";
+        desc->preprocessor = [](const InputBlob::Ptr &) {};
+        descriptors[format] = desc;
+    }
+    return descriptors;
+}
+
+struct Submitter {
+    Submitter() {
+        gst_video_info_set_format(&info, GST_VIDEO_FORMAT_BGRx, 1920, 1080);
+        shared_info.reset(gst_video_info_copy(&info), gst_video_info_free);
+        cached_descriptors = make_descriptors();
+    }
+
+    GstVideoInfo info;
+    std::shared_ptr<GstVideoInfo> shared_info;
+    Descriptors cached_descriptors;
+    std::shared_ptr<BlockPool> results_pool = std::make_shared<BlockPool>();
+    std::shared_ptr<BlockPool> frames_pool = std::make_shared<BlockPool>();
+    // Results in flight, released as inference completion would do
+    std::vector<std::shared_ptr<Result>> submitted;
+};
+
+void submit_allocating(Submitter &s, const std::vector<GstVideoRegionOfInterestMeta> &metas) {
+    for (const auto &meta : metas) {
+        auto result = std::make_shared<Result>();
+        result->inference_frame = std::make_shared<Frame>();
+        result->inference_frame->roi = meta;
+        result->inference_frame->info =
+            std::shared_ptr<GstVideoInfo>(gst_video_info_copy(&s.info), gst_video_info_free);
+        Descriptors descriptors = make_descriptors();
+        dlstreamer::bench::do_not_optimize(descriptors);
+        s.submitted.push_back(std::move(result));
+    }
+}
+
+void submit_pooled(Submitter &s, const std::vector<GstVideoRegionOfInterestMeta> &metas) {
+    for (const auto &meta : metas) {
+        auto result = std::allocate_shared<Result>(PoolAllocator<Result>(s.results_pool));
+        result->inference_frame = std::allocate_shared<Frame>(PoolAllocator<Frame>(s.frames_pool));
+        result->inference_frame->roi = meta;
+        result->inference_frame->info = s.shared_info;
+        const Descriptors &descriptors = s.cached_descriptors;
+        dlstreamer::bench::do_not_optimize(descriptors);
+        s.submitted.push_back(std::move(result));
+    }
+}
+
+dlstreamer::bench::BenchmarkFunction submit_benchmark(int rois, bool pooled) {
+    return [=](dlstreamer::bench::State &state) {
+        Submitter submitter;
+        std::vector<GstVideoRegionOfInterestMeta> metas(rois);
+        for (int i = 0; i < rois; i++) {
+            metas[i] = {};
+            metas[i].id = i;
+            metas[i].x = 10 * i;
+            metas[i].w = metas[i].h = 64;
+        }
+        submitter.submitted.reserve(rois * frames_per_iteration);
+
+        while (state.keep_running()) {
+            for (int f = 0; f < frames_per_iteration; f++) {
+                if (pooled)
+                    submit_pooled(submitter, metas);
+                else
+                    submit_allocating(submitter, metas);
+            }
+            submitter.submitted.clear();
+        }
+        if (state.iterations() > 0)
+            state.set_counter("ns_per_roi", state.elapsed_ns() / (state.iterations() * frames_per_iteration * rois));
+    };
+}
+
+bool register_all() {
+    for (int rois : {1, 10, 100, 300}) {
+        std::string suffix = "/" + std::to_string(rois);
+        dlstreamer::bench::register_benchmark("roi_submit/allocating" + suffix, submit_benchmark(rois, false));
+        dlstreamer::bench::register_benchmark("roi_submit/pooled" + suffix, submit_benchmark(rois, true));
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Shared memory metadata ring used by gvametapublish method=shm: writer publishes records with N regions of interest
+// while reader threads copy them out with gva_shm_reader_next, as separate consumer processes would. Writer never
+// waits for readers, so 'read_ratio' shows share of records a reader managed to get before they were overwritten.
+
+#include "benchmark.h"
+#include "shm_ring_writer.hpp"
+
+#include <gva_shm_ring.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t slot_count = 64;
+constexpr uint32_t slot_size = 65536;
+
+size_t write_record(ShmRingWriter &writer, int rois) {
+    static const char strings[] = "\0person\0vehicle";
+    uint8_t *record = writer.begin_record();
+    auto frame = reinterpret_cast<GvaShmFrame *>(record);
+    std::memset(frame, 0, sizeof(*frame));
+    frame->sequence = writer.sequence();
+    frame->width = 1920;
+    frame->height = 1080;
+    frame->roi_count = rois;
+
+    auto shm_rois = reinterpret_cast<GvaShmRoi *>(frame + 1);
+    for (int i = 0; i < rois; i++) {
+        GvaShmRoi &roi = shm_rois[i];
+        std::memset(&roi, 0, sizeof(roi));
+        roi.id = i + 1;
+        roi.object_id = i;
+        roi.label_id = i % 2;
+        roi.label = i % 2 ? 8 : 1;
+        roi.x = 10 * i;
+        roi.y = 5 * i;
+        roi.w = 64;
+        roi.h = 128;
+        roi.x_min = roi.x / 1920.f;
+        roi.y_min = roi.y / 1080.f;
+        roi.x_max = (roi.x + roi.w) / 1920.f;
+        roi.y_max = (roi.y + roi.h) / 1080.f;
+        roi.confidence = 0.9f;
+    }
+
+    frame->strings_offset = sizeof(GvaShmFrame) + rois * sizeof(GvaShmRoi);
+    frame->strings_size = sizeof(strings);
+    std::memcpy(record + frame->strings_offset, strings, sizeof(strings));
+    const size_t size = frame->strings_offset + frame->strings_size;
+    writer.commit_record(size);
+    return size;
+}
+
+dlstreamer::bench::BenchmarkFunction ring_benchmark(int rois, int readers) {
+    return [=](dlstreamer::bench::State &state) {
+        const std::string name = "/dlstreamer_bench_" + std::to_string(getpid());
+        ShmRingWriter writer(name, slot_count, slot_size);
+        size_t mapping_size = 0;
+        const GvaShmRingHeader *ring = gva_shm_ring_open(name.c_str(), &mapping_size);
+        if (!ring)
+            return;
+
+        std::atomic<bool> stop{false};
+        std::vector<uint64_t> read(readers, 0);
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; r++) {
+            threads.emplace_back([&, r] {
+                GvaShmReader reader;
+                gva_shm_reader_init(&reader, ring);
+                std::vector<uint64_t> buffer(slot_size / sizeof(uint64_t));
+                size_t size = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    if (gva_shm_reader_next(&reader, buffer.data(), slot_size, &size) == GVA_SHM_OK)
+                        read[r]++;
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        size_t record_size = 0;
+        while (state.keep_running())
+            record_size = write_record(writer, rois);
+        stop = true;
+        for (auto &thread : threads)
+            thread.join();
+        munmap(const_cast<GvaShmRingHeader *>(ring), mapping_size);
+
+        uint64_t total_read = 0;
+        for (uint64_t count : read)
+            total_read += count;
+        state.set_counter("record_bytes", record_size);
+        if (state.elapsed_ns() > 0)
+            state.set_counter("records_per_s", 1e9 * state.iterations() / state.elapsed_ns());
+        if (state.iterations() && readers)
+            state.set_counter("read_ratio", static_cast<double>(total_read) / readers / state.iterations());
+    };
+}
+
+bool register_all() {
+    for (int rois : {0, 16, 256}) {
+        std::string suffix = "/" + std::to_string(rois);
+        dlstreamer::bench::register_benchmark("shm_meta_ring/1_reader" + suffix, ring_benchmark(rois, 1));
+        dlstreamer::bench::register_benchmark("shm_meta_ring/4_readers" + suffix, ring_benchmark(rois, 4));
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+// Output tensor allocation of CPU transform elements: tensor is allocated and released per iteration, with plain
+// malloc/free (as CPUTensorAlloc did before) versus CPUTensorArena. Tensors are kept in flight for a few iterations,
+// as buffers queued downstream are, and in 'cross_thread' variants released by another thread, as downstream element
+// running in its own streaming thread does.
+
+#include "benchmark.h"
+
+#include <dlstreamer/cpu/tensor_arena.h>
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+using dlstreamer::CPUTensorArena;
+
+constexpr size_t frames_in_flight = 4;
+
+struct Block {
+    void *data;
+    size_t size;
+};
+
+void *allocate(size_t size, bool arena) {
+    void *data = arena ? CPUTensorArena::instance().allocate(size) : malloc(size);
+    // touch memory as element writing output would, first page is enough to fault fresh allocation in
+    static_cast<volatile char *>(data)[0] = 1;
+    return data;
+}
+
+void release(const Block &block, bool arena) {
+    if (arena)
+        CPUTensorArena::instance().deallocate(block.data, block.size);
+    else
+        free(block.data);
+}
+
+dlstreamer::bench::BenchmarkFunction alloc_benchmark(size_t size, bool arena, bool cross_thread) {
+    return [=](dlstreamer::bench::State &state) {
+        const auto stats_before = CPUTensorArena::instance().statistics();
+        std::deque<Block> in_flight;
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool stop = false;
+
+        // Releasing thread, keeps frames_in_flight latest blocks
+        std::thread consumer;
+        if (cross_thread) {
+            consumer = std::thread([&] {
+                std::unique_lock<std::mutex> lock(mutex);
+                for (;;) {
+                    cond.wait(lock, [&] { return stop || in_flight.size() > frames_in_flight; });
+                    while (in_flight.size() > (stop ? 0 : frames_in_flight)) {
+                        Block block = in_flight.front();
+                        in_flight.pop_front();
+                        release(block, arena);
+                    }
+                    cond.notify_all();
+                    if (stop)
+                        return;
+                }
+            });
+        }
+
+        while (state.keep_running()) {
+            Block block = {allocate(size, arena), size};
+            if (cross_thread) {
+                // bounded queue, producer waits for consumer as upstream element waits for full queue
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&] { return in_flight.size() <= 2 * frames_in_flight; });
+                in_flight.push_back(block);
+                cond.notify_all();
+                continue;
+            }
+            in_flight.push_back(block);
+            if (in_flight.size() > frames_in_flight) {
+                release(in_flight.front(), arena);
+                in_flight.pop_front();
+            }
+        }
+
+        if (cross_thread) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            cond.notify_all();
+            consumer.join();
+        }
+        for (const auto &block : in_flight)
+            release(block, arena);
+
+        const auto stats = CPUTensorArena::instance().statistics();
+        if (arena)
+            state.set_counter("system_allocations", stats.system_allocations - stats_before.system_allocations);
+    };
+}
+
+bool register_all() {
+    const std::pair<const char *, size_t> sizes[] = {
+        {"224x224x3", 224 * 224 * 3}, {"640x640x3_fp32", 640 * 640 * 3 * 4}, {"2160p_rgb", 3840 * 2160 * 3}};
+    for (const auto &size : sizes) {
+        for (bool cross_thread : {false, true}) {
+            std::string suffix = std::string(cross_thread ? "/cross_thread/" : "/") + size.first;
+            dlstreamer::bench::register_benchmark("tensor_alloc/malloc" + suffix,
+                                                  alloc_benchmark(size.second, false, cross_thread));
+            dlstreamer::bench::register_benchmark("tensor_alloc/arena" + suffix,
+                                                  alloc_benchmark(size.second, true, cross_thread));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+[[maybe_unused]] static bool registered = register_all();
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -8,6 +8,7 @@
 
 #include "dlstreamer/context.h"
 #include "dlstreamer/memory_mapper.h"
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -55,6 +56,16 @@ class BaseContext : public Context {
         _parent = parent;
     }
 
+    /**
+     * @brief Requests callback to be called once memory of tensor allocated in this context is released, for example
+     * when buffer pool is destroyed. Used by MemoryMapperCache to drop objects mapped from released memory, as handle
+     * of released memory may be reused by new allocation.
+     * @return false if release of tensor memory can't be watched, callback is not called then
+     */
+    virtual bool watch_release(const TensorPtr & /*tensor*/, std::function<void()> /*callback*/) {
+        return false;
+    }
+
     void attach_mapper(MemoryMapperPtr mapper) {
         if (mapper)
             _mappers[{mapper->input_context().get(), mapper->output_context().get()}] = mapper;
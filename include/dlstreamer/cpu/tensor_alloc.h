@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -7,20 +7,26 @@
 #include "dlstreamer/base/tensor.h"
 #include "dlstreamer/cpu/context.h"
 #include "dlstreamer/cpu/tensor.h"
+#include "dlstreamer/cpu/tensor_arena.h"
 
 namespace dlstreamer {
 
+// CPU tensor owning its memory, allocated from process-wide CPUTensorArena
 class CPUTensorAlloc final : public CPUTensor {
   public:
-    CPUTensorAlloc(const TensorInfo &info) : CPUTensor(info, malloc(info.nbytes())) {
+    CPUTensorAlloc(const TensorInfo &info)
+        : CPUTensor(info, CPUTensorArena::instance().allocate(info.nbytes())), _size(info.nbytes()) {
     }
 
     ~CPUTensorAlloc() {
         if (_data) {
-            free(_data);
+            CPUTensorArena::instance().deallocate(_data, _size);
             _data = nullptr;
         }
     }
+
+  private:
+    size_t _size;
 };
 
 } // namespace dlstreamer
@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace dlstreamer {
+
+/**
+ * @brief Process-wide recycling allocator for CPU tensor memory. Requested size is rounded up to size class (multiple
+ * of 64 bytes up to 4 KB, larger sizes waste at most 1/8 of block) and memory is 64-byte aligned. Released blocks are
+ * kept in per-thread cache first, then in global free lists shared by all threads, so tensors of the same size
+ * allocated frame after frame reuse memory instead of calling malloc/free.
+ * Blocks of 2 MB and larger are aligned to 2 MB and advised for transparent huge pages if environment variable
+ * DLSTREAMER_TENSOR_ARENA_HUGE_PAGES=1 is set (Linux only).
+ */
+class CPUTensorArena {
+  public:
+    static constexpr size_t alignment = 64;
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+    static constexpr size_t max_thread_cache_bytes = 64 * 1024 * 1024;
+    static constexpr size_t max_thread_cache_blocks = 8; // per size class
+    static constexpr size_t max_global_cache_bytes = 512 * 1024 * 1024;
+
+    // Counters are updated on slow paths only, thread cache hit is one atomic increment
+    struct Statistics {
+        size_t allocations = 0;        // number of allocate() calls
+        size_t thread_cache_hits = 0;  // allocations served from per-thread cache
+        size_t global_cache_hits = 0;  // allocations served from global free lists
+        size_t system_allocations = 0; // allocations which had to get memory from system
+        size_t system_releases = 0;    // blocks returned to system because caches were full
+        size_t bytes_reserved = 0;     // bytes of all blocks got from system and not returned (in use or cached)
+        size_t bytes_cached = 0;       // bytes of blocks in global free lists
+    };
+
+    // Arena shared by all elements in process. Never destroyed, so tensors released at exit stay valid to free
+    static CPUTensorArena &instance() {
+        static CPUTensorArena *arena = new CPUTensorArena();
+        return *arena;
+    }
+
+    static size_t size_class(size_t size) {
+        if (size <= 4096)
+            return size ? (size + alignment - 1) & ~(alignment - 1) : alignment;
+        size_t step = 1;
+        while ((step << 4) < size)
+            step <<= 1;
+        return (size + step - 1) & ~(step - 1);
+    }
+
+    void *allocate(size_t size) {
+        const size_t block_size = size_class(size);
+        ThreadCache *cache = thread_cache();
+        if (void *block = cache ? cache->pop(block_size) : nullptr) {
+            _thread_cache_hits++;
+            return block;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _free_lists.find(block_size);
+            if (it != _free_lists.end() && !it->second.empty()) {
+                void *block = it->second.back();
+                it->second.pop_back();
+                _bytes_cached -= block_size;
+                _global_cache_hits++;
+                return block;
+            }
+        }
+        void *block = system_allocate(block_size);
+        _system_allocations++;
+        _bytes_reserved += block_size;
+        return block;
+    }
+
+    // Size must be the same as passed to allocate()
+    void deallocate(void *block, size_t size) {
+        if (!block)
+            return;
+        const size_t block_size = size_class(size);
+        ThreadCache *cache = thread_cache();
+        if (!cache || !cache->push(block, block_size))
+            release(block, block_size);
+    }
+
+    Statistics statistics() const {
+        Statistics stats;
+        stats.thread_cache_hits = _thread_cache_hits;
+        stats.global_cache_hits = _global_cache_hits;
+        stats.system_allocations = _system_allocations;
+        stats.allocations = stats.thread_cache_hits + stats.global_cache_hits + stats.system_allocations;
+        stats.system_releases = _system_releases;
+        stats.bytes_reserved = _bytes_reserved;
+        stats.bytes_cached = _bytes_cached;
+        return stats;
+    }
+
+  private:
+    // Blocks released by current thread, returned to global free lists when thread exits. Threads typically use few
+    // size classes, so they are searched linearly
+    struct ThreadCache {
+        struct SizeClass {
+            size_t block_size;
+            std::vector<void *> blocks;
+        };
+        CPUTensorArena *arena;
+        std::vector<SizeClass> classes;
+        size_t bytes = 0;
+
+        SizeClass *find(size_t block_size) {
+            for (auto &size_class : classes) {
+                if (size_class.block_size == block_size)
+                    return &size_class;
+            }
+            return nullptr;
+        }
+
+        void *pop(size_t block_size) {
+            SizeClass *size_class = find(block_size);
+            if (!size_class || size_class->blocks.empty())
+                return nullptr;
+            void *block = size_class->blocks.back();
+            size_class->blocks.pop_back();
+            bytes -= block_size;
+            return block;
+        }
+
+        bool push(void *block, size_t block_size) {
+            if (bytes + block_size > max_thread_cache_bytes)
+                return false;
+            SizeClass *size_class = find(block_size);
+            if (!size_class) {
+                classes.push_back({block_size, {}});
+                size_class = &classes.back();
+            }
+            if (size_class->blocks.size() >= max_thread_cache_blocks)
+                return false;
+            size_class->blocks.push_back(block);
+            bytes += block_size;
+            return true;
+        }
+
+        ~ThreadCache() {
+            destroyed() = true;
+            for (auto &size_class : classes) {
+                for (void *block : size_class.blocks)
+                    arena->release(block, size_class.block_size);
+            }
+        }
+    };
+
+    CPUTensorArena() {
+        const char *env = std::getenv("DLSTREAMER_TENSOR_ARENA_HUGE_PAGES");
+        _huge_pages = env && !std::strcmp(env, "1");
+    }
+
+    // Set when thread cache is destroyed on thread exit, tensors released after that bypass it
+    static bool &destroyed() {
+        thread_local bool value = false;
+        return value;
+    }
+
+    ThreadCache *thread_cache() {
+        if (destroyed())
+            return nullptr;
+        thread_local ThreadCache cache{this, {}, 0};
+        return &cache;
+    }
+
+    void release(void *block, size_t block_size) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_bytes_cached + block_size <= max_global_cache_bytes) {
+                _free_lists[block_size].push_back(block);
+                _bytes_cached += block_size;
+                return;
+            }
+        }
+        _system_releases++;
+        _bytes_reserved -= block_size;
+        system_free(block);
+    }
+
+    void *system_allocate(size_t block_size) {
+        const size_t align = (_huge_pages && block_size >= huge_page_size) ? huge_page_size : alignment;
+        void *block = nullptr;
+#ifdef _WIN32
+        block = _aligned_malloc(block_size, align);
+#else
+        if (posix_memalign(&block, align, block_size))
+            block = nullptr;
+#endif
+        if (!block)
+            throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (align == huge_page_size)
+            madvise(block, block_size, MADV_HUGEPAGE);
+#endif
+        return block;
+    }
+
+    static void system_free(void *block) {
+#ifdef _WIN32
+        _aligned_free(block);
+#else
+        free(block);
+#endif
+    }
+
+    bool _huge_pages = false;
+    std::mutex _mutex;
+    std::unordered_map<size_t, std::vector<void *>> _free_lists;
+    std::atomic<size_t> _thread_cache_hits{0};
+    std::atomic<size_t> _global_cache_hits{0};
+    std::atomic<size_t> _system_allocations{0};
+    std::atomic<size_t> _system_releases{0};
+    std::atomic<size_t> _bytes_reserved{0};
+    std::atomic<size_t> _bytes_cached{0};
+};
+
+} // namespace dlstreamer
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -12,6 +12,7 @@
 #include "dlstreamer/gst/mappers/gst_to_cpu.h"
 #include "dlstreamer/gst/mappers/gst_to_opencl.h"
 #include "dlstreamer/gst/mappers/gst_to_vaapi.h"
+#include "dlstreamer/gst/tensor.h"
 #include "dlstreamer/gst/utils.h"
 #include "dlstreamer/utils.h"
 
@@ -134,8 +135,24 @@ class GSTContext : public BaseContext {
         return mapper;
     }
 
+    // GstMemory of pooled buffer stays alive while pool exists, so callback is called when pool is destroyed
+    bool watch_release(const TensorPtr &tensor, std::function<void()> callback) override {
+        auto gst_tensor = std::dynamic_pointer_cast<GSTTensor>(tensor);
+        if (!gst_tensor || !gst_tensor->gst_memory())
+            return false;
+        gst_mini_object_weak_ref(GST_MINI_OBJECT(gst_tensor->gst_memory()), release_notify,
+                                 new std::function<void()>(std::move(callback)));
+        return true;
+    }
+
   private:
     GstElement *_element = nullptr;
+
+    static void release_notify(gpointer data, GstMiniObject * /*obj*/) {
+        auto callback = static_cast<std::function<void()> *>(data);
+        (*callback)();
+        delete callback;
+    }
 };
 
 } // namespace dlstreamer
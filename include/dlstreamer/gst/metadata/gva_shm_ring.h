@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+/**
+ * @file gva_shm_ring.h
+ * @brief Binary layout of frame metadata published by gvametapublish method=shm, and functions to read it.
+ *
+ * Writer creates POSIX shared memory object (shm-name property) of the following layout:
+ *
+ *     GvaShmRingHeader | slot 0 | slot 1 | ... | slot (slot_count - 1)
+ *
+ * Each slot is slot_size bytes: GvaShmSlotHeader followed by one record. Record n (counting from 0) is written to slot
+ * n % slot_count, so the ring keeps last slot_count records and readers never block the writer. Records overwritten
+ * before reader got to them are counted as lost. Record layout:
+ *
+ *     GvaShmFrame | GvaShmRoi[roi_count] | GvaShmTensor[tensor_count] | tensors data | strings
+ *
+ * All offsets in record are in bytes from the beginning of the record (GvaShmFrame). Strings are null-terminated,
+ * offset 0 is always empty string. Integers are in host byte order, readers are expected to run on the same host.
+ *
+ * Header doesn't depend on GStreamer and may be used from C and C++. Typical reader:
+ *
+ *     size_t size;
+ *     const void *ring = gva_shm_ring_open("/dlstreamer_meta", &size);
+ *     GvaShmReader reader;
+ *     gva_shm_reader_init(&reader, ring);
+ *     void *record = malloc(reader.ring->slot_size);
+ *     for (;;) {
+ *         size_t record_size;
+ *         if (gva_shm_reader_next(&reader, record, reader.ring->slot_size, &record_size) != GVA_SHM_OK)
+ *             continue; // or sleep
+ *         const GvaShmFrame *frame = (const GvaShmFrame *)record;
+ *         const GvaShmRoi *rois = gva_shm_frame_rois(frame);
+ *         ...
+ *     }
+ */
+
+#ifndef __GVA_SHM_RING_H__
+#define __GVA_SHM_RING_H__
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GVA_SHM_RING_MAGIC 0x31474E4952415647ULL /**< "GVARING1" */
+#define GVA_SHM_RING_VERSION 1
+#define GVA_SHM_NONE UINT64_MAX /**< value of GvaShmFrame::pts if buffer has no timestamp */
+
+#define GVA_SHM_FRAME_TRUNCATED 1 /**< GvaShmFrame::flags: metadata didn't fit into slot, some ROIs are missing */
+#define GVA_SHM_FRAME_NO_TENSORS 2 /**< GvaShmFrame::flags: tensors requested but didn't fit into slot */
+
+/**
+ * @brief Header of shared memory object, 64 bytes
+ */
+typedef struct {
+    uint64_t magic;          /**< GVA_SHM_RING_MAGIC, written last when ring is initialized */
+    uint32_t version;        /**< GVA_SHM_RING_VERSION */
+    uint32_t slot_count;     /**< number of slots */
+    uint32_t slot_size;      /**< size of one slot including GvaShmSlotHeader, multiple of 8 */
+    uint32_t writer_pid;     /**< process id of writer, used to detect ring left by crashed writer */
+    uint64_t write_sequence; /**< number of records written so far, updated atomically after record is complete */
+    uint64_t reserved2[4];   /**< zero */
+} GvaShmRingHeader;
+
+/**
+ * @brief Header of slot, 16 bytes
+ */
+typedef struct {
+    uint64_t state; /**< 2 * n + 1 while record n is written, 2 * n + 2 when it's complete */
+    uint32_t size;  /**< size of record */
+    uint32_t reserved;
+} GvaShmSlotHeader;
+
+/**
+ * @brief Metadata of one frame, 48 bytes
+ */
+typedef struct {
+    uint64_t sequence;       /**< record number, gaps in numbers seen by reader mean lost records */
+    uint64_t pts;            /**< buffer presentation timestamp in nanoseconds, GVA_SHM_NONE if not set */
+    uint32_t width;          /**< frame width, 0 if unknown */
+    uint32_t height;         /**< frame height, 0 if unknown */
+    uint32_t roi_count;      /**< number of GvaShmRoi following this structure */
+    uint32_t tensor_count;   /**< number of GvaShmTensor following ROIs */
+    uint32_t strings_offset; /**< offset of strings table */
+    uint32_t strings_size;   /**< size of strings table */
+    uint32_t flags;          /**< GVA_SHM_FRAME_* flags */
+    uint32_t reserved;       /**< zero */
+} GvaShmFrame;
+
+/**
+ * @brief Region of interest, 56 bytes
+ */
+typedef struct {
+    int32_t id;        /**< id of GstVideoRegionOfInterestMeta */
+    int32_t object_id; /**< tracking id, 0 if not tracked */
+    int32_t label_id;  /**< detection label id */
+    uint32_t label;    /**< offset of label in strings table */
+    uint32_t x;        /**< bounding box in pixels */
+    uint32_t y;        /**< bounding box in pixels */
+    uint32_t w;        /**< bounding box in pixels */
+    uint32_t h;        /**< bounding box in pixels */
+    float x_min;       /**< normalized bounding box, zeros if frame size is unknown */
+    float y_min;       /**< normalized bounding box */
+    float x_max;       /**< normalized bounding box */
+    float y_max;       /**< normalized bounding box */
+    float confidence;  /**< detection confidence */
+    uint32_t reserved; /**< zero */
+} GvaShmRoi;
+
+/**
+ * @brief Inference result (classification or raw tensor) attached to frame or region of interest, 32 bytes
+ */
+typedef struct {
+    int32_t roi_id;       /**< GvaShmRoi::id the tensor belongs to, -1 for frame-level tensor */
+    uint32_t name;        /**< offset of tensor name in strings table */
+    uint32_t label;       /**< offset of label in strings table, empty if tensor has no label */
+    int32_t label_id;     /**< label id, 0 if not set */
+    float confidence;     /**< confidence, 0 if not set */
+    uint32_t precision;   /**< GVAPrecision value of data (see gva_tensor_meta.h) */
+    uint32_t data_offset; /**< offset of raw data, 8-byte aligned */
+    uint32_t data_size;   /**< size of raw data, 0 if data is not attached */
+} GvaShmTensor;
+
+typedef enum {
+    GVA_SHM_OK = 0,             /**< record was copied */
+    GVA_SHM_EMPTY = 1,          /**< no new records */
+    GVA_SHM_SMALL_BUFFER = 2,   /**< provided buffer is smaller than record */
+    GVA_SHM_INVALID_RING = 3    /**< shared memory isn't initialized ring of supported version */
+} GvaShmStatus;
+
+/**
+ * @brief State of one reader. Readers don't write to shared memory, any number of them may read the same ring
+ */
+typedef struct {
+    const GvaShmRingHeader *ring; /**< mapped ring */
+    uint64_t next;                /**< sequence number of next record to read */
+    uint64_t lost;                /**< number of records overwritten before they were read */
+} GvaShmReader;
+
+static inline const GvaShmSlotHeader *gva_shm_ring_slot(const GvaShmRingHeader *ring, uint64_t sequence) {
+    return (const GvaShmSlotHeader *)((const uint8_t *)ring + sizeof(GvaShmRingHeader) +
+                                      (size_t)(sequence % ring->slot_count) * ring->slot_size);
+}
+
+/**
+ * @brief Maps existing ring read-only
+ * @param name name of POSIX shared memory object, as shm-name property of gvametapublish
+ * @param size returns size of mapping, to be passed to munmap
+ * @return pointer to ring header, NULL on error
+ */
+static inline const GvaShmRingHeader *gva_shm_ring_open(const char *name, size_t *size) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(GvaShmRingHeader))
+        mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return NULL;
+    const GvaShmRingHeader *ring = (const GvaShmRingHeader *)mapping;
+    if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != GVA_SHM_RING_MAGIC ||
+        ring->version != GVA_SHM_RING_VERSION || !ring->slot_count ||
+        sizeof(GvaShmRingHeader) + (size_t)ring->slot_count * ring->slot_size > (size_t)st.st_size) {
+        munmap(mapping, (size_t)st.st_size);
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return ring;
+}
+
+/**
+ * @brief Initializes reader to read records written after this call
+ */
+static inline GvaShmStatus gva_shm_reader_init(GvaShmReader *reader, const GvaShmRingHeader *ring) {
+    reader->ring = ring;
+    reader->next = 0;
+    reader->lost = 0;
+    if (!ring || __atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != GVA_SHM_RING_MAGIC ||
+        ring->version != GVA_SHM_RING_VERSION)
+        return GVA_SHM_INVALID_RING;
+    reader->next = __atomic_load_n(&ring->write_sequence, __ATOMIC_ACQUIRE);
+    return GVA_SHM_OK;
+}
+
+/**
+ * @brief Copies next record into buffer. Records overwritten by writer before or while they are copied are skipped and
+ * counted in reader->lost
+ * @param buffer destination, slot_size bytes is always enough
+ * @param record_size returns size of copied record
+ */
+static inline GvaShmStatus gva_shm_reader_next(GvaShmReader *reader, void *buffer, size_t buffer_size,
+                                               size_t *record_size) {
+    const GvaShmRingHeader *ring = reader->ring;
+    for (;;) {
+        const uint64_t written = __atomic_load_n(&ring->write_sequence, __ATOMIC_ACQUIRE);
+        if (reader->next >= written)
+            return GVA_SHM_EMPTY;
+        if (written - reader->next > ring->slot_count) {
+            reader->lost += written - ring->slot_count - reader->next;
+            reader->next = written - ring->slot_count;
+        }
+
+        const GvaShmSlotHeader *slot = gva_shm_ring_slot(ring, reader->next);
+        const uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        if (state == 2 * reader->next + 2) {
+            const size_t size = slot->size;
+            if (size > buffer_size)
+                return GVA_SHM_SMALL_BUFFER;
+            memcpy(buffer, slot + 1, size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->state, __ATOMIC_RELAXED) == state) {
+                reader->next++;
+                *record_size = size;
+                return GVA_SHM_OK;
+            }
+        }
+        // slot is already reused for newer record
+        reader->lost++;
+        reader->next++;
+    }
+}
+
+static inline const GvaShmRoi *gva_shm_frame_rois(const GvaShmFrame *frame) {
+    return (const GvaShmRoi *)(frame + 1);
+}
+
+static inline const GvaShmTensor *gva_shm_frame_tensors(const GvaShmFrame *frame) {
+    return (const GvaShmTensor *)(gva_shm_frame_rois(frame) + frame->roi_count);
+}
+
+static inline const char *gva_shm_frame_string(const GvaShmFrame *frame, uint32_t offset) {
+    return offset < frame->strings_size ? (const char *)frame + frame->strings_offset + offset : "";
+}
+
+static inline const void *gva_shm_frame_tensor_data(const GvaShmFrame *frame, const GvaShmTensor *tensor) {
+    return tensor->data_size ? (const uint8_t *)frame + tensor->data_offset : NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GVA_SHM_RING_H__ */
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2021 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -55,9 +55,15 @@ class RegionOfInterest {
      * @return Bounding box coordinates of the RegionOfInterest
      */
     Rect<double> normalized_rect() {
-        Tensor det = detection();
-        return {det.get_double("x_min"), det.get_double("y_min"), det.get_double("x_max") - det.get_double("x_min"),
-                det.get_double("y_max") - det.get_double("y_min")};
+        const GstStructure *det = detection_structure();
+        if (!det)
+            det = detection().gst_structure();
+        double x_min = 0, y_min = 0, x_max = 0, y_max = 0;
+        gst_structure_get_double(det, "x_min", &x_min);
+        gst_structure_get_double(det, "y_min", &y_min);
+        gst_structure_get_double(det, "x_max", &x_max);
+        gst_structure_get_double(det, "y_max", &y_max);
+        return {x_min, y_min, x_max - x_min, y_max - y_min};
     }
 
     /**
@@ -74,7 +80,10 @@ class RegionOfInterest {
      * @return last added detection Tensor confidence if exists, otherwise 0.0
      */
     double confidence() const {
-        return _detection ? _detection->confidence() : 0.0;
+        double confidence = 0.0;
+        if (const GstStructure *det_structure = detection_structure())
+            gst_structure_get_double(det_structure, "confidence", &confidence);
+        return confidence;
     }
 
     /**
@@ -95,7 +104,11 @@ class RegionOfInterest {
      * @return vector of Tensor instances added to this RegionOfInterest
      */
     std::vector<Tensor> tensors() const {
-        return this->_tensors;
+        if (_tensors_loaded)
+            return this->_tensors;
+        std::vector<Tensor> tensors;
+        fill_tensors(tensors);
+        return tensors;
     }
 
     /**
@@ -106,11 +119,17 @@ class RegionOfInterest {
      * @return just created Tensor object, which can be filled with tensor information further
      */
     Tensor add_tensor(const std::string &name) {
+        load_tensors();
         GstStructure *tensor = gst_structure_new_empty(name.c_str());
         gst_video_region_of_interest_meta_add_param(_gst_meta, tensor);
+        // vector may be reallocated, so detection Tensor is referenced by position
+        const size_t detection_pos = _detection ? _detection - _tensors.data() : _tensors.size();
         _tensors.emplace_back(tensor);
-        if (_tensors.back().is_detection())
+        if (_tensors.back().is_detection()) {
             _detection = &_tensors.back();
+        } else if (_detection) {
+            _detection = &_tensors[detection_pos];
+        }
 
         return _tensors.back();
     }
@@ -125,6 +144,7 @@ class RegionOfInterest {
      * this method was called
      */
     Tensor detection() {
+        load_tensors();
         if (!_detection) {
             add_tensor("detection");
         }
@@ -136,28 +156,22 @@ class RegionOfInterest {
      * @return last added detection Tensor label_id if exists, otherwise 0
      */
     int label_id() const {
-        return _detection ? _detection->label_id() : 0;
+        int label_id = 0;
+        if (const GstStructure *det_structure = detection_structure())
+            gst_structure_get_int(det_structure, "label_id", &label_id);
+        return label_id;
     }
 
     /**
      * @brief Construct RegionOfInterest instance from GstVideoRegionOfInterestMeta. After this, RegionOfInterest will
-     * obtain all tensors (detection & inference results) from GstVideoRegionOfInterestMeta
+     * obtain all tensors (detection & inference results) from GstVideoRegionOfInterestMeta. Tensor objects are
+     * created on first call of non-const method which needs them, const getters read the params directly
      * @param meta GstVideoRegionOfInterestMeta containing bounding box information and tensors
      */
-    RegionOfInterest(GstVideoRegionOfInterestMeta *meta) : _gst_meta(meta), _detection(nullptr) {
+    RegionOfInterest(GstVideoRegionOfInterestMeta *meta)
+        : _gst_meta(meta), _detection(nullptr), _tensors_loaded(false) {
         if (not _gst_meta)
             throw std::invalid_argument("GVA::RegionOfInterest: meta is nullptr");
-
-        _tensors.reserve(g_list_length(meta->params));
-
-        for (GList *l = meta->params; l; l = g_list_next(l)) {
-            GstStructure *s = GST_STRUCTURE(l->data);
-            if (not gst_structure_has_name(s, "object_id")) {
-                _tensors.emplace_back(s);
-                if (_tensors.back().is_detection())
-                    _detection = &_tensors.back();
-            }
-        }
     }
 
     /**
@@ -201,6 +215,48 @@ class RegionOfInterest {
     }
 
   protected:
+    /**
+     * @brief Get last added "detection" GstStructure from GstVideoRegionOfInterestMeta params
+     * @return last added "detection" GstStructure if exists, otherwise nullptr
+     */
+    const GstStructure *detection_structure() const {
+        const GstStructure *detection = nullptr;
+        for (GList *l = _gst_meta->params; l; l = g_list_next(l)) {
+            const GstStructure *s = GST_STRUCTURE(l->data);
+            if (gst_structure_has_name(s, "detection"))
+                detection = s;
+        }
+        return detection;
+    }
+
+    /**
+     * @brief Fills vector with Tensor objects for GstVideoRegionOfInterestMeta params
+     * @param tensors vector to fill
+     */
+    void fill_tensors(std::vector<Tensor> &tensors) const {
+        tensors.reserve(g_list_length(_gst_meta->params));
+        for (GList *l = _gst_meta->params; l; l = g_list_next(l)) {
+            GstStructure *s = GST_STRUCTURE(l->data);
+            if (not gst_structure_has_name(s, "object_id"))
+                tensors.emplace_back(s);
+        }
+    }
+
+    /**
+     * @brief Fills _tensors and _detection from GstVideoRegionOfInterestMeta params if not done yet
+     */
+    void load_tensors() {
+        if (_tensors_loaded)
+            return;
+        _tensors_loaded = true;
+
+        fill_tensors(_tensors);
+        for (Tensor &tensor : _tensors) {
+            if (tensor.is_detection())
+                _detection = &tensor;
+        }
+    }
+
     /**
      * @brief GstVideoRegionOfInterestMeta containing fields filled with detection result (produced by gvadetect element
      * in Gstreamer pipeline) and all the additional tensors, describing detection and other inference results (produced
@@ -216,6 +272,10 @@ class RegionOfInterest {
      * @brief last added detection Tensor instance, defined as Tensor with name set to "detection"
      */
     Tensor *_detection;
+    /**
+     * @brief true if _tensors and _detection are filled from GstVideoRegionOfInterestMeta
+     */
+    bool _tensors_loaded;
 };
 
 } // namespace GVA
@@ -71,6 +71,7 @@ class InferenceResultMetadata : public DictionaryProxy {
   private:
     typedef enum {
         GVA_PRECISION_FP32 = 10,
+        GVA_PRECISION_FP16 = 11,
         GVA_PRECISION_U8 = 40,
         GVA_PRECISION_I32 = 70,
         GVA_PRECISION_I64 = 72,
@@ -87,6 +88,8 @@ class InferenceResultMetadata : public DictionaryProxy {
             return GVA_PRECISION_U8;
         case DataType::Float32:
             return GVA_PRECISION_FP32;
+        case DataType::Float16:
+            return GVA_PRECISION_FP16;
         case DataType::Int32:
             return GVA_PRECISION_I32;
         case DataType::Int64:
@@ -100,6 +103,8 @@ class InferenceResultMetadata : public DictionaryProxy {
             return DataType::UInt8;
         case GVA_PRECISION_FP32:
             return DataType::Float32;
+        case GVA_PRECISION_FP16:
+            return DataType::Float16;
         case GVA_PRECISION_I32:
             return DataType::Int32;
         case GVA_PRECISION_I64:
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -10,8 +10,12 @@
 #include <dlstreamer/base/memory_mapper.h>
 #include <dlstreamer/context.h>
 #include <dlstreamer/utils.h>
+#include <algorithm>
 #include <list>
+#include <mutex>
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace dlstreamer {
 
@@ -50,47 +54,71 @@ class MemoryMapperChain final : public MemoryMapper {
     std::vector<MemoryMapperPtr> _chain;
 };
 
-class MemoryMapperCache final : public MemoryMapper {
+/**
+ * @brief Memory mapper which caches mapped TensorPtr and FramePtr objects by handle of source tensor (for example,
+ * VASurfaceID or DMA buffer descriptor), so repeated mapping of buffers from the same pool returns already mapped
+ * objects. Cache keeps at most 'capacity' tensors and 'capacity' frames, least recently used entries are evicted.
+ * If evicted source is mapped again, pool is larger than capacity and LRU order would evict every entry before its
+ * reuse, so capacity is doubled, up to 'max_capacity'. Entries of source are removed when context of source reports
+ * release of its memory (see BaseContext::watch_release), as released handle may be reused by new pool. Entry is also
+ * invalidated if source with the same handle has different shape or format. Thread-safe, lookup and insertion are done
+ * under lock while mapping itself is done without lock.
+ */
+class MemoryMapperCache final : public MemoryMapper, public std::enable_shared_from_this<MemoryMapperCache> {
   public:
-    MemoryMapperCache(MemoryMapperPtr mapper) : _mapper(mapper) {
+    static constexpr size_t default_capacity = 64;
+    static constexpr size_t default_max_capacity = 1024;
+
+    struct Statistics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;     // entries removed because cache was full
+        size_t invalidations = 0; // entries removed because source with the same handle changed
+        size_t releases = 0;      // entries removed because source memory was released
+        size_t grows = 0;         // capacity increases because evicted entries were requested again
+        size_t size = 0;          // number of cached tensors and frames
+        size_t capacity = 0;      // current capacity of tensors or frames cache, whichever is larger
+    };
+
+    MemoryMapperCache(MemoryMapperPtr mapper, size_t capacity = default_capacity,
+                      size_t max_capacity = default_max_capacity)
+        : _mapper(mapper), _tensors_cache(capacity, max_capacity), _frames_cache(capacity, max_capacity) {
         DLS_CHECK(mapper);
+        DLS_CHECK(capacity);
+        DLS_CHECK(max_capacity >= capacity);
     }
 
     TensorPtr map(TensorPtr src, dlstreamer::AccessMode mode) override {
         auto handle = src->handle();
-        auto value = _tensors_cache.find(handle);
-        // std::string mem1 = memory_type_to_string(_mapper->input_context()->memory_type());
-        // std::string mem2 = memory_type_to_string(_mapper->output_context()->memory_type());
-        if (value != _tensors_cache.end()) {
-            // printf("- using cache %s->%s, %p->%p\n", mem1.data(), mem2.data(), (void*)handle, value->second.get());
-            return value->second;
-        } else {
-            auto dst = _mapper->map(src, mode);
-            // printf("- new map %s->%s, %p->%p\n", mem1.data(), mem2.data(), (void*)handle, dst.get());
-            auto dst_casted = std::dynamic_pointer_cast<BaseTensor>(dst);
-            if (dst_casted)
-                dst_casted->set_parent(nullptr);
-            _tensors_cache[handle] = dst;
-            return dst;
-        }
+        Signature signature(src->info());
+        if (auto cached = lookup(_tensors_cache, handle, signature))
+            return cached;
+
+        auto dst = _mapper->map(src, mode);
+        auto dst_casted = std::dynamic_pointer_cast<BaseTensor>(dst);
+        if (dst_casted)
+            dst_casted->set_parent(nullptr);
+        if (insert(_tensors_cache, handle, std::move(signature), dst))
+            watch_release(src, handle);
+        return dst;
     }
 
     FramePtr map(FramePtr src, dlstreamer::AccessMode mode) override {
         auto tensor0 = src->tensor(0);
         auto handle = tensor0->handle();
-        auto value = _frames_cache.find(handle);
-        if (value != _frames_cache.end()) {
-            value->second->metadata().clear(); // remove all metadata
-            // printf("Re-using frame %s\n", memory_type_to_string(value->second->memory_type()));
-            return value->second;
-        } else {
-            auto dst = _mapper->map(src, mode);
-            auto dst_casted = std::dynamic_pointer_cast<BaseFrame>(dst);
-            if (dst_casted)
-                dst_casted->set_parent(nullptr);
-            _frames_cache[handle] = dst;
-            return dst;
+        Signature signature(tensor0->info(), src->format(), src->num_tensors());
+        if (auto cached = lookup(_frames_cache, handle, signature)) {
+            cached->metadata().clear(); // remove all metadata
+            return cached;
         }
+
+        auto dst = _mapper->map(src, mode);
+        auto dst_casted = std::dynamic_pointer_cast<BaseFrame>(dst);
+        if (dst_casted)
+            dst_casted->set_parent(nullptr);
+        if (insert(_frames_cache, handle, std::move(signature), dst))
+            watch_release(tensor0, handle);
+        return dst;
     }
 
     ContextPtr input_context() const override {
@@ -101,10 +129,156 @@ class MemoryMapperCache final : public MemoryMapper {
         return _mapper->output_context();
     }
 
+    Statistics statistics() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Statistics stats = _stats;
+        stats.size = _tensors_cache.entries.size() + _frames_cache.entries.size();
+        stats.capacity = std::max(_tensors_cache.capacity, _frames_cache.capacity);
+        return stats;
+    }
+
+    /**
+     * @brief Removes objects mapped from source with given handle. Called when memory of source is released
+     */
+    void release(Tensor::handle_t handle) {
+        TensorPtr tensor; // released after unlock
+        FramePtr frame;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _watched.erase(handle);
+        tensor = _tensors_cache.remove(handle);
+        frame = _frames_cache.remove(handle);
+        _stats.releases += (tensor != nullptr) + (frame != nullptr);
+    }
+
   private:
+    // Properties of source which must match for cached object to be reused
+    struct Signature {
+        TensorInfo info;
+        Format format = 0;
+        size_t num_tensors = 0;
+
+        Signature(const TensorInfo &info, Format format = 0, size_t num_tensors = 0)
+            : info(info), format(format), num_tensors(num_tensors) {
+        }
+
+        bool operator==(const Signature &other) const {
+            return info.shape == other.info.shape && info.stride == other.info.stride &&
+                   info.dtype == other.info.dtype && format == other.format && num_tensors == other.num_tensors;
+        }
+    };
+
+    template <typename T>
+    struct LRUMap {
+        struct Entry {
+            Tensor::handle_t handle;
+            Signature signature;
+            T value;
+        };
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<Tensor::handle_t, typename std::list<Entry>::iterator> index;
+        // Handles of last 'max_capacity' evicted entries, oldest first. Pool of up to max_capacity entries is detected
+        // however small the capacity is
+        std::list<Tensor::handle_t> evicted;
+        std::unordered_set<Tensor::handle_t> evicted_index;
+        size_t capacity;
+        const size_t max_capacity;
+
+        LRUMap(size_t capacity, size_t max_capacity) : capacity(capacity), max_capacity(max_capacity) {
+        }
+
+        // Removes entry and forgets its eviction, so new source with the same handle doesn't grow capacity
+        T remove(Tensor::handle_t handle) {
+            if (evicted_index.erase(handle))
+                evicted.remove(handle);
+            auto it = index.find(handle);
+            if (it == index.end())
+                return nullptr;
+            T value = std::move(it->second->value);
+            entries.erase(it->second);
+            index.erase(it);
+            return value;
+        }
+    };
+
+    template <typename T>
+    T lookup(LRUMap<T> &cache, Tensor::handle_t handle, const Signature &signature) {
+        T stale; // released after unlock
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = cache.index.find(handle);
+        if (it != cache.index.end()) {
+            if (it->second->signature == signature) {
+                cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+                _stats.hits++;
+                return it->second->value;
+            }
+            stale = std::move(it->second->value);
+            cache.entries.erase(it->second);
+            cache.index.erase(it);
+            _stats.invalidations++;
+        }
+        _stats.misses++;
+        return nullptr;
+    }
+
+    // Returns true if release of source with this handle isn't watched yet
+    template <typename T>
+    bool insert(LRUMap<T> &cache, Tensor::handle_t handle, Signature &&signature, const T &value) {
+        std::list<typename LRUMap<T>::Entry> evicted; // released after unlock
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = cache.index.find(handle);
+        if (it != cache.index.end()) { // mapped concurrently by another thread
+            evicted.splice(evicted.end(), cache.entries, it->second);
+            cache.index.erase(it);
+        }
+        // Other evicted entries requested while cache is still filling up after grow don't grow it again
+        if (cache.evicted_index.count(handle) && cache.entries.size() >= cache.capacity &&
+            cache.capacity < cache.max_capacity) {
+            cache.capacity = std::min(cache.capacity * 2, cache.max_capacity);
+            _stats.grows++;
+        }
+        cache.entries.push_front({handle, std::move(signature), value});
+        cache.index[handle] = cache.entries.begin();
+        while (cache.entries.size() > cache.capacity) {
+            const Tensor::handle_t evicted_handle = cache.entries.back().handle;
+            cache.index.erase(evicted_handle);
+            evicted.splice(evicted.end(), cache.entries, std::prev(cache.entries.end()));
+            _stats.evictions++;
+            if (cache.evicted_index.insert(evicted_handle).second)
+                cache.evicted.push_back(evicted_handle);
+        }
+        while (cache.evicted.size() > cache.max_capacity) {
+            cache.evicted_index.erase(cache.evicted.front());
+            cache.evicted.pop_front();
+        }
+        return _watch_release && _watched.insert(handle).second;
+    }
+
+    // Asks context of source to notify when its memory is released. Watch stays after eviction, so source memory is
+    // watched once however many times it is mapped again
+    void watch_release(const TensorPtr &src, Tensor::handle_t handle) {
+        auto context = std::dynamic_pointer_cast<BaseContext>(src->context());
+        if (!context)
+            context = std::dynamic_pointer_cast<BaseContext>(_mapper->input_context());
+        std::weak_ptr<MemoryMapperCache> weak_self = weak_from_this();
+        const bool watched = context && context->watch_release(src, [weak_self, handle]() {
+            if (auto self = weak_self.lock())
+                self->release(handle);
+        });
+        if (!watched) {
+            // Context can't watch release of its memory, cache relies on signature check only
+            std::lock_guard<std::mutex> lock(_mutex);
+            _watched.erase(handle);
+            _watch_release = false;
+        }
+    }
+
     MemoryMapperPtr _mapper;
-    std::map<Tensor::handle_t, TensorPtr> _tensors_cache;
-    std::map<Tensor::handle_t, FramePtr> _frames_cache;
+    mutable std::mutex _mutex;
+    LRUMap<TensorPtr> _tensors_cache;
+    LRUMap<FramePtr> _frames_cache;
+    std::unordered_set<Tensor::handle_t> _watched; // handles of sources release of which is watched
+    bool _watch_release = true;                    // false if context of sources can't watch release
+    Statistics _stats;
 };
 
 /**
@@ -112,11 +286,14 @@ class MemoryMapperCache final : public MemoryMapper {
  * with input context equal to first element in specified vector and output context equal to last element in specified
  * vector of context objects.
  * @param context_chain Vector of context objects defining mapping sequence
- * @param use_cache If true, the returned mapper cashes internally all mapped TensorPtr and FramePtr objects to avoid
+ * @param use_cache If true, the returned mapper caches internally mapped TensorPtr and FramePtr objects to avoid
  * mapping operation on same TensorPtr/FramePtr multiple times. This optimization is useful for case mapper works on
- * pool of limited number TensorPtr/FramePtr objects.
+ * pool of limited number TensorPtr/FramePtr objects. Up to 'cache_capacity' recently used objects are kept, capacity
+ * grows up to MemoryMapperCache::default_max_capacity if pool is larger.
+ * @param cache_capacity Initial capacity of cache, for example size of the pool if known
  */
-static inline MemoryMapperPtr create_mapper(std::vector<ContextPtr> context_chain, bool use_cache = false) {
+static inline MemoryMapperPtr create_mapper(std::vector<ContextPtr> context_chain, bool use_cache = false,
+                                            size_t cache_capacity = MemoryMapperCache::default_capacity) {
     DLS_CHECK(context_chain.size() >= 2)
     if (context_chain.size() == 2 && context_chain[0] == context_chain[1])
         return std::make_shared<BaseMemoryMapper>(context_chain[0], context_chain[1]);
@@ -147,7 +324,8 @@ static inline MemoryMapperPtr create_mapper(std::vector<ContextPtr> context_chai
 
     MemoryMapperPtr mapper_chain = std::make_shared<MemoryMapperChain>(mappers);
     if (use_cache)
-        mapper_chain = std::make_shared<MemoryMapperCache>(mapper_chain);
+        mapper_chain = std::make_shared<MemoryMapperCache>(
+            mapper_chain, cache_capacity, std::max(cache_capacity, MemoryMapperCache::default_max_capacity));
 
     auto input_context = std::dynamic_pointer_cast<BaseContext>(context_chain.front());
     if (input_context)
@@ -33,6 +33,8 @@ cl_channel_type data_type_to_opencl(DataType type) {
         return CL_SIGNED_INT32;
     case DataType::Float32:
         return CL_FLOAT;
+    case DataType::Float16:
+        return CL_HALF_FLOAT;
     }
     throw std::runtime_error("Unsupported data type");
 }
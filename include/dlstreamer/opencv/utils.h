@@ -21,6 +21,8 @@ static inline int data_type_to_opencv(DataType type) {
         throw std::runtime_error("Int64 not supported in cv::Mat");
     case DataType::Float32:
         return CV_32F;
+    case DataType::Float16:
+        return CV_16F;
     }
     throw std::runtime_error("Unsupported data type");
 }
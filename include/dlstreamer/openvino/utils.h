@@ -17,6 +17,8 @@ static inline DataType data_type_from_openvino(ov::element::Type element) {
         return DataType::UInt8;
     case ov::element::Type_t::f32:
         return DataType::Float32;
+    case ov::element::Type_t::f16:
+        return DataType::Float16;
     case ov::element::Type_t::i32:
         return DataType::Int32;
     case ov::element::Type_t::i64:
@@ -33,6 +35,8 @@ static inline ov::element::Type data_type_to_openvino(DataType type) {
         return ov::element::Type_t::u8;
     case DataType::Float32:
         return ov::element::Type_t::f32;
+    case DataType::Float16:
+        return ov::element::Type_t::f16;
     case DataType::Int32:
         return ov::element::Type_t::i32;
     case DataType::Int64:
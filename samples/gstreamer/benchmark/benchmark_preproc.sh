@@ -0,0 +1,43 @@
+#!/bin/bash
+# ==============================================================================
+# Copyright (C) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# ==============================================================================
+
+set -e
+
+# Compares CPU pre-processing throughput of element chain used by pre-process-backend=gst-opencv
+# (videoscale ! videoconvert ! tensor_convert ! opencv_tensor_normalize) and fused element opencv_preproc
+# (pre-process-backend=opencv-fused). No model or video file required.
+
+INPUT_WIDTH=${1:-1920}
+INPUT_HEIGHT=${2:-1080}
+TENSOR_WIDTH=${3:-416}
+TENSOR_HEIGHT=${4:-416}
+NUMBER_STREAMS=${5:-1}
+NUMBER_FRAMES=${6:-3000}
+INPUT_FORMAT=${7:-NV12}     # Supported values: "NV12", "BGR", "BGRX"
+TENSOR_TYPE=${8:-float32}   # Supported values: "float32", "float16" (float16 is supported by opencv_preproc only)
+
+NORMALIZATION='range="<(double)0,(double)1>"'
+SOURCE="videotestsrc num-buffers=${NUMBER_FRAMES} pattern=ball ! \
+video/x-raw,format=${INPUT_FORMAT},width=${INPUT_WIDTH},height=${INPUT_HEIGHT}"
+TENSOR_CAPS="other/tensors,num_tensors=1,types=${TENSOR_TYPE},dimensions=${TENSOR_WIDTH}:${TENSOR_HEIGHT}:3:1"
+
+PIPELINE_CHAIN=" ${SOURCE} ! \
+videoscale ! videoconvert ! video/x-raw,format=BGRP,width=${TENSOR_WIDTH},height=${TENSOR_HEIGHT} ! \
+tensor_convert ! opencv_tensor_normalize ${NORMALIZATION} ! ${TENSOR_CAPS} ! \
+gvafpscounter ! fakesink async=false"
+
+PIPELINE_FUSED=" ${SOURCE} ! \
+opencv_preproc ${NORMALIZATION} ! ${TENSOR_CAPS} ! \
+gvafpscounter ! fakesink async=false"
+
+if [ "$TENSOR_TYPE" == "float32" ]; then
+  echo "=== Element chain (pre-process-backend=gst-opencv) ==="
+  $(dirname "$0")/gst-launch-multi.sh "$PIPELINE_CHAIN" $NUMBER_STREAMS 1
+fi
+
+echo "=== opencv_preproc (pre-process-backend=opencv-fused) ==="
+$(dirname "$0")/gst-launch-multi.sh "$PIPELINE_FUSED" $NUMBER_STREAMS 1
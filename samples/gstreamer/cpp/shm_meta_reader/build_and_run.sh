@@ -0,0 +1,24 @@
+#!/bin/bash
+# ==============================================================================
+# Copyright (C) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# ==============================================================================
+
+SHM_NAME=${1:-/dlstreamer_meta}
+
+BASE_DIR=$(realpath $(dirname "$0"))
+BUILD_DIR=$HOME/intel/dl_streamer/samples/shm_meta_reader/build
+rm -rf ${BUILD_DIR}
+mkdir -p ${BUILD_DIR}
+cd ${BUILD_DIR}
+
+if [ -f /etc/lsb-release ]; then
+    cmake ${BASE_DIR}
+else
+    cmake3 ${BASE_DIR}
+fi
+
+make -j $(nproc)
+
+${BUILD_DIR}/shm_meta_reader -n $SHM_NAME
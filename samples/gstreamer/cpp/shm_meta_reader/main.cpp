@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "gst/metadata/gva_shm_ring.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void PrintUsage(const char *app) {
+    printf("Usage: %s [-n SHM_NAME] [-q] [-d SECONDS]\n"
+           "  -n SHM_NAME  shm-name property of gvametapublish, default /dlstreamer_meta\n"
+           "  -q           don't print metadata, print only statistics\n"
+           "  -d SECONDS   stop after given time, default is to run until interrupted\n",
+           app);
+}
+
+void PrintRecord(const GvaShmFrame *frame) {
+    printf("#%" PRIu64 " pts=%" PRIu64 " %ux%u rois=%u tensors=%u%s%s\n", frame->sequence, frame->pts, frame->width,
+           frame->height, frame->roi_count, frame->tensor_count,
+           (frame->flags & GVA_SHM_FRAME_TRUNCATED) ? " truncated" : "",
+           (frame->flags & GVA_SHM_FRAME_NO_TENSORS) ? " no-tensors" : "");
+
+    const GvaShmRoi *rois = gva_shm_frame_rois(frame);
+    for (uint32_t i = 0; i < frame->roi_count; i++) {
+        const GvaShmRoi &roi = rois[i];
+        printf("  roi %d object_id=%d label=%s (%d) confidence=%.2f box=[%u, %u, %u, %u]\n", roi.id, roi.object_id,
+               gva_shm_frame_string(frame, roi.label), roi.label_id, roi.confidence, roi.x, roi.y, roi.w, roi.h);
+    }
+
+    const GvaShmTensor *tensors = gva_shm_frame_tensors(frame);
+    for (uint32_t i = 0; i < frame->tensor_count; i++) {
+        const GvaShmTensor &tensor = tensors[i];
+        printf("  tensor %s roi=%d label=%s confidence=%.2f data=%u bytes\n", gva_shm_frame_string(frame, tensor.name),
+               tensor.roi_id, gva_shm_frame_string(frame, tensor.label), tensor.confidence, tensor.data_size);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string shm_name = "/dlstreamer_meta";
+    bool quiet = false;
+    double duration = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (!strcmp(argv[i], "-q")) {
+            quiet = true;
+        } else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Writer creates the ring when pipeline starts, so the reader may be started first
+    size_t mapping_size = 0;
+    const GvaShmRingHeader *ring = nullptr;
+    printf("Waiting for shared memory '%s'\n", shm_name.c_str());
+    while (!(ring = gva_shm_ring_open(shm_name.c_str(), &mapping_size)))
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    GvaShmReader reader;
+    if (gva_shm_reader_init(&reader, ring) != GVA_SHM_OK) {
+        fprintf(stderr, "Shared memory '%s' is not a metadata ring\n", shm_name.c_str());
+        return EXIT_FAILURE;
+    }
+    printf("Reading %u slots of %u bytes\n", ring->slot_count, ring->slot_size);
+
+    std::vector<uint64_t> record(ring->slot_size / sizeof(uint64_t)); // 8-byte aligned buffer for record
+    const auto start = std::chrono::steady_clock::now();
+    auto report_time = start;
+    uint64_t records = 0, report_records = 0, rois = 0;
+    for (;;) {
+        size_t record_size = 0;
+        const GvaShmStatus status = gva_shm_reader_next(&reader, record.data(), ring->slot_size, &record_size);
+        const auto now = std::chrono::steady_clock::now();
+        if (status == GVA_SHM_OK) {
+            const GvaShmFrame *frame = reinterpret_cast<const GvaShmFrame *>(record.data());
+            records++;
+            rois += frame->roi_count;
+            if (!quiet)
+                PrintRecord(frame);
+        } else if (status == GVA_SHM_EMPTY) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        } else {
+            fprintf(stderr, "Failed to read record: %d\n", status);
+            break;
+        }
+
+        const double elapsed = std::chrono::duration<double>(now - report_time).count();
+        if (elapsed >= 1.0) {
+            fprintf(stderr, "records/s: %.1f, total records: %" PRIu64 ", regions: %" PRIu64 ", lost: %" PRIu64 "\n",
+                    (records - report_records) / elapsed, records, rois, reader.lost);
+            report_time = now;
+            report_records = records;
+        }
+        if (duration > 0 && std::chrono::duration<double>(now - start).count() >= duration)
+            break;
+    }
+
+    munmap(const_cast<GvaShmRingHeader *>(ring), mapping_size);
+    return EXIT_SUCCESS;
+}
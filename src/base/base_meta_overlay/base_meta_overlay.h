@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -7,80 +7,12 @@
 #include "dlstreamer/base/transform.h"
 #include "dlstreamer/image_metadata.h"
 #include "dlstreamer/utils.h"
+#include "overlay_prims.h"
 #include <array>
 #include <cmath>
+#include <optional>
 
 namespace dlstreamer {
-namespace overlay {
-class Color {
-  private:
-    std::array<uint8_t, 4> vec;
-
-  public:
-    Color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) : vec{r, g, b, a} {};
-    Color(uint32_t rgba) {
-        vec = {static_cast<uint8_t>(rgba), static_cast<uint8_t>(rgba >> 8), static_cast<uint8_t>(rgba >> 16),
-               static_cast<uint8_t>(rgba >> 24)};
-    }
-
-    std::array<uint8_t, 4> get_array() {
-        return vec;
-    };
-    uint32_t get_uint32(dlstreamer::Format format) {
-        auto image_format = static_cast<dlstreamer::ImageFormat>(format);
-        if (image_format == dlstreamer::ImageFormat::RGB || image_format == dlstreamer::ImageFormat::RGBX) {
-            return static_cast<uint32_t>(vec[0]) << 0 | static_cast<uint32_t>(vec[1]) << 8 |
-                   static_cast<uint32_t>(vec[2]) << 16 | static_cast<uint32_t>(vec[3]) << 24;
-        } else if (image_format == dlstreamer::ImageFormat::BGR || image_format == dlstreamer::ImageFormat::BGRX) {
-            return static_cast<uint32_t>(vec[0]) << 16 | static_cast<uint32_t>(vec[1]) << 8 |
-                   static_cast<uint32_t>(vec[2]) << 0 | static_cast<uint32_t>(vec[3]) << 24;
-        } else {
-            throw std::runtime_error("Unsupported color format");
-        }
-    }
-};
-
-namespace prims {
-struct Rect {
-    int32_t x;
-    int32_t y;
-    int32_t width;
-    int32_t height;
-    uint32_t color;
-    uint32_t thickness;
-};
-struct Text {
-    std::string str;
-    int32_t x;
-    int32_t y;
-    uint32_t color;
-    uint32_t region_index;
-};
-struct Circle {
-    int32_t x;
-    int32_t y;
-    uint32_t radius;
-    uint32_t color;
-};
-struct Line {
-    int32_t x1;
-    int32_t y1;
-    int32_t x2;
-    int32_t y2;
-    uint32_t color;
-    uint32_t thickness;
-    bool steep = false;
-};
-struct Mask {
-    uint8_t *data;
-    int32_t x;
-    int32_t y;
-    int32_t w;
-    int32_t h;
-    uint32_t color;
-};
-} // namespace prims
-} // namespace overlay
 
 class MetaOverlayBase : public BaseTransformInplace {
   public:
@@ -215,46 +147,63 @@ class MetaOverlayBase : public BaseTransformInplace {
                        std::vector<overlay::prims::Text> *texts, std::vector<overlay::prims::Mask> *masks,
                        std::vector<overlay::prims::Circle> *keypoints, std::vector<overlay::prims::Line> *lines) {
         ImageInfo image_info(frame->tensor(0)->info());
+        std::vector<std::string> labels;
         for (size_t i = 0; i < regions.size(); i++) {
             auto &region = regions[i];
             auto region_tensor = region->tensor(0);
 
+            // Single pass over region metadata, typed metadata is created only for items found
+            DictionaryPtr detection_dict, object_id_dict, label_mask_meta;
+            labels.clear();
+            for (auto &meta : region->metadata()) {
+                const std::string name = meta->name();
+                if (!detection_dict && name == DetectionMetadata::name)
+                    detection_dict = meta;
+                else if (!object_id_dict && name == ObjectIdMetadata::name)
+                    object_id_dict = meta;
+                else if (!label_mask_meta && name == _label_mask_key)
+                    label_mask_meta = meta;
+                if (texts) {
+                    auto meta_label = meta->try_get("label");
+                    if (meta_label)
+                        labels.push_back(any_cast<std::string>(*meta_label));
+                }
+            }
+
             ImageInfo region_info(region_tensor->info());
             int offset_x = 0, offset_y = 0;
-            auto detection_meta = find_metadata<DetectionMetadata>(*region);
-            if (detection_meta) {
-                offset_x = std::lround(detection_meta->x_min() * image_info.width());
-                offset_y = std::lround(detection_meta->y_min() * image_info.height());
+            if (detection_dict) {
+                DetectionMetadata detection_meta(detection_dict);
+                offset_x = std::lround(detection_meta.x_min() * image_info.width());
+                offset_y = std::lround(detection_meta.y_min() * image_info.height());
             }
 
             uint32_t color = _default_color.get_uint32(_info.format);
-            auto object_id_meta = find_metadata<ObjectIdMetadata>(*region);
-            if (object_id_meta)
-                color = index_to_color(object_id_meta->id()).get_uint32(_info.format);
+            std::optional<int> object_id;
+            if (object_id_dict) {
+                object_id = ObjectIdMetadata(object_id_dict).id();
+                color = index_to_color(*object_id).get_uint32(_info.format);
+            }
 
             std::string label;
             if (texts) {
                 std::ostringstream ss;
-                if (object_id_meta)
-                    ss << object_id_meta->id() << ":";
-                for (auto &meta : region->metadata()) {
-                    auto meta_label = meta->try_get("label");
-                    if (meta_label)
-                        append(ss, any_cast<std::string>(*meta_label));
-                }
+                if (object_id)
+                    ss << *object_id << ":";
+                for (auto &meta_label : labels)
+                    append(ss, meta_label);
                 label = ss.str();
                 if (!label.empty()) {
                     overlay::prims::Text text;
-                    text.str = ss.str();
+                    text.str = label;
                     text.x = offset_x;
                     text.y = (offset_y < _font_height) ? (offset_y + _font_height) : offset_y; // TODO text location
                     text.color = color;
                     text.region_index = i;
-                    texts->emplace_back(text);
+                    texts->emplace_back(std::move(text));
                 }
             }
 
-            auto label_mask_meta = find_metadata(*regions[i], _label_mask_key);
             if (masks && label_mask_meta) {
                 overlay::prims::Mask mask;
                 auto label_mask = InferenceResultMetadata(label_mask_meta).tensor();
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Copyright (C) 2018-2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "dlstreamer/image_info.h"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace dlstreamer {
+namespace overlay {
+class Color {
+  private:
+    std::array<uint8_t, 4> vec;
+
+  public:
+    Color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) : vec{r, g, b, a} {};
+    Color(uint32_t rgba) {
+        vec = {static_cast<uint8_t>(rgba), static_cast<uint8_t>(rgba >> 8), static_cast<uint8_t>(rgba >> 16),
+               static_cast<uint8_t>(rgba >> 24)};
+    }
+
+    std::array<uint8_t, 4> get_array() {
+        return vec;
+    };
+    uint32_t get_uint32(dlstreamer::Format format) {
+        auto image_format = static_cast<dlstreamer::ImageFormat>(format);
+        if (image_format == dlstreamer::ImageFormat::RGB || image_format == dlstreamer::ImageFormat::RGBX) {
+            return static_cast<uint32_t>(vec[0]) << 0 | static_cast<uint32_t>(vec[1]) << 8 |
+                   static_cast<uint32_t>(vec[2]) << 16 | static_cast<uint32_t>(vec[3]) << 24;
+        } else if (image_format == dlstreamer::ImageFormat::BGR || image_format == dlstreamer::ImageFormat::BGRX) {
+            return static_cast<uint32_t>(vec[0]) << 16 | static_cast<uint32_t>(vec[1]) << 8 |
+                   static_cast<uint32_t>(vec[2]) << 0 | static_cast<uint32_t>(vec[3]) << 24;
+        } else {
+            throw std::runtime_error("Unsupported color format");
+        }
+    }
+};
+
+namespace prims {
+struct Rect {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    uint32_t color;
+    uint32_t thickness;
+};
+struct Text {
+    std::string str;
+    int32_t x;
+    int32_t y;
+    uint32_t color;
+    uint32_t region_index;
+};
+struct Circle {
+    int32_t x;
+    int32_t y;
+    uint32_t radius;
+    uint32_t color;
+};
+struct Line {
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+    uint32_t color;
+    uint32_t thickness;
+    bool steep = false;
+};
+struct Mask {
+    uint8_t *data;
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+    uint32_t color;
+};
+} // namespace prims
+} // namespace overlay
+
+} // namespace dlstreamer
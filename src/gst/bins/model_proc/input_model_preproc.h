@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -16,7 +16,7 @@ struct ModelInputProcessorInfo {
     std::string format;
     std::string layer_name;
     std::string precision;
-    GstStructure *params;
+    GstStructure *params = nullptr;
 
     ~ModelInputProcessorInfo() {
         if (params)
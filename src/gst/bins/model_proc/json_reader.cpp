@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -15,6 +15,10 @@ void JsonReader::read(const std::string &file_path) {
     input_file.close();
 }
 
+void JsonReader::parse(const std::string &content) {
+    file_contents = json::parse(content);
+}
+
 void JsonReader::setSchema(const nlohmann::json &schema) {
     try {
         validator.set_root_schema(schema);
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -22,6 +22,7 @@ class JsonReader {
 
   public:
     void read(const std::string &file_path);
+    void parse(const std::string &content);
     void setSchema(const nlohmann::json &schema);
     void validate();
     const json &content() const;
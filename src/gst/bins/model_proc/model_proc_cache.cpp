@@ -0,0 +1,43 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "model_proc_cache.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+std::string readFileContent(const std::string &file_path, const std::string &what) {
+    std::ifstream input_file(file_path, std::ios::binary);
+    if (not input_file)
+        throw std::runtime_error(what + " file '" + file_path + "' was not found");
+    std::ostringstream content;
+    content << input_file.rdbuf();
+    return content.str();
+}
+
+std::shared_ptr<const std::vector<std::string>> readLabelsFile(const std::string &file_path) {
+    static ContentCache<std::vector<std::string>> cache;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::string content = readFileContent(file_path, "Labels");
+    bool created = false;
+    auto labels = cache.get(
+        content,
+        [&content]() {
+            auto labels = std::make_shared<std::vector<std::string>>();
+            std::istringstream stream(content);
+            for (std::string line; std::getline(stream, line);)
+                labels->emplace_back(std::move(line));
+            return labels;
+        },
+        &created);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    GST_INFO("Labels file '%s' (%zu labels) %s in %.2f ms", file_path.c_str(), labels->size(),
+             created ? "loaded" : "found in cache", elapsed.count());
+    return labels;
+}
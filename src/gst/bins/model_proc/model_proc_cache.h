@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "input_model_preproc.h"
+
+#include <gst/gst.h>
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Parsed and validated model-proc. Instances in cache are shared and never modified, users get copies of structures
+struct ModelProcDescription {
+    std::vector<ModelInputProcessorInfo::Ptr> input_preproc;
+    std::map<std::string, GstStructure *> output_postproc;
+
+    ModelProcDescription() = default;
+    ModelProcDescription(const ModelProcDescription &) = delete;
+    ModelProcDescription &operator=(const ModelProcDescription &) = delete;
+    ~ModelProcDescription() {
+        for (auto &proc : output_postproc)
+            gst_structure_free(proc.second);
+    }
+};
+
+/**
+ * Process-wide cache of objects created from file content, keyed by content itself (hashed by unordered_map), so
+ * pipelines using the same file in one process parse it once, and file changed between pipeline launches is parsed
+ * again. Concurrent requests for the same content wait for the first one to create object. Creation errors are not
+ * cached. Cache is cleared when it reaches max_entries, which takes many distinct files.
+ */
+template <typename T>
+class ContentCache {
+  public:
+    static constexpr size_t max_entries = 64;
+
+    using Ptr = std::shared_ptr<const T>;
+
+    // Returns object for content, calling create() if there is none. 'created' is set if create() was called
+    Ptr get(const std::string &content, const std::function<Ptr()> &create, bool *created = nullptr) {
+        std::promise<Ptr> promise;
+        std::shared_future<Ptr> future;
+        bool owner = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _entries.find(content);
+            if (it == _entries.end()) {
+                if (_entries.size() >= max_entries)
+                    _entries.clear();
+                it = _entries.emplace(content, promise.get_future().share()).first;
+                owner = true;
+            }
+            future = it->second;
+        }
+        if (created)
+            *created = owner;
+        if (!owner)
+            return future.get();
+
+        try {
+            promise.set_value(create());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            std::lock_guard<std::mutex> lock(_mutex);
+            _entries.erase(content);
+        }
+        return future.get();
+    }
+
+  private:
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::shared_future<Ptr>> _entries;
+};
+
+// Reads whole file, throws if file can't be opened. 'what' names file in error message
+std::string readFileContent(const std::string &file_path, const std::string &what);
+
+// Returns lines of labels file, shared by all users of file with the same content
+std::shared_ptr<const std::vector<std::string>> readLabelsFile(const std::string &file_path);
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -11,8 +11,24 @@
 #include "model_proc_parser_v2_2.h"
 #include "model_proc_schema.h"
 
+#include <chrono>
+
 void ModelProcProvider::readJsonFile(const std::string &file_path) {
-    json_reader.read(file_path);
+    static ContentCache<ModelProcDescription> cache;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::string content = readFileContent(file_path, "Model-proc");
+    bool created = false;
+    model_proc = cache.get(content, [&]() { return parse(content, file_path); }, &created);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    GST_INFO("Model-proc file '%s' %s in %.2f ms", file_path.c_str(),
+             created ? "parsed and validated" : "found in cache", elapsed.count());
+}
+
+std::shared_ptr<const ModelProcDescription> ModelProcProvider::parse(const std::string &content,
+                                                                     const std::string &file_path) {
+    JsonReader json_reader;
+    json_reader.parse(content);
 
     const nlohmann::json &model_proc_json = json_reader.content();
     auto it = model_proc_json.find("json_schema_version");
@@ -21,39 +37,60 @@ void ModelProcProvider::readJsonFile(const std::string &file_path) {
                                     " model-proc file");
 
     const std::string schema_version = it.value();
-    createParser(schema_version);
+    auto model_proc_parser = createParser(json_reader, schema_version);
+
+    auto description = std::make_shared<ModelProcDescription>();
+    description->input_preproc = model_proc_parser->parseInputPreproc(model_proc_json.at("input_preproc"));
+    description->output_postproc = model_proc_parser->parseOutputPostproc(model_proc_json.at("output_postproc"));
+    return description;
 }
 
-void ModelProcProvider::createParser(const std::string &schema_version) {
+std::unique_ptr<ModelProcParser> ModelProcProvider::createParser(JsonReader &json_reader,
+                                                                 const std::string &schema_version) {
     // FIXME: maybe need to move schema validation in parser?
     if (schema_version == "1.0.0") {
-        validateSchema(MODEL_PROC_SCHEMA_V1);
-        model_proc_parser = std::make_unique<ModelProcParserV1>();
+        validateSchema(json_reader, MODEL_PROC_SCHEMA_V1);
+        return std::make_unique<ModelProcParserV1>();
     } else if (schema_version == "2.0.0") {
-        validateSchema(MODEL_PROC_SCHEMA_V2);
-        model_proc_parser = std::make_unique<ModelProcParserV2>();
+        validateSchema(json_reader, MODEL_PROC_SCHEMA_V2);
+        return std::make_unique<ModelProcParserV2>();
     } else if (schema_version == "2.1.0") {
-        validateSchema(MODEL_PROC_SCHEMA_V2_1);
-        model_proc_parser = std::make_unique<ModelProcParserV2_1>();
+        validateSchema(json_reader, MODEL_PROC_SCHEMA_V2_1);
+        return std::make_unique<ModelProcParserV2_1>();
     } else if (schema_version == "2.2.0") {
-        validateSchema(MODEL_PROC_SCHEMA_V2_2);
-        model_proc_parser = std::make_unique<ModelProcParserV2_2>();
+        validateSchema(json_reader, MODEL_PROC_SCHEMA_V2_2);
+        return std::make_unique<ModelProcParserV2_2>();
     } else {
         throw std::invalid_argument("Parser for " + schema_version + " version not found");
     }
 }
 
-void ModelProcProvider::validateSchema(const nlohmann::json &json_schema) {
+void ModelProcProvider::validateSchema(JsonReader &json_reader, const nlohmann::json &json_schema) {
     json_reader.setSchema(json_schema);
     json_reader.validate();
 }
 
 std::vector<ModelInputProcessorInfo::Ptr> ModelProcProvider::parseInputPreproc() {
-    const nlohmann::json &model_proc_content = json_reader.content();
-    return model_proc_parser->parseInputPreproc(model_proc_content.at("input_preproc"));
+    if (!model_proc)
+        throw std::runtime_error("Model-proc file was not read");
+    std::vector<ModelInputProcessorInfo::Ptr> input_preproc;
+    input_preproc.reserve(model_proc->input_preproc.size());
+    for (const auto &cached : model_proc->input_preproc) {
+        auto preprocessor = std::make_shared<ModelInputProcessorInfo>();
+        preprocessor->format = cached->format;
+        preprocessor->layer_name = cached->layer_name;
+        preprocessor->precision = cached->precision;
+        preprocessor->params = cached->params ? gst_structure_copy(cached->params) : nullptr;
+        input_preproc.push_back(std::move(preprocessor));
+    }
+    return input_preproc;
 }
 
 std::map<std::string, GstStructure *> ModelProcProvider::parseOutputPostproc() {
-    const nlohmann::json &model_proc_content = json_reader.content();
-    return model_proc_parser->parseOutputPostproc(model_proc_content.at("output_postproc"));
+    if (!model_proc)
+        throw std::runtime_error("Model-proc file was not read");
+    std::map<std::string, GstStructure *> output_postproc;
+    for (const auto &proc : model_proc->output_postproc)
+        output_postproc[proc.first] = gst_structure_copy(proc.second);
+    return output_postproc;
 }
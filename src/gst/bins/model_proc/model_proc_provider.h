@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -7,21 +7,24 @@
 #pragma once
 
 #include "json_reader.h"
+#include "model_proc_cache.h"
 #include "model_proc_parser.h"
 
 #include <string>
 
 class ModelProcProvider {
   private:
-    JsonReader json_reader;
-    std::unique_ptr<ModelProcParser> model_proc_parser;
+    std::shared_ptr<const ModelProcDescription> model_proc;
 
-    void validateSchema(const nlohmann::json &json_schema);
-    void createParser(const std::string &schema_version);
+    static std::shared_ptr<const ModelProcDescription> parse(const std::string &content, const std::string &file_path);
+    static void validateSchema(JsonReader &json_reader, const nlohmann::json &json_schema);
+    static std::unique_ptr<ModelProcParser> createParser(JsonReader &json_reader, const std::string &schema_version);
 
   public:
+    // Model-proc is parsed and validated once per process for the same file content, see ContentCache
     void readJsonFile(const std::string &file_path);
 
+    // Return copies of parsed model-proc owned by caller
     std::vector<ModelInputProcessorInfo::Ptr> parseInputPreproc();
     std::map<std::string, GstStructure *> parseOutputPostproc();
 };
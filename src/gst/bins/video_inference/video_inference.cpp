@@ -117,6 +117,10 @@ GType preprocess_backend_get_type() {
         {static_cast<int>(PreProcessBackend::VAAPI_OPENCL),
          "VA-API (primary) and OpenCL (secondary). Pre-processing outputs other/tensors(memory:OpenCL)",
          "vaapi-opencl"},
+        {static_cast<int>(PreProcessBackend::OPENCV_FUSED),
+         "Fused single-pass resize, color conversion and normalization on CPU. Pre-processing outputs "
+         "other/tensors(memory:System)",
+         "opencv-fused"},
 
         // deprecated values
         {static_cast<int>(PreProcessBackend::GST_OPENCV),
@@ -473,6 +477,19 @@ class VideoInferencePrivate {
                     std::to_string(OPENCL_QUEUE_SIZE(_batch_size));
             pipe += separator + elem::opencl_tensor_normalize;
             break;
+        case PreProcessBackend::OPENCV_FUSED:
+            // videoconvert works in passthrough mode if decoder output format is supported by opencv_preproc.
+            // Crop is applied to first plane only, so NV12 is supported on full frame only.
+            pipe += separator + elem::videoconvert;
+            if (_inference_region == Region::ROI_LIST)
+                pipe += separator + elem::caps_system_memory + ",format={BGR,BGRX,RGB,RGBX}";
+            else
+                pipe += separator + elem::caps_system_memory + ",format={NV12,BGR,BGRX,RGB,RGBX}";
+            pipe += separator + elem::opencv_preproc + " color-space=" + color_space;
+            if (keep_aspect_ratio)
+                pipe += " add-borders=true";
+            pipe += normalization_params;
+            break;
         default:
             throw std::runtime_error("Unexpected preproc_backend type");
         }
@@ -28,7 +28,8 @@ enum class PreProcessBackend : int {
     VAAPI = 2,
     VAAPI_TENSORS = 3,
     VAAPI_SURFACE_SHARING = 4,
-    VAAPI_OPENCL = 5
+    VAAPI_OPENCL = 5,
+    OPENCV_FUSED = 6
 };
 
 // GType for property 'pre-process-backend'
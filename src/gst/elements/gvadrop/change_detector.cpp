@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "change_detector.h"
+
+#include <algorithm>
+#include <cmath>
+
+double ChangeDetector::measure(const uint8_t *data, int pixel_stride, size_t stride, int width, int height) {
+    if (width <= 0 || height <= 0)
+        return 1.0;
+    const int grid_width = std::min(grid_size, width);
+    const int grid_height = std::min(grid_size, height);
+    const int columns_per_block = std::min(samples_per_block, width / grid_width);
+    const int rows_per_block = std::min(samples_per_block, height / grid_height);
+
+    // Columns sampled in every block, evenly spread over block
+    _columns.resize(grid_width * columns_per_block);
+    for (int block = 0; block < grid_width; block++) {
+        const int block_x = block * width / grid_width;
+        const int block_width = (block + 1) * width / grid_width - block_x;
+        for (int i = 0; i < columns_per_block; i++)
+            _columns[block * columns_per_block + i] = (block_x + i * block_width / columns_per_block) * pixel_stride;
+    }
+
+    _signature.assign(grid_width * grid_height, 0.f);
+    for (int block_row = 0; block_row < grid_height; block_row++) {
+        const int block_y = block_row * height / grid_height;
+        const int block_height = (block_row + 1) * height / grid_height - block_y;
+        float *blocks = _signature.data() + block_row * grid_width;
+        for (int i = 0; i < rows_per_block; i++) {
+            const uint8_t *row = data + (block_y + i * block_height / rows_per_block) * stride;
+            for (int block = 0; block < grid_width; block++) {
+                const int *columns = _columns.data() + block * columns_per_block;
+                unsigned sum = 0;
+                for (int j = 0; j < columns_per_block; j++)
+                    sum += row[columns[j]];
+                blocks[block] += sum;
+            }
+        }
+    }
+    const float norm = 1.f / (255.f * rows_per_block * columns_per_block);
+    for (float &block : _signature)
+        block *= norm;
+
+    if (_reference.size() != _signature.size())
+        return 1.0;
+    float change = 0.f;
+    for (size_t i = 0; i < _signature.size(); i++)
+        change = std::max(change, std::fabs(_signature[i] - _reference[i]));
+    return change;
+}
+
+void ChangeDetector::accept() {
+    _reference.swap(_signature);
+}
+
+void ChangeDetector::reset() {
+    _signature.clear();
+    _reference.clear();
+}
@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Cheap perceptual change detection for gvadrop. Frame signature is luma averaged over grid of blocks, computed from
+ * subsampled pixels, and change is the largest absolute difference of block averages between frame and reference
+ * frame (last passed one), normalized to [0, 1]. Comparing with last passed frame instead of previous one lets slow
+ * changes accumulate, and using block maximum instead of frame average keeps small moving objects detectable.
+ */
+class ChangeDetector {
+  public:
+    static constexpr int grid_size = 16;        // blocks per frame side
+    static constexpr int samples_per_block = 8; // sampled pixels per block side
+
+    /**
+     * Computes signature of frame and returns its change relative to reference, or 1 if there is no reference.
+     * @param data first byte of luma (or other 8-bit component used as luma) of top-left pixel
+     * @param pixel_stride distance in bytes between neighbour pixels in row
+     * @param stride distance in bytes between rows
+     */
+    double measure(const uint8_t *data, int pixel_stride, size_t stride, int width, int height);
+
+    // Makes frame last passed to measure() the reference for next frames
+    void accept();
+
+    void reset();
+
+  private:
+    std::vector<float> _signature;
+    std::vector<float> _reference;
+    std::vector<int> _columns; // sampled columns multiplied by pixel stride
+};
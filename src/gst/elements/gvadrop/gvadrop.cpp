@@ -1,10 +1,11 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
 
 #include "gvadrop.h"
+#include "change_detector.h"
 
 #include <gst/gstevent.h>
 
@@ -30,13 +31,31 @@ constexpr guint MIN_DROP_FRAMES = 0;
 constexpr guint MAX_DROP_FRAMES = G_MAXUINT;
 constexpr guint DEFAULT_DROP_FRAMES = 0;
 
+constexpr gdouble MIN_CHANGE_THRESHOLD = 0.0;
+constexpr gdouble MAX_CHANGE_THRESHOLD = 1.0;
+constexpr gdouble DEFAULT_CHANGE_THRESHOLD = 0.0;
+
+constexpr guint MIN_CHANGE_MAX_DROP = 0;
+constexpr guint MAX_CHANGE_MAX_DROP = G_MAXUINT;
+constexpr guint DEFAULT_CHANGE_MAX_DROP = 0;
+
 constexpr auto DEFAULT_MODE = DropMode::DEFAULT;
 // Enum value names
 constexpr auto UNKNOWN_VALUE_NAME = "unknown";
 constexpr auto MODE_DEFAULT_NAME = "default";
 constexpr auto MODE_GAP_EVENT_NAME = "gap";
 
-enum { PROP_0, PROP_PASS_FRAMES, PROP_DROP_FRAMES, PROP_MODE };
+enum {
+    PROP_0,
+    PROP_PASS_FRAMES,
+    PROP_DROP_FRAMES,
+    PROP_MODE,
+    PROP_CHANGE_THRESHOLD,
+    PROP_CHANGE_MAX_DROP,
+    PROP_PASSED_FRAMES,
+    PROP_DROPPED_FRAMES,
+    PROP_UNCHANGED_FRAMES
+};
 
 std::string mode_to_string(DropMode mode) {
     switch (mode) {
@@ -49,7 +68,38 @@ std::string mode_to_string(DropMode mode) {
     }
 }
 
+// Returns change of frame relative to last passed one, or 1 (changed) if frame can't be analyzed
+double measure_change(GvaDrop *self, GstBuffer *buffer) {
+    if (!self->video_info)
+        return 1.0;
+    const GstVideoFormatInfo *finfo = self->video_info->finfo;
+    // Luma of YUV and gray formats, green as luma approximation for RGB formats
+    const guint component = GST_VIDEO_FORMAT_INFO_IS_RGB(finfo) ? 1 : 0;
+    if (GST_VIDEO_FORMAT_INFO_DEPTH(finfo, component) != 8) {
+        if (!self->change_warned)
+            GST_WARNING_OBJECT(self, "Change detection is not supported for format %s, frames are passed",
+                               GST_VIDEO_FORMAT_INFO_NAME(finfo));
+        self->change_warned = TRUE;
+        return 1.0;
+    }
+
+    GstVideoFrame frame;
+    if (!gst_video_frame_map(&frame, self->video_info, buffer, GST_MAP_READ)) {
+        if (!self->change_warned)
+            GST_WARNING_OBJECT(self, "Failed to map buffer for change detection, frames are passed");
+        self->change_warned = TRUE;
+        return 1.0;
+    }
+    double change = self->change_detector->measure(
+        static_cast<const uint8_t *>(GST_VIDEO_FRAME_COMP_DATA(&frame, component)),
+        GST_VIDEO_FRAME_COMP_PSTRIDE(&frame, component), GST_VIDEO_FRAME_COMP_STRIDE(&frame, component),
+        GST_VIDEO_FRAME_COMP_WIDTH(&frame, component), GST_VIDEO_FRAME_COMP_HEIGHT(&frame, component));
+    gst_video_frame_unmap(&frame);
+    return change;
+}
+
 GstFlowReturn mode_handle(GvaDrop *self, GstBuffer *buffer) {
+    self->dropped_frames++;
     switch (self->mode) {
     case DropMode::DEFAULT: {
         GST_DEBUG_OBJECT(self, "Drop buffer: frame=%u ts=%" GST_TIME_FORMAT, self->frames_counter,
@@ -93,22 +143,85 @@ static void gva_drop_reset(GvaDrop *self) {
 
     self->pass_frames = DEFAULT_PASS_FRAMES;
     self->drop_frames = DEFAULT_DROP_FRAMES;
+    self->change_threshold = DEFAULT_CHANGE_THRESHOLD;
+    self->change_max_drop = DEFAULT_CHANGE_MAX_DROP;
+    self->frames_counter = 0;
+}
+
+// Resets stream state, called when processing (re)starts
+static void gva_drop_reset_stream(GvaDrop *self) {
     self->frames_counter = 0;
+    self->unchanged_counter = 0;
+    self->passed_frames = 0;
+    self->dropped_frames = 0;
+    self->unchanged_frames = 0;
+    self->change_warned = FALSE;
+    self->change_detector->reset();
 }
 
 static void gva_drop_init(GvaDrop *self) {
     GST_DEBUG_OBJECT(self, "%s", __FUNCTION__);
+    self->change_detector = new ChangeDetector();
+    self->video_info = nullptr;
     gva_drop_reset(self);
+    gva_drop_reset_stream(self);
+}
+
+static void gva_drop_finalize(GObject *object) {
+    GvaDrop *self = GVA_DROP(object);
+    GST_DEBUG_OBJECT(self, "%s", __FUNCTION__);
+
+    gva_drop_reset_stream(self);
+    delete self->change_detector;
+    self->change_detector = nullptr;
+    if (self->video_info) {
+        gst_video_info_free(self->video_info);
+        self->video_info = nullptr;
+    }
+
+    G_OBJECT_CLASS(gva_drop_parent_class)->finalize(object);
 }
 
 static gboolean gva_drop_start(GstBaseTransform *trans) {
     GvaDrop *self = GVA_DROP(trans);
     GST_DEBUG_OBJECT(self, "%s", __FUNCTION__);
 
-    GST_INFO_OBJECT(self, "%s parameters: -- Pass frames: %d\n -- Drop frames: %d\n -- Mode: %s\n",
+    GST_INFO_OBJECT(self,
+                    "%s parameters: -- Pass frames: %d\n -- Drop frames: %d\n -- Mode: %s\n -- Change threshold: %f\n "
+                    "-- Change max drop: %u\n",
                     GST_ELEMENT_NAME(GST_ELEMENT_CAST(self)), self->pass_frames, self->drop_frames,
-                    mode_to_string(self->mode).c_str());
+                    mode_to_string(self->mode).c_str(), self->change_threshold, self->change_max_drop);
 
+    gva_drop_reset_stream(self);
+    return TRUE;
+}
+
+static gboolean gva_drop_stop(GstBaseTransform *trans) {
+    GvaDrop *self = GVA_DROP(trans);
+    GST_DEBUG_OBJECT(self, "%s", __FUNCTION__);
+
+    GST_INFO_OBJECT(self, "%s statistics: passed %" G_GUINT64_FORMAT ", dropped %" G_GUINT64_FORMAT
+                    " (unchanged %" G_GUINT64_FORMAT ")",
+                    GST_ELEMENT_NAME(GST_ELEMENT_CAST(self)), self->passed_frames, self->dropped_frames,
+                    self->unchanged_frames);
+    return TRUE;
+}
+
+static gboolean gva_drop_set_caps(GstBaseTransform *trans, GstCaps *incaps, GstCaps *) {
+    GvaDrop *self = GVA_DROP(trans);
+    GST_DEBUG_OBJECT(self, "%s", __FUNCTION__);
+
+    if (self->video_info)
+        gst_video_info_free(self->video_info);
+    // Caps are not required to be video, change detection is then disabled
+    self->video_info = gst_video_info_new();
+    if (!gst_video_info_from_caps(self->video_info, incaps)) {
+        gst_video_info_free(self->video_info);
+        self->video_info = nullptr;
+        if (self->change_threshold > 0)
+            GST_WARNING_OBJECT(self, "Change detection requires raw video caps, frames are passed");
+    }
+    self->change_detector->reset();
     return TRUE;
 }
 
@@ -126,6 +239,12 @@ void gva_drop_set_property(GObject *object, guint property_id, const GValue *val
     case PROP_MODE:
         self->mode = static_cast<DropMode>(g_value_get_enum(value));
         break;
+    case PROP_CHANGE_THRESHOLD:
+        self->change_threshold = g_value_get_double(value);
+        break;
+    case PROP_CHANGE_MAX_DROP:
+        self->change_max_drop = g_value_get_uint(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -146,6 +265,21 @@ void gva_drop_get_property(GObject *object, guint property_id, GValue *value, GP
     case PROP_MODE:
         g_value_set_enum(value, self->mode);
         break;
+    case PROP_CHANGE_THRESHOLD:
+        g_value_set_double(value, self->change_threshold);
+        break;
+    case PROP_CHANGE_MAX_DROP:
+        g_value_set_uint(value, self->change_max_drop);
+        break;
+    case PROP_PASSED_FRAMES:
+        g_value_set_uint64(value, self->passed_frames);
+        break;
+    case PROP_DROPPED_FRAMES:
+        g_value_set_uint64(value, self->dropped_frames);
+        break;
+    case PROP_UNCHANGED_FRAMES:
+        g_value_set_uint64(value, self->unchanged_frames);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -156,19 +290,34 @@ static GstFlowReturn gva_drop_transform_ip(GstBaseTransform *trans, GstBuffer *b
     GvaDrop *self = GVA_DROP(trans);
     GST_DEBUG_OBJECT(self, "%s", __FUNCTION__);
 
-    if (self->drop_frames == 0)
-        return GST_FLOW_OK;
+    // Fixed pass/drop pattern limits output rate, change detection is applied to frames passed by pattern
+    if (self->drop_frames != 0) {
+        self->frames_counter++;
+        if (self->frames_counter > self->pass_frames) {
+            if (self->frames_counter == self->pass_frames + self->drop_frames) {
+                self->frames_counter = 0;
+            }
+            return mode_handle(self, buffer);
+        }
+    }
 
-    self->frames_counter++;
-    if (self->frames_counter > self->pass_frames) {
-        if (self->frames_counter == self->pass_frames + self->drop_frames) {
-            self->frames_counter = 0;
+    // Frame without perceptible change is dropped, unless change-max-drop frames in row were dropped already
+    if (self->change_threshold > 0) {
+        const double change = measure_change(self, buffer);
+        GST_LOG_OBJECT(self, "Frame change %f ts=%" GST_TIME_FORMAT, change, GST_TIME_ARGS(GST_BUFFER_PTS(buffer)));
+        if (change < self->change_threshold &&
+            (self->change_max_drop == 0 || self->unchanged_counter < self->change_max_drop)) {
+            self->unchanged_counter++;
+            self->unchanged_frames++;
+            return mode_handle(self, buffer);
         }
-        return mode_handle(self, buffer);
+        self->unchanged_counter = 0;
+        self->change_detector->accept();
     }
 
     GST_DEBUG_OBJECT(self, "Pass buffer: frame=%u ts=%" GST_TIME_FORMAT, self->frames_counter,
                      GST_TIME_ARGS(GST_BUFFER_PTS(buffer)));
+    self->passed_frames++;
     return GST_FLOW_OK;
 }
 
@@ -187,7 +336,10 @@ static void gva_drop_class_init(GvaDropClass *klass) {
 
     gobject_class->set_property = gva_drop_set_property;
     gobject_class->get_property = gva_drop_get_property;
+    gobject_class->finalize = gva_drop_finalize;
     base_transform_class->start = GST_DEBUG_FUNCPTR(gva_drop_start);
+    base_transform_class->stop = GST_DEBUG_FUNCPTR(gva_drop_stop);
+    base_transform_class->set_caps = GST_DEBUG_FUNCPTR(gva_drop_set_caps);
     base_transform_class->transform_ip = GST_DEBUG_FUNCPTR(gva_drop_transform_ip);
 
     constexpr auto prm_flags = static_cast<GParamFlags>(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT);
@@ -204,4 +356,34 @@ static void gva_drop_class_init(GvaDropClass *klass) {
                                     g_param_spec_enum("mode", "Drop mode",
                                                       "Mode defines what to do with dropped frames",
                                                       GST_TYPE_GVA_DROP_MODE, DEFAULT_MODE, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_CHANGE_THRESHOLD,
+        g_param_spec_double("change-threshold", "Change Threshold",
+                            "If not 0, frames which differ from last passed frame less than threshold are dropped. "
+                            "Difference is the largest change of average luma over blocks of 1/16 frame width and "
+                            "height, in fractions of full luma range (0.02-0.05 ignores noise on static scene)",
+                            MIN_CHANGE_THRESHOLD, MAX_CHANGE_THRESHOLD, DEFAULT_CHANGE_THRESHOLD, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_CHANGE_MAX_DROP,
+        g_param_spec_uint("change-max-drop", "Change Max Drop",
+                          "Maximum number of unchanged frames dropped in row, next frame is passed regardless of "
+                          "change (0 - no limit). Together with pass-frames/drop-frames, limiting maximum output "
+                          "rate, guarantees minimum output rate",
+                          MIN_CHANGE_MAX_DROP, MAX_CHANGE_MAX_DROP, DEFAULT_CHANGE_MAX_DROP, prm_flags));
+
+    constexpr auto stat_flags = static_cast<GParamFlags>(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_property(gobject_class, PROP_PASSED_FRAMES,
+                                    g_param_spec_uint64("passed-frames", "Passed Frames",
+                                                        "Number of frames passed since start", 0, G_MAXUINT64, 0,
+                                                        stat_flags));
+    g_object_class_install_property(gobject_class, PROP_DROPPED_FRAMES,
+                                    g_param_spec_uint64("dropped-frames", "Dropped Frames",
+                                                        "Number of frames dropped since start (replaced by GAP event "
+                                                        "in gap mode)",
+                                                        0, G_MAXUINT64, 0, stat_flags));
+    g_object_class_install_property(gobject_class, PROP_UNCHANGED_FRAMES,
+                                    g_param_spec_uint64("unchanged-frames", "Unchanged Frames",
+                                                        "Number of dropped frames which were dropped because of "
+                                                        "change below change-threshold",
+                                                        0, G_MAXUINT64, 0, stat_flags));
 }
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2022 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -8,6 +8,7 @@
 
 #include <gst/base/gstbasetransform.h>
 #include <gst/gst.h>
+#include <gst/video/video.h>
 
 G_BEGIN_DECLS
 
@@ -23,15 +24,28 @@ typedef struct _GvaDropClass GvaDropClass;
 
 enum DropMode { DEFAULT, GAP_EVENT };
 
+class ChangeDetector;
+
 struct _GvaDrop {
     GstBaseTransform parent;
     /* public properties */
     guint pass_frames;
     guint drop_frames;
     DropMode mode;
+    gdouble change_threshold;
+    guint change_max_drop;
+
+    /* statistics */
+    guint64 passed_frames;
+    guint64 dropped_frames;
+    guint64 unchanged_frames;
 
     /* private properties */
     guint frames_counter;
+    guint unchanged_counter;
+    ChangeDetector *change_detector;
+    GstVideoInfo *video_info;
+    gboolean change_warned;
 };
 
 struct _GvaDropClass {
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -7,6 +7,7 @@
 #include "fpscounter_c.h"
 #include "config.h"
 #include "fpscounter.h"
+#include "metrics.h"
 #include "inference_backend/logger.h"
 #include "utils.h"
 
@@ -111,3 +112,31 @@ gboolean fps_counter_validate_intervals(const char *intervals_string) {
 
     return false;
 }
+
+void *fps_counter_metrics_register_stream(const char *element_name, const char *metrics_sink, unsigned int interval) {
+    try {
+        return MetricsRegistry::instance().RegisterStream(element_name, metrics_sink, interval);
+    } catch (std::exception &e) {
+        GVA_ERROR("Error during creation of metrics sink: %s", Utils::createNestedErrorMsg(e).c_str());
+    }
+    return nullptr;
+}
+
+void fps_counter_metrics_new_frame(void *stream_metrics, GstBuffer *buffer, GstElement *element) {
+    auto stream = static_cast<StreamMetrics *>(stream_metrics);
+    if (!stream)
+        return;
+    try {
+        // probes on pipeline elements installed on first frame, when pipeline is fully constructed
+        if (!stream->instrumented.exchange(true))
+            MetricsRegistry::instance().InstrumentPipeline(element);
+        stream->NewFrame(buffer);
+    } catch (std::exception &e) {
+        GVA_ERROR("Error during metrics update: %s", Utils::createNestedErrorMsg(e).c_str());
+    }
+}
+
+void fps_counter_metrics_unregister_stream(void *stream_metrics) {
+    if (stream_metrics)
+        MetricsRegistry::instance().UnregisterStream(static_cast<StreamMetrics *>(stream_metrics));
+}
@@ -24,6 +24,10 @@ void fps_counter_eos();
 void fps_counter_set_output(FILE *out);
 gboolean fps_counter_validate_intervals(const char *intervals_string);
 
+void *fps_counter_metrics_register_stream(const char *element_name, const char *metrics_sink, unsigned int interval);
+void fps_counter_metrics_new_frame(void *stream_metrics, GstBuffer *, GstElement *element);
+void fps_counter_metrics_unregister_stream(void *stream_metrics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -26,7 +26,15 @@ static GstStaticPadTemplate sinktemplate =
 GST_DEBUG_CATEGORY_STATIC(gst_gva_fpscounter_debug_category);
 #define GST_CAT_DEFAULT gst_gva_fpscounter_debug_category
 
-enum { PROP_0, PROP_INTERVAL, PROP_STARTING_FRAME, PROP_WRITE_PIPE, PROP_READ_PIPE };
+enum {
+    PROP_0,
+    PROP_INTERVAL,
+    PROP_STARTING_FRAME,
+    PROP_WRITE_PIPE,
+    PROP_READ_PIPE,
+    PROP_METRICS_SINK,
+    PROP_METRICS_INTERVAL
+};
 
 #define DEFAULT_INTERVAL "1"
 
@@ -34,11 +42,16 @@ enum { PROP_0, PROP_INTERVAL, PROP_STARTING_FRAME, PROP_WRITE_PIPE, PROP_READ_PI
 #define DEFAULT_MIN_STARTING_FRAME 0
 #define DEFAULT_MAX_STARTING_FRAME UINT_MAX
 
+#define DEFAULT_METRICS_INTERVAL 1
+#define DEFAULT_MIN_METRICS_INTERVAL 1
+#define DEFAULT_MAX_METRICS_INTERVAL 3600
+
 /* prototypes */
 static void gst_gva_fpscounter_set_property(GObject *object, guint property_id, const GValue *value, GParamSpec *pspec);
 static void gst_gva_fpscounter_get_property(GObject *object, guint property_id, GValue *value, GParamSpec *pspec);
 static gboolean gst_gva_fpscounter_check_interval_value(const GValue *value);
 static gboolean gst_gva_fpscounter_start(GstBaseTransform *trans);
+static gboolean gst_gva_fpscounter_stop(GstBaseTransform *trans);
 static void gst_gva_fpscounter_dispose(GObject *object);
 static void gst_gva_fpscounter_finalize(GObject *object);
 static void gst_gva_fpscounter_cleanup(GstGvaFpscounter *gva_fpscounter);
@@ -70,6 +83,7 @@ static void gst_gva_fpscounter_class_init(GstGvaFpscounterClass *klass) {
     gobject_class->dispose = gst_gva_fpscounter_dispose;
     gobject_class->finalize = gst_gva_fpscounter_finalize;
     base_transform_class->start = GST_DEBUG_FUNCPTR(gst_gva_fpscounter_start);
+    base_transform_class->stop = GST_DEBUG_FUNCPTR(gst_gva_fpscounter_stop);
     base_transform_class->transform = NULL;
     base_transform_class->transform_ip = GST_DEBUG_FUNCPTR(gst_gva_fpscounter_transform_ip);
     base_transform_class->sink_event = GST_DEBUG_FUNCPTR(gst_gva_fpscounter_sink_event);
@@ -95,6 +109,21 @@ static void gst_gva_fpscounter_class_init(GstGvaFpscounterClass *klass) {
         g_param_spec_string("read-pipe", "Read from named pipe",
                             "Read FPS data from a named pipe. Create and delete a named pipe.", "",
                             G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_SINK,
+        g_param_spec_string("metrics-sink", "Metrics sink",
+                            "Export per-stream and per-element metrics (fps, dropped frames, processing time "
+                            "percentiles, queue fill) and CPU time of streaming threads (shared by all elements "
+                            "running on a thread). Supported values: 'file:PATH' - append JSON line every "
+                            "metrics-interval; 'unix:PATH' or 'http:[ADDRESS:]PORT' - serve OpenMetrics text over "
+                            "HTTP on Unix socket or TCP port (127.0.0.1 by default)",
+                            NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_INTERVAL,
+        g_param_spec_uint("metrics-interval", "Metrics interval",
+                          "The time interval in seconds for which metrics are aggregated and exported",
+                          DEFAULT_MIN_METRICS_INTERVAL, DEFAULT_MAX_METRICS_INTERVAL, DEFAULT_METRICS_INTERVAL,
+                          (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 }
 
 static void gst_gva_fpscounter_init(GstGvaFpscounter *gva_fpscounter) {
@@ -106,6 +135,9 @@ static void gst_gva_fpscounter_init(GstGvaFpscounter *gva_fpscounter) {
     gva_fpscounter->starting_frame = DEFAULT_STARTING_FRAME;
     gva_fpscounter->write_pipe = NULL;
     gva_fpscounter->read_pipe = NULL;
+    gva_fpscounter->metrics_sink = NULL;
+    gva_fpscounter->metrics_interval = DEFAULT_METRICS_INTERVAL;
+    gva_fpscounter->stream_metrics = NULL;
 }
 
 void gst_gva_fpscounter_get_property(GObject *object, guint property_id, GValue *value, GParamSpec *pspec) {
@@ -125,6 +157,12 @@ void gst_gva_fpscounter_get_property(GObject *object, guint property_id, GValue
     case PROP_READ_PIPE:
         g_value_set_string(value, gvafpscounter->read_pipe);
         break;
+    case PROP_METRICS_SINK:
+        g_value_set_string(value, gvafpscounter->metrics_sink);
+        break;
+    case PROP_METRICS_INTERVAL:
+        g_value_set_uint(value, gvafpscounter->metrics_interval);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -166,6 +204,13 @@ void gst_gva_fpscounter_set_property(GObject *object, guint property_id, const G
         g_free(gvafpscounter->read_pipe);
         gvafpscounter->read_pipe = g_value_dup_string(value);
         break;
+    case PROP_METRICS_SINK:
+        g_free(gvafpscounter->metrics_sink);
+        gvafpscounter->metrics_sink = g_value_dup_string(value);
+        break;
+    case PROP_METRICS_INTERVAL:
+        gvafpscounter->metrics_interval = g_value_get_uint(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -184,6 +229,10 @@ static void gst_gva_fpscounter_cleanup(GstGvaFpscounter *gva_fpscounter) {
     }
     g_free(gva_fpscounter->write_pipe);
     g_free(gva_fpscounter->read_pipe);
+    g_free(gva_fpscounter->metrics_sink);
+    gva_fpscounter->metrics_sink = NULL;
+    fps_counter_metrics_unregister_stream(gva_fpscounter->stream_metrics);
+    gva_fpscounter->stream_metrics = NULL;
 }
 
 static gboolean gst_gva_fpscounter_start(GstBaseTransform *trans) {
@@ -204,6 +253,27 @@ static gboolean gst_gva_fpscounter_start(GstBaseTransform *trans) {
             fps_counter_create_readpipe(gvafpscounter, gvafpscounter->read_pipe);
         }
     }
+
+    if (gvafpscounter->metrics_sink && *gvafpscounter->metrics_sink && !gvafpscounter->stream_metrics) {
+        gvafpscounter->stream_metrics =
+            fps_counter_metrics_register_stream(GST_ELEMENT_NAME(GST_ELEMENT_CAST(gvafpscounter)),
+                                                gvafpscounter->metrics_sink, gvafpscounter->metrics_interval);
+        if (!gvafpscounter->stream_metrics) {
+            GST_ELEMENT_ERROR(gvafpscounter, RESOURCE, SETTINGS, ("Failed to create metrics sink"),
+                              ("Invalid or unavailable metrics-sink '%s'", gvafpscounter->metrics_sink));
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static gboolean gst_gva_fpscounter_stop(GstBaseTransform *trans) {
+    GstGvaFpscounter *gvafpscounter = GST_GVA_FPSCOUNTER(trans);
+
+    GST_DEBUG_OBJECT(gvafpscounter, "stop");
+
+    fps_counter_metrics_unregister_stream(gvafpscounter->stream_metrics);
+    gvafpscounter->stream_metrics = NULL;
     return TRUE;
 }
 
@@ -242,6 +312,8 @@ static GstFlowReturn gst_gva_fpscounter_transform_ip(GstBaseTransform *trans, Gs
     GST_DEBUG_OBJECT(gvafpscounter, "transform_ip");
 
     fps_counter_new_frame(buf, GST_ELEMENT_NAME(GST_ELEMENT(trans)));
+    if (gvafpscounter->stream_metrics)
+        fps_counter_metrics_new_frame(gvafpscounter->stream_metrics, buf, GST_ELEMENT(trans));
 
     if (!gst_pad_is_linked(GST_BASE_TRANSFORM_SRC_PAD(trans))) {
         return GST_BASE_TRANSFORM_FLOW_DROPPED;
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2021 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -28,6 +28,9 @@ struct _GstGvaFpscounter {
     guint starting_frame;
     gchar *write_pipe;
     gchar *read_pipe;
+    gchar *metrics_sink;
+    guint metrics_interval;
+    void *stream_metrics;
 };
 
 struct _GstGvaFpscounterClass {
@@ -0,0 +1,746 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "metrics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+GQuark metrics_quark = g_quark_from_static_string("gvafpscounter_metrics");
+GQuark pipeline_quark = g_quark_from_static_string("gvafpscounter_metrics_pipeline");
+
+constexpr double percentiles[] = {0.5, 0.9, 0.99};
+constexpr const char *percentile_names[] = {"0.5", "0.9", "0.99"};
+
+// Hash of PTS into index in ElementMetrics entries (PTS values are usually multiples of frame duration)
+inline size_t pts_slot(GstClockTime pts) {
+    return (pts * 0x9E3779B97F4A7C15ull) >> 58;
+}
+static_assert(ElementMetrics::ENTRIES_SIZE == 64, "pts_slot() returns 6-bit index");
+
+int current_thread_id() {
+#ifdef __linux__
+    static thread_local int tid = static_cast<int>(syscall(SYS_gettid));
+    return tid;
+#else
+    return 0;
+#endif
+}
+
+// Element name prefixed with names of all bins containing element, except top-level pipeline
+std::string element_path_name(GstElement *element) {
+    gchar *name = gst_element_get_name(element);
+    std::string str = name;
+    g_free(name);
+    GstObject *parent = gst_object_get_parent(GST_OBJECT(element));
+    while (parent) {
+        GstObject *grandparent = gst_object_get_parent(parent);
+        if (grandparent) {
+            gchar *bin_name = gst_object_get_name(parent);
+            str = std::string(bin_name) + "/" + str;
+            g_free(bin_name);
+        }
+        gst_object_unref(parent);
+        parent = grandparent;
+    }
+    return str;
+}
+
+// Escapes string for JSON string literal
+std::string json_escape(const std::string &str) {
+    std::string ret;
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            ret += "\\\"";
+            break;
+        case '\\':
+            ret += "\\\\";
+            break;
+        case '\n':
+            ret += "\\n";
+            break;
+        case '\r':
+            ret += "\\r";
+            break;
+        case '\t':
+            ret += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                snprintf(code, sizeof(code), "\\u%04x", c);
+                ret += code;
+            } else {
+                ret += c;
+            }
+        }
+    }
+    return ret;
+}
+
+// Escapes string for OpenMetrics label value, which has escape sequences for backslash, double quote and line feed
+// only: other control characters are replaced with space
+std::string label_escape(const std::string &str) {
+    std::string ret;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            ret += '\\';
+            ret += c;
+        } else if (c == '\n') {
+            ret += "\\n";
+        } else if (static_cast<unsigned char>(c) < 0x20 || c == 0x7f) {
+            ret += ' ';
+        } else {
+            ret += c;
+        }
+    }
+    return ret;
+}
+
+GstPadProbeReturn sink_probe(GstPad *, GstPadProbeInfo *info, gpointer metrics) {
+    static_cast<ElementMetricsPtr *>(metrics)->get()->BufferIn(GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn src_probe(GstPad *, GstPadProbeInfo *info, gpointer metrics) {
+    static_cast<ElementMetricsPtr *>(metrics)->get()->BufferOut(GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+}
+
+// Destroy-notify of probe, qdata and signal handler data, releases reference to metrics
+void release_metrics(gpointer metrics) {
+    delete static_cast<ElementMetricsPtr *>(metrics);
+}
+
+void release_metrics_closure(gpointer metrics, GClosure *) {
+    release_metrics(metrics);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Exporters
+
+class JsonLinesExporter : public MetricsExporter {
+  public:
+    explicit JsonLinesExporter(const std::string &path) : _file(fopen(path.c_str(), "a")) {
+        if (!_file)
+            throw std::runtime_error("Can't open metrics file " + path + ": " + strerror(errno));
+    }
+    ~JsonLinesExporter() override {
+        fclose(_file);
+    }
+    void Update(const MetricsSnapshot &snapshot) override {
+        std::string line = snapshot.ToJson();
+        fprintf(_file, "%s\n", line.c_str());
+        fflush(_file);
+    }
+
+  private:
+    FILE *_file;
+};
+
+#ifdef __linux__
+// Serves latest snapshot in OpenMetrics text format as HTTP response to any request on TCP or Unix socket
+class HttpExporter : public MetricsExporter {
+  public:
+    HttpExporter(int listen_fd, const std::string &unix_path)
+        : _listen_fd(listen_fd), _unix_path(unix_path), _text("# EOF\n") {
+        if (pipe(_wake_pipe)) {
+            std::string error = strerror(errno);
+            close(_listen_fd);
+            throw std::runtime_error("Can't create pipe: " + error);
+        }
+        _thread = std::thread(&HttpExporter::Serve, this);
+    }
+    ~HttpExporter() override {
+        if (write(_wake_pipe[1], "", 1) < 0)
+            fprintf(stderr, "Metrics server wake up error: %s\n", strerror(errno));
+        _thread.join();
+        close(_wake_pipe[0]);
+        close(_wake_pipe[1]);
+        close(_listen_fd);
+        if (!_unix_path.empty())
+            unlink(_unix_path.c_str());
+    }
+    void Update(const MetricsSnapshot &snapshot) override {
+        std::string text = snapshot.ToOpenMetrics();
+        std::lock_guard<std::mutex> guard(_mutex);
+        _text.swap(text);
+    }
+
+  private:
+    void Serve() {
+        while (true) {
+            pollfd fds[2] = {{_listen_fd, POLLIN, 0}, {_wake_pipe[0], POLLIN, 0}};
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            if (fds[1].revents)
+                break;
+            int client = accept4(_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0)
+                continue;
+            Respond(client);
+            close(client);
+        }
+    }
+
+    void Respond(int client) {
+        // Request content is ignored, but read it so client doesn't get connection reset
+        char request[4096];
+        pollfd fd = {client, POLLIN, 0};
+        if (poll(&fd, 1, 1000) > 0 && recv(client, request, sizeof(request), 0) < 0)
+            return;
+        std::string body;
+        {
+            std::lock_guard<std::mutex> guard(_mutex);
+            body = _text;
+        }
+        std::string response = "HTTP/1.0 200 OK\r\n"
+                               "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                               "Content-Length: " +
+                               std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            sent += n;
+        }
+    }
+
+    int _listen_fd;
+    int _wake_pipe[2];
+    std::string _unix_path;
+    std::mutex _mutex;
+    std::string _text;
+    std::thread _thread;
+};
+
+int listen_unix(const std::string &path) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        throw std::invalid_argument("Invalid Unix socket path: " + path);
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Can't create socket: ") + strerror(errno));
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) || listen(fd, 16)) {
+        std::string error = strerror(errno);
+        close(fd);
+        throw std::runtime_error("Can't listen on Unix socket " + path + ": " + error);
+    }
+    return fd;
+}
+
+int listen_tcp(const std::string &address) {
+    // [ADDRESS:]PORT, listen on loopback interface by default
+    std::string host = "127.0.0.1";
+    std::string port = address;
+    auto pos = address.rfind(':');
+    if (pos != std::string::npos) {
+        host = address.substr(0, pos);
+        port = address.substr(pos + 1);
+    }
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+        throw std::invalid_argument("Invalid IPv4 address: " + host);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Can't create socket: ") + strerror(errno));
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) || listen(fd, 16)) {
+        std::string error = strerror(errno);
+        close(fd);
+        throw std::runtime_error("Can't listen on " + host + ":" + port + ": " + error);
+    }
+    return fd;
+}
+#endif
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// MetricsSnapshot
+
+std::string MetricsSnapshot::ToJson() const {
+    std::ostringstream out;
+    out.precision(6);
+    out << std::fixed << "{\"timestamp\":" << timestamp << ",\"streams\":[";
+    for (size_t i = 0; i < streams.size(); i++) {
+        const Stream &s = streams[i];
+        out << (i ? "," : "") << "{\"name\":\"" << json_escape(s.name) << "\",\"frames\":" << s.frames
+            << ",\"dropped\":" << s.dropped << ",\"fps\":" << s.fps << "}";
+    }
+    out << "],\"elements\":[";
+    for (size_t i = 0; i < elements.size(); i++) {
+        const Element &e = elements[i];
+        out << (i ? "," : "") << "{\"name\":\"" << json_escape(e.name) << "\",\"type\":\"" << json_escape(e.type)
+            << "\",\"buffers\":" << e.buffers << ",\"dropped\":" << e.dropped
+            << ",\"latency_samples\":" << e.latency_samples;
+        for (size_t p = 0; p < std::size(percentiles); p++)
+            out << ",\"latency_p" << static_cast<int>(percentiles[p] * 100) << "_sec\":" << e.latency_percentiles[p];
+        out << ",\"thread_id\":" << e.thread_id;
+        if (e.queue_max >= 0)
+            out << ",\"queue_level\":" << e.queue_level << ",\"queue_max\":" << e.queue_max;
+        out << "}";
+    }
+    out << "],\"threads\":[";
+    for (size_t i = 0; i < threads.size(); i++) {
+        const Thread &t = threads[i];
+        out << (i ? "," : "") << "{\"id\":" << t.id << ",\"cpu_sec\":" << t.cpu_sec << ",\"cpu_load\":" << t.cpu_load
+            << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::string MetricsSnapshot::ToOpenMetrics() const {
+    std::ostringstream out;
+    out.precision(6);
+    out << std::fixed;
+    auto header = [&out](const char *name, const char *type, const char *help) {
+        out << "# TYPE " << name << " " << type << "\n# HELP " << name << " " << help << "\n";
+    };
+    auto stream_label = [](const Stream &s) { return "{stream=\"" + label_escape(s.name) + "\"}"; };
+    auto element_labels = [](const Element &e) {
+        return "element=\"" + label_escape(e.name) + "\",type=\"" + label_escape(e.type) + "\"";
+    };
+
+    header("dlstreamer_stream_frames", "counter", "Frames passed through gvafpscounter");
+    for (auto &s : streams)
+        out << "dlstreamer_stream_frames_total" << stream_label(s) << " " << s.frames << "\n";
+    header("dlstreamer_stream_dropped_frames", "counter", "Frames missing in stream, estimated from timestamp gaps");
+    for (auto &s : streams)
+        out << "dlstreamer_stream_dropped_frames_total" << stream_label(s) << " " << s.dropped << "\n";
+    header("dlstreamer_stream_fps", "gauge", "Frames per second within last interval");
+    for (auto &s : streams)
+        out << "dlstreamer_stream_fps" << stream_label(s) << " " << s.fps << "\n";
+
+    header("dlstreamer_element_buffers", "counter", "Buffers processed by element");
+    for (auto &e : elements)
+        out << "dlstreamer_element_buffers_total{" << element_labels(e) << "} " << e.buffers << "\n";
+    header("dlstreamer_element_dropped_frames", "counter", "Frames dropped by element, as reported in QoS messages");
+    for (auto &e : elements)
+        out << "dlstreamer_element_dropped_frames_total{" << element_labels(e) << "} " << e.dropped << "\n";
+    header("dlstreamer_element_processing_time_seconds", "summary", "Time between buffer input and output");
+    for (auto &e : elements) {
+        if (!e.latency_samples)
+            continue;
+        std::string labels = element_labels(e);
+        for (size_t p = 0; p < std::size(percentiles); p++) {
+            out << "dlstreamer_element_processing_time_seconds{" << labels << ",quantile=\"" << percentile_names[p]
+                << "\"} " << e.latency_percentiles[p] << "\n";
+        }
+        out << "dlstreamer_element_processing_time_seconds_count{" << labels << "} " << e.latency_samples << "\n";
+    }
+    header("dlstreamer_element_thread", "info", "Streaming thread running element's input");
+    for (auto &e : elements)
+        if (e.thread_id)
+            out << "dlstreamer_element_thread_info{" << element_labels(e) << ",thread=\"" << e.thread_id << "\"} 1\n";
+    header("dlstreamer_queue_level_buffers", "gauge", "Buffers in queue element");
+    for (auto &e : elements)
+        if (e.queue_max >= 0)
+            out << "dlstreamer_queue_level_buffers{" << element_labels(e) << "} " << e.queue_level << "\n";
+    header("dlstreamer_queue_max_buffers", "gauge", "Queue element capacity in buffers, 0 if unlimited");
+    for (auto &e : elements)
+        if (e.queue_max >= 0)
+            out << "dlstreamer_queue_max_buffers{" << element_labels(e) << "} " << e.queue_max << "\n";
+
+    header("dlstreamer_thread_cpu_seconds", "counter",
+           "CPU time of streaming thread, shared by all elements running on the thread");
+    for (auto &t : threads)
+        out << "dlstreamer_thread_cpu_seconds_total{thread=\"" << t.id << "\"} " << t.cpu_sec << "\n";
+    header("dlstreamer_thread_cpu_load", "gauge", "CPU load of streaming thread within last interval");
+    for (auto &t : threads)
+        out << "dlstreamer_thread_cpu_load{thread=\"" << t.id << "\"} " << t.cpu_load << "\n";
+    out << "# EOF\n";
+    return out.str();
+}
+
+std::unique_ptr<MetricsExporter> MetricsExporter::Create(const std::string &sink) {
+    auto pos = sink.find(':');
+    std::string scheme = sink.substr(0, pos);
+    std::string value = (pos == std::string::npos) ? std::string() : sink.substr(pos + 1);
+    if (scheme == "file" && !value.empty())
+        return std::unique_ptr<MetricsExporter>(new JsonLinesExporter(value));
+#ifdef __linux__
+    if (scheme == "unix")
+        return std::unique_ptr<MetricsExporter>(new HttpExporter(listen_unix(value), value));
+    if (scheme == "http" && !value.empty())
+        return std::unique_ptr<MetricsExporter>(new HttpExporter(listen_tcp(value), std::string()));
+#endif
+    throw std::invalid_argument("Invalid metrics sink '" + sink +
+                                "', expected 'file:PATH', 'unix:PATH' or 'http:[ADDRESS:]PORT'");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// StreamMetrics
+
+void StreamMetrics::NewFrame(GstBuffer *buffer) {
+    frames.fetch_add(1, std::memory_order_relaxed);
+    if (!buffer || !GST_BUFFER_PTS_IS_VALID(buffer))
+        return;
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    GstClockTime duration = GST_BUFFER_DURATION(buffer);
+    // Estimate frames lost upstream from gap between timestamps of consecutive frames
+    if (GST_CLOCK_TIME_IS_VALID(last_pts) && GST_CLOCK_TIME_IS_VALID(duration) && duration > 0 && pts > last_pts) {
+        uint64_t lost = (pts - last_pts + duration / 2) / duration - 1;
+        if (lost)
+            dropped.fetch_add(lost, std::memory_order_relaxed);
+    }
+    last_pts = pts;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ElementMetrics
+
+ElementMetrics::ElementMetrics(GstElement *element, const std::string &name)
+    : name(name), type(G_OBJECT_TYPE_NAME(element)) {
+    g_weak_ref_init(&this->element, element);
+    for (auto &latency : _latency_us)
+        latency.store(0, std::memory_order_relaxed);
+}
+
+ElementMetrics::~ElementMetrics() {
+    g_weak_ref_clear(&element);
+}
+
+void ElementMetrics::BufferIn(GstBuffer *buffer) {
+    buffers_in.fetch_add(1, std::memory_order_relaxed);
+    if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+        Entry &entry = _entries[pts_slot(GST_BUFFER_PTS(buffer))];
+        entry.time.store(g_get_monotonic_time(), std::memory_order_relaxed);
+        entry.pts.store(GST_BUFFER_PTS(buffer), std::memory_order_release);
+    }
+#ifdef __linux__
+    int tid = current_thread_id();
+    if (_thread_id.load(std::memory_order_relaxed) != tid) {
+        clockid_t clock;
+        if (pthread_getcpuclockid(pthread_self(), &clock) == 0) {
+            _thread_clock.store(clock, std::memory_order_relaxed);
+            _thread_id.store(tid, std::memory_order_relaxed);
+        }
+    }
+#endif
+}
+
+void ElementMetrics::BufferOut(GstBuffer *buffer) {
+    buffers_out.fetch_add(1, std::memory_order_relaxed);
+    if (!GST_BUFFER_PTS_IS_VALID(buffer))
+        return;
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    Entry &entry = _entries[pts_slot(pts)];
+    if (entry.pts.load(std::memory_order_acquire) != pts)
+        return;
+    int64_t start = entry.time.load(std::memory_order_relaxed);
+    // Entry could be overwritten by another input buffer between loads, consume it only if PTS still matches
+    uint64_t expected = pts;
+    if (!entry.pts.compare_exchange_strong(expected, GST_CLOCK_TIME_NONE, std::memory_order_acq_rel))
+        return;
+    int64_t latency_us = std::max<int64_t>(g_get_monotonic_time() - start, 0);
+    uint64_t index = _latency_count.fetch_add(1, std::memory_order_relaxed);
+    _latency_us[index % LATENCY_RING_SIZE].store(static_cast<uint32_t>(std::min<int64_t>(latency_us, UINT32_MAX)),
+                                                 std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MetricsRegistry
+
+MetricsRegistry &MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    StopThread();
+}
+
+StreamMetrics *MetricsRegistry::RegisterStream(const std::string &name, const std::string &sink,
+                                               unsigned interval_sec) {
+    std::lock_guard<std::mutex> lifecycle(_lifecycle_mutex);
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (!_exporters.count(sink))
+        _exporters[sink] = MetricsExporter::Create(sink);
+    // shortest interval requested by gvafpscounter instances
+    if (interval_sec && (!_active_streams || interval_sec < _interval_sec))
+        _interval_sec = interval_sec;
+    _streams.emplace_back(new StreamMetrics(name));
+    if (!_active_streams++) {
+        _last_report = std::chrono::steady_clock::now();
+        _thread = std::thread(&MetricsRegistry::AggregationLoop, this);
+    }
+    return _streams.back().get();
+}
+
+void MetricsRegistry::UnregisterStream(StreamMetrics *stream) {
+    std::lock_guard<std::mutex> lifecycle(_lifecycle_mutex);
+    {
+        // released after final report
+        std::lock_guard<std::mutex> guard(_mutex);
+        stream->active.store(false);
+        if (--_active_streams)
+            return;
+    }
+    // Aggregation thread never takes _lifecycle_mutex, so it can be joined here
+    StopThread();
+    std::lock_guard<std::mutex> guard(_mutex);
+    Report();
+    _exporters.clear();
+    _threads_cpu_sec.clear();
+    // Instrumented elements keep their metrics, and are added back when their pipeline is scanned by next stream
+    _elements.clear();
+    _generation++;
+}
+
+void MetricsRegistry::StopThread() {
+    if (!_thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> guard(_thread_mutex);
+        _stop = true;
+    }
+    _thread_cv.notify_all();
+    _thread.join();
+    _stop = false;
+}
+
+void MetricsRegistry::InstrumentPipeline(GstElement *element) {
+    GstObject *top = GST_OBJECT(gst_object_ref(element));
+    while (GstObject *parent = gst_object_get_parent(top)) {
+        gst_object_unref(top);
+        top = parent;
+    }
+    std::lock_guard<std::mutex> guard(_mutex);
+    // Pipeline qdata is generation pipeline was scanned in, 0 if it wasn't scanned yet
+    const uintptr_t scanned =
+        GST_IS_BIN(top) ? reinterpret_cast<uintptr_t>(g_object_get_qdata(G_OBJECT(top), pipeline_quark)) : 0;
+    if (GST_IS_BIN(top) && scanned != _generation) {
+        g_object_set_qdata(G_OBJECT(top), pipeline_quark, reinterpret_cast<gpointer>(_generation));
+        if (!scanned) {
+            g_signal_connect(top, "deep-element-added", G_CALLBACK(OnDeepElementAdded), this);
+
+            GstBus *bus = gst_element_get_bus(GST_ELEMENT(top));
+            if (bus) {
+                gst_bus_enable_sync_message_emission(bus);
+                g_signal_connect(bus, "sync-message::qos", G_CALLBACK(OnQosMessage), this);
+                gst_object_unref(bus);
+            }
+        }
+
+        GstIterator *it = gst_bin_iterate_recurse(GST_BIN(top));
+        GValue item = G_VALUE_INIT;
+        bool done = false;
+        while (!done) {
+            switch (gst_iterator_next(it, &item)) {
+            case GST_ITERATOR_OK:
+                InstrumentElement(GST_ELEMENT(g_value_get_object(&item)));
+                g_value_reset(&item);
+                break;
+            case GST_ITERATOR_RESYNC:
+                // already instrumented elements are skipped
+                gst_iterator_resync(it);
+                break;
+            default:
+                done = true;
+                break;
+            }
+        }
+        g_value_unset(&item);
+        gst_iterator_free(it);
+    }
+    gst_object_unref(top);
+}
+
+// Called with _mutex locked
+void MetricsRegistry::InstrumentElement(GstElement *element) {
+    // bins are skipped, buffers pushed through ghost pads are counted on real elements
+    if (GST_IS_BIN(element))
+        return;
+    auto instrumented = static_cast<ElementMetricsPtr *>(g_object_get_qdata(G_OBJECT(element), metrics_quark));
+    if (instrumented) {
+        // instrumented before metrics were released with last stream
+        if (std::find(_elements.begin(), _elements.end(), *instrumented) == _elements.end())
+            _elements.push_back(*instrumented);
+        return;
+    }
+    auto metrics = std::make_shared<ElementMetrics>(element, element_path_name(element));
+    _elements.push_back(metrics);
+    g_object_set_qdata_full(G_OBJECT(element), metrics_quark, new ElementMetricsPtr(metrics), release_metrics);
+    gst_element_foreach_pad(
+        element,
+        [](GstElement *, GstPad *pad, gpointer metrics) -> gboolean {
+            InstrumentPad(pad, *static_cast<ElementMetricsPtr *>(metrics));
+            return TRUE;
+        },
+        &metrics);
+    g_signal_connect_data(element, "pad-added", G_CALLBACK(OnPadAdded), new ElementMetricsPtr(metrics),
+                          release_metrics_closure, GConnectFlags(0));
+}
+
+void MetricsRegistry::InstrumentPad(GstPad *pad, const ElementMetricsPtr &metrics) {
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, GST_PAD_IS_SINK(pad) ? sink_probe : src_probe,
+                      new ElementMetricsPtr(metrics), release_metrics);
+}
+
+void MetricsRegistry::OnDeepElementAdded(GstBin *, GstBin *, GstElement *element, gpointer self) {
+    auto registry = static_cast<MetricsRegistry *>(self);
+    std::lock_guard<std::mutex> guard(registry->_mutex);
+    // without streams element is instrumented when pipeline is scanned by next stream
+    if (registry->_active_streams)
+        registry->InstrumentElement(element);
+}
+
+void MetricsRegistry::OnPadAdded(GstElement *, GstPad *pad, gpointer metrics) {
+    InstrumentPad(pad, *static_cast<ElementMetricsPtr *>(metrics));
+}
+
+void MetricsRegistry::OnQosMessage(GstBus *, GstMessage *message, gpointer) {
+    GstObject *src = GST_MESSAGE_SRC(message);
+    if (!src || !GST_IS_ELEMENT(src))
+        return;
+    auto metrics = static_cast<ElementMetricsPtr *>(g_object_get_qdata(G_OBJECT(src), metrics_quark));
+    if (!metrics)
+        return;
+    GstFormat format;
+    guint64 processed, dropped;
+    gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+    if ((format == GST_FORMAT_BUFFERS || format == GST_FORMAT_DEFAULT) && dropped != static_cast<guint64>(-1))
+        (*metrics)->qos_dropped.store(dropped, std::memory_order_relaxed);
+}
+
+MetricsSnapshot MetricsRegistry::Aggregate(double elapsed_sec) {
+    MetricsSnapshot snapshot;
+    snapshot.timestamp = g_get_real_time() * 1e-6;
+
+    for (auto &stream : _streams) {
+        MetricsSnapshot::Stream s;
+        s.name = stream->name;
+        s.frames = stream->frames.load(std::memory_order_relaxed);
+        s.dropped = stream->dropped.load(std::memory_order_relaxed);
+        s.fps = (s.frames - stream->last_frames) / elapsed_sec;
+        stream->last_frames = s.frames;
+        snapshot.streams.push_back(std::move(s));
+    }
+    _streams.remove_if([](const std::unique_ptr<StreamMetrics> &stream) { return !stream->active.load(); });
+
+    std::vector<uint32_t> latency;
+#ifdef __linux__
+    std::map<int, clockid_t> thread_clocks;
+#endif
+    for (auto &metrics : _elements) {
+        MetricsSnapshot::Element e;
+        e.name = metrics->name;
+        e.type = metrics->type;
+        uint64_t buffers_in = metrics->buffers_in.load(std::memory_order_relaxed);
+        e.buffers = buffers_in ? buffers_in : metrics->buffers_out.load(std::memory_order_relaxed);
+        e.dropped = metrics->qos_dropped.load(std::memory_order_relaxed);
+
+        e.latency_samples = metrics->_latency_count.load(std::memory_order_relaxed);
+        size_t n = std::min<size_t>(e.latency_samples, ElementMetrics::LATENCY_RING_SIZE);
+        if (n) {
+            latency.resize(n);
+            for (size_t i = 0; i < n; i++)
+                latency[i] = metrics->_latency_us[i].load(std::memory_order_relaxed);
+            for (size_t p = 0; p < std::size(percentiles); p++) {
+                auto nth = latency.begin() + static_cast<size_t>(percentiles[p] * (n - 1));
+                std::nth_element(latency.begin(), nth, latency.end());
+                e.latency_percentiles[p] = *nth * 1e-6;
+            }
+        }
+
+#ifdef __linux__
+        e.thread_id = metrics->_thread_id.load(std::memory_order_relaxed);
+        if (e.thread_id && !thread_clocks.count(e.thread_id))
+            thread_clocks[e.thread_id] = static_cast<clockid_t>(metrics->_thread_clock.load(std::memory_order_relaxed));
+#endif
+
+        GstElement *element = static_cast<GstElement *>(g_weak_ref_get(&metrics->element));
+        if (element) {
+            GObjectClass *klass = G_OBJECT_GET_CLASS(element);
+            if (g_object_class_find_property(klass, "current-level-buffers") &&
+                g_object_class_find_property(klass, "max-size-buffers")) {
+                guint level = 0, max = 0;
+                g_object_get(element, "current-level-buffers", &level, "max-size-buffers", &max, NULL);
+                e.queue_level = static_cast<int>(level);
+                e.queue_max = static_cast<int>(max);
+            }
+            gst_object_unref(element);
+        }
+        snapshot.elements.push_back(std::move(e));
+    }
+    // Element destroyed, metrics are released with the last pad (probe) referencing them
+    _elements.remove_if([](const ElementMetricsPtr &metrics) {
+        GObject *element = static_cast<GObject *>(g_weak_ref_get(&metrics->element));
+        if (element)
+            g_object_unref(element);
+        return element == nullptr;
+    });
+
+#ifdef __linux__
+    // Threads are reported once, however many elements they run. Exited threads are not reported
+    std::map<int, double> threads_cpu_sec;
+    for (auto &thread_clock : thread_clocks) {
+        timespec ts;
+        if (clock_gettime(thread_clock.second, &ts) != 0)
+            continue;
+        MetricsSnapshot::Thread t;
+        t.id = thread_clock.first;
+        t.cpu_sec = ts.tv_sec + ts.tv_nsec * 1e-9;
+        auto last = _threads_cpu_sec.find(t.id);
+        if (last != _threads_cpu_sec.end() && t.cpu_sec >= last->second)
+            t.cpu_load = (t.cpu_sec - last->second) / elapsed_sec;
+        threads_cpu_sec[t.id] = t.cpu_sec;
+        snapshot.threads.push_back(t);
+    }
+    _threads_cpu_sec.swap(threads_cpu_sec);
+#endif
+    return snapshot;
+}
+
+void MetricsRegistry::Report() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed_sec = std::chrono::duration<double>(now - _last_report).count();
+    _last_report = now;
+    MetricsSnapshot snapshot = Aggregate(elapsed_sec);
+    for (auto &exporter : _exporters)
+        exporter.second->Update(snapshot);
+}
+
+void MetricsRegistry::AggregationLoop() {
+    std::unique_lock<std::mutex> lock(_thread_mutex);
+    while (!_thread_cv.wait_for(lock, std::chrono::seconds(_interval_sec.load()), [this] { return _stop; })) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        Report();
+    }
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Per-stream, per-element and per-streaming-thread pipeline metrics exported by gvafpscounter.
+ *
+ * Streaming threads only do relaxed atomic updates (no locks, no allocations) on metrics objects registered once per
+ * stream/element. Aggregation thread periodically builds MetricsSnapshot and passes it to exporters. It runs while at
+ * least one gvafpscounter stream is registered.
+ *
+ * CPU time is measured per streaming thread, not per element: all elements running on one thread (up to next queue or
+ * other thread boundary) share it. Elements refer to their thread by id.
+ */
+
+struct MetricsSnapshot {
+    struct Stream {
+        std::string name;
+        uint64_t frames = 0;
+        uint64_t dropped = 0;
+        double fps = 0;
+    };
+    struct Element {
+        std::string name;
+        std::string type;
+        uint64_t buffers = 0;
+        uint64_t dropped = 0;               // reported by element in QoS messages
+        uint64_t latency_samples = 0;       // total number of processing time measurements
+        double latency_percentiles[3] = {}; // 50, 90, 99 percentile of processing time, seconds
+        int thread_id = 0;                  // streaming thread running element's input, 0 if unknown
+        int queue_level = -1;               // queue elements only
+        int queue_max = -1;
+    };
+    struct Thread {
+        int id = 0;
+        double cpu_sec = 0;  // CPU time of thread, shared by all elements running on it
+        double cpu_load = 0; // CPU time / wall time within last interval
+    };
+    double timestamp = 0; // seconds since epoch
+    std::vector<Stream> streams;
+    std::vector<Element> elements;
+    std::vector<Thread> threads;
+
+    std::string ToJson() const;
+    std::string ToOpenMetrics() const;
+};
+
+class MetricsExporter {
+  public:
+    virtual ~MetricsExporter() = default;
+    virtual void Update(const MetricsSnapshot &snapshot) = 0;
+
+    // Creates exporter from string 'file:PATH', 'unix:PATH' or 'http:[ADDRESS:]PORT'
+    static std::unique_ptr<MetricsExporter> Create(const std::string &sink);
+};
+
+class StreamMetrics {
+  public:
+    explicit StreamMetrics(const std::string &name) : name(name) {
+    }
+
+    // Called from streaming thread for each frame
+    void NewFrame(GstBuffer *buffer);
+
+    const std::string name;
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> active{true};
+    std::atomic<bool> instrumented{false};
+
+  private:
+    friend class MetricsRegistry;
+    // Accessed from streaming thread only
+    GstClockTime last_pts = GST_CLOCK_TIME_NONE;
+    // Accessed from aggregation thread only
+    uint64_t last_frames = 0;
+};
+
+class ElementMetrics {
+  public:
+    static constexpr size_t ENTRIES_SIZE = 64;
+    static constexpr size_t LATENCY_RING_SIZE = 1024;
+
+    ElementMetrics(GstElement *element, const std::string &name);
+    ~ElementMetrics();
+
+    // Called from pad probes in streaming threads
+    void BufferIn(GstBuffer *buffer);
+    void BufferOut(GstBuffer *buffer);
+
+    const std::string name;
+    std::string type;
+    GWeakRef element;
+    std::atomic<uint64_t> buffers_in{0};
+    std::atomic<uint64_t> buffers_out{0};
+    std::atomic<uint64_t> qos_dropped{0};
+
+  private:
+    friend class MetricsRegistry;
+
+    // Input timestamps keyed by buffer PTS, matched on output to measure processing time
+    struct Entry {
+        std::atomic<uint64_t> pts{GST_CLOCK_TIME_NONE};
+        std::atomic<int64_t> time{0};
+    };
+    std::array<Entry, ENTRIES_SIZE> _entries;
+    // Last processing time measurements in microseconds
+    std::array<std::atomic<uint32_t>, LATENCY_RING_SIZE> _latency_us;
+    std::atomic<uint64_t> _latency_count{0};
+    // Streaming thread which pushes buffers into element
+    std::atomic<int> _thread_id{0};
+    std::atomic<int64_t> _thread_clock{-1};
+};
+
+// Referenced by registry and by element qdata, pad probes and signal handlers, so metrics outlive registry entry while
+// element is instrumented
+using ElementMetricsPtr = std::shared_ptr<ElementMetrics>;
+
+class MetricsRegistry {
+  public:
+    static MetricsRegistry &instance();
+    ~MetricsRegistry();
+
+    // Creates exporter for 'sink' (if not created yet) and starts aggregation thread with first registered stream
+    StreamMetrics *RegisterStream(const std::string &name, const std::string &sink, unsigned interval_sec);
+    // Stops aggregation thread, closes exporters and releases element metrics after final report when last stream is
+    // unregistered
+    void UnregisterStream(StreamMetrics *stream);
+
+    // Installs pad probes on all elements of the pipeline containing 'element' (once per pipeline)
+    void InstrumentPipeline(GstElement *element);
+
+  private:
+    MetricsRegistry() = default;
+
+    void InstrumentElement(GstElement *element);
+    static void InstrumentPad(GstPad *pad, const ElementMetricsPtr &metrics);
+    // Called with _mutex locked
+    void Report();
+    MetricsSnapshot Aggregate(double elapsed_sec);
+    void AggregationLoop();
+    void StopThread();
+
+    static void OnDeepElementAdded(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer self);
+    static void OnPadAdded(GstElement *element, GstPad *pad, gpointer metrics);
+    static void OnQosMessage(GstBus *bus, GstMessage *message, gpointer self);
+
+    std::mutex _mutex;
+    std::list<std::unique_ptr<StreamMetrics>> _streams;
+    std::list<ElementMetricsPtr> _elements;
+    // Incremented when element metrics are released, so pipelines are scanned again by next streams
+    uintptr_t _generation = 1;
+    std::map<std::string, std::unique_ptr<MetricsExporter>> _exporters;
+    std::atomic<unsigned> _interval_sec{1};
+    size_t _active_streams = 0;
+    std::chrono::steady_clock::time_point _last_report;
+    // Last CPU time of streaming threads by thread id, accessed with _mutex locked
+    std::map<int, double> _threads_cpu_sec;
+
+    // Serializes registration with start and stop of aggregation thread
+    std::mutex _lifecycle_mutex;
+    std::thread _thread;
+    std::mutex _thread_mutex;
+    std::condition_variable _thread_cv;
+    bool _stop = false;
+};
@@ -1,16 +1,20 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
 
 #include "meta_aggregate.h"
+#include "box_batch.h"
 #include "dlstreamer/gst/frame.h"
 #include "dlstreamer/gst/mappers/gst_to_cpu.h"
 #include "dlstreamer/gst/metadata/gva_tensor_meta.h"
 #include "dlstreamer/image_metadata.h"
 #include "roi_split.h"
-#include <list>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 
 using namespace dlstreamer;
 
@@ -19,6 +23,15 @@ GST_DEBUG_CATEGORY_STATIC(meta_aggregate_debug);
 
 enum { PROP_0, PROP_ATTACH_TENSOR_DATA };
 
+enum {
+    PAD_PROP_0,
+    PAD_PROP_QUEUE_LENGTH,
+    PAD_PROP_MAX_QUEUE_LENGTH,
+    PAD_PROP_BUFFERS,
+    PAD_PROP_AVG_LATENCY,
+    PAD_PROP_MAX_LATENCY
+};
+
 #define DEFAULT_ATTACH_TENSOR_DATA TRUE
 
 // ---
@@ -56,11 +69,68 @@ class MetaAggregatePadPrivate {
         return _frame_info;
     }
 
+    // Called from pad probe in upstream streaming thread when buffer is queued on pad
+    void buffer_queued(guint num_buffers) {
+        GstClockTime now = gst_util_get_timestamp();
+        std::lock_guard<std::mutex> guard(_stats_mutex);
+        _arrival_times.insert(_arrival_times.end(), num_buffers, now);
+        _max_queue_length = std::max<guint>(_max_queue_length, _arrival_times.size());
+    }
+
+    // Called from aggregate thread when buffer is taken from pad queue
+    void buffer_dequeued() {
+        GstClockTime now = gst_util_get_timestamp();
+        std::lock_guard<std::mutex> guard(_stats_mutex);
+        if (_arrival_times.empty())
+            return;
+        GstClockTime latency = now - _arrival_times.front();
+        _arrival_times.pop_front();
+        _num_buffers++;
+        _total_latency += latency;
+        _max_latency = std::max(_max_latency, latency);
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> guard(_stats_mutex);
+        _arrival_times.clear();
+    }
+
+    void get_property(guint prop_id, GValue *value) {
+        std::lock_guard<std::mutex> guard(_stats_mutex);
+        switch (prop_id) {
+        case PAD_PROP_QUEUE_LENGTH:
+            g_value_set_uint(value, _arrival_times.size());
+            return;
+        case PAD_PROP_MAX_QUEUE_LENGTH:
+            g_value_set_uint(value, _max_queue_length);
+            return;
+        case PAD_PROP_BUFFERS:
+            g_value_set_uint64(value, _num_buffers);
+            return;
+        case PAD_PROP_AVG_LATENCY:
+            g_value_set_double(value,
+                               _num_buffers ? static_cast<double>(_total_latency) / _num_buffers / GST_MSECOND : 0);
+            return;
+        case PAD_PROP_MAX_LATENCY:
+            g_value_set_double(value, static_cast<double>(_max_latency) / GST_MSECOND);
+            return;
+        }
+        throw std::runtime_error("Invalid property " + std::to_string(prop_id));
+    }
+
   private:
     GstAggregatorPad *_mybase;
     bool _video_info_valid = false;
     GstVideoInfo _video_info;
     FrameInfo _frame_info;
+
+    // Statistics. Arrival times of queued buffers, buffers are taken from pad queue in FIFO order
+    std::mutex _stats_mutex;
+    std::deque<GstClockTime> _arrival_times;
+    guint _max_queue_length = 0;
+    guint64 _num_buffers = 0;
+    GstClockTime _total_latency = 0;
+    GstClockTime _max_latency = 0;
 };
 
 // Define type after private data
@@ -70,12 +140,35 @@ static void meta_aggregate_pad_init(MetaAggregatePad *self) {
     // Intialization of private data
     auto *priv_memory = meta_aggregate_pad_get_instance_private(self);
     self->impl = new (priv_memory) MetaAggregatePadPrivate(&self->parent);
+
+    // Track buffers arrival for latency and queue length statistics
+    gst_pad_add_probe(
+        GST_PAD(self), static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+        [](GstPad *pad, GstPadProbeInfo *info, gpointer) {
+            guint num_buffers = (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+                                    ? gst_buffer_list_length(GST_PAD_PROBE_INFO_BUFFER_LIST(info))
+                                    : 1;
+            GST_META_AGGREGATE_PAD(pad)->impl->buffer_queued(num_buffers);
+            return GST_PAD_PROBE_OK;
+        },
+        nullptr, nullptr);
 }
 
 void meta_aggregate_pad_finalize(GObject *object) {
     MetaAggregatePad *pad = GST_META_AGGREGATE_PAD(object);
     g_assert(pad->impl);
 
+    if (pad->impl) {
+        guint64 buffers;
+        gdouble avg_latency, max_latency;
+        guint max_queue_length;
+        g_object_get(object, "buffers", &buffers, "avg-latency", &avg_latency, "max-latency", &max_latency,
+                     "max-queue-length", &max_queue_length, nullptr);
+        GST_INFO_OBJECT(pad,
+                        "buffers=%" G_GUINT64_FORMAT " avg-latency=%.3f ms max-latency=%.3f ms max-queue-length=%u",
+                        buffers, avg_latency, max_latency, max_queue_length);
+    }
+
     if (pad->impl) {
         pad->impl->~MetaAggregatePadPrivate();
         pad->impl = nullptr;
@@ -86,7 +179,35 @@ void meta_aggregate_pad_finalize(GObject *object) {
 
 static void meta_aggregate_pad_class_init(MetaAggregatePadClass *klass) {
     GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+    GstAggregatorPadClass *aggregator_pad_class = GST_AGGREGATOR_PAD_CLASS(klass);
     gobject_class->finalize = meta_aggregate_pad_finalize;
+    gobject_class->get_property = [](GObject *object, guint prop_id, GValue *value, GParamSpec *) {
+        GST_META_AGGREGATE_PAD(object)->impl->get_property(prop_id, value);
+    };
+    aggregator_pad_class->flush = [](GstAggregatorPad *pad, GstAggregator *) {
+        GST_META_AGGREGATE_PAD(pad)->impl->flush();
+        return GST_FLOW_OK;
+    };
+
+    auto flags = static_cast<GParamFlags>(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_property(gobject_class, PAD_PROP_QUEUE_LENGTH,
+                                    g_param_spec_uint("queue-length", "Queue length", "Number of buffers queued on pad",
+                                                      0, G_MAXUINT, 0, flags));
+    g_object_class_install_property(gobject_class, PAD_PROP_MAX_QUEUE_LENGTH,
+                                    g_param_spec_uint("max-queue-length", "Max queue length",
+                                                      "Maximum number of buffers queued on pad", 0, G_MAXUINT, 0,
+                                                      flags));
+    g_object_class_install_property(gobject_class, PAD_PROP_BUFFERS,
+                                    g_param_spec_uint64("buffers", "Buffers", "Number of buffers taken from pad", 0,
+                                                        G_MAXUINT64, 0, flags));
+    g_object_class_install_property(gobject_class, PAD_PROP_AVG_LATENCY,
+                                    g_param_spec_double("avg-latency", "Average latency",
+                                                        "Average time (ms) buffer waits on pad before aggregated", 0,
+                                                        G_MAXDOUBLE, 0, flags));
+    g_object_class_install_property(gobject_class, PAD_PROP_MAX_LATENCY,
+                                    g_param_spec_double("max-latency", "Max latency",
+                                                        "Maximum time (ms) buffer waits on pad before aggregated", 0,
+                                                        G_MAXDOUBLE, 0, flags));
 }
 
 // ----
@@ -217,10 +338,16 @@ class MetaAggregatePrivate {
     }
 
   private:
+    // Drops buffer at the head of pad queue and updates pad statistics
+    void dropBuffer_(MetaAggregatePad *pad) {
+        if (gst_aggregator_pad_drop_buffer(&pad->parent))
+            pad->impl->buffer_dequeued();
+    }
+
     GstFlowReturn finishCurrentBuffer_() {
         // ITT_TASK("Finish buffer");
         auto first_pad = firstSink();
-        gst_aggregator_pad_drop_buffer(&first_pad->parent);
+        dropBuffer_(first_pad);
         GST_DEBUG_OBJECT(mybase_, "Finish current buffer: ts=%" GST_TIME_FORMAT,
                          GST_TIME_ARGS(GST_BUFFER_PTS(current_buf_)));
         auto ret = gst_aggregator_finish_buffer(mybase_, current_buf_);
@@ -260,7 +387,7 @@ class MetaAggregatePrivate {
         time_start = gst_segment_to_running_time(&first_pad->parent.segment, GST_FORMAT_TIME, time_start);
         if (!GST_CLOCK_TIME_IS_VALID(time_start)) {
             GST_DEBUG_OBJECT(mybase_, "Buffer outside segment, dropping");
-            gst_aggregator_pad_drop_buffer(&first_pad->parent);
+            dropBuffer_(first_pad);
             return GST_AGGREGATOR_FLOW_NEED_DATA;
         }
 
@@ -351,7 +478,7 @@ class MetaAggregatePrivate {
             buf_time = gst_segment_to_running_time(&pad->parent.segment, GST_FORMAT_TIME, buf_time);
             if (!GST_CLOCK_TIME_IS_VALID(buf_time)) {
                 GST_DEBUG_OBJECT(mybase_, "Buffer %" GST_PTR_FORMAT " outside segment -> dropping", meta_buf);
-                gst_aggregator_pad_drop_buffer(&pad->parent);
+                dropBuffer_(pad);
                 gst_buffer_unref(meta_buf);
 
                 continue;
@@ -384,7 +511,7 @@ class MetaAggregatePrivate {
 
             if (gst_buffer_has_flags(meta_buf, GST_BUFFER_FLAG_GAP)) {
                 GST_DEBUG_OBJECT(mybase_, "Buffer %" GST_PTR_FORMAT " with GAP -> dropping", meta_buf);
-                gst_aggregator_pad_drop_buffer(&pad->parent);
+                dropBuffer_(pad);
                 gst_buffer_unref(meta_buf);
 
                 // FIXME:
@@ -396,7 +523,7 @@ class MetaAggregatePrivate {
             GST_DEBUG_OBJECT(mybase_, "Collecting metadata buffer %p %" GST_TIME_FORMAT " for current buffer %p",
                              meta_buf, GST_TIME_ARGS(buf_time), current_buf_);
 
-            gst_aggregator_pad_drop_buffer(&pad->parent);
+            dropBuffer_(pad);
 
             GstFramePtr frame;
             if (pad->impl->video_info()) {
@@ -410,7 +537,7 @@ class MetaAggregatePrivate {
             }
 
             if (frame)
-                current_meta_bufs_.push_back(std::move(frame));
+                addPendingMeta_(buf_time, std::move(frame));
             else
                 GST_ERROR_OBJECT(mybase_, "Failed to create internal frame object from buffer %p on pad %p", meta_buf,
                                  pad);
@@ -425,24 +552,53 @@ class MetaAggregatePrivate {
         return GST_FLOW_OK;
     }
 
+    void addPendingMeta_(GstClockTime running_time, GstFramePtr frame) {
+        // Per-ROI inference results are keyed by ROI id, full-frame results and video frames by zero id
+        int roi_id = 0;
+        if (frame->media_type() == MediaType::Tensors) {
+            auto source_id_meta = find_metadata<SourceIdentifierMetadata>(*frame);
+            if (source_id_meta)
+                roi_id = source_id_meta->roi_id();
+        }
+        pending_meta_[{running_time, roi_id}].push_back(std::move(frame));
+        num_pending_meta_++;
+    }
+
+    // Index of ROI metadata on current buffer by id, replaces linear search per ROI
+    void indexRois_() {
+        roi_index_.clear();
+        gpointer state = nullptr;
+        GstMeta *meta;
+        while ((meta = gst_buffer_iterate_meta_filtered(current_buf_, &state,
+                                                        GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE))) {
+            auto roi_meta = reinterpret_cast<GstVideoRegionOfInterestMeta *>(meta);
+            roi_index_[roi_meta->id] = roi_meta;
+        }
+    }
+
     void mergeMetadata() {
         g_assert(current_buf_);
 
         current_buf_ = gst_buffer_make_writable(current_buf_);
 
-        GST_DEBUG_OBJECT(mybase_, "Merging %lu buffers w/meta to buffer %p ts=%" GST_TIME_FORMAT,
-                         current_meta_bufs_.size(), current_buf_, GST_TIME_ARGS(GST_BUFFER_PTS(current_buf_)));
-        while (!current_meta_bufs_.empty()) {
-            auto meta_frame = current_meta_bufs_.front();
-            current_meta_bufs_.pop_front();
-
-            if (!mergeMetaFromFrame(std::move(meta_frame))) {
-                GST_WARNING_OBJECT(mybase_, "Failed to merge metadata");
+        GST_DEBUG_OBJECT(mybase_, "Merging %lu buffers w/meta to buffer %p ts=%" GST_TIME_FORMAT, num_pending_meta_,
+                         current_buf_, GST_TIME_ARGS(GST_BUFFER_PTS(current_buf_)));
+        indexRois_();
+        // Ordered by timestamp, then full-frame metadata (which may add ROIs) before per-ROI metadata
+        for (auto &pending : pending_meta_) {
+            int roi_id = pending.first.second;
+            for (auto &meta_frame : pending.second) {
+                if (!mergeMetaFromFrame(std::move(meta_frame), roi_id)) {
+                    GST_WARNING_OBJECT(mybase_, "Failed to merge metadata");
+                }
             }
         }
+        pending_meta_.clear();
+        num_pending_meta_ = 0;
+        roi_index_.clear();
     }
 
-    bool mergeMetaFromFrame(GstFramePtr dls_buf_with_meta) {
+    bool mergeMetaFromFrame(GstFramePtr dls_buf_with_meta, int roi_id) {
         g_assert(current_buf_);
         g_assert(gst_buffer_is_writable(current_buf_) && "Current buffer from video pad is not writable");
 
@@ -451,7 +607,7 @@ class MetaAggregatePrivate {
             return mergeMetaFromVideoFrame(std::move(dls_buf_with_meta));
 
         case MediaType::Tensors:
-            return mergeMetaFromTensorFrame(std::move(dls_buf_with_meta));
+            return mergeMetaFromTensorFrame(std::move(dls_buf_with_meta), roi_id);
 
         default:
             break;
@@ -460,7 +616,17 @@ class MetaAggregatePrivate {
         return false;
     }
 
+    GstVideoRegionOfInterestMeta *addRoi_(const gchar *label) {
+        GstVideoRegionOfInterestMeta *roi_meta =
+            gst_buffer_add_video_region_of_interest_meta(current_buf_, label, 0, 0, 0, 0);
+        roi_meta->id = gst_util_seqnum_next();
+        roi_index_[roi_meta->id] = roi_meta;
+        return roi_meta;
+    }
+
     bool mergeMetaFromVideoFrame(GstFramePtr frame) {
+        // If we hold the only reference to the buffer, move structures instead of copying
+        const bool take_ownership = gst_buffer_is_writable(frame->gst_buffer());
         gpointer state = nullptr;
         GstMeta *meta;
         while ((meta = gst_buffer_iterate_meta_filtered(frame->gst_buffer(), &state,
@@ -477,36 +643,34 @@ class MetaAggregatePrivate {
                 continue;
             }
 
-            // FIXME: avoid copy by taking ownership?
-            structure = gst_structure_copy(structure);
+            if (take_ownership)
+                roi_meta_to_merge->params = g_list_remove(roi_meta_to_merge->params, structure);
+            else
+                structure = gst_structure_copy(structure);
             const gchar *label = gst_structure_get_string(structure, "label");
             if (!label)
                 label = g_quark_to_string(roi_meta_to_merge->roi_type);
 
-            GstVideoRegionOfInterestMeta *roi_meta =
-                gst_buffer_add_video_region_of_interest_meta(current_buf_, label, 0, 0, 0, 0);
+            GstVideoRegionOfInterestMeta *roi_meta = addRoi_(label);
 
             // FIXME: scale ?
 
             gst_video_region_of_interest_meta_add_param(roi_meta, structure);
-            roi_meta->id = gst_util_seqnum_next();
         }
 
         return true;
     }
 
-    bool mergeMetaFromTensorFrame(GstFramePtr meta_frame) {
+    bool mergeMetaFromTensorFrame(GstFramePtr meta_frame, int roi_id) {
         g_assert(meta_frame && "Meta frame must be valid");
-        // Find SourceIdentifierMetadata and corresponding ROI meta if inference-region=per-roi
+        // Find ROI meta corresponding to SourceIdentifierMetadata if inference-region=per-roi
         GstVideoRegionOfInterestMeta *parent_roi_meta = nullptr;
-        auto source_id_meta = find_metadata<SourceIdentifierMetadata>(*meta_frame);
-        if (source_id_meta) {
-            int roi_id = source_id_meta->roi_id();
-            if (roi_id != GST_SEQNUM_INVALID) { // non-zero
-                parent_roi_meta = gst_buffer_get_video_region_of_interest_meta_id(current_buf_, roi_id);
-                if (!parent_roi_meta)
-                    GST_WARNING_OBJECT(mybase_, "Can't find ROI by id: %d", roi_id);
-            }
+        if (roi_id != GST_SEQNUM_INVALID) { // non-zero
+            auto it = roi_index_.find(roi_id);
+            if (it != roi_index_.end())
+                parent_roi_meta = it->second;
+            else
+                GST_WARNING_OBJECT(mybase_, "Can't find ROI by id: %d", roi_id);
         }
 
         std::vector<std::string> output_layers;
@@ -514,25 +678,34 @@ class MetaAggregatePrivate {
         if (model_info_meta)
             output_layers = model_info_meta->output_layers();
 
+        // If we hold the only reference to the buffer, take ownership of GstStructure instead of copying
+        const bool take_ownership = gst_buffer_is_writable(meta_frame->gst_buffer());
+        std::shared_ptr<AffineTransformInfoMetadata> affine_transform;
+        FramePtr cpu_buffer;
+        detections_.clear();
+
         GstGVATensorMeta *custom_meta;
         gpointer state = nullptr;
         while ((custom_meta = GST_GVA_TENSOR_META_ITERATE(meta_frame->gst_buffer(), &state))) {
+            if (!custom_meta->data)
+                continue;
             std::string name = g_quark_to_string(custom_meta->data->name);
             // Skip utility metadata-s
             if (name == SourceIdentifierMetadata::name || name == ModelInfoMetadata::name ||
                 name == AffineTransformInfoMetadata::name)
                 continue;
-#if 0
-            // Take ownership of GstStructure
-            GstStructure *out_tensor_data = custom_meta->data;
-            custom_meta->data = nullptr;
-#else
-            GstStructure *out_tensor_data = gst_structure_copy(custom_meta->data);
-#endif
+            GstStructure *out_tensor_data;
+            if (take_ownership) {
+                out_tensor_data = custom_meta->data;
+                custom_meta->data = nullptr;
+            } else {
+                out_tensor_data = gst_structure_copy(custom_meta->data);
+            }
 
             // Copy tensor data to GstStructure if requested by property and tensor data not attached yet
             if (attach_tensor_data_ && !gst_structure_has_field(out_tensor_data, "data_buffer")) {
-                FramePtr cpu_buffer = gst_to_cpu_.map(meta_frame, AccessMode::Read);
+                if (!cpu_buffer)
+                    cpu_buffer = gst_to_cpu_.map(meta_frame, AccessMode::Read);
                 for (size_t i = 0; i < cpu_buffer->num_tensors(); i++) {
                     InferenceResultMetadata inference_meta(std::make_shared<GSTDictionary>(out_tensor_data));
                     std::string layer_name = (i < output_layers.size()) ? output_layers[i] : "";
@@ -542,15 +715,14 @@ class MetaAggregatePrivate {
             // Attach to output buffer
             if (name == DetectionMetadata::name) { // attach as GstVideoRegionOfInterestMeta
                 auto label = gst_structure_get_string(out_tensor_data, DetectionMetadata::key::label);
-                GstVideoRegionOfInterestMeta *roi_meta =
-                    gst_buffer_add_video_region_of_interest_meta(current_buf_, label, 0, 0, 0, 0);
-
-                auto affine_transform = find_metadata<AffineTransformInfoMetadata>(*meta_frame);
+                GstVideoRegionOfInterestMeta *roi_meta = addRoi_(label);
+                if (detections_.empty())
+                    affine_transform = find_metadata<AffineTransformInfoMetadata>(*meta_frame);
 
-                scaleRoi_(roi_meta, out_tensor_data, nullptr, affine_transform.get());
+                // coordinates of all detections are scaled in one pass after the loop
+                detections_.push_back({roi_meta, out_tensor_data});
 
                 gst_video_region_of_interest_meta_add_param(roi_meta, out_tensor_data);
-                roi_meta->id = gst_util_seqnum_next();
                 if (parent_roi_meta)
                     roi_meta->parent_id = parent_roi_meta->id;
             } else { // attach as GstGVATensorMeta (full-frame) or param in GstVideoRegionOfInterestMeta (per-roi)
@@ -565,69 +737,75 @@ class MetaAggregatePrivate {
             }
         }
 
-        return true;
-    }
+        if (!detections_.empty())
+            scaleRois_(detections_, nullptr, affine_transform.get());
 
-    std::pair<double, double> applyMatrix(double x, double y, double *m) { // 3x2 matrix
-        double xx = x * m[0] + y * m[1] + m[2];
-        double yy = x * m[3] + y * m[4] + m[5];
-        return {xx, yy};
+        return true;
     }
 
-    void scaleRoi_(GstVideoRegionOfInterestMeta *roi_meta, GstStructure *detection,
-                   GstVideoRegionOfInterestMeta *parent_roi, AffineTransformInfoMetadata *affine_transform = nullptr) {
-        g_assert(detection);
-        g_assert(roi_meta);
-
-        const GstVideoInfo *video_info = &video_info_;
+    struct Detection {
+        GstVideoRegionOfInterestMeta *roi_meta;
+        GstStructure *structure;
+    };
 
-        double x_min, x_max, y_min, y_max;
-        gst_structure_get_double(detection, DetectionMetadata::key::x_min, &x_min);
-        gst_structure_get_double(detection, DetectionMetadata::key::x_max, &x_max);
-        gst_structure_get_double(detection, DetectionMetadata::key::y_min, &y_min);
-        gst_structure_get_double(detection, DetectionMetadata::key::y_max, &y_max);
+    // Scales all detections from one tensor frame in single pass: coordinates are gathered into arrays, transformed
+    // and clipped by BoxBatch helpers (auto-vectorized), then stored into ROI metas and detection structures
+    void scaleRois_(const std::vector<Detection> &detections, GstVideoRegionOfInterestMeta *parent_roi,
+                    AffineTransformInfoMetadata *affine_transform = nullptr) {
+        const size_t n = detections.size();
+        BoxBatch &boxes = boxes_;
+        boxes.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            GstStructure *detection = detections[i].structure;
+            g_assert(detection);
+            gst_structure_get_double(detection, DetectionMetadata::key::x_min, &boxes.x_min[i]);
+            gst_structure_get_double(detection, DetectionMetadata::key::x_max, &boxes.x_max[i]);
+            gst_structure_get_double(detection, DetectionMetadata::key::y_min, &boxes.y_min[i]);
+            gst_structure_get_double(detection, DetectionMetadata::key::y_max, &boxes.y_max[i]);
+        }
 
         // In case affine transform was applied (resize, crop, rotate, etc), multiply coordinates by transform matrix
+        BoxTransform transform;
         if (affine_transform) {
             auto matrix = affine_transform->matrix();
             if (matrix.size() < 6)
                 throw std::runtime_error("Expect AffineTransformInfoMetadata with matrix size equal to 6");
-            std::tie(x_min, y_min) = applyMatrix(x_min, y_min, matrix.data());
-            std::tie(x_max, y_max) = applyMatrix(x_max, y_max, matrix.data());
+            std::copy_n(matrix.begin(), 6, transform.m.begin());
         }
 
-        // clip to [0, 1] range
-        if (!((x_min >= 0) && (y_min >= 0) && (x_max <= +1) && (y_max <= +1))) {
-            GST_DEBUG_OBJECT(
-                mybase_, "ROI coordinates x=[%.5f, %.5f], y=[%.5f, %.5f] are out of range [0,1] and will be clipped",
-                x_min, x_max, y_min, y_max);
-            x_min = std::clamp(x_min, 0., 1.);
-            y_min = std::clamp(y_min, 0., 1.);
-            x_max = std::clamp(x_max, 0., 1.);
-            y_max = std::clamp(y_max, 0., 1.);
-        }
+        size_t num_clipped = transform_and_clip(boxes, transform);
+        if (num_clipped)
+            GST_DEBUG_OBJECT(mybase_, "Coordinates of %zu ROI(s) were out of range [0,1] and clipped", num_clipped);
 
         /* calculate scaled coords */
+        const GstVideoInfo *video_info = &video_info_;
         auto parent_width = parent_roi ? parent_roi->w : video_info->width;
         auto parent_height = parent_roi ? parent_roi->h : video_info->height;
         auto x_offset = parent_roi ? parent_roi->x : 0;
         auto y_offset = parent_roi ? parent_roi->y : 0;
-        roi_meta->x = static_cast<uint32_t>(x_min * parent_width + 0.5) + x_offset;
-        roi_meta->y = static_cast<uint32_t>(y_min * parent_height + 0.5) + y_offset;
-        roi_meta->w = static_cast<uint32_t>((x_max - x_min) * parent_width + 0.5);
-        roi_meta->h = static_cast<uint32_t>((y_max - y_min) * parent_height + 0.5);
-
-        if (parent_roi) {
-            // In case of parent roi we need to change detection values relative to full frame
-            x_min = std::clamp(roi_meta->x / static_cast<double>(video_info->width), 0., 1.);
-            y_min = std::clamp(roi_meta->y / static_cast<double>(video_info->height), 0., 1.);
-            x_max = std::clamp((roi_meta->x + roi_meta->w) / static_cast<double>(video_info->width), 0., 1.);
-            y_max = std::clamp((roi_meta->y + roi_meta->h) / static_cast<double>(video_info->height), 0., 1.);
-        }
+        to_absolute(boxes, parent_width, parent_height, x_offset, y_offset);
+        for (size_t i = 0; i < n; i++) {
+            GstVideoRegionOfInterestMeta *roi_meta = detections[i].roi_meta;
+            g_assert(roi_meta);
+            roi_meta->x = boxes.x[i];
+            roi_meta->y = boxes.y[i];
+            roi_meta->w = boxes.w[i];
+            roi_meta->h = boxes.h[i];
+
+            if (parent_roi) {
+                // In case of parent roi we need to change detection values relative to full frame
+                const double width = video_info->width, height = video_info->height;
+                boxes.x_min[i] = std::clamp(roi_meta->x / width, 0., 1.);
+                boxes.y_min[i] = std::clamp(roi_meta->y / height, 0., 1.);
+                boxes.x_max[i] = std::clamp((roi_meta->x + roi_meta->w) / width, 0., 1.);
+                boxes.y_max[i] = std::clamp((roi_meta->y + roi_meta->h) / height, 0., 1.);
+            }
 
-        gst_structure_set(detection, DetectionMetadata::key::x_min, G_TYPE_DOUBLE, x_min, DetectionMetadata::key::x_max,
-                          G_TYPE_DOUBLE, x_max, DetectionMetadata::key::y_min, G_TYPE_DOUBLE, y_min,
-                          DetectionMetadata::key::y_max, G_TYPE_DOUBLE, y_max, NULL);
+            gst_structure_set(detections[i].structure, DetectionMetadata::key::x_min, G_TYPE_DOUBLE, boxes.x_min[i],
+                              DetectionMetadata::key::x_max, G_TYPE_DOUBLE, boxes.x_max[i],
+                              DetectionMetadata::key::y_min, G_TYPE_DOUBLE, boxes.y_min[i],
+                              DetectionMetadata::key::y_max, G_TYPE_DOUBLE, boxes.y_max[i], NULL);
+        }
     }
 
   private:
@@ -640,7 +818,12 @@ class MetaAggregatePrivate {
     GstClockTime current_running_time_ = GST_CLOCK_TIME_NONE;
     GstClockTime current_running_time_end_ = GST_CLOCK_TIME_NONE;
 
-    std::list<GstFramePtr> current_meta_bufs_;
+    // Metadata frames pending merge into current buffer, indexed by (running time, ROI id)
+    std::map<std::pair<GstClockTime, int>, std::vector<GstFramePtr>> pending_meta_;
+    size_t num_pending_meta_ = 0;
+    std::unordered_map<int, GstVideoRegionOfInterestMeta *> roi_index_;
+    std::vector<Detection> detections_;
+    BoxBatch boxes_;
 
     uint32_t request_pad_counters_[std::size(request_templs)] = {};
     MemoryMapperGSTToCPU gst_to_cpu_;
@@ -1,165 +1,343 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
 
-#include <functional>
 #include <gst/gst.h>
 #include <gst/gsttracer.h>
-#include <map>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
 #include <memory>
-#include <set>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #define ELEMENT_DESCRIPTION "Buffers tracing - gst_pad_push statistic"
 
+// Tracer parameters, for example GST_TRACERS="buffer_tracer(interval=5000)"
+#define DEFAULT_INTERVAL_MS 2000
+#define SAMPLING_PERIOD_MS 50
+#define SAMPLING_RING_SIZE 64
+
 template <class T>
 using auto_ptr = std::unique_ptr<T, std::function<void(T *)>>;
 
+static GQuark link_quark = g_quark_from_static_string("buffer_tracer_link");
+static GQuark element_quark = g_quark_from_static_string("buffer_tracer_element");
+
+/*
+ * Push path (pad-push-pre hook) does constant amount of atomic increments on statistic objects cached in pad's qdata,
+ * without locks and memory allocations. Statistic objects are created once per pad/element on first buffer (or after
+ * pad re-link) under mutex. Separate thread periodically samples in-flight counters into fixed-size rings and prints
+ * aggregated statistic, so memory doesn't depend on number of buffers passed through pipeline.
+ * Statistic objects are reference counted, referenced by registry and by qdata of pad/element (and link statistic
+ * references statistic of its elements), so they outlive tracer if pads and elements do. Statistic of dead link is
+ * removed from registry once push calls which could read it from qdata before it died have returned (epoch-based
+ * reclamation, see enter/leave).
+ */
 struct BufferStatistic {
-    struct ElementStatistic {
-        std::set<GstBuffer *> input_buffer_pool;
-        std::set<GstBuffer *> output_buffer_pool;
-        int num_buffers = 0;
-        double start_time = 0;
-        double last_time = 0;
-        double total = 0;
+    // Aligned to cache line so counters updated from different streaming threads don't share cache line
+    struct alignas(64) ElementStatistic {
+        std::atomic<uint64_t> input_buffers{0};
+        std::atomic<uint64_t> output_buffers{0};
+        std::atomic<bool> alive{true};
         std::string name;
+        // Reference held by element qdata, released by its destroy-notify
+        std::shared_ptr<ElementStatistic> qdata_ref;
+
+        // Accessed from aggregation thread only
+        std::array<int64_t, SAMPLING_RING_SIZE> in_flight_ring = {};
+        size_t num_samples = 0;
+        uint64_t last_output_buffers = 0;
+
+        // Number of buffers received by element and not yet pushed downstream. Meaningful only for elements having
+        // both input and output (not for sources and sinks), and only if element doesn't merge or split buffers.
+        bool has_in_flight() const {
+            return input_buffers.load(std::memory_order_relaxed) && output_buffers.load(std::memory_order_relaxed);
+        }
+        int64_t in_flight() const {
+            // load output first, so concurrent push can't make value negative
+            int64_t output = output_buffers.load(std::memory_order_relaxed);
+            int64_t input = input_buffers.load(std::memory_order_relaxed);
+            return std::max<int64_t>(input - output, 0);
+        }
 
-        std::set<ElementStatistic *> next;
-        bool printed = false;
-
-        void Update(GstBuffer *buffer, double ts, int inc) {
-            if (start_time == 0) {
-                start_time = ts;
-                last_time = ts;
-            }
-            if (inc > 0)
-                input_buffer_pool.insert(buffer);
-            if (inc < 0)
-                output_buffer_pool.insert(buffer);
-
-            total += (ts - last_time) * num_buffers;
-            num_buffers += inc;
-            last_time = ts;
+        void Sample() {
+            in_flight_ring[num_samples++ % SAMPLING_RING_SIZE] = in_flight();
         }
 
-        void Print() {
-            if (printed)
+        void Print(double elapsed_sec) {
+            uint64_t output = output_buffers.load(std::memory_order_relaxed);
+            double fps = (output - last_output_buffers) / elapsed_sec;
+            last_output_buffers = output;
+            if (!has_in_flight()) {
+                printf("%70s, %-9s, %-9s, %-9s, %9.2f\n", name.data(), "-", "-", "-", fps);
                 return;
-            std::string buffer_pool_size;
-            if (output_buffer_pool.size() != input_buffer_pool.size() ||
-                !equal(output_buffer_pool.begin(), output_buffer_pool.end(), input_buffer_pool.begin())) {
-                buffer_pool_size = std::to_string(output_buffer_pool.size());
             }
-            double average = (total > 0) ? total / (last_time - start_time) : 0;
-            printf("%70s, %-7s, %-7d, %7.2f\n", name.data(), buffer_pool_size.data(), num_buffers, average);
-            printed = true;
-
-            for (auto elem : next) {
-                elem->Print();
+            size_t n = std::min<size_t>(num_samples, SAMPLING_RING_SIZE);
+            int64_t sum = 0, max = 0;
+            for (size_t i = 0; i < n; i++) {
+                sum += in_flight_ring[i];
+                max = std::max(max, in_flight_ring[i]);
             }
+            double average = n ? static_cast<double>(sum) / n : 0;
+            printf("%70s, %-9ld, %-9.2f, %-9ld, %9.2f\n", name.data(), static_cast<long>(in_flight()), average,
+                   static_cast<long>(max), fps);
         }
     };
+    using ElementStatisticPtr = std::shared_ptr<ElementStatistic>;
+
+    struct alignas(64) LinkStatistic {
+        std::atomic<uint64_t> buffers{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<bool> alive{true};
+
+        // Peer pad at the moment of link registration, compared on push path to detect re-link
+        GstPad *peer = nullptr;
+        // Element owning the pad and real element behind ghost pad (if any), on upstream and downstream side
+        std::array<ElementStatisticPtr, 2> upstream;
+        std::array<ElementStatisticPtr, 2> downstream;
+        std::string name;
+        // Reference held by pad qdata, released by its destroy-notify
+        std::shared_ptr<LinkStatistic> qdata_ref;
+
+        // Accessed from aggregation thread only
+        uint64_t last_buffers = 0;
+        uint64_t last_bytes = 0;
+
+        void Update(uint64_t num_buffers, uint64_t num_bytes) {
+            buffers.fetch_add(num_buffers, std::memory_order_relaxed);
+            bytes.fetch_add(num_bytes, std::memory_order_relaxed);
+            for (auto &elem : upstream)
+                if (elem)
+                    elem->output_buffers.fetch_add(num_buffers, std::memory_order_relaxed);
+            for (auto &elem : downstream)
+                if (elem)
+                    elem->input_buffers.fetch_add(num_buffers, std::memory_order_relaxed);
+        }
 
-    std::map<GstElement *, ElementStatistic> _stat;
-    std::set<GstBin *> all_bins;
-    double last_printing_ts = 0;
-
-    void register_bin(GstPad *pad) {
-        auto elem = auto_ptr<GstElement>(gst_pad_get_parent_element(pad), gst_object_unref);
-        if (elem && GST_IS_BIN(elem.get()))
-            all_bins.insert(GST_BIN(elem.get()));
-    }
-
-    static int cmp_ptr(gconstpointer a, gconstpointer b) {
-        const GValue *item = (const GValue *)a;
-        GstElement *elem = GST_ELEMENT(g_value_get_object(item));
-        if (elem == b)
-            return 0;
-        else
-            return 1;
-    }
-
-    std::string find_upper_bins(GstElement *element) {
-        std::string str;
-        for (auto bin : all_bins) {
-            auto iter = gst_bin_iterate_recurse(bin);
-            GValue val = {};
-            if (gst_iterator_find_custom(iter, cmp_ptr, &val, (gpointer)element)) {
-                auto name = gst_element_get_name(bin);
-                str += std::string(name) + std::string(" / ");
-                g_free(name);
-            }
-            g_value_unset(&val);
-            gst_iterator_free(iter);
+        void Print(double elapsed_sec) {
+            uint64_t cur_buffers = buffers.load(std::memory_order_relaxed);
+            uint64_t cur_bytes = bytes.load(std::memory_order_relaxed);
+            printf("%70s, %9.2f, %9.2f\n", name.data(), (cur_buffers - last_buffers) / elapsed_sec,
+                   (cur_bytes - last_bytes) / elapsed_sec / (1024 * 1024));
+            last_buffers = cur_buffers;
+            last_bytes = cur_bytes;
         }
-        return str;
+    };
+    using LinkStatisticPtr = std::shared_ptr<LinkStatistic>;
+
+    // Registry, modified on slow path (first buffer on pad) and in aggregation thread
+    std::mutex _mutex;
+    std::list<ElementStatisticPtr> _elements;
+    std::list<LinkStatisticPtr> _links;
+    // Dead links removed from registry, released once push calls counted in epoch _retired_epoch have returned
+    std::list<LinkStatisticPtr> _retired;
+    uint64_t _retired_epoch = 0;
+
+    // Push calls in progress, counted by parity of epoch they entered in
+    std::atomic<uint64_t> _epoch{0};
+    std::array<std::atomic<uint64_t>, 2> _readers = {};
+
+    std::thread _thread;
+    std::mutex _thread_mutex;
+    std::condition_variable _thread_cv;
+    bool _stop = false;
+
+    // qdata destroy-notify, called when pad or element finalized (or link replaced after re-link). Releases reference
+    // held by qdata, so statistic is released here if tracer is already finalized
+    static void release_link(gpointer data) {
+        auto link = static_cast<LinkStatistic *>(data);
+        link->alive.store(false);
+        LinkStatisticPtr ref = std::move(link->qdata_ref);
+    }
+    static void release_element(gpointer data) {
+        auto elem = static_cast<ElementStatistic *>(data);
+        elem->alive.store(false);
+        ElementStatisticPtr ref = std::move(elem->qdata_ref);
     }
 
-    void set_name(GstElement *elem) {
-        auto p = &_stat[elem];
-        if (p->name.empty()) {
-            auto g_name = gst_element_get_name(elem);
-            p->name = find_upper_bins(elem) + std::string(g_name);
-            g_free(g_name);
+    // Element name prefixed with names of all bins containing element, except top-level pipeline
+    static std::string full_name(GstElement *element) {
+        auto g_name = gst_element_get_name(element);
+        std::string str = g_name;
+        g_free(g_name);
+        auto parent = auto_ptr<GstObject>(gst_object_get_parent(GST_OBJECT(element)), gst_object_unref);
+        while (parent) {
+            auto grandparent = auto_ptr<GstObject>(gst_object_get_parent(parent.get()), gst_object_unref);
+            if (!grandparent)
+                break;
+            auto bin_name = gst_object_get_name(parent.get());
+            str = std::string(bin_name) + " / " + str;
+            g_free(bin_name);
+            parent = std::move(grandparent);
         }
+        return str;
     }
 
-    void pad_push_event(GstClockTime clock_ts, GstPad *_pad, GstBuffer *buffer) {
-        if (!_pad)
-            return;
+    // Called with _mutex locked
+    ElementStatisticPtr get_element_statistic(GstElement *element) {
+        auto p = static_cast<ElementStatistic *>(g_object_get_qdata(G_OBJECT(element), element_quark));
+        if (p)
+            return p->qdata_ref;
+        auto elem = std::make_shared<ElementStatistic>();
+        elem->name = full_name(element);
+        elem->qdata_ref = elem;
+        _elements.push_back(elem);
+        g_object_set_qdata_full(G_OBJECT(element), element_quark, elem.get(), release_element);
+        return elem;
+    }
+
+    // Element owning pad and real element behind chain of ghost pads, nullptr if same element
+    std::array<ElementStatisticPtr, 2> get_pad_elements(GstPad *_pad) {
+        std::array<ElementStatisticPtr, 2> ret;
         auto pad = auto_ptr<GstPad>((GstPad *)gst_object_ref(_pad), gst_object_unref);
-        double ts = clock_ts * 1e-9;
+        auto elem = auto_ptr<GstElement>(gst_pad_get_parent_element(pad.get()), gst_object_unref);
+        if (elem)
+            ret[0] = get_element_statistic(elem.get());
+
+        // try go from bin element to real element
+        while (pad && GST_IS_GHOST_PAD(pad.get())) {
+            pad = auto_ptr<GstPad>(gst_ghost_pad_get_target(GST_GHOST_PAD(pad.get())), gst_object_unref);
+        }
+        if (!pad)
+            return ret;
+        auto elem2 = auto_ptr<GstElement>(gst_pad_get_parent_element(pad.get()), gst_object_unref);
+        if (elem2 && elem2.get() != elem.get())
+            ret[1] = get_element_statistic(elem2.get());
+        return ret;
+    }
 
-        std::map<int, GstElement *> elements;
+    // Slow path: called on first buffer pushed through pad or after pad re-linked
+    LinkStatistic *register_link(GstPad *pad) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto link = std::make_shared<LinkStatistic>();
+        auto peer = auto_ptr<GstPad>(gst_pad_get_peer(pad), gst_object_unref);
+        link->peer = peer.get();
+        link->upstream = get_pad_elements(pad);
+        if (peer)
+            link->downstream = get_pad_elements(peer.get());
+
+        auto real = [](const std::array<ElementStatisticPtr, 2> &elements) -> std::string {
+            auto &elem = elements[1] ? elements[1] : elements[0];
+            return elem ? elem->name : std::string("?");
+        };
+        link->name = real(link->upstream) + " -> " + real(link->downstream);
+
+        link->qdata_ref = link;
+        _links.push_back(link);
+        // marks previous link statistic on this pad (if any) as dead
+        g_object_set_qdata_full(G_OBJECT(pad), link_quark, link.get(), release_link);
+        return link.get();
+    }
 
-        for (int inc = -1; inc <= 1; inc += 2) { // for [ upstream element, downstream element ]
-            if (!pad)
-                break;
-            register_bin(pad.get());
+    // Counts push call in readers of current epoch. Re-checks epoch after counting, so aggregation thread which
+    // advanced epoch and waits for readers of previous one either sees this call counted or this call enters new epoch
+    uint64_t enter() {
+        for (;;) {
+            const uint64_t epoch = _epoch.load();
+            _readers[epoch & 1].fetch_add(1);
+            if (_epoch.load() == epoch)
+                return epoch;
+            _readers[epoch & 1].fetch_sub(1);
+        }
+    }
 
-            auto elem = auto_ptr<GstElement>(gst_pad_get_parent_element(pad.get()), gst_object_unref);
-            if (elem)
-                _stat[elem.get()].Update(buffer, ts, inc);
+    void leave(uint64_t epoch) {
+        _readers[epoch & 1].fetch_sub(1);
+    }
 
-            // try go from bin element to real element
-            while (GST_IS_GHOST_PAD(pad.get())) {
-                pad = auto_ptr<GstPad>(gst_ghost_pad_get_target(GST_GHOST_PAD(pad.get())), gst_object_unref);
+    void pad_push_event(GstPad *pad, uint64_t num_buffers, uint64_t num_bytes) {
+        if (!pad)
+            return;
+        const uint64_t epoch = enter();
+        auto link = static_cast<LinkStatistic *>(g_object_get_qdata(G_OBJECT(pad), link_quark));
+        if (!link || link->peer != GST_PAD_PEER(pad))
+            link = register_link(pad);
+        link->Update(num_buffers, num_bytes);
+        leave(epoch);
+    }
+
+    // Called with _mutex locked. Dead links are unreachable from qdata, but push call which read link from qdata
+    // before re-link may still update it. Links retired in previous epoch are released once its readers have left,
+    // then dead links are retired and epoch is advanced, so readers of retired links are counted in previous epoch
+    void reclaim() {
+        if (!_retired.empty() && _readers[_retired_epoch & 1].load() == 0)
+            _retired.clear();
+        if (!_retired.empty())
+            return;
+        for (auto it = _links.begin(); it != _links.end();) {
+            if ((*it)->alive.load()) {
+                ++it;
+                continue;
             }
-            auto elem2 = auto_ptr<GstElement>(gst_pad_get_parent_element(pad.get()), gst_object_unref);
-            if (elem2 && elem2.get() != elem.get())
-                _stat[elem2.get()].Update(buffer, ts, inc);
+            _retired.push_back(std::move(*it));
+            it = _links.erase(it);
+        }
+        if (!_retired.empty())
+            _retired_epoch = _epoch.fetch_add(1);
+    }
 
-            elements[inc] = elem2.get();
+    void sample() {
+        std::lock_guard<std::mutex> guard(_mutex);
+        for (auto &elem : _elements)
+            elem->Sample();
+    }
 
-            // switch from upstream element to downstream element
-            pad = auto_ptr<GstPad>(gst_pad_get_peer(_pad), gst_object_unref);
-        }
+    void print(double elapsed_sec) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        printf("%70s, %-9s, %-9s, %-9s, %-9s\n", "BIN NAME / ELEMENT NAME", "IN-FLIGHT", "AVERAGE", "MAX",
+               "BUFFERS/S");
+        printf("%70s, %-9s, %-9s, %-9s, %-9s\n", "------------------------------------------", "-----", "-----",
+               "-----", "-----");
+        for (auto &elem : _elements)
+            elem->Print(elapsed_sec);
+        printf("%70s, %-9s, %-9s\n", "LINK", "BUFFERS/S", "MB/S");
+        printf("%70s, %-9s, %-9s\n", "------------------------------------------", "-----", "-----");
+        for (auto &link : _links)
+            if (link->alive.load())
+                link->Print(elapsed_sec);
+
+        // Remove statistic of destroyed pads and elements, element statistic is released with last link referencing it
+        reclaim();
+        _elements.remove_if([](const ElementStatisticPtr &elem) { return !elem->alive.load(); });
+    }
 
-        if (elements[-1] && elements[1])
-            _stat[elements[-1]].next.insert(&_stat[elements[1]]);
-
-        if (!last_printing_ts)
-            last_printing_ts = ts;
-        if (ts - last_printing_ts > 2) {
-            printf("%70s, %-7s, %-7s, %-7s\n", "BIN NAME / ELEMENT NAME", "POOL", "BUFFERS", "AVERAGE BUFFERS");
-            printf("%70s, %-7s, %-7s, %-7s\n", "------------------------------------------", "-----", "-----", "-----");
-            for (auto &stat : _stat) {
-                set_name(stat.first);
-                stat.second.printed = false;
-            }
-            for (auto &stat : _stat) {
-                if (stat.second.name.find("demux") != std::string::npos) {
-                    stat.second.Print();
-                }
+    void aggregation_loop(int interval_ms) {
+        using clock = std::chrono::steady_clock;
+        auto last_printing = clock::now();
+        std::unique_lock<std::mutex> lock(_thread_mutex);
+        while (!_thread_cv.wait_for(lock, std::chrono::milliseconds(SAMPLING_PERIOD_MS), [this] { return _stop; })) {
+            sample();
+            auto now = clock::now();
+            std::chrono::duration<double> elapsed = now - last_printing;
+            if (elapsed.count() * 1000 >= interval_ms) {
+                print(elapsed.count());
+                last_printing = now;
             }
-            for (auto &stat : _stat)
-                stat.second.Print();
-            last_printing_ts = ts;
         }
     }
+
+    void start(int interval_ms) {
+        _thread = std::thread(&BufferStatistic::aggregation_loop, this, interval_ms);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> guard(_thread_mutex);
+            _stop = true;
+        }
+        _thread_cv.notify_all();
+        if (_thread.joinable())
+            _thread.join();
+    }
 };
 
 extern "C" {
@@ -170,6 +348,7 @@ typedef struct _BufferTracerClass BufferTracerClass;
 struct _BufferTracer {
     GstTracer parent;
     void *stat;
+    int interval;
 };
 
 struct _BufferTracerClass {
@@ -178,17 +357,43 @@ struct _BufferTracerClass {
 
 G_GNUC_INTERNAL GType buffer_tracer_get_type(void);
 
-// GST_DEBUG_CATEGORY_STATIC(gst_itt_debug);
-//#define GST_CAT_DEFAULT gst_itt_debug
-//#define _do_init GST_DEBUG_CATEGORY_INIT(gst_itt_debug, "itt", 0, "itt tracer");
+GST_DEBUG_CATEGORY_STATIC(buffer_tracer_debug);
+#define GST_CAT_DEFAULT buffer_tracer_debug
+#define _do_init GST_DEBUG_CATEGORY_INIT(buffer_tracer_debug, "buffer_tracer", 0, "buffer tracer");
 
 #define buffer_tracer_parent_class parent_class
 
-// G_DEFINE_TYPE_WITH_CODE(BufferTracer, buffer_tracer, GST_TYPE_TRACER, _do_init);
-G_DEFINE_TYPE(BufferTracer, buffer_tracer, GST_TYPE_TRACER);
+G_DEFINE_TYPE_WITH_CODE(BufferTracer, buffer_tracer, GST_TYPE_TRACER, _do_init);
+
+static void buffer_tracer_constructed(GObject *object) {
+    BufferTracer *self = (BufferTracer *)object;
+    gchar *params = NULL;
+    g_object_get(self, "params", &params, NULL);
+    if (params) {
+        gchar *tmp = g_strdup_printf("buffer_tracer,%s", params);
+        GstStructure *params_struct = gst_structure_from_string(tmp, NULL);
+        g_free(tmp);
+        if (params_struct) {
+            gst_structure_get_int(params_struct, "interval", &self->interval);
+            gst_structure_free(params_struct);
+        }
+        g_free(params);
+    }
+    if (self->interval <= 0)
+        self->interval = DEFAULT_INTERVAL_MS;
+    GST_INFO_OBJECT(self, "interval set to %d ms", self->interval);
+
+    ((BufferStatistic *)self->stat)->start(self->interval);
+
+    G_OBJECT_CLASS(parent_class)->constructed(object);
+}
 
 static void buffer_tracer_finalize(GObject *obj) {
-    // BufferTracer *self = buffer_TRACER (obj);
+    BufferTracer *self = (BufferTracer *)obj;
+    // Statistic objects referenced from qdata of pads and elements which outlive tracer are released with qdata
+    ((BufferStatistic *)self->stat)->stop();
+    delete (BufferStatistic *)self->stat;
+    self->stat = nullptr;
 
     G_OBJECT_CLASS(parent_class)->finalize(obj);
 }
@@ -196,19 +401,28 @@ static void buffer_tracer_finalize(GObject *obj) {
 static void buffer_tracer_class_init(BufferTracerClass *klass) {
     GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
 
+    gobject_class->constructed = buffer_tracer_constructed;
     gobject_class->finalize = buffer_tracer_finalize;
 }
 
 static void GstTracerHookPadPushPre(GObject *self, GstClockTime ts, GstPad *pad, GstBuffer *buffer) {
-    ((BufferStatistic *)((BufferTracer *)self)->stat)->pad_push_event(ts, pad, buffer);
+    (void)ts;
+    ((BufferStatistic *)((BufferTracer *)self)->stat)->pad_push_event(pad, 1, gst_buffer_get_size(buffer));
+}
+
+static void GstTracerHookPadPushListPre(GObject *self, GstClockTime ts, GstPad *pad, GstBufferList *list) {
+    (void)ts;
+    ((BufferStatistic *)((BufferTracer *)self)->stat)
+        ->pad_push_event(pad, gst_buffer_list_length(list), gst_buffer_list_calculate_size(list));
 }
 
 static void buffer_tracer_init(BufferTracer *self) {
     /* Register callbacks */
     gst_tracing_register_hook(GST_TRACER(self), "pad-push-pre", G_CALLBACK(GstTracerHookPadPushPre));
-    // gst_tracing_register_hook(GST_TRACER(self), "pad-push-post", G_CALLBACK(GstTracerHookPadPushPost));
+    gst_tracing_register_hook(GST_TRACER(self), "pad-push-list-pre", G_CALLBACK(GstTracerHookPadPushListPre));
 
     self->stat = new BufferStatistic();
+    self->interval = DEFAULT_INTERVAL_MS;
 }
 
 static gboolean plugin_init(GstPlugin *plugin) {
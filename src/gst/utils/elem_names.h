@@ -16,6 +16,7 @@ constexpr const char *vaapi_to_opencl = "vaapi_to_opencl";
 constexpr const char *opencv_cropscale = "opencv_cropscale";
 constexpr const char *tensor_convert = "tensor_convert";
 constexpr const char *opencv_tensor_normalize = "opencv_tensor_normalize";
+constexpr const char *opencv_preproc = "opencv_preproc";
 constexpr const char *opencl_tensor_normalize = "opencl_tensor_normalize";
 constexpr const char *openvino_tensor_inference = "openvino_tensor_inference";
 constexpr const char *openvino_video_inference = "openvino_video_inference";
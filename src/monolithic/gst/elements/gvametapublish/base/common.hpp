@@ -24,6 +24,7 @@ constexpr auto UNKNOWN_VALUE_NAME = "unknown";
 constexpr auto PUBLISH_METHOD_FILE_NAME = "file";
 constexpr auto PUBLISH_METHOD_MQTT_NAME = "mqtt";
 constexpr auto PUBLISH_METHOD_KAFKA_NAME = "kafka";
+constexpr auto PUBLISH_METHOD_SHM_NAME = "shm";
 
 constexpr auto FILE_FORMAT_JSON_NAME = "json";
 constexpr auto FILE_FORMAT_JSON_LINES_NAME = "json-lines";
@@ -36,6 +37,12 @@ constexpr auto DEFAULT_SIGNAL_HANDOFFS = false;
 constexpr auto DEFAULT_MAX_CONNECT_ATTEMPTS = 1;
 constexpr auto DEFAULT_MAX_RECONNECT_INTERVAL = 30;
 
+// Shared memory specific constants
+constexpr auto DEFAULT_SHM_NAME = "/dlstreamer_meta";
+constexpr auto DEFAULT_SHM_SLOT_COUNT = 64;
+constexpr auto DEFAULT_SHM_SLOT_SIZE = 65536;
+constexpr auto DEFAULT_SHM_INCLUDE_TENSORS = false;
+
 GST_EXPORT const gchar *file_format_to_string(FileFormat format);
 
 GST_EXPORT GType gva_metapublish_file_format_get_type(void);
@@ -64,12 +64,19 @@ class GvaMetaPublishBasePrivate {
             GST_DEBUG_OBJECT(_base, "Signal handoffs");
             g_signal_emit(_base, gst_interpret_signals[SIGNAL_HANDOFF], 0, buf);
         }
+        GvaMetaPublishBaseClass *klass = GVA_META_PUBLISH_BASE_GET_CLASS(_base);
+        if (klass->publish_buffer) {
+            if (!klass->publish_buffer(GVA_META_PUBLISH_BASE(_base), buf)) {
+                GST_ELEMENT_ERROR(_base, RESOURCE, WRITE, ("Failed to publish metadata"), (NULL));
+                return GST_FLOW_ERROR;
+            }
+            return GST_FLOW_OK;
+        }
         if (!json_meta || !json_meta->message) {
             GST_DEBUG_OBJECT(_base, "No JSON metadata");
             return GST_FLOW_OK;
         }
 
-        GvaMetaPublishBaseClass *klass = GVA_META_PUBLISH_BASE_GET_CLASS(_base);
         if (!klass->publish(GVA_META_PUBLISH_BASE(_base), std::string(json_meta->message))) {
             GST_ELEMENT_ERROR(_base, RESOURCE, NOT_FOUND, ("Failed to publish message"), (NULL));
             return GST_FLOW_ERROR;
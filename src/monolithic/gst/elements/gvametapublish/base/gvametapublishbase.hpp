@@ -33,6 +33,8 @@ struct GvaMetaPublishBaseClass {
 
     void (*handoff)(GstElement *element, GstBuffer *buf);
     gboolean (*publish)(GvaMetaPublishBase *self, const std::string &message);
+    // If set, called for every buffer instead of publish, so metadata is published without JSON serialization
+    gboolean (*publish_buffer)(GvaMetaPublishBase *self, GstBuffer *buffer);
 };
 
 GVAMETAPUBLISH_EXPORTS GType gva_meta_publish_base_get_type(void);
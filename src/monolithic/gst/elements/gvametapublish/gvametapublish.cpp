@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -25,6 +25,8 @@ const gchar *method_type_to_string(PublishMethodType method_type) {
         return PUBLISH_METHOD_MQTT_NAME;
     case GVA_META_PUBLISH_KAFKA:
         return PUBLISH_METHOD_KAFKA_NAME;
+    case GVA_META_PUBLISH_SHM:
+        return PUBLISH_METHOD_SHM_NAME;
     default:
         return UNKNOWN_VALUE_NAME;
     }
@@ -44,6 +46,10 @@ enum {
     PROP_MAX_CONNECT_ATTEMPTS,
     PROP_MAX_RECONNECT_INTERVAL,
     PROP_SIGNAL_HANDOFFS,
+    PROP_SHM_NAME,
+    PROP_SHM_SLOT_COUNT,
+    PROP_SHM_SLOT_SIZE,
+    PROP_SHM_INCLUDE_TENSORS,
 };
 
 class GvaMetaPublishPrivate {
@@ -89,6 +95,18 @@ class GvaMetaPublishPrivate {
         case PROP_MAX_RECONNECT_INTERVAL:
             _max_reconnect_interval = g_value_get_uint(value);
             break;
+        case PROP_SHM_NAME:
+            _shm_name = g_value_get_string(value);
+            break;
+        case PROP_SHM_SLOT_COUNT:
+            _shm_slot_count = g_value_get_uint(value);
+            break;
+        case PROP_SHM_SLOT_SIZE:
+            _shm_slot_size = g_value_get_uint(value);
+            break;
+        case PROP_SHM_INCLUDE_TENSORS:
+            _shm_include_tensors = g_value_get_boolean(value);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(G_OBJECT(_base), prop_id, pspec);
             break;
@@ -121,6 +139,18 @@ class GvaMetaPublishPrivate {
         case PROP_MAX_RECONNECT_INTERVAL:
             g_value_set_uint(value, _max_reconnect_interval);
             break;
+        case PROP_SHM_NAME:
+            g_value_set_string(value, _shm_name.c_str());
+            break;
+        case PROP_SHM_SLOT_COUNT:
+            g_value_set_uint(value, _shm_slot_count);
+            break;
+        case PROP_SHM_SLOT_SIZE:
+            g_value_set_uint(value, _shm_slot_size);
+            break;
+        case PROP_SHM_INCLUDE_TENSORS:
+            g_value_set_boolean(value, _shm_include_tensors);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(G_OBJECT(_base), prop_id, pspec);
             break;
@@ -131,10 +161,13 @@ class GvaMetaPublishPrivate {
         GST_INFO_OBJECT(_base,
                         "%s parameters:\n -- Method: %s\n -- File path: %s\n -- File format: %s\n -- Address: %s\n "
                         "-- Mqtt client ID: %s\n -- Kafka topic: %s\n -- Max connect attempts: %d\n "
-                        "-- Max reconnect interval: %d\n -- Signal handoffs: %s\n",
+                        "-- Max reconnect interval: %d\n -- Signal handoffs: %s\n -- Shared memory name: %s\n "
+                        "-- Shared memory slot count: %u\n -- Shared memory slot size: %u\n "
+                        "-- Shared memory include tensors: %s\n",
                         GST_ELEMENT_NAME(GST_ELEMENT_CAST(_base)), method_type_to_string(_method), _file_path.c_str(),
                         file_format_to_string(_file_format), _address.c_str(), _mqtt_client_id.c_str(), _topic.c_str(),
-                        _max_connect_attempts, _max_reconnect_interval, _signal_handoffs ? "true" : "false");
+                        _max_connect_attempts, _max_reconnect_interval, _signal_handoffs ? "true" : "false",
+                        _shm_name.c_str(), _shm_slot_count, _shm_slot_size, _shm_include_tensors ? "true" : "false");
 
         switch (_method) {
         case GVA_META_PUBLISH_FILE:
@@ -152,6 +185,11 @@ class GvaMetaPublishPrivate {
                 g_object_set(_metapublish, "address", _address.c_str(), "topic", _topic.c_str(), "max-connect-attempts",
                              _max_connect_attempts, "max-reconnect-interval", _max_reconnect_interval, nullptr);
             break;
+        case GVA_META_PUBLISH_SHM:
+            if ((_metapublish = gst_element_factory_make("gvametapublishshm", nullptr)))
+                g_object_set(_metapublish, "shm-name", _shm_name.c_str(), "slot-count", _shm_slot_count, "slot-size",
+                             _shm_slot_size, "include-tensors", _shm_include_tensors, nullptr);
+            break;
         default:
             GST_ERROR_OBJECT(_base, "Unknown publish method %d (%s)", _method, method_type_to_string(_method));
             return false;
@@ -200,6 +238,10 @@ class GvaMetaPublishPrivate {
     uint32_t _max_connect_attempts = 0;
     uint32_t _max_reconnect_interval = 0;
     bool _signal_handoffs = false;
+    std::string _shm_name;
+    uint32_t _shm_slot_count = 0;
+    uint32_t _shm_slot_size = 0;
+    bool _shm_include_tensors = false;
 };
 
 G_DEFINE_TYPE_EXTENDED(GvaMetaPublish, gva_meta_publish, GST_TYPE_BIN, 0, G_ADD_PRIVATE(GvaMetaPublish);
@@ -212,6 +254,7 @@ static GType gst_gva_metapublish_method_get_type(void) {
     static const GEnumValue method_types[] = {{GVA_META_PUBLISH_FILE, "File publish", PUBLISH_METHOD_FILE_NAME},
                                               {GVA_META_PUBLISH_MQTT, "MQTT publish", PUBLISH_METHOD_MQTT_NAME},
                                               {GVA_META_PUBLISH_KAFKA, "Kafka publish", PUBLISH_METHOD_KAFKA_NAME},
+                                              {GVA_META_PUBLISH_SHM, "Shared memory publish", PUBLISH_METHOD_SHM_NAME},
                                               {0, NULL, NULL}};
 
     if (!gva_metapublish_method_type) {
@@ -312,4 +355,27 @@ static void gva_meta_publish_class_init(GvaMetaPublishClass *klass) {
                           "[method= kafka | mqtt] Maximum time in seconds between reconnection attempts. Initial "
                           "interval is 1 second and will be doubled on each failure up to this maximum interval.",
                           1, 300, DEFAULT_MAX_RECONNECT_INTERVAL, prm_flags));
+    g_object_class_install_property(gobject_class, PROP_SHM_NAME,
+                                    g_param_spec_string("shm-name", "Shared memory name",
+                                                        "[method= shm] Name of POSIX shared memory object, starting "
+                                                        "with '/', unique per publisher (start fails if object "
+                                                        "exists). See gva_shm_ring.h for layout of published data",
+                                                        DEFAULT_SHM_NAME, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_SHM_SLOT_COUNT,
+        g_param_spec_uint("shm-slot-count", "Shared memory slot count",
+                          "[method= shm] Number of frames kept in the ring. Readers lagging behind by more frames "
+                          "lose them",
+                          1, G_MAXUINT16, DEFAULT_SHM_SLOT_COUNT, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_SHM_SLOT_SIZE,
+        g_param_spec_uint("shm-slot-size", "Shared memory slot size",
+                          "[method= shm] Size of one slot in bytes. Metadata not fitting into slot is truncated", 1024,
+                          G_MAXINT32, DEFAULT_SHM_SLOT_SIZE, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_SHM_INCLUDE_TENSORS,
+        g_param_spec_boolean("shm-include-tensors", "Shared memory include tensors",
+                             "[method= shm] Publish classification results and raw tensors in addition to regions of "
+                             "interest",
+                             DEFAULT_SHM_INCLUDE_TENSORS, prm_flags));
 }
@@ -11,7 +11,8 @@
 G_BEGIN_DECLS
 
 #define GVA_META_PUBLISH_NAME "Generic metadata publisher"
-#define GVA_META_PUBLISH_DESCRIPTION "Publishes the JSON metadata to MQTT or Kafka message brokers or files."
+#define GVA_META_PUBLISH_DESCRIPTION                                                                                   \
+    "Publishes the JSON metadata to MQTT or Kafka message brokers or files, or binary metadata to shared memory."
 
 #define GST_TYPE_GVA_META_PUBLISH (gva_meta_publish_get_type())
 #define GVA_META_PUBLISH(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_GVA_META_PUBLISH, GvaMetaPublish))
@@ -19,7 +20,12 @@ G_BEGIN_DECLS
 #define GST_IS_GVA_META_PUBLISH(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj), GST_TYPE_GVA_META_PUBLISH))
 #define GST_IS_GVA_META_PUBLISH_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass), GST_TYPE_GVA_META_PUBLISH))
 
-typedef enum { GVA_META_PUBLISH_FILE = 1, GVA_META_PUBLISH_MQTT = 2, GVA_META_PUBLISH_KAFKA = 3 } PublishMethodType;
+typedef enum {
+    GVA_META_PUBLISH_FILE = 1,
+    GVA_META_PUBLISH_MQTT = 2,
+    GVA_META_PUBLISH_KAFKA = 3,
+    GVA_META_PUBLISH_SHM = 4
+} PublishMethodType;
 
 struct GvaMetaPublish {
     GstBin base;
@@ -8,6 +8,9 @@
 
 #include "file/gvametapublishfile.hpp"
 #include "gvametapublish.hpp"
+#ifndef _WIN32
+#include "shm/gvametapublishshm.hpp"
+#endif
 
 #include <gst/gst.h>
 
@@ -15,6 +18,9 @@ static gboolean plugin_init(GstPlugin *plugin) {
     gboolean result = TRUE;
     result &= gst_element_register(plugin, "gvametapublish", GST_RANK_NONE, GST_TYPE_GVA_META_PUBLISH);
     result &= gst_element_register(plugin, "gvametapublishfile", GST_RANK_NONE, GST_TYPE_GVA_META_PUBLISH_FILE);
+#ifndef _WIN32
+    result &= gst_element_register(plugin, "gvametapublishshm", GST_RANK_NONE, GST_TYPE_GVA_META_PUBLISH_SHM);
+#endif
     return result;
 }
 
@@ -0,0 +1,371 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "gvametapublishshm.hpp"
+#include "shm_ring_writer.hpp"
+
+#include <common.hpp>
+#include <gva_tensor_meta.h>
+#include <region_of_interest.h>
+
+#include <gst/video/video.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+GST_DEBUG_CATEGORY_STATIC(gva_meta_publish_shm_debug_category);
+#define GST_CAT_DEFAULT gva_meta_publish_shm_debug_category
+
+/* Properties */
+enum {
+    PROP_0,
+    PROP_SHM_NAME,
+    PROP_SLOT_COUNT,
+    PROP_SLOT_SIZE,
+    PROP_INCLUDE_TENSORS,
+};
+
+class GvaMetaPublishShmPrivate {
+  private:
+    uint32_t add_string(const char *str) {
+        if (!str || !*str)
+            return 0;
+        auto it = _string_offsets.find(str);
+        if (it != _string_offsets.end())
+            return it->second;
+        const uint32_t offset = static_cast<uint32_t>(_strings.size());
+        _strings.append(str, std::strlen(str) + 1);
+        _string_offsets.emplace(str, offset);
+        return offset;
+    }
+
+    void add_tensor(int32_t roi_id, GstStructure *structure) {
+        GVA::Tensor tensor(structure);
+        GvaShmTensor shm_tensor = {};
+        shm_tensor.roi_id = roi_id;
+        shm_tensor.name = add_string(tensor.name().c_str());
+        shm_tensor.label = add_string(tensor.label().c_str());
+        shm_tensor.label_id = tensor.label_id();
+        shm_tensor.confidence = static_cast<float>(tensor.confidence());
+        shm_tensor.precision = static_cast<uint32_t>(tensor.precision());
+
+        gsize size = 0;
+        const void *data = gva_get_tensor_data(structure, &size);
+        // data which can't fit into slot anyway is not published
+        if (!data || size > _writer->max_record_size())
+            size = 0;
+        shm_tensor.data_size = static_cast<uint32_t>(size);
+        _tensors.push_back(shm_tensor);
+        _tensor_data.push_back(data);
+        _tensor_data_size += ShmRingWriter::align(size);
+    }
+
+    // Collects metadata of the buffer into reused vectors, so steady state publishing doesn't allocate
+    void collect(GstBuffer *buffer) {
+        _rois.clear();
+        _roi_strings_end.clear();
+        _tensors.clear();
+        _tensor_data.clear();
+        _tensor_data_size = 0;
+        _strings.assign(1, '\0');
+        _string_offsets.clear();
+
+        GstMeta *meta = nullptr;
+        gpointer state = nullptr;
+        while ((meta = gst_buffer_iterate_meta_filtered(buffer, &state, GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE))) {
+            auto roi_meta = reinterpret_cast<GstVideoRegionOfInterestMeta *>(meta);
+            GVA::RegionOfInterest roi(roi_meta);
+            GvaShmRoi shm_roi = {};
+            shm_roi.id = roi_meta->id;
+            shm_roi.object_id = roi.object_id();
+            shm_roi.label_id = roi.label_id();
+            shm_roi.label = add_string(g_quark_to_string(roi_meta->roi_type));
+            shm_roi.x = roi_meta->x;
+            shm_roi.y = roi_meta->y;
+            shm_roi.w = roi_meta->w;
+            shm_roi.h = roi_meta->h;
+            if (_width && _height) {
+                shm_roi.x_min = static_cast<float>(roi_meta->x) / _width;
+                shm_roi.y_min = static_cast<float>(roi_meta->y) / _height;
+                shm_roi.x_max = static_cast<float>(roi_meta->x + roi_meta->w) / _width;
+                shm_roi.y_max = static_cast<float>(roi_meta->y + roi_meta->h) / _height;
+            }
+            shm_roi.confidence = static_cast<float>(roi.confidence());
+            _rois.push_back(shm_roi);
+            _roi_strings_end.push_back(static_cast<uint32_t>(_strings.size()));
+
+            if (!_include_tensors)
+                continue;
+            for (GList *l = roi_meta->params; l; l = g_list_next(l)) {
+                GstStructure *structure = GST_STRUCTURE(l->data);
+                // detection and tracking results are already published as ROI fields
+                if (!gst_structure_has_name(structure, "object_id") && !gst_structure_has_name(structure, "detection"))
+                    add_tensor(roi_meta->id, structure);
+            }
+        }
+
+        if (!_include_tensors)
+            return;
+        GstGVATensorMeta *tensor_meta = nullptr;
+        state = nullptr;
+        while ((tensor_meta = GST_GVA_TENSOR_META_ITERATE(buffer, &state)))
+            add_tensor(-1, tensor_meta->data);
+    }
+
+    size_t record_size(size_t roi_count, size_t tensor_count, size_t tensor_data_size, size_t strings_size) const {
+        return sizeof(GvaShmFrame) + roi_count * sizeof(GvaShmRoi) + tensor_count * sizeof(GvaShmTensor) +
+               tensor_data_size + strings_size;
+    }
+
+    // Writes collected metadata into the slot, dropping tensors and then ROIs which don't fit. Returns record size
+    size_t write_record(GstBuffer *buffer, uint8_t *record) {
+        const size_t max_size = _writer->max_record_size();
+        size_t roi_count = _rois.size();
+        size_t tensor_count = _tensors.size();
+        size_t tensor_data_size = _tensor_data_size;
+        size_t strings_size = _strings.size();
+        uint32_t flags = 0;
+
+        if (tensor_count && record_size(roi_count, tensor_count, tensor_data_size, strings_size) > max_size) {
+            tensor_count = 0;
+            tensor_data_size = 0;
+            strings_size = roi_count ? _roi_strings_end[roi_count - 1] : 1;
+            flags |= GVA_SHM_FRAME_NO_TENSORS;
+        }
+        while (roi_count && record_size(roi_count, 0, 0, strings_size) > max_size) {
+            roi_count--;
+            strings_size = roi_count ? _roi_strings_end[roi_count - 1] : 1;
+            flags |= GVA_SHM_FRAME_TRUNCATED;
+        }
+        if (flags & GVA_SHM_FRAME_TRUNCATED)
+            GST_DEBUG_OBJECT(_base, "Only %zu of %zu regions fit into slot of %zu bytes", roi_count, _rois.size(),
+                             max_size);
+
+        auto frame = reinterpret_cast<GvaShmFrame *>(record);
+        frame->sequence = _writer->sequence();
+        frame->pts = GST_BUFFER_PTS_IS_VALID(buffer) ? GST_BUFFER_PTS(buffer) : GVA_SHM_NONE;
+        frame->width = _width;
+        frame->height = _height;
+        frame->roi_count = static_cast<uint32_t>(roi_count);
+        frame->tensor_count = static_cast<uint32_t>(tensor_count);
+        frame->strings_size = static_cast<uint32_t>(strings_size);
+        frame->flags = flags;
+        frame->reserved = 0;
+
+        uint8_t *ptr = record + sizeof(GvaShmFrame);
+        std::memcpy(ptr, _rois.data(), roi_count * sizeof(GvaShmRoi));
+        ptr += roi_count * sizeof(GvaShmRoi);
+
+        auto tensors = reinterpret_cast<GvaShmTensor *>(ptr);
+        size_t data_offset = sizeof(GvaShmFrame) + roi_count * sizeof(GvaShmRoi) + tensor_count * sizeof(GvaShmTensor);
+        for (size_t i = 0; i < tensor_count; i++) {
+            tensors[i] = _tensors[i];
+            tensors[i].data_offset = static_cast<uint32_t>(data_offset);
+            std::memcpy(record + data_offset, _tensor_data[i], tensors[i].data_size);
+            data_offset += ShmRingWriter::align(tensors[i].data_size);
+        }
+
+        frame->strings_offset = static_cast<uint32_t>(data_offset);
+        std::memcpy(record + data_offset, _strings.data(), strings_size);
+        return data_offset + strings_size;
+    }
+
+  public:
+    GvaMetaPublishShmPrivate(GvaMetaPublishBase *base) : _base(base) {
+    }
+
+    ~GvaMetaPublishShmPrivate() = default;
+
+    gboolean start() {
+        try {
+            _writer.reset(new ShmRingWriter(_shm_name, _slot_count, _slot_size));
+        } catch (const std::exception &e) {
+            GST_ELEMENT_ERROR(_base, RESOURCE, OPEN_WRITE, ("Failed to create shared memory ring"), ("%s", e.what()));
+            return false;
+        }
+        GST_INFO_OBJECT(_base, "Publishing to shared memory '%s': %u slots of %u bytes", _shm_name.c_str(), _slot_count,
+                        _slot_size);
+        return true;
+    }
+
+    gboolean stop() {
+        if (_writer)
+            GST_INFO_OBJECT(_base, "Published %" G_GUINT64_FORMAT " records", _writer->sequence());
+        _writer.reset();
+        return true;
+    }
+
+    gboolean set_caps(GstCaps *caps) {
+        GstVideoInfo info;
+        if (gst_video_info_from_caps(&info, caps)) {
+            _width = GST_VIDEO_INFO_WIDTH(&info);
+            _height = GST_VIDEO_INFO_HEIGHT(&info);
+        } else {
+            _width = _height = 0;
+        }
+        return true;
+    }
+
+    gboolean publish_buffer(GstBuffer *buffer) {
+        if (!_writer)
+            return false;
+        try {
+            collect(buffer);
+            uint8_t *record = _writer->begin_record();
+            _writer->commit_record(write_record(buffer, record));
+        } catch (const std::exception &e) {
+            GST_ERROR_OBJECT(_base, "Failed to publish metadata to shared memory: %s", e.what());
+            return false;
+        }
+        return true;
+    }
+
+    bool get_property(guint prop_id, GValue *value) {
+        switch (prop_id) {
+        case PROP_SHM_NAME:
+            g_value_set_string(value, _shm_name.c_str());
+            break;
+        case PROP_SLOT_COUNT:
+            g_value_set_uint(value, _slot_count);
+            break;
+        case PROP_SLOT_SIZE:
+            g_value_set_uint(value, _slot_size);
+            break;
+        case PROP_INCLUDE_TENSORS:
+            g_value_set_boolean(value, _include_tensors);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    bool set_property(guint prop_id, const GValue *value) {
+        switch (prop_id) {
+        case PROP_SHM_NAME:
+            _shm_name = g_value_get_string(value);
+            break;
+        case PROP_SLOT_COUNT:
+            _slot_count = g_value_get_uint(value);
+            break;
+        case PROP_SLOT_SIZE:
+            _slot_size = g_value_get_uint(value);
+            break;
+        case PROP_INCLUDE_TENSORS:
+            _include_tensors = g_value_get_boolean(value);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+  private:
+    GvaMetaPublishBase *_base;
+
+    std::string _shm_name;
+    uint32_t _slot_count = DEFAULT_SHM_SLOT_COUNT;
+    uint32_t _slot_size = DEFAULT_SHM_SLOT_SIZE;
+    bool _include_tensors = DEFAULT_SHM_INCLUDE_TENSORS;
+    std::unique_ptr<ShmRingWriter> _writer;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+
+    std::vector<GvaShmRoi> _rois;
+    std::vector<uint32_t> _roi_strings_end; // size of strings table after strings of each ROI are added
+    std::vector<GvaShmTensor> _tensors;
+    std::vector<const void *> _tensor_data;
+    size_t _tensor_data_size = 0;
+    std::string _strings;
+    std::unordered_map<std::string, uint32_t> _string_offsets;
+};
+
+G_DEFINE_TYPE_EXTENDED(GvaMetaPublishShm, gva_meta_publish_shm, GST_TYPE_GVA_META_PUBLISH_BASE, 0,
+                       G_ADD_PRIVATE(GvaMetaPublishShm);
+                       GST_DEBUG_CATEGORY_INIT(gva_meta_publish_shm_debug_category, "gvametapublishshm", 0,
+                                               "debug category for gvametapublishshm element"));
+
+static void gva_meta_publish_shm_init(GvaMetaPublishShm *self) {
+    // Initialize of private data
+    auto *priv_memory = gva_meta_publish_shm_get_instance_private(self);
+    self->impl = new (priv_memory) GvaMetaPublishShmPrivate(&self->base);
+}
+
+static void gva_meta_publish_shm_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec) {
+    auto self = GVA_META_PUBLISH_SHM(object);
+
+    if (!self->impl->get_property(prop_id, value))
+        G_OBJECT_CLASS(gva_meta_publish_shm_parent_class)->get_property(object, prop_id, value, pspec);
+}
+
+static void gva_meta_publish_shm_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec) {
+    auto self = GVA_META_PUBLISH_SHM(object);
+
+    if (!self->impl->set_property(prop_id, value))
+        G_OBJECT_CLASS(gva_meta_publish_shm_parent_class)->set_property(object, prop_id, value, pspec);
+}
+
+static void gva_meta_publish_shm_finalize(GObject *object) {
+    auto self = GVA_META_PUBLISH_SHM(object);
+    g_assert(self->impl && "Expected valid 'impl' pointer during finalize");
+
+    if (self->impl) {
+        // Destroy C++ structure manually
+        self->impl->~GvaMetaPublishShmPrivate();
+        self->impl = nullptr;
+    }
+
+    G_OBJECT_CLASS(gva_meta_publish_shm_parent_class)->finalize(object);
+}
+
+static void gva_meta_publish_shm_class_init(GvaMetaPublishShmClass *klass) {
+    auto gobject_class = G_OBJECT_CLASS(klass);
+    auto base_transform_class = GST_BASE_TRANSFORM_CLASS(klass);
+    auto base_metapublish_class = GVA_META_PUBLISH_BASE_CLASS(klass);
+
+    gobject_class->set_property = gva_meta_publish_shm_set_property;
+    gobject_class->get_property = gva_meta_publish_shm_get_property;
+    gobject_class->finalize = gva_meta_publish_shm_finalize;
+
+    base_transform_class->start = [](GstBaseTransform *base) { return GVA_META_PUBLISH_SHM(base)->impl->start(); };
+    base_transform_class->stop = [](GstBaseTransform *base) { return GVA_META_PUBLISH_SHM(base)->impl->stop(); };
+    base_transform_class->set_caps = [](GstBaseTransform *base, GstCaps *incaps, GstCaps *) {
+        return GVA_META_PUBLISH_SHM(base)->impl->set_caps(incaps);
+    };
+
+    base_metapublish_class->publish_buffer = [](GvaMetaPublishBase *base, GstBuffer *buffer) {
+        return GVA_META_PUBLISH_SHM(base)->impl->publish_buffer(buffer);
+    };
+
+    gst_element_class_set_static_metadata(GST_ELEMENT_CLASS(klass), "Shared memory metadata publisher", "Metadata",
+                                          "Publishes binary frame metadata to ring buffer in POSIX shared memory",
+                                          "Intel Corporation");
+
+    auto prm_flags = static_cast<GParamFlags>(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT);
+    g_object_class_install_property(gobject_class, PROP_SHM_NAME,
+                                    g_param_spec_string("shm-name", "Shared memory name",
+                                                        "Name of POSIX shared memory object, starting with '/'. "
+                                                        "Must be unique per publisher, start fails if object exists",
+                                                        DEFAULT_SHM_NAME, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_SLOT_COUNT,
+        g_param_spec_uint("slot-count", "Slot count",
+                          "Number of frames kept in the ring. Readers lagging behind by more frames lose them", 1,
+                          G_MAXUINT16, DEFAULT_SHM_SLOT_COUNT, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_SLOT_SIZE,
+        g_param_spec_uint("slot-size", "Slot size",
+                          "Size of one slot in bytes. Metadata not fitting into slot is truncated", 1024, G_MAXINT32,
+                          DEFAULT_SHM_SLOT_SIZE, prm_flags));
+    g_object_class_install_property(
+        gobject_class, PROP_INCLUDE_TENSORS,
+        g_param_spec_boolean("include-tensors", "Include tensors",
+                             "Publish classification results and raw tensors in addition to regions of interest",
+                             DEFAULT_SHM_INCLUDE_TENSORS, prm_flags));
+}
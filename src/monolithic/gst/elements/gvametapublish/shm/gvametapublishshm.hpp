@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <gvametapublishbase.hpp>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_GVA_META_PUBLISH_SHM (gva_meta_publish_shm_get_type())
+#define GVA_META_PUBLISH_SHM(obj)                                                                                      \
+    (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_GVA_META_PUBLISH_SHM, GvaMetaPublishShm))
+#define GVA_META_PUBLISH_SHM_CLASS(klass)                                                                              \
+    (G_TYPE_CHECK_CLASS_CAST((klass), GST_TYPE_GVA_META_PUBLISH_SHM, GvaMetaPublishShmClass))
+#define IS_GVA_META_PUBLISH_SHM(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj), GST_TYPE_GVA_META_PUBLISH_SHM))
+#define IS_GVA_META_PUBLISH_SHM_CLASS(obj) (G_TYPE_CHECK_CLASS_TYPE((klass), GST_TYPE_GVA_META_PUBLISH_SHM))
+#define GVA_META_PUBLISH_SHM_GET_CLASS(obj)                                                                            \
+    (G_TYPE_INSTANCE_GET_CLASS((obj), GST_TYPE_GVA_META_PUBLISH_SHM, GvaMetaPublishShmClass))
+
+struct GvaMetaPublishShm {
+    GvaMetaPublishBase base;
+
+    class GvaMetaPublishShmPrivate *impl;
+};
+
+struct GvaMetaPublishShmClass {
+    GvaMetaPublishBaseClass base;
+};
+
+GType gva_meta_publish_shm_get_type(void);
+
+G_END_DECLS
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <gva_shm_ring.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Single producer side of ring in POSIX shared memory, see gva_shm_ring.h for layout. Record is built directly in the
+ * slot between begin_record() and commit_record(), so publishing doesn't copy it. Not thread-safe, only one writer
+ * per ring is allowed: creation fails if ring with the same name exists, unless its writer process is gone.
+ */
+class ShmRingWriter {
+  public:
+    ShmRingWriter(const std::string &name, uint32_t slot_count, uint32_t slot_size)
+        : _name(name), _slot_count(slot_count), _slot_size(static_cast<uint32_t>(align(slot_size))) {
+        if (!_slot_count || _slot_size <= sizeof(GvaShmSlotHeader) + sizeof(GvaShmFrame))
+            throw std::invalid_argument("Invalid shared memory ring size");
+        _size = sizeof(GvaShmRingHeader) + static_cast<size_t>(_slot_count) * _slot_size;
+
+        // Object is always created, so ring of running writer with the same name is never taken over, and readers
+        // mapping previous object don't get SIGBUS from it being truncated
+        int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0 && errno == EEXIST) {
+            if (!remove_stale_ring(_name))
+                throw std::runtime_error("Shared memory '" + _name +
+                                         "' already exists. It's used by another publisher (each needs its own "
+                                         "shm-name) or isn't a ring, remove /dev/shm" +
+                                         _name + " if it isn't used");
+            fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        }
+        if (fd < 0)
+            throw std::runtime_error("Failed to create shared memory '" + _name + "': " + std::strerror(errno));
+        void *mapping = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(_size)) == 0)
+            mapping = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            shm_unlink(_name.c_str());
+            throw std::runtime_error("Failed to map shared memory '" + _name + "': " + std::strerror(error));
+        }
+
+        // New object is zero-filled. Readers check magic with acquire, so it's written last
+        _ring = static_cast<GvaShmRingHeader *>(mapping);
+        _ring->version = GVA_SHM_RING_VERSION;
+        _ring->writer_pid = static_cast<uint32_t>(getpid());
+        _ring->slot_count = _slot_count;
+        _ring->slot_size = _slot_size;
+        __atomic_store_n(&_ring->magic, GVA_SHM_RING_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    ShmRingWriter(const ShmRingWriter &) = delete;
+    ShmRingWriter &operator=(const ShmRingWriter &) = delete;
+
+    // Readers which mapped the ring keep reading it, new readers can't open it
+    ~ShmRingWriter() {
+        munmap(_ring, _size);
+        shm_unlink(_name.c_str());
+    }
+
+    size_t max_record_size() const {
+        return _slot_size - sizeof(GvaShmSlotHeader);
+    }
+
+    // Sequence number of record returned by next begin_record()
+    uint64_t sequence() const {
+        return _sequence;
+    }
+
+    // Marks slot of the next record as being written and returns memory of max_record_size() bytes for the record
+    uint8_t *begin_record() {
+        GvaShmSlotHeader *slot = current_slot();
+        __atomic_store_n(&slot->state, 2 * _sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        return reinterpret_cast<uint8_t *>(slot + 1);
+    }
+
+    void commit_record(size_t size) {
+        if (size > max_record_size())
+            throw std::out_of_range("Record doesn't fit into shared memory ring slot");
+        GvaShmSlotHeader *slot = current_slot();
+        slot->size = static_cast<uint32_t>(size);
+        __atomic_store_n(&slot->state, 2 * _sequence + 2, __ATOMIC_RELEASE);
+        _sequence++;
+        __atomic_store_n(&_ring->write_sequence, _sequence, __ATOMIC_RELEASE);
+    }
+
+    static constexpr size_t align(size_t size) {
+        return (size + 7) & ~size_t(7);
+    }
+
+  private:
+    // Removes ring left by writer process which no longer exists. Returns false if object isn't such ring
+    static bool remove_stale_ring(const std::string &name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return errno == ENOENT; // removed meanwhile
+        struct stat st;
+        uint32_t pid = 0;
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(GvaShmRingHeader)) {
+            void *mapping = mmap(nullptr, sizeof(GvaShmRingHeader), PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED) {
+                auto ring = static_cast<const GvaShmRingHeader *>(mapping);
+                if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) == GVA_SHM_RING_MAGIC)
+                    pid = ring->writer_pid;
+                munmap(mapping, sizeof(GvaShmRingHeader));
+            }
+        }
+        close(fd);
+        if (!pid || kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH)
+            return false;
+        return shm_unlink(name.c_str()) == 0 || errno == ENOENT;
+    }
+
+    GvaShmSlotHeader *current_slot() {
+        return reinterpret_cast<GvaShmSlotHeader *>(reinterpret_cast<uint8_t *>(_ring) + sizeof(GvaShmRingHeader) +
+                                                    static_cast<size_t>(_sequence % _slot_count) * _slot_size);
+    }
+
+    std::string _name;
+    uint32_t _slot_count;
+    uint32_t _slot_size;
+    size_t _size = 0;
+    GvaShmRingHeader *_ring = nullptr;
+    uint64_t _sequence = 0;
+};
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -57,6 +57,10 @@
 #define DEFAULT_MAX_NIREQ 1024
 #define DEFAULT_NIREQ 0
 
+#define DEFAULT_MIN_MAX_INFLIGHT_FRAMES 0
+#define DEFAULT_MAX_MAX_INFLIGHT_FRAMES UINT_MAX
+#define DEFAULT_MAX_INFLIGHT_FRAMES 0
+
 #define DEFAULT_CPU_THROUGHPUT_STREAMS 0
 #define DEFAULT_MIN_CPU_THROUGHPUT_STREAMS 0
 #define DEFAULT_MAX_CPU_THROUGHPUT_STREAMS UINT_MAX
@@ -67,6 +71,15 @@
 
 #define DEFAULT_ALLOCATOR_NAME nullptr
 
+#define DEFAULT_PRE_PROC_CACHE FALSE
+
+#define DEFAULT_MIN_PRIORITY 0
+#define DEFAULT_MAX_PRIORITY 100
+#define DEFAULT_PRIORITY 0
+
+#define DEFAULT_RECORD_OUTPUTS nullptr
+#define DEFAULT_REPLAY_OUTPUTS nullptr
+
 G_DEFINE_TYPE_WITH_PRIVATE(GvaBaseInference, gva_base_inference, GST_TYPE_BASE_TRANSFORM);
 
 GST_DEBUG_CATEGORY_STATIC(gva_base_inference_debug_category);
@@ -83,6 +96,7 @@ enum {
     PROP_RESHAPE_HEIGHT,
     PROP_NO_BLOCK,
     PROP_NIREQ,
+    PROP_MAX_INFLIGHT_FRAMES,
     PROP_MODEL_INSTANCE_ID,
     PROP_PRE_PROC_BACKEND,
     PROP_MODEL_PROC,
@@ -95,7 +109,12 @@ enum {
     PROP_OBJECT_CLASS,
     PROP_LABELS,
     PROP_LABELS_FILE,
-    PROP_SCALE_METHOD
+    PROP_SCALE_METHOD,
+    PROP_PRE_PROC_CACHE,
+    PROP_PRIORITY,
+    PROP_RECORD_OUTPUTS,
+    PROP_REPLAY_OUTPUTS,
+    PROP_STATS
 };
 
 GType gst_gva_base_inference_get_inf_region(void) {
@@ -255,6 +274,15 @@ void gva_base_inference_class_init(GvaBaseInferenceClass *klass) {
                                                       DEFAULT_MIN_NIREQ, DEFAULT_MAX_NIREQ, DEFAULT_NIREQ,
                                                       param_flags));
 
+    g_object_class_install_property(
+        gobject_class, PROP_MAX_INFLIGHT_FRAMES,
+        g_param_spec_uint("max-inflight-frames", "Max-Inflight-Frames",
+                          "Maximum number of frames of this element waiting for inference results before input is "
+                          "blocked. Limits share of inference requests taken by one stream when model instance is "
+                          "shared between elements (see model-instance-id). 0 means no limit",
+                          DEFAULT_MIN_MAX_INFLIGHT_FRAMES, DEFAULT_MAX_MAX_INFLIGHT_FRAMES, DEFAULT_MAX_INFLIGHT_FRAMES,
+                          param_flags));
+
     g_object_class_install_property(
         gobject_class, PROP_CPU_THROUGHPUT_STREAMS,
         g_param_spec_uint("cpu-throughput-streams", "CPU-Throughput-Streams",
@@ -319,6 +347,56 @@ void gva_base_inference_class_init(GvaBaseInferenceClass *klass) {
                                                         " Only default and scale-method=fast (VAAPI based) supported "
                                                         "in this element",
                                                         nullptr, param_flags));
+
+    g_object_class_install_property(
+        gobject_class, PROP_PRE_PROC_CACHE,
+        g_param_spec_boolean("pre-process-cache", "Pre-processing cache",
+                             "If true, regions pre-processed for inference are kept in the frame and reused by "
+                             "this and downstream elements with this property enabled, if the model has the same "
+                             "input size, color format and pre-processing parameters. Applicable to software "
+                             "pre-processing (pre-process-backend=opencv or ie)",
+                             DEFAULT_PRE_PROC_CACHE, param_flags));
+
+    g_object_class_install_property(
+        gobject_class, PROP_PRIORITY,
+        g_param_spec_uint("priority", "Priority",
+                          "Priority of inference of this element's frames over frames of other elements sharing "
+                          "inference requests (see model-instance-id). Free inference request is given to the waiting "
+                          "frame with the highest priority. Waiting frame gains one priority level every 100 ms, so "
+                          "frames with low priority are delayed but not starved",
+                          DEFAULT_MIN_PRIORITY, DEFAULT_MAX_PRIORITY, DEFAULT_PRIORITY, param_flags));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RECORD_OUTPUTS,
+        g_param_spec_string("record-outputs", "Record outputs",
+                            "Path to file to record model output blobs into, with identifiers (PTS, region position) "
+                            "of frames they were produced for. Recorded file can be replayed with 'replay-outputs' "
+                            "property to tune or benchmark post-processing without running inference",
+                            DEFAULT_RECORD_OUTPUTS, param_flags));
+
+    g_object_class_install_property(
+        gobject_class, PROP_REPLAY_OUTPUTS,
+        g_param_spec_string("replay-outputs", "Replay outputs",
+                            "Path to file recorded with 'record-outputs' property. Model isn't loaded and inference "
+                            "isn't run, recorded output blobs are passed to post-processing in recorded order instead, "
+                            "one recorded request per submitted frames batch, from beginning again after the last one. "
+                            "If frame identifiers of request don't match the batch, request recorded for the batch "
+                            "frames is looked up by PTS and replay continues from it. 'model' property is not required",
+                            DEFAULT_REPLAY_OUTPUTS, param_flags));
+
+    g_object_class_install_property(
+        gobject_class, PROP_STATS,
+        g_param_spec_boxed("stats", "Statistics",
+                           "Statistics of inference instance (shared by elements with the same model-instance-id), "
+                           "updated while running: pre-process-cache-hits (regions loaded from pre-processing cache), "
+                           "pre-process-cache-misses (regions pre-processed because not found in the cache), "
+                           "pre-process-cache-stores (regions stored in the cache for downstream elements), "
+                           "pre-process-cache-full (regions not stored because cache of the frame reached its size "
+                           "limit), priorities (array of per priority statistics of completed frames: frames, "
+                           "request-wait-avg-us and request-wait-max-us of waiting for free inference request, "
+                           "latency-avg-us and latency-max-us from submission to inference completion). NULL if "
+                           "inference instance isn't created",
+                           GST_TYPE_STRUCTURE, static_cast<GParamFlags>(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
 }
 
 void gva_base_inference_cleanup(GvaBaseInference *base_inference) {
@@ -364,6 +442,12 @@ void gva_base_inference_cleanup(GvaBaseInference *base_inference) {
     g_free(base_inference->device_extensions);
     base_inference->device_extensions = nullptr;
 
+    g_free(base_inference->record_outputs);
+    base_inference->record_outputs = nullptr;
+
+    g_free(base_inference->replay_outputs);
+    base_inference->replay_outputs = nullptr;
+
     if (base_inference->info) {
         gst_video_info_free(base_inference->info);
         base_inference->info = nullptr;
@@ -417,6 +501,7 @@ void gva_base_inference_init(GvaBaseInference *base_inference) {
     base_inference->reshape_height = DEFAULT_RESHAPE_HEIGHT;
     base_inference->no_block = DEFAULT_NO_BLOCK;
     base_inference->nireq = DEFAULT_NIREQ;
+    base_inference->max_inflight_frames = DEFAULT_MAX_INFLIGHT_FRAMES;
     base_inference->model_instance_id = g_strdup(DEFAULT_MODEL_INSTANCE_ID);
     base_inference->pre_proc_type = g_strdup(DEFAULT_PRE_PROC);
     // TODO: make one property for streams
@@ -426,6 +511,10 @@ void gva_base_inference_init(GvaBaseInference *base_inference) {
     base_inference->pre_proc_config = g_strdup("");
     base_inference->allocator_name = g_strdup(DEFAULT_ALLOCATOR_NAME);
     base_inference->device_extensions = g_strdup(DEFAULT_DEVICE_EXTENSIONS);
+    base_inference->pre_proc_cache = DEFAULT_PRE_PROC_CACHE;
+    base_inference->priority = DEFAULT_PRIORITY;
+    base_inference->record_outputs = g_strdup(DEFAULT_RECORD_OUTPUTS);
+    base_inference->replay_outputs = g_strdup(DEFAULT_REPLAY_OUTPUTS);
 
     base_inference->initialized = FALSE;
     base_inference->info = nullptr;
@@ -449,7 +538,15 @@ GstStateChangeReturn gva_base_inference_change_state(GstElement *element, GstSta
     GvaBaseInference *base_inference = GVA_BASE_INFERENCE(element);
     GST_DEBUG_OBJECT(base_inference, "gva_base_inference_change_state");
 
-    return GST_ELEMENT_CLASS(gva_base_inference_parent_class)->change_state(element, transition);
+    // Streaming thread waiting for 'max-inflight-frames' must not block pads deactivation
+    if (base_inference->inference && transition == GST_STATE_CHANGE_PAUSED_TO_READY)
+        base_inference->inference->SetOutputStreamFlushing(base_inference, true);
+
+    GstStateChangeReturn ret = GST_ELEMENT_CLASS(gva_base_inference_parent_class)->change_state(element, transition);
+
+    if (base_inference->inference && transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+        base_inference->inference->SetOutputStreamFlushing(base_inference, false);
+    return ret;
 }
 
 gboolean check_gva_base_inference_stopped(GvaBaseInference *base_inference) {
@@ -545,6 +642,9 @@ void gva_base_inference_set_property(GObject *object, guint property_id, const G
     case PROP_NIREQ:
         base_inference->nireq = g_value_get_uint(value);
         break;
+    case PROP_MAX_INFLIGHT_FRAMES:
+        base_inference->max_inflight_frames = g_value_get_uint(value);
+        break;
     case PROP_MODEL_INSTANCE_ID:
         g_free(base_inference->model_instance_id);
         base_inference->model_instance_id = g_value_dup_string(value);
@@ -610,6 +710,20 @@ void gva_base_inference_set_property(GObject *object, guint property_id, const G
         } else
             GST_ERROR_OBJECT(base_inference, "Unsupported scale-method=%s", g_value_get_string(value));
         break;
+    case PROP_PRE_PROC_CACHE:
+        base_inference->pre_proc_cache = g_value_get_boolean(value);
+        break;
+    case PROP_PRIORITY:
+        base_inference->priority = g_value_get_uint(value);
+        break;
+    case PROP_RECORD_OUTPUTS:
+        g_free(base_inference->record_outputs);
+        base_inference->record_outputs = g_value_dup_string(value);
+        break;
+    case PROP_REPLAY_OUTPUTS:
+        g_free(base_inference->replay_outputs);
+        base_inference->replay_outputs = g_value_dup_string(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -652,6 +766,9 @@ void gva_base_inference_get_property(GObject *object, guint property_id, GValue
     case PROP_NIREQ:
         g_value_set_uint(value, base_inference->nireq);
         break;
+    case PROP_MAX_INFLIGHT_FRAMES:
+        g_value_set_uint(value, base_inference->max_inflight_frames);
+        break;
     case PROP_MODEL_INSTANCE_ID:
         g_value_set_string(value, base_inference->model_instance_id);
         break;
@@ -688,6 +805,21 @@ void gva_base_inference_get_property(GObject *object, guint property_id, GValue
     case PROP_SCALE_METHOD:
         g_value_set_string(value, base_inference->scale_method);
         break;
+    case PROP_PRE_PROC_CACHE:
+        g_value_set_boolean(value, base_inference->pre_proc_cache);
+        break;
+    case PROP_PRIORITY:
+        g_value_set_uint(value, base_inference->priority);
+        break;
+    case PROP_RECORD_OUTPUTS:
+        g_value_set_string(value, base_inference->record_outputs);
+        break;
+    case PROP_REPLAY_OUTPUTS:
+        g_value_set_string(value, base_inference->replay_outputs);
+        break;
+    case PROP_STATS:
+        g_value_take_boxed(value, get_inference_instance_stats(base_inference));
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -746,6 +878,10 @@ gboolean gva_base_inference_set_caps(GstBaseTransform *trans, GstCaps *incaps, G
     base_inference->caps_feature = caps_feature;
 
     base_inference->priv->buffer_mapper.reset();
+    base_inference->priv->shared_info.reset(gst_video_info_copy(&video_info), gst_video_info_free);
+    base_inference->priv->input_preprocessors.clear();
+    base_inference->priv->input_preprocessors_valid = false;
+    base_inference->priv->pre_proc_cache_store_valid = false;
 
     // If pre-process-backend property not set and SYSTEM_MEMORY_CAPS, set preproc to "ie".
     // Added due to VAAPI media driver stability issues, this emulates behaviour of 2021.x releases
@@ -822,17 +958,31 @@ gboolean gva_base_inference_check_properties_correctness(GvaBaseInference *base_
     if (!base_inference->model_instance_id) {
         base_inference->model_instance_id = g_strdup(GST_ELEMENT_NAME(GST_ELEMENT(base_inference)));
 
-        if (base_inference->model == nullptr) {
+        // Model isn't loaded when outputs are replayed
+        const bool model_needed = base_inference->replay_outputs == nullptr;
+        if (model_needed && base_inference->model == nullptr) {
             GST_ELEMENT_ERROR(base_inference, RESOURCE, NOT_FOUND, ("'model' is not set"),
                               ("'model' property is not set"));
             return FALSE;
-        } else if (!g_file_test(base_inference->model, G_FILE_TEST_EXISTS)) {
+        } else if (model_needed && !g_file_test(base_inference->model, G_FILE_TEST_EXISTS)) {
             GST_ELEMENT_ERROR(base_inference, RESOURCE, NOT_FOUND, ("'model' does not exist"),
                               ("path %s set in 'model' does not exist", base_inference->model));
             return FALSE;
         }
     }
 
+    if (base_inference->replay_outputs != nullptr && !g_file_test(base_inference->replay_outputs, G_FILE_TEST_EXISTS)) {
+        GST_ELEMENT_ERROR(base_inference, RESOURCE, NOT_FOUND, ("'replay-outputs' does not exist"),
+                          ("path %s set in 'replay-outputs' does not exist", base_inference->replay_outputs));
+        return FALSE;
+    }
+
+    if (base_inference->record_outputs != nullptr && base_inference->replay_outputs != nullptr) {
+        GST_ELEMENT_ERROR(base_inference, RESOURCE, SETTINGS, ("'record-outputs' and 'replay-outputs' are both set"),
+                          ("model outputs can't be recorded while they are replayed"));
+        return FALSE;
+    }
+
     if (base_inference->model_proc != nullptr && !g_file_test(base_inference->model_proc, G_FILE_TEST_EXISTS)) {
         GST_ELEMENT_ERROR(base_inference, RESOURCE, NOT_FOUND, ("'model-proc' does not exist"),
                           ("path %s set in 'model-proc' does not exist", base_inference->model_proc));
@@ -867,14 +1017,15 @@ gboolean gva_base_inference_start(GstBaseTransform *trans) {
         "-- Reshape width: %d\n -- Reshape height: %d\n -- No block: %s\n -- Num of requests: %d\n "
         "-- Model instance ID: %s\n -- CPU streams: %d\n -- GPU streams: %d\n -- IE config: %s\n "
         "-- Allocator name: %s\n -- Preprocessing type: %s\n -- Device extensions: %s\n -- Object class: %s\n "
-        "-- Labels: %s\n",
+        "-- Labels: %s\n -- Priority: %u\n -- Record outputs: %s\n -- Replay outputs: %s\n",
         GST_ELEMENT_NAME(GST_ELEMENT_CAST(base_inference)), base_inference->model, base_inference->model_proc,
         base_inference->device, base_inference->inference_interval, base_inference->reshape ? "true" : "false",
         base_inference->batch_size, base_inference->reshape_width, base_inference->reshape_height,
         base_inference->no_block ? "true" : "false", base_inference->nireq, base_inference->model_instance_id,
         base_inference->cpu_streams, base_inference->gpu_streams, base_inference->ie_config,
         base_inference->allocator_name, base_inference->pre_proc_type, base_inference->device_extensions,
-        base_inference->object_class, base_inference->labels);
+        base_inference->object_class, base_inference->labels, base_inference->priority,
+        base_inference->record_outputs, base_inference->replay_outputs);
 
     if (!gva_base_inference_check_properties_correctness(base_inference)) {
         return base_inference->initialized;
@@ -914,9 +1065,13 @@ gboolean gva_base_inference_sink_event(GstBaseTransform *trans, GstEvent *event)
     GST_DEBUG_OBJECT(base_inference, "sink_event");
 
     try {
+        if (base_inference->inference && event->type == GST_EVENT_FLUSH_START)
+            base_inference->inference->SetOutputStreamFlushing(base_inference, true);
         if (base_inference->inference && (event->type == GST_EVENT_EOS || event->type == GST_EVENT_FLUSH_STOP)) {
             base_inference->inference->FlushInference();
         }
+        if (base_inference->inference && event->type == GST_EVENT_FLUSH_STOP)
+            base_inference->inference->SetOutputStreamFlushing(base_inference, false);
     } catch (const std::exception &e) {
         GST_ELEMENT_ERROR(base_inference, CORE, EVENT, ("base_inference failed while handling sink"),
                           ("%s", Utils::createNestedErrorMsg(e).c_str()));
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2021 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -45,6 +45,7 @@ typedef struct _GvaBaseInference {
     guint reshape_height;
     gboolean no_block;
     guint nireq;
+    guint max_inflight_frames;
     gchar *model_instance_id;
     guint cpu_streams;
     guint gpu_streams;
@@ -56,6 +57,10 @@ typedef struct _GvaBaseInference {
     gchar *object_class;
     gchar *labels;
     gchar *scale_method;
+    gboolean pre_proc_cache;
+    guint priority;
+    gchar *record_outputs;
+    gchar *replay_outputs;
 
     // other fields
     struct GvaBaseInferencePrivate *priv;
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -9,8 +9,13 @@
 #ifdef __cplusplus
 
 #include "inference_backend/buffer_mapper.h"
+#include "inference_backend/image_inference.h"
 
+#include <gst/video/video.h>
+
+#include <map>
 #include <memory>
+#include <string>
 
 // Channel (GvaBaseInference) specific information. Contains C++ objects
 struct GvaBaseInferencePrivate {
@@ -18,6 +23,19 @@ struct GvaBaseInferencePrivate {
     dlstreamer::ContextPtr va_display;
 
     std::unique_ptr<InferenceBackend::BufferToImageMapper> buffer_mapper;
+
+    // Copy of GvaBaseInference::info shared by all InferenceFrame objects, replaced (not modified) on caps change
+    std::shared_ptr<GstVideoInfo> shared_info;
+
+    // Input layer descriptors of the model, created on first submission and reused for all ROIs unless they depend on
+    // ROI. Accessed from element's streaming thread only, reset when inference instance is re-acquired
+    std::map<std::string, InferenceBackend::InputLayerDesc::Ptr> input_preprocessors;
+    bool input_preprocessors_valid = false;
+
+    // Whether regions pre-processed by element are stored in pre-processing cache of the frame, i.e. some element
+    // downstream has 'pre-process-cache' enabled. Checked on first submission after caps change
+    bool pre_proc_cache_store = false;
+    bool pre_proc_cache_store_valid = false;
 };
 
 #endif // __cplusplus
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -19,7 +19,10 @@
 #include "inference_backend/pre_proc.h"
 #include "logger_functions.h"
 #include "model_proc_provider.h"
+#include "output_log.h"
+#include "pre_proc_cache_meta.h"
 #include "region_of_interest.h"
+#include "replay_image_inference.h"
 #include "safe_arithmetic.hpp"
 #include "scope_guard.h"
 #include "utils.h"
@@ -31,6 +34,7 @@
 
 #include <gst/allocators/allocators.h>
 
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <cstring>
@@ -40,6 +44,7 @@
 #include <regex>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #ifdef ENABLE_VAAPI
@@ -312,10 +317,12 @@ void UpdateClassificationHistory(GstVideoRegionOfInterestMeta *meta, GvaBaseInfe
         return;
 
     GstGvaClassify *gvaclassify = GST_GVA_CLASSIFY(gva_base_inference);
-    gint meta_id = 0;
-    get_object_id(meta, &meta_id);
-    if (gvaclassify->reclassify_interval != 1 and meta_id > 0)
-        gvaclassify->classification_history->UpdateROIParams(meta_id, classification_result);
+    if (gvaclassify->reclassify_interval == 1)
+        return;
+    // object id set by gvatrack or id of matched untracked ROI
+    gint history_id = gvaclassify->classification_history->GetHistoryId(meta);
+    if (history_id != 0)
+        gvaclassify->classification_history->UpdateROIParams(history_id, classification_result);
 }
 
 MemoryType GetMemoryType(CapsFeature caps_feature) {
@@ -392,13 +399,87 @@ dlstreamer::ContextPtr createVaDisplay(GvaBaseInference *gva_base_inference) {
     return display;
 }
 
+// Returns pad receiving buffers pushed from src_pad, looking through ghost pads of bins. Returns new reference or
+// nullptr if not linked
+GstPad *GetReceivingPad(GstPad *src_pad) {
+    GstPad *pad = gst_pad_get_peer(src_pad);
+    while (pad) {
+        GstPad *next;
+        if (GST_IS_GHOST_PAD(pad)) {
+            // sink ghost pad of bin, continue with pad of element inside bin
+            next = gst_ghost_pad_get_target(GST_GHOST_PAD(pad));
+        } else if (GST_IS_PROXY_PAD(pad)) {
+            // internal pad of src ghost pad, continue with peer of bin
+            GstPad *ghost = GST_PAD(gst_proxy_pad_get_internal(GST_PROXY_PAD(pad)));
+            next = ghost ? gst_pad_get_peer(ghost) : nullptr;
+            if (ghost)
+                gst_object_unref(ghost);
+        } else {
+            return pad;
+        }
+        gst_object_unref(pad);
+        pad = next;
+    }
+    return nullptr;
+}
+
+// Returns true if buffers pushed by element may reach other inference element with 'pre-process-cache' enabled, so
+// regions pre-processed by element are worth storing in the cache of the frame
+bool HasDownstreamPreProcCacheUser(GstElement *element) {
+    std::vector<GstElement *> pending = {GST_ELEMENT(gst_object_ref(element))};
+    std::unordered_set<GstElement *> visited = {element};
+    bool found = false;
+    while (!pending.empty()) {
+        GstElement *current = pending.back();
+        pending.pop_back();
+        std::vector<GstPad *> pads;
+        if (!found) {
+            gst_element_foreach_src_pad(
+                current,
+                [](GstElement *, GstPad *pad, gpointer pads) {
+                    if (GstPad *receiving = GetReceivingPad(pad))
+                        static_cast<std::vector<GstPad *> *>(pads)->push_back(receiving);
+                    return TRUE;
+                },
+                &pads);
+        }
+        gst_object_unref(current);
+        for (GstPad *pad : pads) {
+            GstElement *next = gst_pad_get_parent_element(pad);
+            gst_object_unref(pad);
+            if (!next)
+                continue;
+            if (G_TYPE_CHECK_INSTANCE_TYPE(next, GST_TYPE_GVA_BASE_INFERENCE) &&
+                GVA_BASE_INFERENCE(next)->pre_proc_cache)
+                found = true;
+            if (found || !visited.insert(next).second) {
+                gst_object_unref(next);
+                continue;
+            }
+            pending.push_back(next);
+        }
+    }
+    return found;
+}
+
+// Id of frame in output log, the same for recording and replay. Region ids come from a process-wide sequence and
+// differ between runs, so region is identified by its position in buffer
+InferenceBackend::OutputLogFrameId GetOutputLogFrameId(GstBuffer *buffer, int32_t roi_index) {
+    InferenceBackend::OutputLogFrameId id = {};
+    id.timestamp = GST_BUFFER_PTS(buffer); // GST_CLOCK_TIME_NONE is UINT64_MAX
+    id.roi_index = roi_index;
+    return id;
+}
+
 } // namespace
 
 InferenceImpl::Model InferenceImpl::CreateModel(GvaBaseInference *gva_base_inference, const std::string &model_file,
                                                 const std::string &model_proc_path, const std::string &labels_str) {
     assert(gva_base_inference && "Expected a valid pointer to GvaBaseInference");
 
-    if (!Utils::fileExists(model_file))
+    // Model isn't loaded when recorded outputs are replayed
+    const bool replay = gva_base_inference->replay_outputs != nullptr;
+    if (!replay && !Utils::fileExists(model_file))
         throw std::invalid_argument("Model file '" + model_file + "' does not exist");
 
     Model model;
@@ -441,9 +522,20 @@ InferenceImpl::Model InferenceImpl::CreateModel(GvaBaseInference *gva_base_infer
         }
     }
 
-    auto image_inference = ImageInference::make_shared(
-        memory_type, ie_config, allocator.get(), std::bind(&InferenceImpl::InferenceCompletionCallback, this, _1, _2),
-        std::bind(&InferenceImpl::PushFramesIfInferenceFailed, this, _1), std::move(va_dpy));
+    ImageInference::Ptr image_inference;
+    if (replay)
+        image_inference = std::make_shared<ReplayImageInference>(
+            gva_base_inference->replay_outputs, std::bind(&InferenceImpl::InferenceCompletionCallback, this, _1, _2),
+            std::bind(&InferenceImpl::PushFramesIfInferenceFailed, this, _1),
+            [](const ImageInference::IFrameBase &frame) {
+                const auto &result = static_cast<const InferenceResult &>(frame);
+                return GetOutputLogFrameId(result.inference_frame->buffer, result.roi_index);
+            });
+    else
+        image_inference = ImageInference::make_shared(
+            memory_type, ie_config, allocator.get(),
+            std::bind(&InferenceImpl::InferenceCompletionCallback, this, _1, _2),
+            std::bind(&InferenceImpl::PushFramesIfInferenceFailed, this, _1), std::move(va_dpy));
     if (!image_inference)
         throw std::runtime_error("Failed to create inference instance");
     model.inference = image_inference;
@@ -454,10 +546,10 @@ InferenceImpl::Model InferenceImpl::CreateModel(GvaBaseInference *gva_base_infer
 
 InferenceImpl::InferenceImpl(GvaBaseInference *gva_base_inference) {
     assert(gva_base_inference != nullptr && "Expected a valid pointer to gva_base_inference");
-    if (!gva_base_inference->model) {
+    if (!gva_base_inference->model && !gva_base_inference->replay_outputs) {
         throw std::runtime_error("Model not specified");
     }
-    std::string model_file(gva_base_inference->model);
+    std::string model_file(gva_base_inference->model ? gva_base_inference->model : "");
 
     std::string model_proc;
     if (gva_base_inference->model_proc) {
@@ -471,11 +563,21 @@ InferenceImpl::InferenceImpl(GvaBaseInference *gva_base_inference) {
 
     allocator = CreateAllocator(gva_base_inference->allocator_name);
 
-    GST_WARNING_OBJECT(gva_base_inference, "Loading model: device=%s, path=%s", gva_base_inference->device,
-                       model_file.c_str());
+    if (gva_base_inference->replay_outputs)
+        GST_WARNING_OBJECT(gva_base_inference, "Replaying model outputs recorded in %s, model is not loaded",
+                           gva_base_inference->replay_outputs);
+    else
+        GST_WARNING_OBJECT(gva_base_inference, "Loading model: device=%s, path=%s", gva_base_inference->device,
+                           model_file.c_str());
     GST_WARNING_OBJECT(gva_base_inference, "Initial settings batch_size=%d, nireq=%d", gva_base_inference->batch_size,
                        gva_base_inference->nireq);
     this->model = CreateModel(gva_base_inference, model_file, model_proc, labels_str);
+
+    if (gva_base_inference->record_outputs) {
+        GST_WARNING_OBJECT(gva_base_inference, "Recording model outputs to %s", gva_base_inference->record_outputs);
+        output_recorder = std::make_unique<InferenceBackend::OutputLogWriter>(
+            gva_base_inference->record_outputs, InferenceBackend::OutputLogModelInfo::FromInference(*model.inference));
+    }
 }
 
 void InferenceImpl::FlushInference() {
@@ -484,7 +586,7 @@ void InferenceImpl::FlushInference() {
 
 void InferenceImpl::UpdateObjectClasses(const gchar *obj_classes_str) {
     // Lock mutex to avoid data race in case of shared inference instance in multichannel mode
-    std::unique_lock<std::mutex> lock(_mutex);
+    std::unique_lock<std::shared_mutex> lock(_mutex);
 
     if (obj_classes_str && obj_classes_str[0])
         object_classes = Utils::splitString(obj_classes_str, ',');
@@ -538,23 +640,88 @@ bool InferenceImpl::IsRoiSizeValid(const GstVideoRegionOfInterestMeta *roi_meta)
     return roi_meta->w > 1 && roi_meta->h > 1;
 }
 
-void InferenceImpl::PushOutput() {
+/**
+ * Pushes completed frames from the head of element's output queue. Only one thread pushes frames of the element at a
+ * time to keep their order, gst_pad_push is called with output_frames_mutex released.
+ *
+ * @param[in] gva_base_inference - element which output queue to process
+ * @param[in] lock - lock owning output_frames_mutex
+ */
+void InferenceImpl::PushOutput(GvaBaseInference *gva_base_inference, std::unique_lock<std::mutex> &lock) {
     ITT_TASK(__FUNCTION__);
-    while (!output_frames.empty()) {
-        auto &front = output_frames.front();
-        if (front.inference_count != 0) {
-            break; // inference not completed yet
-        }
-
-        for (const std::shared_ptr<InferenceFrame> &inference_roi : front.inference_rois) {
+    auto it = output_streams.find(gva_base_inference);
+    if (it == output_streams.end() || it->second.pushing)
+        return; // thread which is pushing frames of this element will push completed frames as well
+
+    OutputStream &stream = it->second;
+    stream.pushing = true;
+    while (!stream.frames.empty() && stream.frames.front()->inference_count == 0) {
+        OutputFramePtr front = std::move(stream.frames.front());
+        stream.frames.pop_front();
+        output_frames_cond.notify_all();
+
+        lock.unlock();
+        for (const std::shared_ptr<InferenceFrame> &inference_roi : front->inference_rois) {
             for (const GstStructure *roi_classification : inference_roi->roi_classifications) {
-                UpdateClassificationHistory(&inference_roi->roi, front.filter, roi_classification);
+                UpdateClassificationHistory(&inference_roi->roi, front->filter, roi_classification);
             }
         }
+        PushBufferToSrcPad(*front);
+        lock.lock();
+    }
+    stream.pushing = false;
+    output_frames_cond.notify_all();
+}
+
+/**
+ * Blocks while number of element's frames waiting for inference or push reaches 'max-inflight-frames' property value.
+ * Woken up when element's frames are pushed or element is stopping (see SetOutputStreamFlushing).
+ *
+ * @param[in] gva_base_inference - element which submits new frame
+ */
+void InferenceImpl::WaitOutputStream(GvaBaseInference *gva_base_inference) {
+    ITT_TASK(__FUNCTION__);
+    const size_t max_inflight_frames = gva_base_inference->max_inflight_frames;
+    std::unique_lock<std::mutex> lock(output_frames_mutex);
+    // Stream is looked up on every wakeup, output_streams can be rehashed by other elements meanwhile
+    output_frames_cond.wait(lock, [this, gva_base_inference, max_inflight_frames] {
+        auto it = output_streams.find(gva_base_inference);
+        return it == output_streams.end() || it->second.flushing || it->second.frames.size() < max_inflight_frames;
+    });
+}
 
-        PushBufferToSrcPad(front);
-        output_frames.pop_front();
+void InferenceImpl::SetOutputStreamFlushing(GvaBaseInference *gva_base_inference, bool flushing) {
+    {
+        std::lock_guard<std::mutex> guard(output_frames_mutex);
+        auto it = output_streams.find(gva_base_inference);
+        if (it == output_streams.end())
+            return;
+        it->second.flushing = flushing;
     }
+    output_frames_cond.notify_all();
+}
+
+void InferenceImpl::RemoveOutputStream(GvaBaseInference *gva_base_inference) {
+    std::unique_lock<std::mutex> lock(output_frames_mutex);
+    // Stream is looked up on every wakeup, output_streams can be rehashed by other elements meanwhile
+    output_frames_cond.wait(lock, [this, gva_base_inference] {
+        auto it = output_streams.find(gva_base_inference);
+        return it == output_streams.end() || !it->second.pushing;
+    });
+    auto it = output_streams.find(gva_base_inference);
+    if (it == output_streams.end())
+        return;
+    for (auto &output_frame : it->second.frames) {
+        // buffers of frames with inference in progress are still referenced by inference requests and released
+        // when requests complete
+        if (output_frame->inference_count == 0)
+            gst_buffer_unref(output_frame->buffer);
+        else
+            output_frame->orphaned = true;
+    }
+    output_streams.erase(it);
+    // wake up element's streaming thread if it waits for 'max-inflight-frames'
+    output_frames_cond.notify_all();
 }
 
 void InferenceImpl::PushBufferToSrcPad(OutputFrame &output_frame) {
@@ -565,34 +732,38 @@ void InferenceImpl::PushBufferToSrcPad(OutputFrame &output_frame) {
         if (ret != GST_FLOW_OK) {
             GVA_WARNING("Inference gst_pad_push returned status: %d", ret);
         }
+    } else {
+        gst_buffer_unref(buffer);
     }
 }
 
 std::shared_ptr<InferenceImpl::InferenceResult>
 InferenceImpl::MakeInferenceResult(GvaBaseInference *gva_base_inference, Model &model,
                                    GstVideoRegionOfInterestMeta *meta, std::shared_ptr<InferenceBackend::Image> &image,
-                                   GstBuffer *buffer) {
-    auto result = std::make_shared<InferenceResult>();
-    /* expect that std::make_shared must throw instead of returning nullptr */
+                                   GstBuffer *buffer, const OutputFramePtr &output_frame) {
+    auto result = std::allocate_shared<InferenceResult>(PoolAllocator<InferenceResult>(inference_results_pool));
+    /* expect that std::allocate_shared must throw instead of returning nullptr */
     assert(result.get() != nullptr && "Expected a valid InferenceResult");
 
-    result->inference_frame = std::make_shared<InferenceFrame>();
-    /* expect that std::make_shared must throw instead of returning nullptr */
+    result->inference_frame =
+        std::allocate_shared<InferenceFrame>(PoolAllocator<InferenceFrame>(inference_frames_pool));
+    /* expect that std::allocate_shared must throw instead of returning nullptr */
     assert(result->inference_frame.get() != nullptr && "Expected a valid InferenceFrame");
 
     result->inference_frame->buffer = buffer;
     result->inference_frame->roi = *meta;
     result->inference_frame->gva_base_inference = gva_base_inference;
-    if (gva_base_inference->info)
-        result->inference_frame->info = gst_video_info_copy(gva_base_inference->info);
+    result->inference_frame->info = gva_base_inference->priv->shared_info;
 
+    result->output_frame = output_frame;
     result->model = &model;
     result->image = image;
     return result;
 }
 
 GstFlowReturn InferenceImpl::SubmitImages(GvaBaseInference *gva_base_inference,
-                                          const std::vector<GstVideoRegionOfInterestMeta *> &metas, GstBuffer *buffer) {
+                                          const std::vector<GstVideoRegionOfInterestMeta *> &metas, GstBuffer *buffer,
+                                          const OutputFramePtr &output_frame) {
     ITT_TASK(__FUNCTION__);
     try {
         if (!gva_base_inference || !gva_base_inference->priv)
@@ -605,28 +776,76 @@ GstFlowReturn InferenceImpl::SubmitImages(GvaBaseInference *gva_base_inference,
         auto &buf_mapper = *gva_base_inference->priv->buffer_mapper;
         assert(buf_mapper.memoryType() == GetInferenceMemoryType() && "Mapper mem type =/= inference mem type");
 
+        auto &priv = *gva_base_inference->priv;
+
+        // Cache is attached to the frame only if element downstream may load regions from it. Otherwise regions are
+        // loaded from cache attached upstream (if any), but not stored. Buffer is a copy made by this element, so it's
+        // writable and cache meta can be added
+        InferenceBackend::PreProcCache::Ptr pre_proc_cache;
+        if (gva_base_inference->pre_proc_cache) {
+            if (!priv.pre_proc_cache_store_valid) {
+                priv.pre_proc_cache_store = HasDownstreamPreProcCacheUser(GST_ELEMENT(gva_base_inference));
+                priv.pre_proc_cache_store_valid = true;
+                GST_INFO_OBJECT(gva_base_inference, "Pre-processed regions are %s",
+                                priv.pre_proc_cache_store ? "stored in cache for downstream elements"
+                                                          : "loaded from cache only, no downstream element uses it");
+            }
+            pre_proc_cache = priv.pre_proc_cache_store ? gva_pre_proc_cache_get_or_add(buffer)
+                                                       : gva_pre_proc_cache_get(buffer);
+        }
+
         /* we invoke CreateImage::gva_buffer_map::gst_video_frame_map with
          * GST_VIDEO_FRAME_MAP_FLAG_NO_REF to avoid refcount increase.
          * CreateImage::gva_buffer_unmap::gst_video_frame_unmap also will not decrease refcount.
          */
         InferenceBackend::ImagePtr image =
             buf_mapper.map(buffer, GstMapFlags(GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF));
+        const bool has_input_preprocessors =
+            !model.input_processor_info.empty() && gva_base_inference->input_prerocessors_factory;
+        const bool input_preprocessors_per_roi =
+            has_input_preprocessors && InputPreprocessorsDependOnRoi(model.input_processor_info);
+
+        // Regions are identified in output log by position in buffer. Metas are in the order of buffer regions
+        const bool full_frame = gva_base_inference->inference_region == FULL_FRAME;
+        gpointer roi_state = nullptr;
+        int32_t roi_index = -1;
 
         size_t i = 0;
         for (const auto meta : metas) {
             ApplyImageBoundaries(image, meta, gva_base_inference->inference_region);
-            auto result = MakeInferenceResult(gva_base_inference, model, meta, image, buffer);
+            auto result = MakeInferenceResult(gva_base_inference, model, meta, image, buffer, output_frame);
+            if (!full_frame) {
+                GstVideoRegionOfInterestMeta *roi_meta = nullptr;
+                do {
+                    roi_meta = GST_VIDEO_REGION_OF_INTEREST_META_ITERATE(buffer, &roi_state);
+                    roi_index++;
+                } while (roi_meta && roi_meta != meta);
+                result->roi_index = roi_meta ? roi_index : -1;
+                if (!roi_meta)
+                    roi_index = -1; // iteration starts over
+            }
+            result->pre_proc_cache = pre_proc_cache;
+            result->pre_proc_cache_store = priv.pre_proc_cache_store;
+            result->priority = static_cast<int>(gva_base_inference->priority);
             // Because image is a shared pointer with custom deleter which performs buffer unmapping
             // we need to manually reset it after we passed it to the last InferenceResult
             // Otherwise it may try to unmap buffer which is already pushed to downstream
             // if completion callback is called before we exit this scope
             if (++i == metas.size())
                 image.reset();
-            std::map<std::string, InferenceBackend::InputLayerDesc::Ptr> input_preprocessors;
-            if (!model.input_processor_info.empty() && gva_base_inference->input_prerocessors_factory)
-                input_preprocessors =
+            if (input_preprocessors_per_roi) {
+                auto input_preprocessors =
+                    gva_base_inference->input_prerocessors_factory(model.inference, model.input_processor_info, meta);
+                model.inference->SubmitImage(std::move(result), input_preprocessors);
+                continue;
+            }
+            // Descriptors don't depend on ROI and are only read by inference backend, so created once per element
+            if (has_input_preprocessors && !priv.input_preprocessors_valid) {
+                priv.input_preprocessors =
                     gva_base_inference->input_prerocessors_factory(model.inference, model.input_processor_info, meta);
-            model.inference->SubmitImage(std::move(result), input_preprocessors);
+                priv.input_preprocessors_valid = true;
+            }
+            model.inference->SubmitImage(std::move(result), priv.input_preprocessors);
         }
     } catch (const std::exception &e) {
         std::throw_with_nested(std::runtime_error("Failed to submit images to inference"));
@@ -640,9 +859,37 @@ const InferenceImpl::Model &InferenceImpl::GetModel() const {
     return model;
 }
 
+GstStructure *InferenceImpl::GetStats() const {
+    InferenceBackend::ImageInference::Stats stats;
+    if (model.inference)
+        stats = model.inference->GetStats();
+    GstStructure *structure = gst_structure_new(
+        "stats", "pre-process-cache-hits", G_TYPE_UINT64, stats.pre_proc_cache_hits, "pre-process-cache-misses",
+        G_TYPE_UINT64, stats.pre_proc_cache_misses, "pre-process-cache-stores", G_TYPE_UINT64,
+        stats.pre_proc_cache_stores, "pre-process-cache-full", G_TYPE_UINT64, stats.pre_proc_cache_full, nullptr);
+
+    GValue priorities = G_VALUE_INIT;
+    g_value_init(&priorities, GST_TYPE_ARRAY);
+    for (const auto &entry : stats.priorities) {
+        const auto &priority = entry.second;
+        GValue value = G_VALUE_INIT;
+        g_value_init(&value, GST_TYPE_STRUCTURE);
+        g_value_take_boxed(&value, gst_structure_new("priority", "priority", G_TYPE_INT, entry.first, "frames",
+                                                     G_TYPE_UINT64, priority.frames, "request-wait-avg-us",
+                                                     G_TYPE_UINT64, priority.wait_avg_us, "request-wait-max-us",
+                                                     G_TYPE_UINT64, priority.wait_max_us, "latency-avg-us",
+                                                     G_TYPE_UINT64, priority.latency_avg_us, "latency-max-us",
+                                                     G_TYPE_UINT64, priority.latency_max_us, nullptr));
+        gst_value_array_append_and_take_value(&priorities, &value);
+    }
+    gst_structure_take_value(structure, "priorities", &priorities);
+    return structure;
+}
+
 GstFlowReturn InferenceImpl::TransformFrameIp(GvaBaseInference *gva_base_inference, GstBuffer *buffer) {
     ITT_TASK(__FUNCTION__);
-    std::unique_lock<std::mutex> lock(_mutex);
+    if (gva_base_inference->max_inflight_frames)
+        WaitOutputStream(gva_base_inference);
 
     assert(gva_base_inference != nullptr && "Expected a valid pointer to gva_base_inference");
     assert(gva_base_inference->info != nullptr && "Expected a valid pointer to GstVideoInfo");
@@ -674,6 +921,8 @@ GstFlowReturn InferenceImpl::TransformFrameIp(GvaBaseInference *gva_base_inferen
     GstVideoRegionOfInterestMeta full_frame_meta;
     {
         ITT_TASK("InferenceImpl::TransformFrameIp collectROIMetas");
+        // ROI filters read object_classes shared with other elements using this instance
+        std::shared_lock<std::shared_mutex> lock(_mutex);
         switch (gva_base_inference->inference_region) {
         case ROI_LIST: {
             /* iterates through buffer's meta and pushes it in vector if inference needed. */
@@ -712,85 +961,72 @@ GstFlowReturn InferenceImpl::TransformFrameIp(GvaBaseInference *gva_base_inferen
                            "The frame counter value limit has been reached. This value will be reset.");
     }
 
-    // push into output_frames queue
+    // push into element's output queue
+    OutputFramePtr output_frame;
     {
         ITT_TASK("InferenceImpl::TransformFrameIp pushIntoOutputFramesQueue");
         std::lock_guard<std::mutex> guard(output_frames_mutex);
-        if (!inference_count && output_frames.empty()) {
-            // If we don't need to run inference and there are no frames queued for inference then finish transform
+        OutputStream &stream = output_streams[gva_base_inference];
+        if (!inference_count && stream.frames.empty() && !stream.pushing) {
+            // If we don't need to run inference and there are no frames of this element queued for inference then
+            // finish transform
             return GST_FLOW_OK;
         }
 
         // No need to unref buffer copy further
         buf_guard.disable();
 
-        InferenceImpl::OutputFrame output_frame = {
-            .buffer = buffer, .inference_count = inference_count, .filter = gva_base_inference, .inference_rois = {}};
-        output_frames.push_back(output_frame);
+        output_frame = std::make_shared<OutputFrame>(OutputFrame{
+            .buffer = buffer, .inference_count = inference_count, .filter = gva_base_inference, .inference_rois = {}});
+        stream.frames.push_back(output_frame);
         if (!inference_count) {
             return GST_BASE_TRANSFORM_FLOW_DROPPED;
         }
     }
 
-    return SubmitImages(gva_base_inference, metas, buffer);
+    return SubmitImages(gva_base_inference, metas, buffer, output_frame);
 }
 
 void InferenceImpl::PushFramesIfInferenceFailed(
     std::vector<std::shared_ptr<InferenceBackend::ImageInference::IFrameBase>> frames) {
-    std::lock_guard<std::mutex> guard(output_frames_mutex);
+    std::unique_lock<std::mutex> lock(output_frames_mutex);
+    std::vector<GvaBaseInference *> filters;
     for (auto &frame : frames) {
         auto inference_result = std::dynamic_pointer_cast<InferenceResult>(frame);
         /* InferenceResult is inherited from IFrameBase */
         assert(inference_result.get() != nullptr && "Expected a valid InferenceResult");
 
-        std::shared_ptr<InferenceFrame> inference_roi = inference_result->inference_frame;
-        auto it =
-            std::find_if(output_frames.begin(), output_frames.end(), [inference_roi](const OutputFrame &output_frame) {
-                return output_frame.buffer == inference_roi->buffer;
-            });
-
-        if (it != output_frames.end())
+        OutputFrame &output_frame = *inference_result->output_frame;
+        // frame is pushed without results of failed request, but still in order with other frames of the element
+        if (output_frame.inference_count && !--output_frame.inference_count && output_frame.orphaned) {
+            gst_buffer_unref(output_frame.buffer);
             continue;
-
-        PushBufferToSrcPad(*it);
-        output_frames.erase(it);
+        }
+        if (std::find(filters.begin(), filters.end(), output_frame.filter) == filters.end())
+            filters.push_back(output_frame.filter);
     }
+    for (auto filter : filters)
+        PushOutput(filter, lock);
 }
 
 /**
- * Updates buffer pointers for corresponding to 'inference_roi' output_frame, decreases it's inference_count.
- * May affect buffer if it's not writable.
+ * Adds 'inference_roi' to corresponding output_frame, decreases it's inference_count.
  *
+ * @param[in] output_frame - OutputFrame which 'inference_roi' was submitted for
  * @param[in] inference_roi - InferenceFrame to provide buffer's and inference element's info
  */
-void InferenceImpl::UpdateOutputFrames(std::shared_ptr<InferenceFrame> &inference_roi) {
+void InferenceImpl::UpdateOutputFrames(OutputFrame &output_frame, std::shared_ptr<InferenceFrame> &inference_roi) {
     assert(inference_roi && "Inference frame is null");
+    assert(output_frame.inference_count > 0 && "Inference completed for output frame more times than submitted");
 
-    /* we must iterate through std::list because it has no lookup operations */
-    for (auto &output_frame : output_frames) {
-        if (output_frame.buffer != inference_roi->buffer)
-            continue;
-
-        /* only gvadetect or full-frame elements are affecting buffer */
-        if (inference_roi->gva_base_inference->type == GST_GVA_DETECT_TYPE ||
-            inference_roi->gva_base_inference->inference_region == FULL_FRAME) {
-            if (output_frame.inference_count == 0)
-                // This condition is necessary if two items in output_frames refer to the same buffer.
-                // If current output_frame.inference_count equals 0, then inference for this output_frame
-                // already happened, but buffer wasn't pushed further by pipeline yet. We skip this buffer
-                // to find another, to which current inference callback really belongs
-                continue;
-        }
-        output_frame.inference_rois.push_back(inference_roi);
-        --output_frame.inference_count;
-        break;
-    }
+    output_frame.inference_rois.push_back(inference_roi);
+    --output_frame.inference_count;
 }
 
 /**
- * Callback called when the inference request is completed. Updates output_frames and invokes post-processing for
- * corresponding inference element then makes gst_pad_push to send buffer further down the pipeline.
- * Acquires output_frames_mutex with std::lock_guard.
+ * Callback called when the inference request is completed. Updates output frames and invokes post-processing for
+ * corresponding inference element then makes gst_pad_push to send completed buffers further down the pipeline.
+ * Acquires output_frames_mutex with std::unique_lock.
  * Nullifies shared_ptr for InferenceBackend::Image created during 'SubmitImages'.
  *
  * @param[in] blobs - the resulting blobs obtained after executing inference
@@ -801,12 +1037,16 @@ void InferenceImpl::UpdateOutputFrames(std::shared_ptr<InferenceFrame> &inferenc
 void InferenceImpl::InferenceCompletionCallback(
     std::map<std::string, InferenceBackend::OutputBlob::Ptr> blobs,
     std::vector<std::shared_ptr<InferenceBackend::ImageInference::IFrameBase>> frames) {
-    std::lock_guard<std::mutex> guard(output_frames_mutex);
+    std::unique_lock<std::mutex> lock(output_frames_mutex);
     ITT_TASK(__FUNCTION__);
     if (frames.empty())
         return;
 
     std::vector<std::shared_ptr<InferenceFrame>> inference_frames;
+    std::vector<InferenceBackend::OutputLogFrameId> frame_ids;
+    const bool record_outputs = output_recorder && !output_recording_stopped.load(std::memory_order_relaxed);
+    std::vector<GvaBaseInference *> filters;
+    std::vector<GstBuffer *> orphaned_buffers;
     PostProcessor *post_proc = nullptr;
 
     for (auto &frame : frames) {
@@ -819,8 +1059,24 @@ void InferenceImpl::InferenceCompletionCallback(
         inference_result->image.reset(); // deleter will to not make buffer_unref, see 'SubmitImages' method
         post_proc = inference_roi->gva_base_inference->post_proc;
 
-        UpdateOutputFrames(inference_roi);
+        OutputFrame &output_frame = *inference_result->output_frame;
+        UpdateOutputFrames(output_frame, inference_roi);
+        if (output_frame.orphaned && output_frame.inference_count == 0)
+            orphaned_buffers.push_back(output_frame.buffer);
         inference_frames.push_back(inference_roi);
+        if (record_outputs)
+            frame_ids.push_back(GetOutputLogFrameId(inference_roi->buffer, inference_result->roi_index));
+        if (std::find(filters.begin(), filters.end(), inference_roi->gva_base_inference) == filters.end())
+            filters.push_back(inference_roi->gva_base_inference);
+    }
+
+    if (record_outputs) {
+        try {
+            output_recorder->Write(blobs, frame_ids);
+        } catch (const std::exception &e) {
+            if (!output_recording_stopped.exchange(true))
+                GST_ERROR("Model outputs recording is stopped: %s", Utils::createNestedErrorMsg(e).c_str());
+        }
     }
 
     try {
@@ -833,5 +1089,9 @@ void InferenceImpl::InferenceCompletionCallback(
         GST_ERROR("%s", Utils::createNestedErrorMsg(e).c_str());
     }
 
-    PushOutput();
+    // Frames of elements which released this instance are not pushed, only released after post-processing
+    for (GstBuffer *buffer : orphaned_buffers)
+        gst_buffer_unref(buffer);
+    for (auto filter : filters)
+        PushOutput(filter, lock);
 }
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -9,15 +9,21 @@
 #include "gstgvaclassify.h"
 #include "gva_base_inference.h"
 #include "input_model_preproc.h"
+#include "pool_allocator.h"
 
 #include "inference_backend/image_inference.h"
+#include "output_log.h"
 
 #include <gst/video/video.h>
 
-#include <list>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class InferenceImpl {
@@ -35,6 +41,8 @@ class InferenceImpl {
     GstFlowReturn TransformFrameIp(GvaBaseInference *element, GstBuffer *buffer);
     void FlushInference();
     const Model &GetModel() const;
+    // Statistics of inference instance as GstStructure named 'stats', see 'stats' property of inference elements
+    GstStructure *GetStats() const;
 
     void UpdateObjectClasses(const gchar *obj_classes_str);
     bool FilterObjectClass(GstVideoRegionOfInterestMeta *roi) const;
@@ -48,8 +56,32 @@ class InferenceImpl {
 
     static bool IsRoiSizeValid(const GstVideoRegionOfInterestMeta *roi_meta);
 
+    // Drops output queue of element which no longer uses this inference instance
+    void RemoveOutputStream(GvaBaseInference *gva_base_inference);
+    // Releases element's streaming thread waiting for 'max-inflight-frames' (on stop or flush) until reset
+    void SetOutputStreamFlushing(GvaBaseInference *gva_base_inference, bool flushing);
+
   private:
     InferenceBackend::MemoryType memory_type;
+
+    struct OutputFrame {
+        GstBuffer *buffer;
+        uint64_t inference_count;
+        GvaBaseInference *filter;
+        std::vector<std::shared_ptr<InferenceFrame>> inference_rois;
+        // Output stream of element was removed while inference was in progress, buffer is released on completion
+        bool orphaned = false;
+    };
+    using OutputFramePtr = std::shared_ptr<OutputFrame>;
+
+    // Output frames of one element in submission order. Frames are pushed as soon as head frame of the element is
+    // completed, so elements sharing model instance (model-instance-id) do not wait for each other.
+    struct OutputStream {
+        std::deque<OutputFramePtr> frames;
+        bool pushing = false;  // frames are being pushed downstream by some thread (with output_frames_mutex released)
+        bool flushing = false; // element is stopping or flushing, input is not blocked by 'max-inflight-frames'
+    };
+
     struct InferenceResult : public InferenceBackend::ImageInference::IFrameBase {
         void SetImage(InferenceBackend::ImagePtr image_) override {
             image = image_;
@@ -57,9 +89,25 @@ class InferenceImpl {
         InferenceBackend::ImagePtr GetImage() const override {
             return image;
         }
+        InferenceBackend::PreProcCache::Ptr GetPreProcCache() const override {
+            return pre_proc_cache;
+        }
+        bool IsPreProcCacheStoreNeeded() const override {
+            return pre_proc_cache_store;
+        }
+        int GetPriority() const override {
+            return priority;
+        }
         std::shared_ptr<InferenceFrame> inference_frame;
+        OutputFramePtr output_frame;
         Model *model;
         std::shared_ptr<InferenceBackend::Image> image;
+        InferenceBackend::PreProcCache::Ptr pre_proc_cache;
+        bool pre_proc_cache_store = false;
+        int priority = 0;
+        // Position of region among regions of buffer, -1 for full frame. Identifies region in output log, unlike
+        // region id it is the same in every run of the pipeline
+        int32_t roi_index = -1;
     };
 
     enum InferenceStatus {
@@ -69,36 +117,44 @@ class InferenceImpl {
         INFERENCE_SKIPPED_ROI = 4           // roi skipped because is_roi_inference_needed() returned false
     };
 
+    // Shared between elements using this instance. Read by streaming threads while collecting ROIs (under shared lock
+    // of _mutex), written on element start
     std::vector<std::string> object_classes;
 
-    mutable std::mutex _mutex;
+    mutable std::shared_mutex _mutex;
+    // Records output blobs of completed requests if 'record-outputs' is set. Declared before model to outlive
+    // inference instance, which completes requests in flight when destroyed
+    std::unique_ptr<InferenceBackend::OutputLogWriter> output_recorder;
+    // Set after failed write. Completion callbacks may run concurrently, so output_recorder is released only with this
+    // object and not when recording stops
+    std::atomic<bool> output_recording_stopped{false};
     Model model;
     std::shared_ptr<InferenceBackend::Allocator> allocator;
 
-    struct OutputFrame {
-        GstBuffer *buffer;
-        uint64_t inference_count;
-        GvaBaseInference *filter;
-        std::vector<std::shared_ptr<InferenceFrame>> inference_rois;
-    };
+    // Memory of InferenceResult and InferenceFrame objects (created per ROI) is reused instead of heap allocations
+    std::shared_ptr<BlockPool> inference_results_pool = std::make_shared<BlockPool>();
+    std::shared_ptr<BlockPool> inference_frames_pool = std::make_shared<BlockPool>();
 
-    std::list<OutputFrame> output_frames;
+    std::unordered_map<GvaBaseInference *, OutputStream> output_streams;
     std::mutex output_frames_mutex;
+    std::condition_variable output_frames_cond;
 
-    void PushOutput();
+    void WaitOutputStream(GvaBaseInference *gva_base_inference);
+    void PushOutput(GvaBaseInference *gva_base_inference, std::unique_lock<std::mutex> &lock);
     void PushBufferToSrcPad(OutputFrame &output_frame);
     void PushFramesIfInferenceFailed(std::vector<std::shared_ptr<InferenceBackend::ImageInference::IFrameBase>> frames);
     void InferenceCompletionCallback(std::map<std::string, InferenceBackend::OutputBlob::Ptr> blobs,
                                      std::vector<std::shared_ptr<InferenceBackend::ImageInference::IFrameBase>> frames);
-    void UpdateOutputFrames(std::shared_ptr<InferenceFrame> &inference_roi);
+    void UpdateOutputFrames(OutputFrame &output_frame, std::shared_ptr<InferenceFrame> &inference_roi);
     Model CreateModel(GvaBaseInference *gva_base_inference, const std::string &model_file,
                       const std::string &model_proc_path, const std::string &labels_str);
     void UpdateModelReshapeInfo(GvaBaseInference *gva_base_inference);
 
     GstFlowReturn SubmitImages(GvaBaseInference *gva_base_inference,
-                               const std::vector<GstVideoRegionOfInterestMeta *> &metas, GstBuffer *buffer);
+                               const std::vector<GstVideoRegionOfInterestMeta *> &metas, GstBuffer *buffer,
+                               const OutputFramePtr &output_frame);
     std::shared_ptr<InferenceResult> MakeInferenceResult(GvaBaseInference *gva_base_inference, Model &model,
                                                          GstVideoRegionOfInterestMeta *meta,
                                                          std::shared_ptr<InferenceBackend::Image> &image,
-                                                         GstBuffer *buffer);
+                                                         GstBuffer *buffer, const OutputFramePtr &output_frame);
 };
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -86,13 +86,15 @@ void fillElementProps(GvaBaseInference *targetElem, GvaBaseInference *masterElem
     COPY_GSTRING(targetElem->pre_proc_type, masterElem->pre_proc_type);
     COPY_GSTRING(targetElem->object_class, masterElem->object_class);
     COPY_GSTRING(targetElem->labels, masterElem->labels);
+    COPY_GSTRING(targetElem->record_outputs, masterElem->record_outputs);
+    COPY_GSTRING(targetElem->replay_outputs, masterElem->replay_outputs);
     // no need to copy model_instance_id because it should match already.
 }
 
 void initExistingElements(InferenceRefs *infRefs) {
     GvaBaseInference *master = nullptr;
     for (auto elem : infRefs->refs) {
-        if (elem->model && *elem->model != 0) {
+        if ((elem->model && *elem->model != 0) || (elem->replay_outputs && *elem->replay_outputs != 0)) {
             master = elem;
             break;
         }
@@ -100,7 +102,7 @@ void initExistingElements(InferenceRefs *infRefs) {
 
     if (!master) {
         throw std::logic_error("There is no master inference element. Please, check if all of mandatory parameters are "
-                               "set, for example 'model'.");
+                               "set, for example 'model' or 'replay-outputs'.");
     }
 
     for (auto elem : infRefs->refs) {
@@ -188,6 +190,8 @@ void release_inference_instance(GvaBaseInference *base_inference) {
 
         InferenceRefs *infRefs = it->second;
         infRefs->refs.erase(base_inference);
+        if (infRefs->proxy)
+            infRefs->proxy->RemoveOutputStream(base_inference);
         if (infRefs->refs.empty()) {
             delete infRefs->proxy;
             delete infRefs;
@@ -198,3 +202,15 @@ void release_inference_instance(GvaBaseInference *base_inference) {
                           ("%s", Utils::createNestedErrorMsg(e).c_str()));
     }
 }
+
+GstStructure *get_inference_instance_stats(GvaBaseInference *base_inference) {
+    // Instance may be released by streaming thread (on caps change or stop) while application reads stats, so it's
+    // accessed under pool lock
+    std::lock_guard<std::mutex> guard(inference_pool_mutex_);
+    if (!base_inference->model_instance_id)
+        return nullptr;
+    auto it = inference_pool_.find(get_inference_key(base_inference));
+    if (it == inference_pool_.end() || !it->second->proxy || !it->second->refs.count(base_inference))
+        return nullptr;
+    return it->second->proxy->GetStats();
+}
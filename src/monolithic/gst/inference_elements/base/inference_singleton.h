@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2021 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -27,6 +27,8 @@ typedef struct _GvaBaseInference GvaBaseInference;
 gboolean registerElement(GvaBaseInference *base_inference);
 InferenceImpl *acquire_inference_instance(GvaBaseInference *base_inference);
 void release_inference_instance(GvaBaseInference *base_inference);
+// Returns statistics of inference instance used by element, nullptr if element has no instance
+GstStructure *get_inference_instance_stats(GvaBaseInference *base_inference);
 
 #ifdef __cplusplus
 } /* extern C */
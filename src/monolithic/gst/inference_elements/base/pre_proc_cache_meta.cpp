@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "pre_proc_cache_meta.h"
+
+#include <gst/video/video.h>
+
+namespace {
+
+gboolean pre_proc_cache_meta_init(GstMeta *meta, gpointer, GstBuffer *) {
+    reinterpret_cast<GstGVAPreProcCacheMeta *>(meta)->cache = nullptr;
+    return TRUE;
+}
+
+void pre_proc_cache_meta_free(GstMeta *meta, GstBuffer *) {
+    auto cache_meta = reinterpret_cast<GstGVAPreProcCacheMeta *>(meta);
+    delete cache_meta->cache;
+    cache_meta->cache = nullptr;
+}
+
+gboolean pre_proc_cache_meta_transform(GstBuffer *dest_buf, GstMeta *src_meta, GstBuffer *, GQuark type,
+                                       gpointer data) {
+    // Cached regions are valid only for the same picture, so cache is shared only by whole buffer copies
+    if (!GST_META_TRANSFORM_IS_COPY(type) || static_cast<GstMetaTransformCopy *>(data)->region)
+        return FALSE;
+
+    auto src = reinterpret_cast<GstGVAPreProcCacheMeta *>(src_meta);
+    if (!src->cache || gst_buffer_get_meta(dest_buf, gst_gva_pre_proc_cache_meta_api_get_type()))
+        return TRUE;
+    auto dst = reinterpret_cast<GstGVAPreProcCacheMeta *>(
+        gst_buffer_add_meta(dest_buf, gst_gva_pre_proc_cache_meta_get_info(), nullptr));
+    if (!dst)
+        return FALSE;
+    dst->cache = new InferenceBackend::PreProcCache::Ptr(*src->cache);
+    return TRUE;
+}
+
+} // namespace
+
+GType gst_gva_pre_proc_cache_meta_api_get_type(void) {
+    static GType type;
+    static const gchar *tags[] = {GST_META_TAG_VIDEO_STR, GST_META_TAG_VIDEO_SIZE_STR,
+                                  GST_META_TAG_VIDEO_ORIENTATION_STR, GST_META_TAG_VIDEO_COLORSPACE_STR, nullptr};
+
+    if (g_once_init_enter(&type)) {
+        GType _type = gst_meta_api_type_register(GVA_PRE_PROC_CACHE_META_API_NAME, tags);
+        g_once_init_leave(&type, _type);
+    }
+    return type;
+}
+
+const GstMetaInfo *gst_gva_pre_proc_cache_meta_get_info(void) {
+    static const GstMetaInfo *meta_info = nullptr;
+
+    if (g_once_init_enter(&meta_info)) {
+        const GstMetaInfo *meta = gst_meta_register(
+            gst_gva_pre_proc_cache_meta_api_get_type(), GVA_PRE_PROC_CACHE_META_IMPL_NAME,
+            sizeof(GstGVAPreProcCacheMeta), pre_proc_cache_meta_init, pre_proc_cache_meta_free,
+            pre_proc_cache_meta_transform);
+        g_once_init_leave(&meta_info, meta);
+    }
+    return meta_info;
+}
+
+InferenceBackend::PreProcCache::Ptr gva_pre_proc_cache_get_or_add(GstBuffer *buffer) {
+    auto meta = reinterpret_cast<GstGVAPreProcCacheMeta *>(
+        gst_buffer_get_meta(buffer, gst_gva_pre_proc_cache_meta_api_get_type()));
+    if (!meta)
+        meta = reinterpret_cast<GstGVAPreProcCacheMeta *>(
+            gst_buffer_add_meta(buffer, gst_gva_pre_proc_cache_meta_get_info(), nullptr));
+    if (!meta)
+        return nullptr;
+    if (!meta->cache)
+        meta->cache = new InferenceBackend::PreProcCache::Ptr(std::make_shared<InferenceBackend::PreProcCache>());
+    return *meta->cache;
+}
+
+InferenceBackend::PreProcCache::Ptr gva_pre_proc_cache_get(GstBuffer *buffer) {
+    auto meta = reinterpret_cast<GstGVAPreProcCacheMeta *>(
+        gst_buffer_get_meta(buffer, gst_gva_pre_proc_cache_meta_api_get_type()));
+    if (!meta || !meta->cache)
+        return nullptr;
+    return *meta->cache;
+}
@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <inference_backend/pre_proc_cache.h>
+
+#include <gst/gst.h>
+
+#define GVA_PRE_PROC_CACHE_META_API_NAME "GstGVAPreProcCacheMetaAPI"
+#define GVA_PRE_PROC_CACHE_META_IMPL_NAME "GstGVAPreProcCacheMeta"
+
+/**
+ * Holds pre-processing cache of the frame. Buffer copies share the cache, so it's available to all inference elements
+ * downstream. Meta is tagged as depending on video size, orientation and colorspace, so elements changing the picture
+ * drop it.
+ */
+struct GstGVAPreProcCacheMeta {
+    GstMeta meta;
+    InferenceBackend::PreProcCache::Ptr *cache;
+};
+
+GType gst_gva_pre_proc_cache_meta_api_get_type(void);
+const GstMetaInfo *gst_gva_pre_proc_cache_meta_get_info(void);
+
+// Returns cache attached to the buffer, attaches new one if buffer has no cache. Buffer must be writable in latter case
+InferenceBackend::PreProcCache::Ptr gva_pre_proc_cache_get_or_add(GstBuffer *buffer);
+// Returns cache attached to the buffer, nullptr if buffer has no cache
+InferenceBackend::PreProcCache::Ptr gva_pre_proc_cache_get(GstBuffer *buffer);
@@ -26,19 +26,13 @@ struct InferenceFrame {
     GstVideoRegionOfInterestMeta roi;
     std::vector<GstStructure *> roi_classifications; // length equals to output layers count
     GvaBaseInference *gva_base_inference;
-    GstVideoInfo *info;
+    std::shared_ptr<GstVideoInfo> info; // shared by all frames of the element with the same caps, don't modify
 
     InferenceBackend::ImageTransformationParams::Ptr image_transform_info = nullptr;
 
     InferenceFrame() = default;
     InferenceFrame(const InferenceFrame &) = delete;
     InferenceFrame &operator=(const InferenceFrame &rhs) = delete;
-    ~InferenceFrame() {
-        if (info) {
-            gst_video_info_free(info);
-            info = nullptr;
-        }
-    }
 };
 
 using InputPreprocessingFunction = std::function<void(const InferenceBackend::InputBlob::Ptr &)>;
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -96,14 +96,12 @@ validateModelProcOutputs(const std::map<std::string, GstStructure *> &model_proc
 }
 
 void loadLabelsFromFile(const std::string &layer_name, const std::string &labels_file,
-                        std::map<std::string, std::vector<std::string>> &labels) {
+                        std::map<std::string, post_processing::LabelsPtr> &labels) {
     if (!Utils::fileExists(labels_file))
         throw std::invalid_argument("Labels file '" + labels_file + "' does not exist");
 
-    std::ifstream file_stream(labels_file);
-    labels[layer_name] = std::vector<std::string>();
-    for (std::string line; std::getline(file_stream, line);)
-        labels[layer_name].emplace_back(std::move(line));
+    // Labels are shared with cache, not copied
+    labels[layer_name] = readLabelsFile(labels_file);
 }
 
 void fillModelLabels(post_processing::PostProcessorImpl::Initializer &initializer, const std::string &labels_str) {
@@ -144,7 +142,7 @@ void fillModelLabels(post_processing::PostProcessorImpl::Initializer &initialize
                     }
                     g_value_array_free(labels_raw);
                 }
-                initializer.labels[proc.first] = labels;
+                initializer.labels[proc.first] = std::make_shared<const std::vector<std::string>>(std::move(labels));
             } else if (labels_field_type == G_TYPE_STRING) {
                 const std::string labels_file(gst_structure_get_string(proc.second, "labels"));
                 loadLabelsFromFile(proc.first, labels_file, initializer.labels);
@@ -153,7 +151,7 @@ void fillModelLabels(post_processing::PostProcessorImpl::Initializer &initialize
     }
 
     if (initializer.labels.empty())
-        initializer.labels.insert(std::make_pair(ANY_LAYER_NAME, std::vector<std::string>{}));
+        initializer.labels.insert(std::make_pair(ANY_LAYER_NAME, std::make_shared<const std::vector<std::string>>()));
 }
 
 } /* anonymous namespace */
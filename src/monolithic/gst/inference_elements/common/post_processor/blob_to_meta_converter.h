@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -28,7 +28,7 @@ class BlobToMetaConverter {
         ModelOutputsInfo outputs_info;
 
         GstStructureUniquePtr model_proc_output_info;
-        std::vector<std::string> labels;
+        LabelsPtr labels; // nullptr if model has no labels
     };
 
   private:
@@ -37,7 +37,7 @@ class BlobToMetaConverter {
     const ModelOutputsInfo outputs_info;
 
     GstStructureUniquePtr model_proc_output_info;
-    const std::vector<std::string> labels;
+    const LabelsPtr labels;
 
   protected:
     const ModelImageInputInfo &getModelInputImageInfo() const {
@@ -54,7 +54,8 @@ class BlobToMetaConverter {
         return model_proc_output_info;
     }
     const std::vector<std::string> &getLabels() const {
-        return labels;
+        static const std::vector<std::string> no_labels;
+        return labels ? *labels : no_labels;
     }
     const std::string &getLabelByLabelId(size_t label_id) const {
         static const std::string empty_label;
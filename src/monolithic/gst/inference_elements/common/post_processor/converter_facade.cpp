@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -77,7 +77,7 @@ CoordinatesRestorer::Ptr ConverterFacade::createCoordinatesRestorer(ConverterTyp
 ConverterFacade::ConverterFacade(std::unordered_set<std::string> all_layer_names, GstStructure *model_proc_output_info,
                                  ConverterType converter_type, AttachType attach_type,
                                  const ModelImageInputInfo &input_image_info, const ModelOutputsInfo &outputs_info,
-                                 const std::string &model_name, const std::vector<std::string> &labels)
+                                 const std::string &model_name, const LabelsPtr &labels)
     : layer_names_to_process(std::move(all_layer_names)), process_all_outputs(true) {
 
     GstStructureUniquePtr smart_model_proc_output_info(gst_structure_copy(model_proc_output_info), gst_structure_free);
@@ -98,7 +98,7 @@ ConverterFacade::ConverterFacade(std::unordered_set<std::string> all_layer_names
 ConverterFacade::ConverterFacade(GstStructure *model_proc_output_info, ConverterType converter_type,
                                  AttachType attach_type, const ModelImageInputInfo &input_image_info,
                                  const ModelOutputsInfo &outputs_info, const std::string &model_name,
-                                 const std::vector<std::string> &labels)
+                                 const LabelsPtr &labels)
     : process_all_outputs(false) {
     if (model_proc_output_info == nullptr) {
         throw std::runtime_error("Can not get model_proc output information.");
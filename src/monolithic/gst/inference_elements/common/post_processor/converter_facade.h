@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -42,11 +42,10 @@ class ConverterFacade {
   public:
     ConverterFacade(std::unordered_set<std::string> all_layer_names, GstStructure *model_proc_output_info,
                     ConverterType converter_type, AttachType attach_type, const ModelImageInputInfo &input_image_info,
-                    const ModelOutputsInfo &outputs_info, const std::string &model_name,
-                    const std::vector<std::string> &labels);
+                    const ModelOutputsInfo &outputs_info, const std::string &model_name, const LabelsPtr &labels);
     ConverterFacade(GstStructure *model_proc_output_info, ConverterType converter_type, AttachType attach_type,
                     const ModelImageInputInfo &input_image_info, const ModelOutputsInfo &outputs_info,
-                    const std::string &model_name, const std::vector<std::string> &labels);
+                    const std::string &model_name, const LabelsPtr &labels);
 
     void convert(const OutputBlobs &all_output_blobs, FramesWrapper &frames) const;
 
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -267,7 +267,8 @@ BlobToMetaConverter::Ptr YOLOBaseConverter::create(BlobToMetaConverter::Initiali
     try {
         GstStructure *model_proc_output_info = initializer.model_proc_output_info.get();
 
-        const auto classes_number = getClassesNum(model_proc_output_info, initializer.labels.size());
+        const size_t labels_number = initializer.labels ? initializer.labels->size() : 0;
+        const auto classes_number = getClassesNum(model_proc_output_info, labels_number);
         if (!classes_number)
             throw std::runtime_error("Number of classes if null.");
 
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -44,28 +44,35 @@ void CoordinatesRestorer::restoreActualCoordinates(const FrameWrapper &frame, T
     real_y = orig_img_abs_y / frame.roi->h;
 }
 
-void ROICoordinatesRestorer::clipNormalizedRect(double &real_x_min, double &real_y_min, double &real_x_max,
-                                                double &real_y_max) {
-    if (!((real_x_min >= 0) && (real_y_min >= 0) && (real_x_max < +1) && (real_y_max < +1))) {
-        GST_DEBUG("ROI coordinates top_left=[%.5lf, %.5lf], right_bottom=[%.5lf, %.5lf] are out of range [0,1] and "
-                  "will be clipped",
-                  real_x_min, real_y_min, real_x_max, real_y_max);
-
-        real_x_min = (real_x_min < 0) ? 0 : (real_x_min > 1) ? 1 : real_x_min;
-        real_y_min = (real_y_min < 0) ? 0 : (real_y_min > 1) ? 1 : real_y_min;
-        real_x_max = (real_x_max < 0) ? 0 : (real_x_max > 1) ? 1 : real_x_max;
-        real_y_max = (real_y_max < 0) ? 0 : (real_y_max > 1) ? 1 : real_y_max;
+/**
+ * Same transformation as restoreActualCoordinates() does for one point, as scale and offset per axis.
+ */
+BoxTransform CoordinatesRestorer::actualCoordinatesTransform(const FrameWrapper &frame) const {
+    const InferenceBackend::ImageTransformationParams::Ptr pre_proc_info = frame.image_transform_info;
+    if (!(pre_proc_info && pre_proc_info->WasTransformation()))
+        return BoxTransform();
+
+    double offset_x = 0, offset_y = 0;
+    double scale_x = 1, scale_y = 1;
+    if (pre_proc_info->WasPadding()) {
+        offset_x -= pre_proc_info->padding_size_x;
+        offset_y -= pre_proc_info->padding_size_y;
+    }
+    if (pre_proc_info->WasCrop()) {
+        offset_x += pre_proc_info->croped_border_size_x;
+        offset_y += pre_proc_info->croped_border_size_y;
+    }
+    if (pre_proc_info->WasResize()) {
+        if (pre_proc_info->resize_scale_x)
+            scale_x = pre_proc_info->resize_scale_x;
+        if (pre_proc_info->resize_scale_y)
+            scale_y = pre_proc_info->resize_scale_y;
     }
-}
 
-void ROICoordinatesRestorer::getAbsoluteCoordinates(int orig_image_width, int orig_image_height, double real_x_min,
-                                                    double real_y_min, double real_x_max, double real_y_max,
-                                                    uint32_t &abs_x, uint32_t &abs_y, uint32_t &abs_w,
-                                                    uint32_t &abs_h) {
-    abs_x = safe_convert<uint32_t>(real_x_min * orig_image_width + 0.5);
-    abs_y = safe_convert<uint32_t>(real_y_min * orig_image_height + 0.5);
-    abs_w = safe_convert<uint32_t>((real_x_max - real_x_min) * orig_image_width + 0.5);
-    abs_h = safe_convert<uint32_t>((real_y_max - real_y_min) * orig_image_height + 0.5);
+    const double norm_x = scale_x * frame.roi->w;
+    const double norm_y = scale_y * frame.roi->h;
+    return BoxTransform::scale(input_info.width / norm_x, input_info.height / norm_y, offset_x / norm_x,
+                               offset_y / norm_y);
 }
 
 /**
@@ -92,67 +99,59 @@ GstVideoRegionOfInterestMeta *ROICoordinatesRestorer::findDetectionMeta(const Fr
     return meta;
 }
 
-void ROICoordinatesRestorer::updateCoordinatesToFullFrame(double &x_min, double &y_min, double &x_max, double &y_max,
-                                                          const FrameWrapper &frame) {
+/**
+ * Transformation of model output coordinates to normalized coordinates in the full frame.
+ */
+BoxTransform ROICoordinatesRestorer::fullFrameTransform(const FrameWrapper &frame) {
+    BoxTransform transform = actualCoordinatesTransform(frame);
+
     /* In case of gvadetect with inference-region=roi-list we get coordinates relative to ROI.
      * We need to convert them to coordinates relative to the full frame. */
     if (attach_type == AttachType::TO_ROI) {
         GstVideoRegionOfInterestMeta *meta = findDetectionMeta(frame);
         if (meta) {
-            x_min = (meta->x + meta->w * x_min) / frame.width;
-            y_min = (meta->y + meta->h * y_min) / frame.height;
-            x_max = (meta->x + meta->w * x_max) / frame.width;
-            y_max = (meta->y + meta->h * y_max) / frame.height;
+            const double width = frame.width, height = frame.height;
+            transform = transform.then(BoxTransform::scale(meta->w / width, meta->h / height, meta->x / width,
+                                                           meta->y / height));
         }
     }
+    return transform;
 }
 
-void ROICoordinatesRestorer::getRealCoordinates(GstStructure *detection_tensor, double &x_min_real, double &y_min_real,
-                                                double &x_max_real, double &y_max_real) {
-    gst_structure_get(detection_tensor, "x_min", G_TYPE_DOUBLE, &x_min_real, "x_max", G_TYPE_DOUBLE, &x_max_real,
-                      "y_min", G_TYPE_DOUBLE, &y_min_real, "y_max", G_TYPE_DOUBLE, &y_max_real, NULL);
-}
-
-void ROICoordinatesRestorer::getCoordinates(GstStructure *detection_tensor, const FrameWrapper &frame,
-                                            double &x_min_real, double &y_min_real, double &x_max_real,
-                                            double &y_max_real, uint32_t &x_abs, uint32_t &y_abs, uint32_t &w_abs,
-                                            uint32_t &h_abs) {
-
-    getRealCoordinates(detection_tensor, x_min_real, y_min_real, x_max_real, y_max_real);
-
-    if (frame.image_transform_info and frame.image_transform_info->WasTransformation()) {
-        restoreActualCoordinates(frame, x_min_real, y_min_real);
-        restoreActualCoordinates(frame, x_max_real, y_max_real);
-    }
-
-    updateCoordinatesToFullFrame(x_min_real, y_min_real, x_max_real, y_max_real, frame);
-
-    clipNormalizedRect(x_min_real, y_min_real, x_max_real, y_max_real);
-
-    getAbsoluteCoordinates(frame.width, frame.height, x_min_real, y_min_real, x_max_real, y_max_real, x_abs, y_abs,
-                           w_abs, h_abs);
-}
-
-void ROICoordinatesRestorer::restore(TensorsTable &tensors_batch, const FramesWrapper &frames) {
+/**
+ * Restores coordinates of all detections of a frame at once: boxes are gathered into BoxBatch, transformed to the full
+ * frame and clipped in one pass. Normalized coordinates are written back to detection tensors, absolute ones are kept
+ * in FrameWrapper::boxes for ROIToFrameAttacher.
+ */
+void ROICoordinatesRestorer::restore(TensorsTable &tensors_batch, FramesWrapper &frames) {
     try {
         checkFramesAndTensorsTable(frames, tensors_batch);
 
         for (size_t i = 0; i < frames.size(); ++i) {
-            const auto &frame = frames[i];
+            auto &frame = frames[i];
             const auto &tensor = tensors_batch[i];
+            BoxBatch &boxes = frame.boxes;
+            boxes.clear();
+            if (tensor.empty())
+                continue;
 
+            const BoxTransform transform = fullFrameTransform(frame);
+            boxes.resize(tensor.size());
             for (size_t j = 0; j < tensor.size(); ++j) {
-                GstStructure *detection_tensor = tensor[j];
+                gst_structure_get(tensor[j], "x_min", G_TYPE_DOUBLE, &boxes.x_min[j], "x_max", G_TYPE_DOUBLE,
+                                  &boxes.x_max[j], "y_min", G_TYPE_DOUBLE, &boxes.y_min[j], "y_max", G_TYPE_DOUBLE,
+                                  &boxes.y_max[j], NULL);
+            }
 
-                double x_min_real, y_min_real, x_max_real, y_max_real;
-                uint32_t x_abs, y_abs, w_abs, h_abs;
-                getCoordinates(detection_tensor, frame, x_min_real, y_min_real, x_max_real, y_max_real, x_abs, y_abs,
-                               w_abs, h_abs);
+            const size_t clipped = transform_and_clip(boxes, transform);
+            if (clipped)
+                GST_DEBUG("Coordinates of %zu ROI(s) were out of range [0,1] and clipped", clipped);
+            to_absolute(boxes, frame.width, frame.height);
 
-                gst_structure_set(detection_tensor, "x_min", G_TYPE_DOUBLE, x_min_real, "x_max", G_TYPE_DOUBLE,
-                                  x_max_real, "y_min", G_TYPE_DOUBLE, y_min_real, "y_max", G_TYPE_DOUBLE, y_max_real,
-                                  "x_abs", G_TYPE_UINT, x_abs, "y_abs", G_TYPE_UINT, y_abs, "w_abs", G_TYPE_UINT, w_abs,
-                                  "h_abs", G_TYPE_UINT, h_abs, NULL);
+            for (size_t j = 0; j < tensor.size(); ++j) {
+                gst_structure_set(tensor[j], "x_min", G_TYPE_DOUBLE, boxes.x_min[j], "x_max", G_TYPE_DOUBLE,
+                                  boxes.x_max[j], "y_min", G_TYPE_DOUBLE, boxes.y_min[j], "y_max", G_TYPE_DOUBLE,
+                                  boxes.y_max[j], NULL);
             }
         }
     } catch (const std::exception &e) {
@@ -160,7 +159,7 @@ void ROICoordinatesRestorer::restore(TensorsTable &tensors_batch, const FramesWr
     }
 }
 
-void KeypointsCoordinatesRestorer::restore(TensorsTable &tensors, const FramesWrapper &frames) {
+void KeypointsCoordinatesRestorer::restore(TensorsTable &tensors, FramesWrapper &frames) {
     try {
         checkFramesAndTensorsTable(frames, tensors);
 
@@ -8,6 +8,8 @@
 
 #include "post_proc_common.h"
 
+#include "box_batch.h"
+
 #include <gst/gst.h>
 #include <gst/video/gstvideometa.h>
 
@@ -21,13 +23,14 @@ class CoordinatesRestorer {
 
     template <typename T>
     void restoreActualCoordinates(const FrameWrapper &frame, T &real_x, T &real_y);
+    BoxTransform actualCoordinatesTransform(const FrameWrapper &frame) const;
 
   public:
     CoordinatesRestorer(const ModelImageInputInfo &input_info, AttachType type)
         : input_info(input_info), attach_type(type) {
     }
 
-    virtual void restore(TensorsTable &tensors_batch, const FramesWrapper &frames) = 0;
+    virtual void restore(TensorsTable &tensors_batch, FramesWrapper &frames) = 0;
 
     using Ptr = std::unique_ptr<CoordinatesRestorer>;
 
@@ -36,25 +39,15 @@ class CoordinatesRestorer {
 
 class ROICoordinatesRestorer : public CoordinatesRestorer {
   protected:
-    void clipNormalizedRect(double &real_x_min, double &real_y_min, double &real_x_max, double &real_y_max);
     GstVideoRegionOfInterestMeta *findDetectionMeta(const FrameWrapper &frame);
-    void updateCoordinatesToFullFrame(double &x_min, double &y_min, double &x_max, double &y_max,
-                                      const FrameWrapper &frame);
-    void getAbsoluteCoordinates(int orig_image_width, int orig_image_height, double real_x_min, double real_y_min,
-                                double real_x_max, double real_y_max, uint32_t &abs_x, uint32_t &abs_y, uint32_t &abs_w,
-                                uint32_t &abs_h);
-    void getRealCoordinates(GstStructure *detection_tensor, double &x_min_real, double &y_min_real, double &x_max_real,
-                            double &y_max_real);
-    void getCoordinates(GstStructure *detection_tensor, const FrameWrapper &frame, double &x_min_real,
-                        double &y_min_real, double &x_max_real, double &y_max_real, uint32_t &x_abs, uint32_t &y_abs,
-                        uint32_t &w_abs, uint32_t &h_abs);
+    BoxTransform fullFrameTransform(const FrameWrapper &frame);
 
   public:
     ROICoordinatesRestorer(const ModelImageInputInfo &input_info, AttachType type)
         : CoordinatesRestorer(input_info, type) {
     }
 
-    virtual void restore(TensorsTable &tensors_batch, const FramesWrapper &frames) override;
+    virtual void restore(TensorsTable &tensors_batch, FramesWrapper &frames) override;
 };
 
 class KeypointsCoordinatesRestorer : public CoordinatesRestorer {
@@ -69,7 +62,7 @@ class KeypointsCoordinatesRestorer : public CoordinatesRestorer {
         : CoordinatesRestorer(input_info, type) {
     }
 
-    void restore(TensorsTable &tensors_batch, const FramesWrapper &frames) override;
+    void restore(TensorsTable &tensors_batch, FramesWrapper &frames) override;
 };
 
 } // namespace post_processing
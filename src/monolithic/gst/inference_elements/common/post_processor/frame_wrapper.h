@@ -8,6 +8,8 @@
 
 #include "inference_backend/image_inference.h"
 
+#include "box_batch.h"
+
 #include <gst/video/gstvideometa.h>
 
 struct _GvaBaseInference;
@@ -30,6 +32,8 @@ class FrameWrapper {
     size_t width;
     size_t height;
     std::vector<GstStructure *> *roi_classifications;
+    /* detections of this frame restored by ROICoordinatesRestorer, in the order of tensors */
+    BoxBatch boxes;
 };
 
 using InferenceFrames = std::vector<std::shared_ptr<InferenceFrame>>;
@@ -41,20 +41,33 @@ void ROIToFrameAttacher::attach(const TensorsTable &tensors, FramesWrapper &fram
     for (size_t i = 0; i < frames.size(); ++i) {
         auto &frame = frames[i];
         const auto &tensor = tensors[i];
+        if (tensor.empty())
+            continue;
+
+        GstBuffer **writable_buffer = &frame.buffer;
+        gva_buffer_check_and_make_writable(writable_buffer, PRETTY_FUNCTION_NAME);
+        // Coordinates restored by ROICoordinatesRestorer are taken from the batch instead of structure fields
+        const BoxBatch &boxes = frame.boxes;
+        const bool restored = boxes.size() == tensor.size();
 
         for (size_t j = 0; j < tensor.size(); ++j) {
             GstStructure *detection_tensor = tensor[j];
 
-            uint32_t x_abs, y_abs, w_abs, h_abs;
-            gst_structure_get_uint(detection_tensor, "x_abs", &x_abs);
-            gst_structure_get_uint(detection_tensor, "y_abs", &y_abs);
-            gst_structure_get_uint(detection_tensor, "w_abs", &w_abs);
-            gst_structure_get_uint(detection_tensor, "h_abs", &h_abs);
+            uint32_t x_abs = 0, y_abs = 0, w_abs = 0, h_abs = 0;
+            if (restored) {
+                x_abs = boxes.x[j];
+                y_abs = boxes.y[j];
+                w_abs = boxes.w[j];
+                h_abs = boxes.h[j];
+            } else {
+                gst_structure_get_uint(detection_tensor, "x_abs", &x_abs);
+                gst_structure_get_uint(detection_tensor, "y_abs", &y_abs);
+                gst_structure_get_uint(detection_tensor, "w_abs", &w_abs);
+                gst_structure_get_uint(detection_tensor, "h_abs", &h_abs);
+            }
 
             const gchar *label = gst_structure_get_string(detection_tensor, "label");
 
-            GstBuffer **writable_buffer = &frame.buffer;
-            gva_buffer_check_and_make_writable(writable_buffer, PRETTY_FUNCTION_NAME);
             GstVideoRegionOfInterestMeta *roi_meta =
                 gst_buffer_add_video_region_of_interest_meta(*writable_buffer, label, x_abs, y_abs, w_abs, h_abs);
 
@@ -63,11 +76,10 @@ void ROIToFrameAttacher::attach(const TensorsTable &tensors, FramesWrapper &fram
 
             roi_meta->id = gst_util_seqnum_next();
 
-            gst_structure_remove_field(detection_tensor, "label");
-            gst_structure_remove_field(detection_tensor, "x_abs");
-            gst_structure_remove_field(detection_tensor, "y_abs");
-            gst_structure_remove_field(detection_tensor, "w_abs");
-            gst_structure_remove_field(detection_tensor, "h_abs");
+            if (restored)
+                gst_structure_remove_field(detection_tensor, "label");
+            else
+                gst_structure_remove_fields(detection_tensor, "label", "x_abs", "y_abs", "w_abs", "h_abs", NULL);
 
             gst_video_region_of_interest_meta_add_param(roi_meta, detection_tensor);
         }
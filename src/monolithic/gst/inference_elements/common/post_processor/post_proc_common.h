@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -22,6 +22,8 @@ using TensorsTable = std::vector<std::vector<GstStructure *>>;
 using OutputBlobs = std::map<std::string, InferenceBackend::OutputBlob::Ptr>;
 // <layer_name, blob_dims>
 using ModelOutputsInfo = std::map<std::string, std::vector<size_t>>;
+// Labels are shared by converters and with labels files cache
+using LabelsPtr = std::shared_ptr<const std::vector<std::string>>;
 
 enum class ConverterType { TO_ROI, TO_TENSOR, RAW };
 enum class AttachType { TO_FRAME, TO_ROI, FOR_MICRO /* remove workaround when moved to micro elements */ };
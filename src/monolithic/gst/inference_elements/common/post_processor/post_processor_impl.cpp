@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021-2022 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -87,10 +87,10 @@ PostProcessorImpl::PostProcessorImpl(Initializer initializer) {
                                   initializer.threshold, NULL);
             }
 
-            const std::vector<std::string> labels =
+            const LabelsPtr labels =
                 (initializer.labels.find(model_proc_outputs.cbegin()->first) != initializer.labels.cend())
                     ? initializer.labels.at(model_proc_outputs.cbegin()->first)
-                    : std::vector<std::string>{};
+                    : nullptr;
 
             converters.emplace_back(layer_names, model_proc_outputs.cbegin()->second, initializer.converter_type,
                                     initializer.attach_type, initializer.image_info, initializer.model_outputs,
@@ -106,10 +106,9 @@ PostProcessorImpl::PostProcessorImpl(Initializer initializer) {
                                       initializer.threshold, NULL);
                 }
 
-                const std::vector<std::string> labels =
-                    (initializer.labels.find(model_proc_output.first) != initializer.labels.cend())
-                        ? initializer.labels.at(model_proc_output.first)
-                        : std::vector<std::string>{};
+                const LabelsPtr labels = (initializer.labels.find(model_proc_output.first) != initializer.labels.cend())
+                                             ? initializer.labels.at(model_proc_output.first)
+                                             : nullptr;
 
                 converters.emplace_back(model_proc_output.second, initializer.converter_type, initializer.attach_type,
                                         initializer.image_info, initializer.model_outputs, initializer.model_name,
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2021 Intel Corporation
+ * Copyright (C) 2021-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -35,7 +35,7 @@ class PostProcessorImpl {
         ModelOutputsInfo model_outputs;
         /* model proc info */
         std::map<std::string, GstStructure *> output_processors;
-        std::map<std::string, std::vector<std::string>> labels;
+        std::map<std::string, LabelsPtr> labels;
         /* other */
         ConverterType converter_type;
         AttachType attach_type;
@@ -200,4 +200,14 @@ GetInputPreprocessors(const std::shared_ptr<InferenceBackend::ImageInference> &i
     return preprocessors;
 }
 
+bool InputPreprocessorsDependOnRoi(const std::vector<ModelInputProcessorInfo::Ptr> &model_input_processor_info) {
+    for (const ModelInputProcessorInfo::Ptr &preproc : model_input_processor_info) {
+        if (preproc->format == "sequence_index" || preproc->format == "image_info")
+            continue;
+        if (preproc->params && gst_structure_has_field(preproc->params, "alignment_points"))
+            return true;
+    }
+    return false;
+}
+
 InputPreprocessorsFactory GET_INPUT_PREPROCESSORS = GetInputPreprocessors;
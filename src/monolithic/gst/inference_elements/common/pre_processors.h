@@ -17,6 +17,10 @@ GetInputPreprocessors(const std::shared_ptr<InferenceBackend::ImageInference> &i
                       const std::vector<ModelInputProcessorInfo::Ptr> &model_input_processor_info,
                       GstVideoRegionOfInterestMeta *roi);
 
+// Returns true if input pre-processors created by GetInputPreprocessors differ for different ROIs (face alignment uses
+// landmarks of the ROI), otherwise they can be created once and reused
+bool InputPreprocessorsDependOnRoi(const std::vector<ModelInputProcessorInfo::Ptr> &model_input_processor_info);
+
 extern "C" {
 
 #endif // __cplusplus
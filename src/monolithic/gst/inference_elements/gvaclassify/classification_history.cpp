@@ -12,6 +12,22 @@
 #include <video_frame.h>
 
 #include <algorithm>
+#include <climits>
+
+namespace {
+
+double IntersectionOverUnion(const GVA::Rect<uint32_t> &a, const GVA::Rect<uint32_t> &b) {
+    const double x1 = std::max(a.x, b.x);
+    const double y1 = std::max(a.y, b.y);
+    const double x2 = std::min(static_cast<double>(a.x) + a.w, static_cast<double>(b.x) + b.w);
+    const double y2 = std::min(static_cast<double>(a.y) + a.h, static_cast<double>(b.y) + b.h);
+    if (x2 <= x1 || y2 <= y1)
+        return 0;
+    const double intersection = (x2 - x1) * (y2 - y1);
+    return intersection / (static_cast<double>(a.w) * a.h + static_cast<double>(b.w) * b.h - intersection);
+}
+
+} // namespace
 
 ClassificationHistory::ClassificationHistory(GstGvaClassify *gva_classify)
     : gva_classify(gva_classify), current_num_frame(0), history(CLASSIFICATION_HISTORY_SIZE) {
@@ -26,15 +42,23 @@ bool ClassificationHistory::IsROIClassificationNeeded(GstVideoRegionOfInterestMe
         // we have recent classification result or classification is not required for this object
         bool result = false;
         gint id;
-        if (!get_object_id(roi, &id))
-            // object has not been tracked
-            return true;
+        const bool tracked = get_object_id(roi, &id);
+        if (!tracked) {
+            if (gva_classify->match_iou_threshold <= 0)
+                // object has not been tracked
+                return true;
+            id = MatchUntrackedROI(roi);
+            if (!id) {
+                match_misses++;
+                return true;
+            }
+        }
         if (history.count(id) == 0) { // new object
             history.put(id);
             history.get(id).frame_of_last_update = current_num_frame;
             result = true;
         } else if (gva_classify->reclassify_interval == 0) {
-            return false;
+            result = false;
         } else {
             auto current_interval = current_num_frame - history.get(id).frame_of_last_update;
             if (current_interval > INT64_MAX && history.get(id).frame_of_last_update > current_num_frame)
@@ -46,6 +70,12 @@ bool ClassificationHistory::IsROIClassificationNeeded(GstVideoRegionOfInterestMe
             }
         }
 
+        if (!tracked) {
+            if (result)
+                match_misses++;
+            else
+                match_hits++;
+        }
         return result;
     } catch (const std::exception &e) {
         std::throw_with_nested(std::runtime_error("Failed to check if detection tensor classification needed"));
@@ -78,6 +108,13 @@ void ClassificationHistory::FillROIParams(GstBuffer *buffer) {
         std::lock_guard<std::mutex> guard(history_mutex);
         for (GVA::RegionOfInterest &region : video_frame.regions()) {
             gint id = region.object_id();
+            if (!id && gva_classify->match_iou_threshold > 0) {
+                auto it = roi_to_matched_object.find(region.region_id());
+                if (it != roi_to_matched_object.end()) {
+                    id = it->second.first;
+                    roi_to_matched_object.erase(it);
+                }
+            }
             if (!id)
                 continue;
             InferenceImpl *inference = gva_classify->base_inference.inference;
@@ -112,6 +149,76 @@ LRUCache<int, ClassificationHistory::ROIClassificationHistory> &ClassificationHi
     return history;
 }
 
+int ClassificationHistory::GetHistoryId(GstVideoRegionOfInterestMeta *roi) {
+    gint id = 0;
+    if (get_object_id(roi, &id))
+        return id > 0 ? id : 0;
+
+    std::lock_guard<std::mutex> guard(history_mutex);
+    auto it = roi_to_matched_object.find(roi->id);
+    return it != roi_to_matched_object.end() ? it->second.first : 0;
+}
+
+/**
+ * Associates untracked ROI with ROI of the same label seen on previous frames, if their IoU is not less than
+ * match-iou-threshold. Unmatched ROI is remembered for matching on next frames. Expects history_mutex to be locked.
+ *
+ * @return id of matched object in history, 0 if ROI is not matched
+ */
+int ClassificationHistory::MatchUntrackedROI(GstVideoRegionOfInterestMeta *roi) {
+    RemoveStaleMatches();
+
+    const GVA::Rect<uint32_t> rect = {roi->x, roi->y, roi->w, roi->h};
+    MatchedObject *best = nullptr;
+    double best_iou = gva_classify->match_iou_threshold;
+    for (auto &object : matched_objects) {
+        // one object can be matched with only one ROI of a frame
+        if (object.label != roi->roi_type || object.frame_of_last_match == current_num_frame)
+            continue;
+        double iou = IntersectionOverUnion(object.rect, rect);
+        if (iou >= best_iou) {
+            best_iou = iou;
+            best = &object;
+        }
+    }
+
+    if (!best) {
+        if (matched_objects.size() >= CLASSIFICATION_HISTORY_SIZE)
+            matched_objects.erase(matched_objects.begin());
+        last_matched_object_id = last_matched_object_id == INT_MIN ? -1 : last_matched_object_id - 1;
+        matched_objects.push_back({last_matched_object_id, roi->roi_type, rect, current_num_frame});
+        roi_to_matched_object[roi->id] = {last_matched_object_id, current_num_frame};
+        history.put(last_matched_object_id);
+        history.get(last_matched_object_id).frame_of_last_update = current_num_frame;
+        return 0;
+    }
+
+    best->rect = rect;
+    best->frame_of_last_match = current_num_frame;
+    roi_to_matched_object[roi->id] = {best->id, current_num_frame};
+    return best->id;
+}
+
+void ClassificationHistory::RemoveStaleMatches() {
+    // objects not seen within reclassify-interval would be reclassified anyway
+    const uint64_t max_age = gva_classify->reclassify_interval ? gva_classify->reclassify_interval
+                                                                : CLASSIFICATION_HISTORY_SIZE;
+    auto is_stale = [&](uint64_t frame, uint64_t age) { return current_num_frame > frame + age; };
+
+    matched_objects.erase(std::remove_if(matched_objects.begin(), matched_objects.end(),
+                                         [&](const MatchedObject &object) {
+                                             return is_stale(object.frame_of_last_match, max_age);
+                                         }),
+                          matched_objects.end());
+    // ROIs of buffers which didn't reach src pad
+    for (auto it = roi_to_matched_object.begin(); it != roi_to_matched_object.end();) {
+        if (is_stale(it->second.second, CLASSIFICATION_HISTORY_SIZE))
+            it = roi_to_matched_object.erase(it);
+        else
+            ++it;
+    }
+}
+
 void ClassificationHistory::CheckExistingAndReaddObjectId(int roi_id) {
     if (history.count(roi_id) == 0) {
         GVA_WARNING("Classification history size limit is exceeded. "
@@ -140,3 +247,10 @@ void release_classification_history(ClassificationHistory *classification_histor
 void fill_roi_params_from_history(ClassificationHistory *classification_history, GstBuffer *buffer) {
     classification_history->FillROIParams(buffer);
 }
+
+void get_roi_match_counters(ClassificationHistory *classification_history, guint64 *hits, guint64 *misses) {
+    if (hits)
+        *hits = classification_history ? classification_history->match_hits.load() : 0;
+    if (misses)
+        *misses = classification_history ? classification_history->match_misses.load() : 0;
+}
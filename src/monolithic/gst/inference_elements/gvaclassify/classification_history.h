@@ -18,15 +18,20 @@ struct ClassificationHistory;
 struct ClassificationHistory *create_classification_history(GstGvaClassify *gva_classify);
 void release_classification_history(struct ClassificationHistory *classification_history);
 void fill_roi_params_from_history(struct ClassificationHistory *classification_history, GstBuffer *buffer);
+void get_roi_match_counters(struct ClassificationHistory *classification_history, guint64 *hits, guint64 *misses);
 
 G_END_DECLS
 
 #ifdef __cplusplus
 #include "gst_smart_pointer_types.hpp"
 #include "lru_cache.h"
+#include "region_of_interest.h"
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 const size_t CLASSIFICATION_HISTORY_SIZE = 100;
 
@@ -49,12 +54,34 @@ struct ClassificationHistory {
     void FillROIParams(GstBuffer *buffer);
     LRUCache<int, ROIClassificationHistory> &GetHistory();
 
+    // Returns id of the ROI in history: object id if ROI is tracked, id of matched previous ROI if ROI is not tracked
+    // and was matched by IoU, otherwise 0
+    int GetHistoryId(GstVideoRegionOfInterestMeta *roi);
+
+    std::atomic<uint64_t> match_hits{0};   // untracked ROIs which reused classification results
+    std::atomic<uint64_t> match_misses{0}; // untracked ROIs which were classified
+
   private:
+    // Untracked ROI seen on previous frames. Ids are negative to not intersect with object ids set by gvatrack
+    struct MatchedObject {
+        int id;
+        GQuark label;
+        GVA::Rect<uint32_t> rect;
+        uint64_t frame_of_last_match;
+    };
+
     void CheckExistingAndReaddObjectId(int roi_id);
+    int MatchUntrackedROI(GstVideoRegionOfInterestMeta *roi);
+    void RemoveStaleMatches();
 
     GstGvaClassify *gva_classify;
     uint64_t current_num_frame;
     LRUCache<int, ROIClassificationHistory> history;
     std::mutex history_mutex;
+
+    std::vector<MatchedObject> matched_objects;
+    // GstVideoRegionOfInterestMeta id -> id of matched object and frame number, until buffer leaves the element
+    std::unordered_map<int, std::pair<int, uint64_t>> roi_to_matched_object;
+    int last_matched_object_id = 0;
 };
 #endif
@@ -26,12 +26,19 @@
 enum {
     PROP_0,
     PROP_RECLASSIFY_INTERVAL,
+    PROP_MATCH_IOU_THRESHOLD,
+    PROP_MATCH_HITS,
+    PROP_MATCH_MISSES,
 };
 
 #define DEFAULT_RECLASSIFY_INTERVAL 1
 #define DEFAULT_MIN_RECLASSIFY_INTERVAL 0
 #define DEFAULT_MAX_RECLASSIFY_INTERVAL UINT_MAX
 
+#define DEFAULT_MATCH_IOU_THRESHOLD 0.0
+#define DEFAULT_MIN_MATCH_IOU_THRESHOLD 0.0
+#define DEFAULT_MAX_MATCH_IOU_THRESHOLD 1.0
+
 GST_DEBUG_CATEGORY_STATIC(gst_gva_classify_debug_category);
 #define GST_CAT_DEFAULT gst_gva_classify_debug_category
 
@@ -44,6 +51,7 @@ static void gst_gva_classify_finalize(GObject *);
 static void gst_gva_classify_cleanup(GstGvaClassify *);
 static gboolean gst_gva_classify_check_properties_correctness(GstGvaClassify *gvaclassify);
 static gboolean gst_gva_classify_start(GstBaseTransform *trans);
+static gboolean gst_gva_classify_stop(GstBaseTransform *trans);
 
 void gst_gva_classify_set_property(GObject *object, guint property_id, const GValue *value, GParamSpec *pspec) {
     GstGvaClassify *gvaclassify = GST_GVA_CLASSIFY(object);
@@ -69,6 +77,9 @@ void gst_gva_classify_set_property(GObject *object, guint property_id, const GVa
         }
         break;
     }
+    case PROP_MATCH_IOU_THRESHOLD:
+        gvaclassify->match_iou_threshold = g_value_get_double(value);
+        break;
     default: {
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -85,6 +96,16 @@ void gst_gva_classify_get_property(GObject *object, guint property_id, GValue *v
     case PROP_RECLASSIFY_INTERVAL:
         g_value_set_uint(value, gvaclassify->reclassify_interval);
         break;
+    case PROP_MATCH_IOU_THRESHOLD:
+        g_value_set_double(value, gvaclassify->match_iou_threshold);
+        break;
+    case PROP_MATCH_HITS:
+    case PROP_MATCH_MISSES: {
+        guint64 hits = 0, misses = 0;
+        get_roi_match_counters(gvaclassify->classification_history, &hits, &misses);
+        g_value_set_uint64(value, property_id == PROP_MATCH_HITS ? hits : misses);
+        break;
+    }
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -109,6 +130,7 @@ void gst_gva_classify_class_init(GstGvaClassifyClass *gvaclassify_class) {
 
     GstBaseTransformClass *base_transform_class = GST_BASE_TRANSFORM_CLASS(gvaclassify_class);
     base_transform_class->start = GST_DEBUG_FUNCPTR(gst_gva_classify_start);
+    base_transform_class->stop = GST_DEBUG_FUNCPTR(gst_gva_classify_stop);
 
     g_object_class_install_property(
         gobject_class, PROP_RECLASSIFY_INTERVAL,
@@ -124,6 +146,32 @@ void gst_gva_classify_class_init(GstGvaClassifyClass *gvaclassify_class) {
             "inference interval)",
             DEFAULT_MIN_RECLASSIFY_INTERVAL, DEFAULT_MAX_RECLASSIFY_INTERVAL, DEFAULT_RECLASSIFY_INTERVAL,
             (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MATCH_IOU_THRESHOLD,
+        g_param_spec_double(
+            "match-iou-threshold", "Match IoU Threshold",
+            "Applies 'reclassify-interval' to objects not tracked by gvatrack. Object is associated with object of the "
+            "same label on previous frames if Intersection over Union of their bounding boxes is not less than this "
+            "threshold, and classification results are reused for associated object within 'reclassify-interval'. "
+            "0 disables association (untracked objects are classified on every frame). Has effect only if "
+            "'reclassify-interval' is not 1",
+            DEFAULT_MIN_MATCH_IOU_THRESHOLD, DEFAULT_MAX_MATCH_IOU_THRESHOLD, DEFAULT_MATCH_IOU_THRESHOLD,
+            (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MATCH_HITS,
+        g_param_spec_uint64("match-hits", "Match Hits",
+                            "Number of untracked objects which reused classification results of associated object "
+                            "(see 'match-iou-threshold')",
+                            0, G_MAXUINT64, 0, (GParamFlags)(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MATCH_MISSES,
+        g_param_spec_uint64("match-misses", "Match Misses",
+                            "Number of untracked objects which were classified because no associated object was "
+                            "found or 'reclassify-interval' elapsed (see 'match-iou-threshold')",
+                            0, G_MAXUINT64, 0, (GParamFlags)(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
 }
 
 void gst_gva_classify_init(GstGvaClassify *gvaclassify) {
@@ -137,6 +185,7 @@ void gst_gva_classify_init(GstGvaClassify *gvaclassify) {
     gvaclassify->base_inference.type = GST_GVA_CLASSIFY_TYPE;
     gvaclassify->base_inference.inference_region = ROI_LIST;
     gvaclassify->reclassify_interval = DEFAULT_RECLASSIFY_INTERVAL;
+    gvaclassify->match_iou_threshold = DEFAULT_MATCH_IOU_THRESHOLD;
     gvaclassify->classification_history = create_classification_history(gvaclassify);
     if (gvaclassify->classification_history == NULL)
         return;
@@ -188,11 +237,26 @@ gboolean gst_gva_classify_check_properties_correctness(GstGvaClassify *gvaclassi
     return TRUE;
 }
 
+gboolean gst_gva_classify_stop(GstBaseTransform *trans) {
+    GstGvaClassify *gvaclassify = GST_GVA_CLASSIFY(trans);
+
+    if (gvaclassify->match_iou_threshold > 0) {
+        guint64 hits = 0, misses = 0;
+        get_roi_match_counters(gvaclassify->classification_history, &hits, &misses);
+        GST_INFO_OBJECT(gvaclassify,
+                        "Untracked objects: %" G_GUINT64_FORMAT " reused results, %" G_GUINT64_FORMAT " classified",
+                        hits, misses);
+    }
+
+    return GST_BASE_TRANSFORM_CLASS(gst_gva_classify_parent_class)->stop(trans);
+}
+
 gboolean gst_gva_classify_start(GstBaseTransform *trans) {
     GstGvaClassify *gvaclassify = GST_GVA_CLASSIFY(trans);
 
-    GST_INFO_OBJECT(gvaclassify, "%s parameters:\n -- Reclassify interval: %d\n",
-                    GST_ELEMENT_NAME(GST_ELEMENT_CAST(gvaclassify)), gvaclassify->reclassify_interval);
+    GST_INFO_OBJECT(gvaclassify, "%s parameters:\n -- Reclassify interval: %d\n -- Match IoU threshold: %f\n",
+                    GST_ELEMENT_NAME(GST_ELEMENT_CAST(gvaclassify)), gvaclassify->reclassify_interval,
+                    gvaclassify->match_iou_threshold);
 
     if (!gst_gva_classify_check_properties_correctness(gvaclassify))
         return FALSE;
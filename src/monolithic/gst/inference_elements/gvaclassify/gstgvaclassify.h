@@ -22,6 +22,7 @@ typedef struct _GstGvaClassify {
     GvaBaseInference base_inference;
     // properties:
     guint reclassify_interval;
+    gdouble match_iou_threshold;
 
     struct ClassificationHistory *classification_history;
 } GstGvaClassify;
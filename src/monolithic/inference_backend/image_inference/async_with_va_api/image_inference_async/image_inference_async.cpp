@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -19,6 +19,7 @@
 
 #include "safe_arithmetic.hpp"
 
+#include <algorithm>
 #include <future>
 #include <string>
 #include <tuple>
@@ -34,7 +35,9 @@ CREATE_FEATURE_TOGGLE(VaapiPreprocYUVToggle, "vaapi-preproc-yuv",
                       "pre-proc and see if it enables better performance. ")
 
 std::unique_ptr<VaApiImagePool> create_va_api_image_pool(VaApiImagePool::ImageInfo info, size_t pool_size,
-                                                         VaApiContext *context, float vdbox_sfc_pipe_part) {
+                                                         size_t min_pool_size, size_t max_pool_size,
+                                                         uint32_t grow_wait_ms, VaApiContext *context,
+                                                         float vdbox_sfc_pipe_part) {
 
     // If ENABLE_GVA_FEATURES=vaapi-preproc-yuv set, then VA pipeline ends with scaled I420 image and I420->RGBP CSC
     // happens with OpenCV later.
@@ -51,6 +54,9 @@ std::unique_ptr<VaApiImagePool> create_va_api_image_pool(VaApiImagePool::ImageIn
     // vdbox_sfc_pipe_part is checked below to be in range [0,1]
     size_params.num_fast = vdbox_sfc_pipe_part * pool_size;
     size_params.num_default = pool_size - size_params.num_fast;
+    size_params.min_size = safe_convert<uint32_t>(min_pool_size);
+    size_params.max_size = safe_convert<uint32_t>(max_pool_size);
+    size_params.grow_wait_ms = grow_wait_ms;
     return std::unique_ptr<VaApiImagePool>(new VaApiImagePool(context, size_params, info));
 }
 
@@ -88,7 +94,9 @@ ImageInferenceAsync::ImageInferenceAsync(const InferenceBackend::InferenceConfig
                                          dlstreamer::ContextPtr vadpy_context, ImageInference::Ptr inference)
     : _inference(inference) {
     const auto &pre_process_config = config.at(KEY_PRE_PROCESSOR);
-    if (!Utils::checkAllKeysAreKnown({KEY_VAAPI_THREAD_POOL_SIZE, KEY_VAAPI_FAST_SCALE_LOAD_FACTOR},
+    if (!Utils::checkAllKeysAreKnown({KEY_VAAPI_THREAD_POOL_SIZE, KEY_VAAPI_FAST_SCALE_LOAD_FACTOR,
+                                      KEY_VAAPI_IMAGE_POOL_MIN_SIZE, KEY_VAAPI_IMAGE_POOL_MAX_SIZE,
+                                      KEY_VAAPI_IMAGE_POOL_GROW_WAIT_MS},
                                      pre_process_config)) {
         throw std::invalid_argument("Unknown key in pre-processing configuration.");
     }
@@ -120,10 +128,32 @@ ImageInferenceAsync::ImageInferenceAsync(const InferenceBackend::InferenceConfig
     size_t image_pool_size = safe_mul(safe_convert<size_t>(inference_image_info.batch), _inference->GetNireq());
     if (image_pool_size < thread_pool_size)
         image_pool_size = thread_pool_size;
+
+    // By default pool may shrink to one image per pre-processing thread and grow twice of initial size
+    auto min_pool_size_it = pre_process_config.find(KEY_VAAPI_IMAGE_POOL_MIN_SIZE);
+    size_t min_image_pool_size = min_pool_size_it == pre_process_config.end()
+                                     ? std::max<size_t>(thread_pool_size, 1)
+                                     : std::stoull(min_pool_size_it->second);
+    auto max_pool_size_it = pre_process_config.find(KEY_VAAPI_IMAGE_POOL_MAX_SIZE);
+    size_t max_image_pool_size = max_pool_size_it == pre_process_config.end()
+                                     ? safe_mul(image_pool_size, size_t(2))
+                                     : std::stoull(max_pool_size_it->second);
+    if (min_image_pool_size == 0 || min_image_pool_size > max_image_pool_size)
+        throw std::invalid_argument("VAAPI_IMAGE_POOL_MIN_SIZE must be non-zero and not greater than "
+                                    "VAAPI_IMAGE_POOL_MAX_SIZE.");
+    image_pool_size = std::min(std::max(image_pool_size, min_image_pool_size), max_image_pool_size);
+    // Zero (default) keeps pool default, which is longer than typical pre-processing and inference time of a frame
+    auto grow_wait_it = pre_process_config.find(KEY_VAAPI_IMAGE_POOL_GROW_WAIT_MS);
+    const uint32_t grow_wait_ms = grow_wait_it == pre_process_config.end()
+                                      ? 0
+                                      : safe_convert<uint32_t>(std::stoull(grow_wait_it->second));
+
     _va_image_pool =
-        create_va_api_image_pool(inference_image_info, image_pool_size, _va_context.get(), vdbox_sfc_pipe_part);
+        create_va_api_image_pool(inference_image_info, image_pool_size, min_image_pool_size, max_image_pool_size,
+                                 grow_wait_ms, _va_context.get(), vdbox_sfc_pipe_part);
 
-    GVA_INFO("Vpp image pool size: %lu", image_pool_size);
+    GVA_INFO("Vpp image pool size: %lu (min %lu, max %lu)", image_pool_size, min_image_pool_size,
+             max_image_pool_size);
 }
 
 void ImageInferenceAsync::SubmitInference(VaApiImage *va_api_image, IFrameBase::Ptr frame,
@@ -200,6 +230,10 @@ bool ImageInferenceAsync::IsQueueFull() {
     return _inference->IsQueueFull();
 }
 
+ImageInference::Stats ImageInferenceAsync::GetStats() const {
+    return _inference->GetStats();
+}
+
 void ImageInferenceAsync::Flush() {
     if (_va_image_pool) {
         _va_image_pool->Flush();
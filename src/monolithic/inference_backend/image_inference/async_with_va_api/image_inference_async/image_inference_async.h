@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -47,6 +47,8 @@ class ImageInferenceAsync : public ImageInference {
 
     bool IsQueueFull() override;
 
+    Stats GetStats() const override;
+
     void Flush() override;
 
     void Close() override;
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace InferenceBackend {
+
+/**
+ * Pool of items which grows and shrinks between configured bounds. Doesn't depend on item type, items are created by
+ * user provided allocator.
+ *
+ * Free items are kept in a stack, so acquire and release are O(1). If no item becomes free within grow_wait, pool
+ * allocates new item (unless max_size is reached, then it waits for free item). Every shrink_window acquisitions pool
+ * destroys items which stayed free during the whole window, keeping at least min_size items.
+ *
+ * grow_wait should be longer than usual time item is held (e.g. pre-processing plus inference of one frame): with
+ * shorter wait pool grows on every burst and quickly reaches max_size under steady back-pressure, where more items
+ * only add latency.
+ */
+template <typename Item>
+class DynamicPool {
+  public:
+    class Allocator {
+      public:
+        virtual ~Allocator() = default;
+        virtual std::unique_ptr<Item> Allocate() = 0;
+    };
+
+    static constexpr int64_t DEFAULT_GROW_WAIT_US = 20000;
+
+    struct Params {
+        size_t initial_size = 1;
+        size_t min_size = 1;
+        size_t max_size = 1;
+        std::chrono::microseconds grow_wait{DEFAULT_GROW_WAIT_US};
+        uint64_t shrink_window = 1000;
+    };
+
+    struct Stats {
+        size_t size = 0;           // items allocated now
+        size_t in_use = 0;         // items acquired now
+        size_t peak_in_use = 0;    // max number of items acquired at once
+        uint64_t acquires = 0;     // total number of acquisitions
+        uint64_t waits = 0;        // acquisitions which waited for free item
+        uint64_t wait_time_us = 0; // total time of waits
+        uint64_t allocations = 0;  // items allocated, including initial ones
+        uint64_t deallocations = 0;
+    };
+
+    DynamicPool(std::unique_ptr<Allocator> allocator, Params params)
+        : _allocator(std::move(allocator)), _params(params) {
+        if (!_allocator)
+            throw std::invalid_argument("DynamicPool: allocator is nullptr");
+        if (_params.max_size == 0 || _params.min_size > _params.max_size)
+            throw std::invalid_argument("DynamicPool: invalid size bounds");
+        _params.initial_size = std::min(std::max(_params.initial_size, _params.min_size), _params.max_size);
+
+        for (size_t i = 0; i < _params.initial_size; i++)
+            AddItem(_allocator->Allocate());
+        _free_low_water = _free.size();
+    }
+
+    DynamicPool(const DynamicPool &) = delete;
+    DynamicPool &operator=(const DynamicPool &) = delete;
+
+    Item *Acquire() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stats.acquires++;
+
+        if (_free.empty()) {
+            _stats.waits++;
+            const auto start = std::chrono::steady_clock::now();
+            bool grow = false;
+            while (_free.empty() && !grow) {
+                if (_items.size() + _allocating < _params.max_size) {
+                    grow = !_free_cond.wait_for(lock, _params.grow_wait, [this] { return !_free.empty(); });
+                    // other thread could reach max_size while we were waiting
+                    grow = grow && _items.size() + _allocating < _params.max_size;
+                } else {
+                    _free_cond.wait(lock);
+                }
+            }
+            _stats.wait_time_us +=
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                    .count();
+
+            if (grow) {
+                _allocating++;
+                lock.unlock();
+                std::unique_ptr<Item> item;
+                try {
+                    item = _allocator->Allocate();
+                } catch (...) {
+                    lock.lock();
+                    _allocating--;
+                    throw;
+                }
+                lock.lock();
+                _allocating--;
+                _free_low_water = 0;
+                Item *raw = AddItem(std::move(item));
+                _free.pop_back();
+                return MarkAcquired(raw);
+            }
+        }
+
+        Item *item = _free.back();
+        _free.pop_back();
+        _free_low_water = std::min(_free_low_water, _free.size());
+        // item is marked before shrinking, which releases lock for a while
+        MarkAcquired(item);
+        ShrinkIfIdle(lock);
+        return item;
+    }
+
+    void Release(Item *item) {
+        if (!item)
+            throw std::invalid_argument("DynamicPool: released item is nullptr");
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _items.find(item);
+            if (it == _items.end() || !it->second.in_use)
+                throw std::invalid_argument("DynamicPool: released item is not acquired from this pool");
+            it->second.in_use = false;
+            _stats.in_use--;
+            _free.push_back(item);
+        }
+        _free_cond.notify_one();
+    }
+
+    // Calls fn for every acquired item. Called without lock held, items are guaranteed to stay allocated
+    template <typename Fn>
+    void ForEachAcquired(Fn fn) {
+        std::vector<Item *> acquired;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto &entry : _items)
+                if (entry.second.in_use)
+                    acquired.push_back(entry.first);
+            _shrink_blocked++;
+        }
+        try {
+            for (Item *item : acquired)
+                fn(*item);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _shrink_blocked--;
+            throw;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shrink_blocked--;
+    }
+
+    Stats GetStats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Stats stats = _stats;
+        stats.size = _items.size();
+        return stats;
+    }
+
+  private:
+    struct Entry {
+        std::unique_ptr<Item> item;
+        bool in_use = false;
+    };
+
+    Item *AddItem(std::unique_ptr<Item> item) {
+        if (!item)
+            throw std::runtime_error("DynamicPool: allocator returned nullptr");
+        Item *raw = item.get();
+        _items.emplace(raw, Entry{std::move(item), false});
+        _free.push_back(raw);
+        _stats.allocations++;
+        return raw;
+    }
+
+    Item *MarkAcquired(Item *item) {
+        _items[item].in_use = true;
+        _stats.in_use++;
+        _stats.peak_in_use = std::max(_stats.peak_in_use, _stats.in_use);
+        return item;
+    }
+
+    // Destroys items which were not used during last shrink_window acquisitions
+    void ShrinkIfIdle(std::unique_lock<std::mutex> &lock) {
+        if (++_window_acquires < _params.shrink_window)
+            return;
+        size_t idle = _free_low_water;
+        _window_acquires = 0;
+        if (_shrink_blocked || idle == 0 || _items.size() <= _params.min_size) {
+            _free_low_water = _free.size();
+            return;
+        }
+
+        // least recently used free items are at the bottom of the stack
+        idle = std::min({idle, _items.size() - _params.min_size, _free.size()});
+        std::vector<std::unique_ptr<Item>> released;
+        for (size_t i = 0; i < idle; i++) {
+            auto it = _items.find(_free[i]);
+            released.push_back(std::move(it->second.item));
+            _items.erase(it);
+        }
+        _free.erase(_free.begin(), _free.begin() + idle);
+        _stats.deallocations += idle;
+        _free_low_water = _free.size();
+
+        // destroy items without lock, it may take long for device memory
+        lock.unlock();
+        released.clear();
+        lock.lock();
+    }
+
+    std::unique_ptr<Allocator> _allocator;
+    Params _params;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _free_cond;
+    std::unordered_map<Item *, Entry> _items;
+    std::vector<Item *> _free; // stack of free items, the most recently released on top
+    size_t _allocating = 0;
+    size_t _shrink_blocked = 0;
+
+    uint64_t _window_acquires = 0;
+    size_t _free_low_water = 0; // min number of free items within current shrink window
+    Stats _stats;
+};
+
+} // namespace InferenceBackend
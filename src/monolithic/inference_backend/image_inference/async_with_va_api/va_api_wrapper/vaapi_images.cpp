@@ -1,11 +1,13 @@
 /*******************************************************************************
- * Copyright (C) 2019-2022 Intel Corporation
+ * Copyright (C) 2019-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
 
 #include "vaapi_images.h"
 
+#include <atomic>
+
 using namespace InferenceBackend;
 
 namespace {
@@ -43,6 +45,29 @@ std::string FourccName(int code) {
     return {c4, c3, c2, c1};
 }
 
+// Creates VA surfaces for the pool keeping given part of them with fast scaling method
+class VaApiImageAllocator : public DynamicPool<VaApiImage>::Allocator {
+  public:
+    VaApiImageAllocator(VaApiContext *context, VaApiImagePool::ImageInfo info, double fast_part)
+        : _context(context), _info(info), _fast_part(fast_part) {
+    }
+
+    std::unique_ptr<VaApiImage> Allocate() override {
+        // spreads fast scaling surfaces evenly over allocations
+        const bool fast = static_cast<uint64_t>((_count + 1) * _fast_part) > static_cast<uint64_t>(_count * _fast_part);
+        _count++;
+        return std::unique_ptr<VaApiImage>(new VaApiImage(_context, _info.width, _info.height, _info.format,
+                                                          _info.memory_type,
+                                                          fast ? VA_FILTER_SCALING_FAST : VA_FILTER_SCALING_DEFAULT));
+    }
+
+  private:
+    VaApiContext *_context;
+    VaApiImagePool::ImageInfo _info;
+    double _fast_part;
+    std::atomic<uint64_t> _count{0};
+};
+
 } // namespace
 
 VaApiImage::VaApiImage() {
@@ -63,7 +88,6 @@ VaApiImage::VaApiImage(VaApiContext *context_, uint32_t width, uint32_t height,
     image.va_display = context->DisplayRaw();
     image.va_surface_id = CreateVASurface(context->Display(), width, height, pixel_format, context_->RTFormat());
     image_map = std::unique_ptr<ImageMap>(ImageMap::Create(memory_type));
-    completed = true;
     scaling_flags = scaling_flgs;
 }
 
@@ -122,41 +146,50 @@ VaApiImagePool::VaApiImagePool(VaApiContext *context, SizeParams size_params, Im
         }
     }
 
-    GVA_INFO("VA-API image pool size: default=%u, fast=%u", size_params.num_default, size_params.num_fast);
+    DynamicPool<VaApiImage>::Params params;
+    params.initial_size = size_params.size();
+    params.min_size = size_params.min_size ? size_params.min_size : size_params.size();
+    params.max_size = size_params.max_size ? size_params.max_size : size_params.size();
+    if (params.min_size > params.max_size)
+        throw std::invalid_argument("VA-API image pool minimal size is greater than maximal size");
+    if (size_params.grow_wait_ms)
+        params.grow_wait = std::chrono::milliseconds(size_params.grow_wait_ms);
+
+    GVA_INFO("VA-API image pool size: default=%u, fast=%u, min=%zu, max=%zu, grow wait=%lld ms",
+             size_params.num_default, size_params.num_fast, params.min_size, params.max_size,
+             static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(params.grow_wait).count()));
+
+    const double fast_part = static_cast<double>(size_params.num_fast) / size_params.size();
+    _pool.reset(new DynamicPool<VaApiImage>(
+        std::unique_ptr<VaApiImageAllocator>(new VaApiImageAllocator(context, info, fast_part)), params));
+}
 
-    _images.reserve(size_params.size());
-    for (size_t i = 0; i < size_params.size(); i++) {
-        const uint32_t scaling_method = i < size_params.num_fast ? VA_FILTER_SCALING_FAST : VA_FILTER_SCALING_DEFAULT;
-        _images.push_back(std::unique_ptr<VaApiImage>(
-            new VaApiImage(context, info.width, info.height, info.format, info.memory_type, scaling_method)));
-    }
+VaApiImagePool::~VaApiImagePool() {
+    const Stats stats = GetStats();
+    GVA_INFO("VA-API image pool: size=%zu, peak in use=%zu, acquires=%lu, waits=%lu (%lu us), allocations=%lu, "
+             "deallocations=%lu",
+             stats.size, stats.peak_in_use, stats.acquires, stats.waits, stats.wait_time_us, stats.allocations,
+             stats.deallocations);
 }
 
 VaApiImage *VaApiImagePool::AcquireBuffer() {
-    std::unique_lock<std::mutex> lock(_free_images_mutex);
-    for (;;) {
-        for (auto &image : _images) {
-            if (image->completed) {
-                image->completed = false;
-                return image.get();
-            }
-        }
-        _free_image_condition_variable.wait(lock);
-    }
+    return _pool->Acquire();
 }
 
 void VaApiImagePool::ReleaseBuffer(VaApiImage *image) {
     if (!image)
         throw std::runtime_error("Received VA-API image is null");
 
-    image->completed = true;
-    _free_image_condition_variable.notify_one();
+    _pool->Release(image);
 }
 
 void VaApiImagePool::Flush() {
-    std::unique_lock<std::mutex> lock(_free_images_mutex);
-    for (auto &image : _images) {
-        if (!image->completed)
-            image->sync.wait();
-    }
+    _pool->ForEachAcquired([](VaApiImage &image) {
+        if (image.sync.valid())
+            image.sync.wait();
+    });
+}
+
+VaApiImagePool::Stats VaApiImagePool::GetStats() const {
+    return _pool->GetStats();
 }
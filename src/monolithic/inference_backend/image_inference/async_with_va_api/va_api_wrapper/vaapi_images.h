@@ -1,11 +1,12 @@
 /*******************************************************************************
- * Copyright (C) 2019-2021 Intel Corporation
+ * Copyright (C) 2019-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
 
 #pragma once
 
+#include "dynamic_pool.h"
 #include "vaapi_context.h"
 #include "vaapi_image_map.h"
 #include "vaapi_utils.h"
@@ -23,7 +24,6 @@ struct VaApiImage {
     VaApiContext *context = nullptr;
     Image image = Image();
     std::future<void> sync;
-    bool completed = true;
     std::unique_ptr<ImageMap> image_map;
     uint32_t scaling_flags = VA_FILTER_SCALING_DEFAULT;
 
@@ -40,11 +40,11 @@ struct VaApiImage {
 };
 
 class VaApiImagePool {
-    std::vector<std::unique_ptr<VaApiImage>> _images;
-    std::condition_variable _free_image_condition_variable;
-    std::mutex _free_images_mutex;
+    std::unique_ptr<DynamicPool<VaApiImage>> _pool;
 
   public:
+    using Stats = DynamicPool<VaApiImage>::Stats;
+
     VaApiImage *AcquireBuffer();
     void ReleaseBuffer(VaApiImage *image);
     struct ImageInfo {
@@ -60,6 +60,12 @@ class VaApiImagePool {
         uint32_t num_default = 0;
         // Number of items in the pool with fast scaling method
         uint32_t num_fast = 0;
+        // Bounds of pool size, pool starts with num_default + num_fast items and grows when pre-processing waits for
+        // free item or shrinks when items stay unused. Zero means num_default + num_fast
+        uint32_t min_size = 0;
+        uint32_t max_size = 0;
+        // Time pre-processing waits for free item before pool grows, zero means pool default
+        uint32_t grow_wait_ms = 0;
 
         SizeParams(uint32_t num_default_scale, uint32_t num_fast_scale) noexcept
             : num_default(num_default_scale), num_fast(num_fast_scale) {
@@ -75,8 +81,12 @@ class VaApiImagePool {
     };
 
     VaApiImagePool(VaApiContext *context, SizeParams size_params, ImageInfo info);
+    ~VaApiImagePool();
 
     void Flush();
+
+    // Returns occupancy, waits and allocations counters
+    Stats GetStats() const;
 };
 
 } // namespace InferenceBackend
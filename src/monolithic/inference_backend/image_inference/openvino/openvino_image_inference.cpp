@@ -12,6 +12,7 @@
 #include "model_loader.h"
 #include "openvino_blob_wrapper.h"
 #include "safe_arithmetic.hpp"
+#include "scope_guard.h"
 #include "utils.h"
 #include "wrap_image.h"
 
@@ -31,10 +32,14 @@
 #include <ie_compound_blob.h>
 #include <inference_engine.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <functional>
+#include <iterator>
 #include <stdio.h>
 #include <thread>
+#include <typeinfo>
 
 #include <core_singleton.h>
 
@@ -170,6 +175,12 @@ Image MapBlobBufferToImage(InferenceEngine::Blob::Ptr blob, size_t batch_index)
     return image;
 }
 
+// Planes of image in blob are contiguous, so each image of batch is one memory block of this size
+size_t BlobImageSize(const InferenceEngine::Blob::Ptr &blob) {
+    const auto &dims = blob->getTensorDesc().getDims();
+    return safe_mul(safe_mul(dims[1], dims[2] * dims[3]), blob->element_size());
+}
+
 const InputImageLayerDesc::Ptr
 getImagePreProcInfo(const std::map<std::string, InferenceBackend::InputLayerDesc::Ptr> &input_preprocessors) {
     const auto image_it = input_preprocessors.find("image");
@@ -188,6 +199,18 @@ getImagePreProcInfo(const std::map<std::string, InferenceBackend::InputLayerDesc
 OpenVINOImageInference::~OpenVINOImageInference() {
     GVA_DEBUG("Image Inference destruct");
     Close();
+    if (pre_proc_cache_hits || pre_proc_cache_misses)
+        GVA_INFO("Pre-processing cache of model '%s': %lu hits, %lu misses, %lu stored, %lu not stored (cache full)",
+                 model_name.c_str(), pre_proc_cache_hits.load(), pre_proc_cache_misses.load(),
+                 pre_proc_cache_stores.load(), pre_proc_cache_full.load());
+
+    for (const auto &entry : GetStats().priorities) {
+        const auto &priority = entry.second;
+        GVA_INFO("Model '%s', priority %d: %lu frames, request wait avg %lu us max %lu us, latency avg %lu us "
+                 "max %lu us",
+                 model_name.c_str(), entry.first, priority.frames, priority.wait_avg_us, priority.wait_max_us,
+                 priority.latency_avg_us, priority.latency_max_us);
+    }
 }
 
 std::string getErrorMsg(InferenceEngine::StatusCode code) {
@@ -250,6 +273,7 @@ void OpenVINOImageInference::SetCompletionCallback(std::shared_ptr<BatchRequest>
                 GVA_ERROR("Inference request failed with code: %d (%s)", code, getErrorMsg(code).c_str());
                 this->handleError(batch_request->buffers);
             } else {
+                this->UpdateLatencyStats(*batch_request);
                 this->WorkingFunction(batch_request);
             }
 
@@ -357,8 +381,19 @@ OpenVINOImageInference::OpenVINOImageInference(const InferenceBackend::Inference
 void OpenVINOImageInference::FreeRequest(std::shared_ptr<BatchRequest> request) {
     const size_t buffer_size = request->buffers.size();
     request->buffers.clear();
+    request->submit_time.clear();
     freeRequests.push(request);
-    requests_processing_ -= buffer_size;
+    OnRequestReturned(buffer_size);
+}
+
+// Called after request is returned to freeRequests, completed or as partially filled batch. Wakes up Flush waiting
+// for it
+void OpenVINOImageInference::OnRequestReturned(size_t frames_completed) {
+    {
+        std::lock_guard<std::mutex> lk(flush_mutex);
+        requests_processing_ -= frames_completed;
+        requests_returned_++;
+    }
     request_processed_.notify_all();
 }
 
@@ -461,46 +496,81 @@ bool OpenVINOImageInference::IsQueueFull() {
     return freeRequests.empty();
 }
 
+ImageInference::Stats OpenVINOImageInference::GetStats() const {
+    Stats stats;
+    stats.pre_proc_cache_hits = pre_proc_cache_hits;
+    stats.pre_proc_cache_misses = pre_proc_cache_misses;
+    stats.pre_proc_cache_stores = pre_proc_cache_stores;
+    stats.pre_proc_cache_full = pre_proc_cache_full;
+
+    // Waits of Flush (at MAX_PRIORITY) are not reported, since only priorities of completed frames are
+    const auto wait_stats = freeRequests.wait_stats();
+    std::lock_guard<std::mutex> lock(latency_stats_mutex);
+    for (const auto &entry : latency_stats) {
+        const auto &latency = entry.second;
+        const auto wait_it = wait_stats.find(entry.first);
+        const PriorityLatencyStats wait = wait_it != wait_stats.end() ? wait_it->second : PriorityLatencyStats();
+        auto &priority = stats.priorities[entry.first];
+        priority.frames = latency.count;
+        priority.wait_avg_us = wait.count ? wait.total_us / wait.count : 0;
+        priority.wait_max_us = wait.max_us;
+        priority.latency_avg_us = latency.count ? latency.total_us / latency.count : 0;
+        priority.latency_max_us = latency.max_us;
+    }
+    return stats;
+}
+
 void OpenVINOImageInference::SubmitImageProcessing(const std::string &input_name, std::shared_ptr<BatchRequest> request,
-                                                   const Image &src_img, const InputImageLayerDesc::Ptr &pre_proc_info,
-                                                   const ImageTransformationParams::Ptr image_transform_info) {
+                                                   size_t batch_index, const Image &src_img,
+                                                   const InputImageLayerDesc::Ptr &pre_proc_info,
+                                                   const ImageTransformationParams::Ptr image_transform_info,
+                                                   const PreProcCache::Ptr &pre_proc_cache, bool pre_proc_cache_store) {
     ITT_TASK(__FUNCTION__);
     if (not request or not request->infer_request)
         throw std::invalid_argument("InferRequest is absent");
-    if (request->blob.empty())
-        request->blob.push_back(request->infer_request->GetBlob(input_name));
-    size_t batch_index = request->buffers.size();
-    Image dst_img = MapBlobBufferToImage(request->blob[0], batch_index);
-    if (src_img.planes[0] != dst_img.planes[0]) { // only convert if different buffers
-        try {
-            pre_processor->Convert(src_img, dst_img, pre_proc_info, image_transform_info);
-        } catch (const std::exception &e) {
-            std::throw_with_nested(std::runtime_error("Failed while software frame preprocessing"));
+    InferenceEngine::Blob::Ptr blob;
+    {
+        // Other slots of the batch may be pre-processed concurrently
+        std::lock_guard<std::mutex> lk(request->mutex);
+        if (request->blob.empty())
+            request->blob.push_back(request->infer_request->GetBlob(input_name));
+        blob = request->blob[0];
+    }
+    Image dst_img = MapBlobBufferToImage(blob, batch_index);
+    if (src_img.planes[0] == dst_img.planes[0]) // only convert if different buffers
+        return;
+
+    const size_t dst_size = BlobImageSize(blob);
+    std::string cache_key;
+    if (pre_proc_cache && image_transform_info) {
+        cache_key = PreProcCache::MakeKey(src_img, dst_img, pre_proc_info, typeid(*pre_processor).name());
+        if (pre_proc_cache->Load(cache_key, dst_img.planes[0], dst_size, *image_transform_info)) {
+            pre_proc_cache_hits++;
+            return;
         }
+        pre_proc_cache_misses++;
+    }
+
+    try {
+        pre_processor->Convert(src_img, dst_img, pre_proc_info, image_transform_info);
+    } catch (const std::exception &e) {
+        std::throw_with_nested(std::runtime_error("Failed while software frame preprocessing"));
+    }
+    if (pre_proc_cache && image_transform_info && pre_proc_cache_store) {
+        if (pre_proc_cache->Store(cache_key, dst_img.planes[0], dst_size, *image_transform_info))
+            pre_proc_cache_stores++;
+        else
+            pre_proc_cache_full++;
     }
 }
 
-void OpenVINOImageInference::BypassImageProcessing(const std::string &input_name, std::shared_ptr<BatchRequest> request,
-                                                   const Image &src_img, size_t batch_size) {
+InferenceEngine::Blob::Ptr OpenVINOImageInference::BypassImageProcessing(const Image &src_img) {
     ITT_TASK(__FUNCTION__);
 
-    if (not request or not request->infer_request)
-        throw std::invalid_argument("InferRequest is absent");
-
     InferenceEngine::Blob::Ptr blob = WrapImageToBlob(src_img, *wrap_strategy);
     if (!blob)
         throw std::runtime_error("Could not wrap image");
-
-    if (batch_size > 1) {
-        request->blob.push_back(blob);
-        if (request->blob.size() >= batch_size) {
-            auto blob = InferenceEngine::make_shared_blob<InferenceEngine::BatchedBlob>(request->blob);
-            request->infer_request->SetBlob(input_name, blob);
-            request->blob.clear();
-        }
-    } else {
-        request->infer_request->SetBlob(input_name, blob);
-    }
+    return blob;
 }
 
 bool OpenVINOImageInference::DoNeedImagePreProcessing() const {
@@ -539,42 +609,153 @@ void OpenVINOImageInference::SubmitImage(
     if (!frame)
         throw std::invalid_argument("Invalid frame provided");
 
-    std::unique_lock<std::mutex> lk(requests_mutex_);
-    ++requests_processing_;
-    std::shared_ptr<BatchRequest> request = freeRequests.pop();
+    // Submitters are counted and wait while Flush is in progress, and Flush waits for counted submitters, so it never
+    // pops request a submitter waits for. Otherwise threads wait for free request concurrently, so it's given to the
+    // frame with the highest priority.
+    // Frame takes next slot of popped request, and request with free slots is returned to the front of freeRequests at
+    // once, so next frame takes next slot of the same request and batches are filled completely. With batching, slots
+    // are taken one at a time under batch_mutex_, otherwise concurrent submitters would start several partial batches
+    // in different requests. Pre-processing into the slot is done without batch_mutex_, so frames from different
+    // streams are pre-processed concurrently. Last frame finishing pre-processing of full batch starts inference.
+    const size_t batch = safe_convert<size_t>(batch_size);
+    const auto submit_time = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lk(requests_mutex_);
+        submitters_cond_.wait(lk, [this] { return !flushing_; });
+        ++requests_processing_;
+        ++submitters_;
+    }
+    auto submitter_guard = makeScopeGuard([this] {
+        {
+            std::lock_guard<std::mutex> lk(requests_mutex_);
+            --submitters_;
+        }
+        submitters_cond_.notify_all();
+    });
+
+    std::shared_ptr<BatchRequest> request;
+    size_t batch_index = 0;
+    {
+        std::unique_lock<std::mutex> batch_lk(batch_mutex_, std::defer_lock);
+        if (batch > 1)
+            batch_lk.lock();
+        request = freeRequests.pop(frame->GetPriority());
+        std::lock_guard<std::mutex> lk(request->mutex);
+        batch_index = request->buffers.size();
+        request->buffers.emplace_back();
+        request->submit_time.push_back(submit_time);
+        if (!DoNeedImagePreProcessing())
+            request->blob.emplace_back();
+        request->pending++;
+        if (request->buffers.size() < batch) {
+            freeRequests.push_front(request);
+            OnRequestReturned(0);
+        }
+    }
 
+    InferenceEngine::Blob::Ptr blob;
     try {
         if (DoNeedImagePreProcessing()) {
             SubmitImageProcessing(
-                image_layer, request, *frame->GetImage(),
+                image_layer, request, batch_index, *frame->GetImage(),
                 getImagePreProcInfo(input_preprocessors), // contain operations order for Custom Image PreProcessing
-                frame->GetImageTransformationParams() // during CIPP will be filling of crop and aspect-ratio parameters
-            );
+                frame->GetImageTransformationParams(),    // CIPP fills crop and aspect-ratio parameters in
+                frame->GetPreProcCache(),                 // pre-processed regions shared with other inferences on frame
+                frame->IsPreProcCacheStoreNeeded());
             // After running this function self-managed image memory appears, and the old image memory can be released
             frame->SetImage(nullptr);
         } else {
-            BypassImageProcessing(image_layer, request, *frame->GetImage(), safe_convert<size_t>(batch_size));
+            blob = BypassImageProcessing(*frame->GetImage());
         }
 
+        std::lock_guard<std::mutex> lk(request->mutex);
         ApplyInputPreprocessors(request, input_preprocessors);
-
-        request->buffers.push_back(frame);
     } catch (const std::exception &e) {
+        // Frame isn't added, its slot is removed once other slots of request are pre-processed
+        FinishBatchSlot(request, batch_index, nullptr, nullptr);
+        OnRequestReturned(1);
         std::throw_with_nested(std::runtime_error("Pre-processing was failed."));
     }
 
-    try {
-        // start inference asynchronously if enough buffers for batching
-        if (request->buffers.size() >= safe_convert<size_t>(batch_size)) {
-            request->infer_request->StartAsync();
-        } else {
+    FinishBatchSlot(request, batch_index, frame, blob);
+}
+
+// Sets frame to its slot of batch (nullptr if pre-processing of frame failed). Once no slot is pre-processed, slots of
+// failed frames are removed, and full batch is started or not full one is returned to freeRequests
+void OpenVINOImageInference::FinishBatchSlot(std::shared_ptr<BatchRequest> request, size_t batch_index,
+                                             IFrameBase::Ptr frame, InferenceEngine::Blob::Ptr blob) {
+    const size_t batch = safe_convert<size_t>(batch_size);
+    std::unique_lock<std::mutex> lk(request->mutex);
+    request->buffers[batch_index] = frame;
+    if (blob)
+        request->blob[batch_index] = blob;
+    if (--request->pending)
+        return;
+
+    // Request with all slots taken isn't in freeRequests
+    const bool all_slots_taken = request->buffers.size() >= batch;
+    if (std::find(request->buffers.begin(), request->buffers.end(), nullptr) != request->buffers.end())
+        RemoveFailedBatchSlots(*request);
+    if (request->buffers.size() < batch) {
+        if (all_slots_taken) {
             freeRequests.push_front(request);
+            OnRequestReturned(0);
         }
+        return;
+    }
+
+    try {
+        if (!DoNeedImagePreProcessing()) {
+            InferenceEngine::Blob::Ptr input_blob = request->blob[0];
+            if (batch > 1)
+                input_blob = InferenceEngine::make_shared_blob<InferenceEngine::BatchedBlob>(request->blob);
+            request->blob.clear();
+            request->infer_request->SetBlob(image_layer, input_blob);
+        }
+        request->infer_request->StartAsync();
     } catch (const std::exception &e) {
-        std::throw_with_nested(std::runtime_error("Inference async start was failed."));
+        if (!DoNeedImagePreProcessing())
+            request->blob.clear();
+        lk.unlock();
+        // This frame fails with exception, other frames of batch are passed to error handler
+        std::vector<IFrameBase::Ptr> batch_frames;
+        std::copy_if(request->buffers.begin(), request->buffers.end(), std::back_inserter(batch_frames),
+                     [&frame](const IFrameBase::Ptr &batch_frame) { return batch_frame != frame; });
+        if (!batch_frames.empty())
+            handleError(batch_frames);
+        FreeRequest(request);
+        if (frame)
+            std::throw_with_nested(std::runtime_error("Inference async start was failed."));
+        GVA_ERROR("Inference async start was failed: %s", e.what());
     }
 }
 
+// Moves frames (and pre-processed images) of filled slots to the beginning of batch, so batch has no gaps. Called with
+// request->mutex locked when no slot is pre-processed
+void OpenVINOImageInference::RemoveFailedBatchSlots(BatchRequest &request) {
+    size_t filled = 0;
+    for (size_t i = 0; i < request.buffers.size(); i++) {
+        if (!request.buffers[i])
+            continue;
+        if (i != filled) {
+            request.buffers[filled] = std::move(request.buffers[i]);
+            request.submit_time[filled] = request.submit_time[i];
+            if (DoNeedImagePreProcessing()) {
+                Image dst_img = MapBlobBufferToImage(request.blob[0], filled);
+                Image src_img = MapBlobBufferToImage(request.blob[0], i);
+                std::memcpy(dst_img.planes[0], src_img.planes[0], BlobImageSize(request.blob[0]));
+            } else {
+                request.blob[filled] = std::move(request.blob[i]);
+            }
+        }
+        filled++;
+    }
+    request.buffers.resize(filled);
+    request.submit_time.resize(filled);
+    if (!DoNeedImagePreProcessing())
+        request.blob.resize(filled);
+}
+
 const std::string &OpenVINOImageInference::GetModelName() const {
     return model_name;
 }
@@ -643,11 +824,22 @@ void OpenVINOImageInference::Flush() {
     GVA_DEBUG("enter");
     ITT_TASK(__FUNCTION__);
 
-    // because Flush can execute by several threads for one InferenceImpl instance
-    // it must be synchronous.
-    std::unique_lock<std::mutex> requests_lk(requests_mutex_);
-
-    std::unique_lock<std::mutex> flush_lk(flush_mutex);
+    // Flush can be called by several threads for one instance, so they flush one after another. Frames submitted
+    // during Flush wait until it completes. Frames already being submitted are counted in requests_processing_ but may
+    // not be added to requests yet, so Flush waits until they start or return their requests
+    {
+        std::unique_lock<std::mutex> requests_lk(requests_mutex_);
+        submitters_cond_.wait(requests_lk, [this] { return !flushing_; });
+        flushing_ = true;
+        submitters_cond_.wait(requests_lk, [this] { return submitters_ == 0; });
+    }
+    auto flushing_guard = makeScopeGuard([this] {
+        {
+            std::lock_guard<std::mutex> lk(requests_mutex_);
+            flushing_ = false;
+        }
+        submitters_cond_.notify_all();
+    });
 
     while (requests_processing_ != 0) {
         auto request = freeRequests.pop();
@@ -670,13 +862,18 @@ void OpenVINOImageInference::Flush() {
                 this->handleError(request->buffers);
                 FreeRequest(request);
             }
-        } else {
-            freeRequests.push(request);
+            // Partially filled batches are at the front of freeRequests, next one (if any) is popped without waiting
+            continue;
         }
 
-        // wait_for unlocks flush_mutex until we get notify
-        // waiting will be continued if requests_processing_ != 0
-        request_processed_.wait_for(flush_lk, std::chrono::seconds(1), [this] { return requests_processing_ == 0; });
+        // Remaining frames are in requests being inferred, wait until one of them returns
+        std::unique_lock<std::mutex> flush_lk(flush_mutex);
+        const uint64_t returned = requests_returned_;
+        freeRequests.push(request);
+        // Timeout is a safety net only, each return of request is notified
+        request_processed_.wait_for(flush_lk, std::chrono::seconds(1), [this, returned] {
+            return requests_processing_ == 0 || requests_returned_ != returned;
+        });
     }
 }
 
@@ -693,6 +890,13 @@ void OpenVINOImageInference::Close() {
     }
 }
 
+void OpenVINOImageInference::UpdateLatencyStats(const BatchRequest &request) {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(latency_stats_mutex);
+    for (size_t i = 0; i < request.buffers.size() && i < request.submit_time.size(); i++)
+        latency_stats[request.buffers[i]->GetPriority()].add(now - request.submit_time[i]);
+}
+
 void OpenVINOImageInference::WorkingFunction(const std::shared_ptr<BatchRequest> &request) {
     GVA_DEBUG("enter");
     assert(request);
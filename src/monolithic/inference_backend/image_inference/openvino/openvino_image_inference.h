@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -13,13 +13,14 @@
 #include "model_builder.h"
 
 #include <atomic>
+#include <chrono>
 #include <inference_engine.hpp>
 #include <map>
 #include <string>
 #include <thread>
 
 #include "config.h"
-#include "safe_queue.h"
+#include "priority_safe_queue.h"
 
 struct EntityBuilder;
 namespace WrapImageStrategy {
@@ -50,6 +51,8 @@ class OpenVINOImageInference : public InferenceBackend::ImageInference {
 
     virtual bool IsQueueFull() override;
 
+    virtual Stats GetStats() const override;
+
     virtual void Flush() override;
 
     virtual void Close() override;
@@ -58,13 +61,19 @@ class OpenVINOImageInference : public InferenceBackend::ImageInference {
     struct BatchRequest {
         InferenceEngine::InferRequest::Ptr infer_request;
         std::vector<IFrameBase::Ptr> buffers;
+        std::vector<std::chrono::steady_clock::time_point> submit_time; // of each frame in buffers
         std::vector<InferenceBackend::Allocator::AllocContext *> alloc_context;
         std::vector<InferenceEngine::Blob::Ptr> blob;
+        // Slots of batch are taken in SubmitImage under batch_mutex_ and filled concurrently, frame of slot is set in
+        // buffers once pre-processed. Slots and frames are guarded by mutex
+        std::mutex mutex;
+        size_t pending = 0; // slots being pre-processed
     };
 
     // InferenceBackend::Image GetNextImageBuffer(std::shared_ptr<BatchRequest> request);
     void HandleError(const std::shared_ptr<BatchRequest> &request);
     void WorkingFunction(const std::shared_ptr<BatchRequest> &request);
+    void UpdateLatencyStats(const BatchRequest &request);
 
     InferenceBackend::Allocator *allocator;
     dlstreamer::ContextPtr context_;
@@ -80,7 +89,7 @@ class OpenVINOImageInference : public InferenceBackend::ImageInference {
 
     const int batch_size;
     int nireq;
-    SafeQueue<std::shared_ptr<BatchRequest>> freeRequests;
+    PrioritySafeQueue<std::shared_ptr<BatchRequest>> freeRequests;
 
     std::unique_ptr<EntityBuilder> builder;
     InferenceEngine::CNNNetwork network;
@@ -89,20 +98,42 @@ class OpenVINOImageInference : public InferenceBackend::ImageInference {
 
     // Threading
     std::mutex requests_mutex_;
+    std::mutex batch_mutex_; // serializes taking of batch slots when batch_size > 1
+    // Frames submitted and not completed yet. Decremented with flush_mutex locked
     std::atomic<unsigned int> requests_processing_;
+    // Threads which popped or wait to pop free request in SubmitImage and Flush in progress, guarded by requests_mutex_
+    unsigned int submitters_ = 0;
+    bool flushing_ = false;
+    std::condition_variable submitters_cond_;
+    // Notified with flush_mutex locked on each request returned to freeRequests, counted by requests_returned_
     std::condition_variable request_processed_;
+    uint64_t requests_returned_ = 0;
     std::mutex flush_mutex;
 
+    // Pre-processing cache counters reported by GetStats
+    std::atomic<uint64_t> pre_proc_cache_hits{0};
+    std::atomic<uint64_t> pre_proc_cache_misses{0};
+    std::atomic<uint64_t> pre_proc_cache_stores{0};
+    std::atomic<uint64_t> pre_proc_cache_full{0};
+
+    // Time from submission to inference completion per frame priority
+    std::map<int, PriorityLatencyStats> latency_stats;
+    mutable std::mutex latency_stats_mutex;
+
   private:
     void FreeRequest(std::shared_ptr<BatchRequest> request);
+    void OnRequestReturned(size_t frames_completed);
     InferenceEngine::RemoteContext::Ptr CreateRemoteContext(const InferenceBackend::InferenceConfig &config);
     bool DoNeedImagePreProcessing() const;
     void SubmitImageProcessing(const std::string &input_name, std::shared_ptr<BatchRequest> request,
-                               const InferenceBackend::Image &src_img,
+                               size_t batch_index, const InferenceBackend::Image &src_img,
                                const InferenceBackend::InputImageLayerDesc::Ptr &pre_proc_info,
-                               const InferenceBackend::ImageTransformationParams::Ptr image_transform_info);
-    void BypassImageProcessing(const std::string &input_name, std::shared_ptr<BatchRequest> request,
-                               const InferenceBackend::Image &src_img, size_t batch_size);
+                               const InferenceBackend::ImageTransformationParams::Ptr image_transform_info,
+                               const InferenceBackend::PreProcCache::Ptr &pre_proc_cache, bool pre_proc_cache_store);
+    InferenceEngine::Blob::Ptr BypassImageProcessing(const InferenceBackend::Image &src_img);
+    void FinishBatchSlot(std::shared_ptr<BatchRequest> request, size_t batch_index, IFrameBase::Ptr frame,
+                         InferenceEngine::Blob::Ptr blob);
+    void RemoveFailedBatchSlots(BatchRequest &request);
     void SetCompletionCallback(std::shared_ptr<BatchRequest> &batch_request);
     void
     ApplyInputPreprocessors(std::shared_ptr<BatchRequest> &request,
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "inference_backend/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <queue>
+
+// Latency statistics of one priority level
+struct PriorityLatencyStats {
+    uint64_t count = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+
+    void add(std::chrono::steady_clock::duration latency) {
+        const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        count++;
+        total_us += us;
+        max_us = std::max(max_us, us);
+    }
+};
+
+/**
+ * Same as SafeQueue, but if several threads wait in pop(), pushed element is given to the waiter with the highest
+ * priority. Waiter gains one priority level every aging interval, so low priority waiters are not starved. Waiters with
+ * equal effective priority are served in arrival order.
+ */
+template <class T>
+class PrioritySafeQueue {
+  public:
+    static constexpr int MAX_PRIORITY = std::numeric_limits<int>::max();
+
+    explicit PrioritySafeQueue(std::chrono::milliseconds aging_interval = std::chrono::milliseconds(100))
+        : aging_interval_(aging_interval) {
+    }
+
+    void push(T t) {
+        ITT_TASK("PrioritySafeQueue::push");
+        std::unique_lock<std::mutex> lock(mutex_);
+        queue_.push_back(t);
+        decision_time_ = std::chrono::steady_clock::now();
+        lock.unlock();
+        condition_.notify_all();
+    }
+
+    void push_front(T t) {
+        ITT_TASK("PrioritySafeQueue::push_front");
+        std::unique_lock<std::mutex> lock(mutex_);
+        queue_.push_front(t);
+        decision_time_ = std::chrono::steady_clock::now();
+        lock.unlock();
+        condition_.notify_all();
+    }
+
+    T pop(int priority = MAX_PRIORITY) {
+        ITT_TASK("PrioritySafeQueue::pop");
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto start = std::chrono::steady_clock::now();
+        auto waiter = waiters_.insert(waiters_.end(), Waiter{priority, start});
+        condition_.wait(lock, [&] { return !queue_.empty() && best_waiter() == waiter; });
+        waiters_.erase(waiter);
+
+        T value = queue_.front();
+        queue_.pop_front();
+        decision_time_ = std::chrono::steady_clock::now();
+        wait_stats_[priority].add(decision_time_ - start);
+        lock.unlock();
+        // next waiter by priority may take remaining elements
+        condition_.notify_all();
+        return value;
+    }
+
+    bool empty() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.empty();
+    }
+
+    // Time spent in pop() per priority
+    std::map<int, PriorityLatencyStats> wait_stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return wait_stats_;
+    }
+
+  private:
+    struct Waiter {
+        int priority;
+        std::chrono::steady_clock::time_point start;
+    };
+    using WaiterIt = typename std::list<Waiter>::iterator;
+
+    // Waiters are kept in arrival order, so the first waiter with max effective priority wins ties. Age is counted up
+    // to the last push or pop, so all waiters woken by it agree on the best one
+    WaiterIt best_waiter() {
+        WaiterIt best = waiters_.end();
+        int64_t best_priority = 0;
+        for (auto it = waiters_.begin(); it != waiters_.end(); ++it) {
+            int64_t effective = it->priority;
+            if (aging_interval_.count() > 0 && decision_time_ > it->start)
+                effective += (decision_time_ - it->start) / aging_interval_;
+            if (best == waiters_.end() || effective > best_priority) {
+                best = it;
+                best_priority = effective;
+            }
+        }
+        return best;
+    }
+
+    std::deque<T> queue_;
+    std::list<Waiter> waiters_;
+    std::map<int, PriorityLatencyStats> wait_stats_;
+    std::chrono::steady_clock::time_point decision_time_;
+    const std::chrono::milliseconds aging_interval_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+};
@@ -0,0 +1,400 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "output_log.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace InferenceBackend;
+
+namespace {
+
+constexpr size_t BLOB_HEADER_ALIGNMENT = 8;
+
+constexpr uint64_t AlignUp(uint64_t size, uint64_t alignment = OUTPUT_LOG_ALIGNMENT) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+size_t BlobDataSize(const Blob &blob) {
+    const size_t elements = blob.GetSize();
+    switch (blob.GetPrecision()) {
+    case Blob::Precision::BIN:
+        return (elements + 7) / 8;
+    case Blob::Precision::U4:
+    case Blob::Precision::I4:
+        return (elements + 1) / 2;
+    case Blob::Precision::U8:
+    case Blob::Precision::I8:
+    case Blob::Precision::BOOL:
+        return elements;
+    case Blob::Precision::FP16:
+    case Blob::Precision::BF16:
+    case Blob::Precision::Q78:
+    case Blob::Precision::I16:
+    case Blob::Precision::U16:
+        return elements * 2;
+    case Blob::Precision::FP32:
+    case Blob::Precision::I32:
+    case Blob::Precision::U32:
+        return elements * 4;
+    case Blob::Precision::FP64:
+    case Blob::Precision::I64:
+    case Blob::Precision::U64:
+        return elements * 8;
+    default:
+        throw std::invalid_argument("Precision of output blob is not supported by output log");
+    }
+}
+
+void PutU64(std::string &out, uint64_t value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void PutString(std::string &out, const std::string &str) {
+    PutU64(out, str.size());
+    out.append(str);
+}
+
+void PutLayers(std::string &out, const std::map<std::string, std::vector<size_t>> &layers) {
+    PutU64(out, layers.size());
+    for (const auto &layer : layers) {
+        PutString(out, layer.first);
+        PutU64(out, layer.second.size());
+        for (size_t dim : layer.second)
+            PutU64(out, dim);
+    }
+}
+
+class ByteReader {
+  public:
+    ByteReader(const uint8_t *data, size_t size) : data(data), size(size) {
+    }
+
+    uint64_t U64() {
+        uint64_t value;
+        std::memcpy(&value, Take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::string String() {
+        const uint64_t length = U64();
+        return std::string(reinterpret_cast<const char *>(Take(length)), length);
+    }
+
+    std::map<std::string, std::vector<size_t>> Layers() {
+        std::map<std::string, std::vector<size_t>> layers;
+        for (uint64_t count = U64(); count; count--) {
+            std::vector<size_t> &dims = layers[String()];
+            dims.resize(U64());
+            for (size_t &dim : dims)
+                dim = U64();
+        }
+        return layers;
+    }
+
+  private:
+    const uint8_t *Take(uint64_t count) {
+        if (count > size - pos)
+            throw std::runtime_error("Model description in output log is corrupted");
+        const uint8_t *result = data + pos;
+        pos += count;
+        return result;
+    }
+
+    const uint8_t *data;
+    size_t size;
+    size_t pos = 0;
+};
+
+// Blob with data in mapped log file
+class MappedOutputBlob : public OutputBlob {
+  public:
+    MappedOutputBlob(std::shared_ptr<const void> owner, const void *data, std::vector<size_t> dims,
+                     Precision precision, Layout layout)
+        : owner(std::move(owner)), data(data), dims(std::move(dims)), precision(precision), layout(layout) {
+    }
+
+    const std::vector<size_t> &GetDims() const override {
+        return dims;
+    }
+    Layout GetLayout() const override {
+        return layout;
+    }
+    Precision GetPrecision() const override {
+        return precision;
+    }
+    const void *GetData() const override {
+        return data;
+    }
+
+  private:
+    std::shared_ptr<const void> owner;
+    const void *data;
+    std::vector<size_t> dims;
+    Precision precision;
+    Layout layout;
+};
+
+} // namespace
+
+OutputLogModelInfo OutputLogModelInfo::FromInference(const ImageInference &inference) {
+    OutputLogModelInfo info;
+    info.name = inference.GetModelName();
+    inference.GetModelImageInputInfo(info.width, info.height, info.batch_size, info.format, info.memory_type);
+    info.inputs = inference.GetModelInputsInfo();
+    info.outputs = inference.GetModelOutputsInfo();
+    return info;
+}
+
+OutputLogWriter::OutputLogWriter(const std::string &file_path, const OutputLogModelInfo &model_info)
+    : file_path(file_path), file(file_path, std::ios::binary | std::ios::trunc) {
+    if (!file)
+        throw std::runtime_error("Failed to open output log '" + file_path + "' for writing");
+
+    std::string info;
+    PutString(info, model_info.name);
+    for (uint64_t value : {uint64_t(model_info.width), uint64_t(model_info.height), uint64_t(model_info.batch_size),
+                           uint64_t(model_info.format), uint64_t(model_info.memory_type)})
+        PutU64(info, value);
+    PutLayers(info, model_info.inputs);
+    PutLayers(info, model_info.outputs);
+
+    const OutputLogHeader header = {OUTPUT_LOG_MAGIC, OUTPUT_LOG_VERSION, info.size()};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(info.data(), info.size());
+    offset = sizeof(header) + info.size();
+    WritePadding(AlignUp(offset) - offset);
+    offset = AlignUp(offset);
+    if (!file)
+        throw std::runtime_error("Failed to write output log '" + file_path + "'");
+}
+
+OutputLogWriter::~OutputLogWriter() {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(OutputLogIndexEntry));
+    const OutputLogTrailer trailer = {offset, index.size(), OUTPUT_LOG_INDEX_MAGIC, 0};
+    file.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+    file.close();
+}
+
+void OutputLogWriter::Write(const std::map<std::string, OutputBlob::Ptr> &blobs,
+                            const std::vector<OutputLogFrameId> &frames) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Headers first, then blob data aligned, offsets of data are known after all headers are laid out
+    uint64_t headers_size = sizeof(OutputLogRecordHeader) + frames.size() * sizeof(OutputLogFrameId);
+    for (const auto &blob : blobs)
+        headers_size += AlignUp(sizeof(OutputLogBlobHeader) + blob.first.size(), BLOB_HEADER_ALIGNMENT);
+
+    record_header.assign(headers_size, 0);
+    auto *header = reinterpret_cast<OutputLogRecordHeader *>(record_header.data());
+    header->magic = OUTPUT_LOG_RECORD_MAGIC;
+    header->frames_number = static_cast<uint32_t>(frames.size());
+    header->blobs_number = static_cast<uint32_t>(blobs.size());
+    header->sequence = index.size();
+    std::memcpy(header + 1, frames.data(), frames.size() * sizeof(OutputLogFrameId));
+
+    char *blob_header_ptr = record_header.data() + sizeof(OutputLogRecordHeader) +
+                            frames.size() * sizeof(OutputLogFrameId);
+    uint64_t data_offset = AlignUp(headers_size);
+    for (const auto &blob : blobs) {
+        const auto &dims = blob.second->GetDims();
+        if (dims.size() > OUTPUT_LOG_MAX_DIMS)
+            throw std::invalid_argument("Output blob '" + blob.first + "' has too many dimensions for output log");
+        auto *blob_header = reinterpret_cast<OutputLogBlobHeader *>(blob_header_ptr);
+        blob_header->name_size = static_cast<uint32_t>(blob.first.size());
+        blob_header->precision = static_cast<uint32_t>(blob.second->GetPrecision());
+        blob_header->layout = static_cast<uint32_t>(blob.second->GetLayout());
+        blob_header->dims_number = static_cast<uint32_t>(dims.size());
+        std::copy(dims.begin(), dims.end(), blob_header->dims);
+        blob_header->data_offset = data_offset;
+        blob_header->data_size = BlobDataSize(*blob.second);
+        std::memcpy(blob_header + 1, blob.first.data(), blob.first.size());
+
+        data_offset = AlignUp(data_offset + blob_header->data_size);
+        blob_header_ptr += AlignUp(sizeof(OutputLogBlobHeader) + blob.first.size(), BLOB_HEADER_ALIGNMENT);
+    }
+    header->size = data_offset;
+
+    file.write(record_header.data(), headers_size);
+    WritePadding(AlignUp(headers_size) - headers_size);
+    for (const auto &blob : blobs) {
+        const size_t size = BlobDataSize(*blob.second);
+        file.write(static_cast<const char *>(blob.second->GetData()), size);
+        WritePadding(AlignUp(size) - size);
+    }
+    if (!file)
+        throw std::runtime_error("Failed to write output log '" + file_path + "'");
+
+    index.push_back({offset, frames.empty() ? std::numeric_limits<uint64_t>::max() : frames.front().timestamp});
+    offset += data_offset;
+}
+
+uint64_t OutputLogWriter::GetRecordsNumber() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index.size();
+}
+
+void OutputLogWriter::WritePadding(size_t size) {
+    static const char zeros[OUTPUT_LOG_ALIGNMENT] = {};
+    file.write(zeros, size);
+}
+
+struct OutputLogReader::Mapping {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#endif
+
+    explicit Mapping(const std::string &file_path) {
+#ifndef _WIN32
+        int fd = open(file_path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Failed to open output log '" + file_path + "'");
+        struct stat file_stat;
+        void *mapped = MAP_FAILED;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+            size = static_cast<size_t>(file_stat.st_size);
+            mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (mapped == MAP_FAILED)
+            throw std::runtime_error("Failed to map output log '" + file_path + "' into memory");
+        // Replay reads records one after another
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const uint8_t *>(mapped);
+#else
+        std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("Failed to open output log '" + file_path + "'");
+        buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(buffer.data()), buffer.size());
+        data = buffer.data();
+        size = buffer.size();
+#endif
+    }
+
+    ~Mapping() {
+#ifndef _WIN32
+        munmap(const_cast<uint8_t *>(data), size);
+#endif
+    }
+
+    Mapping(const Mapping &) = delete;
+    Mapping &operator=(const Mapping &) = delete;
+};
+
+OutputLogReader::OutputLogReader(const std::string &file_path)
+    : file_path(file_path), mapping(std::make_shared<Mapping>(file_path)) {
+    const auto *header = reinterpret_cast<const OutputLogHeader *>(At(0, sizeof(OutputLogHeader)));
+    if (header->magic != OUTPUT_LOG_MAGIC)
+        throw std::runtime_error("File '" + file_path + "' is not output log");
+    if (header->version != OUTPUT_LOG_VERSION)
+        throw std::runtime_error("Output log '" + file_path + "' has unsupported version " +
+                                 std::to_string(header->version));
+    ReadModelInfo(sizeof(OutputLogHeader), header->model_info_size);
+    records_offset = AlignUp(sizeof(OutputLogHeader) + header->model_info_size);
+
+    if (!ReadIndex())
+        RebuildIndex();
+    if (index.empty())
+        throw std::runtime_error("Output log '" + file_path + "' has no records");
+}
+
+OutputLogReader::Record OutputLogReader::GetRecord(size_t record_index) const {
+    const uint64_t offset = index.at(record_index).offset;
+    const auto *header = reinterpret_cast<const OutputLogRecordHeader *>(At(offset, sizeof(OutputLogRecordHeader)));
+    if (header->magic != OUTPUT_LOG_RECORD_MAGIC)
+        throw std::runtime_error("Output log '" + file_path + "' is corrupted");
+    const uint8_t *record = At(offset, header->size);
+
+    Record result;
+    const auto *frames = reinterpret_cast<const OutputLogFrameId *>(
+        At(offset + sizeof(OutputLogRecordHeader), header->frames_number * sizeof(OutputLogFrameId)));
+    result.frames.assign(frames, frames + header->frames_number);
+
+    uint64_t blob_header_offset = sizeof(OutputLogRecordHeader) + header->frames_number * sizeof(OutputLogFrameId);
+    for (uint32_t i = 0; i < header->blobs_number; i++) {
+        const auto *blob_header =
+            reinterpret_cast<const OutputLogBlobHeader *>(At(offset + blob_header_offset, sizeof(OutputLogBlobHeader)));
+        const auto *name = reinterpret_cast<const char *>(
+            At(offset + blob_header_offset + sizeof(OutputLogBlobHeader), blob_header->name_size));
+        if (blob_header->dims_number > OUTPUT_LOG_MAX_DIMS || blob_header->data_offset > header->size ||
+            blob_header->data_size > header->size - blob_header->data_offset)
+            throw std::runtime_error("Output log '" + file_path + "' is corrupted");
+
+        std::vector<size_t> dims(blob_header->dims, blob_header->dims + blob_header->dims_number);
+        result.blobs[std::string(name, blob_header->name_size)] = std::make_shared<MappedOutputBlob>(
+            mapping, record + blob_header->data_offset, std::move(dims),
+            static_cast<Blob::Precision>(blob_header->precision), static_cast<Blob::Layout>(blob_header->layout));
+        blob_header_offset += AlignUp(sizeof(OutputLogBlobHeader) + blob_header->name_size, BLOB_HEADER_ALIGNMENT);
+    }
+    return result;
+}
+
+const uint8_t *OutputLogReader::At(uint64_t offset, uint64_t size) const {
+    if (offset > mapping->size || size > mapping->size - offset)
+        throw std::runtime_error("Output log '" + file_path + "' is truncated or corrupted");
+    return mapping->data + offset;
+}
+
+void OutputLogReader::ReadModelInfo(uint64_t offset, uint64_t size) {
+    ByteReader reader(At(offset, size), size);
+    model_info.name = reader.String();
+    model_info.width = reader.U64();
+    model_info.height = reader.U64();
+    model_info.batch_size = reader.U64();
+    model_info.format = static_cast<int>(reader.U64());
+    model_info.memory_type = static_cast<int>(reader.U64());
+    model_info.inputs = reader.Layers();
+    model_info.outputs = reader.Layers();
+}
+
+bool OutputLogReader::ReadIndex() {
+    if (mapping->size < records_offset + sizeof(OutputLogTrailer))
+        return false;
+    const uint64_t trailer_offset = mapping->size - sizeof(OutputLogTrailer);
+    const auto *trailer = reinterpret_cast<const OutputLogTrailer *>(At(trailer_offset, sizeof(OutputLogTrailer)));
+    if (trailer->magic != OUTPUT_LOG_INDEX_MAGIC || trailer->index_offset < records_offset ||
+        trailer->index_offset > trailer_offset ||
+        (trailer_offset - trailer->index_offset) % sizeof(OutputLogIndexEntry) ||
+        trailer->records_number != (trailer_offset - trailer->index_offset) / sizeof(OutputLogIndexEntry))
+        return false;
+
+    const auto *entries = reinterpret_cast<const OutputLogIndexEntry *>(
+        At(trailer->index_offset, trailer->records_number * sizeof(OutputLogIndexEntry)));
+    index.assign(entries, entries + trailer->records_number);
+    return true;
+}
+
+void OutputLogReader::RebuildIndex() {
+    index.clear();
+    uint64_t offset = records_offset;
+    while (offset <= mapping->size && mapping->size - offset >= sizeof(OutputLogRecordHeader)) {
+        const auto *header = reinterpret_cast<const OutputLogRecordHeader *>(mapping->data + offset);
+        // Last record of interrupted recording may be incomplete
+        if (header->magic != OUTPUT_LOG_RECORD_MAGIC || header->size < sizeof(OutputLogRecordHeader) ||
+            header->size > mapping->size - offset)
+            break;
+        uint64_t timestamp = std::numeric_limits<uint64_t>::max();
+        if (header->frames_number && header->size >= sizeof(OutputLogRecordHeader) + sizeof(OutputLogFrameId))
+            timestamp = reinterpret_cast<const OutputLogFrameId *>(header + 1)->timestamp;
+        index.push_back({offset, timestamp});
+        offset += header->size;
+    }
+    index_rebuilt = true;
+}
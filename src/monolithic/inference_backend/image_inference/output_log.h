@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "inference_backend/image_inference.h"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace InferenceBackend {
+
+/*
+ * Log of model outputs recorded by inference elements ('record-outputs' property) and replayed by
+ * ReplayImageInference ('replay-outputs' property). Layout of file, integers are in host byte order:
+ *
+ *   OutputLogHeader, model description (model_info_size bytes)
+ *   records, every record starts at offset aligned to OUTPUT_LOG_ALIGNMENT:
+ *     OutputLogRecordHeader, OutputLogFrameId for every frame of batch,
+ *     OutputLogBlobHeader followed by blob name for every output blob,
+ *     blob data, every blob aligned to OUTPUT_LOG_ALIGNMENT
+ *   index: OutputLogIndexEntry for every record
+ *   OutputLogTrailer
+ *
+ * Blobs are used directly from file mapped into memory. Index is written when writer is closed, log of interrupted
+ * recording has no index and reader builds it by scanning records.
+ */
+
+constexpr uint32_t OUTPUT_LOG_MAGIC = 0x474f4c4f;        // "OLOG"
+constexpr uint32_t OUTPUT_LOG_RECORD_MAGIC = 0x4345524f; // "OREC"
+constexpr uint32_t OUTPUT_LOG_INDEX_MAGIC = 0x5844494f;  // "OIDX"
+constexpr uint32_t OUTPUT_LOG_VERSION = 1;
+constexpr size_t OUTPUT_LOG_ALIGNMENT = 64;
+constexpr size_t OUTPUT_LOG_MAX_DIMS = 8;
+
+struct OutputLogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t model_info_size;
+};
+
+struct OutputLogRecordHeader {
+    uint32_t magic;
+    uint32_t frames_number;
+    uint32_t blobs_number;
+    uint32_t reserved;
+    uint64_t size; // whole record including padding
+    uint64_t sequence;
+};
+
+// Identifies frame (or region of frame) which inference produced record
+struct OutputLogFrameId {
+    uint64_t timestamp; // PTS of buffer in nanoseconds, UINT64_MAX if buffer has no PTS
+    int32_t roi_index;  // position of region of interest among regions of buffer, -1 for full frame
+    uint32_t reserved;
+};
+
+struct OutputLogBlobHeader {
+    uint32_t name_size;
+    uint32_t precision; // Blob::Precision
+    uint32_t layout;    // Blob::Layout
+    uint32_t dims_number;
+    uint64_t dims[OUTPUT_LOG_MAX_DIMS];
+    uint64_t data_offset; // from record start
+    uint64_t data_size;
+};
+
+struct OutputLogIndexEntry {
+    uint64_t offset;
+    uint64_t timestamp; // of first frame of record
+};
+
+struct OutputLogTrailer {
+    uint64_t index_offset;
+    uint64_t records_number;
+    uint32_t magic;
+    uint32_t reserved;
+};
+
+// Model information needed to replay outputs without model
+struct OutputLogModelInfo {
+    std::string name;
+    size_t width = 0;
+    size_t height = 0;
+    size_t batch_size = 0;
+    int format = 0;
+    int memory_type = 0;
+    std::map<std::string, std::vector<size_t>> inputs;
+    std::map<std::string, std::vector<size_t>> outputs;
+
+    static OutputLogModelInfo FromInference(const ImageInference &inference);
+};
+
+/**
+ * Appends records of output blobs to log file. Thread-safe, records are written in order of Write() calls.
+ */
+class OutputLogWriter {
+  public:
+    OutputLogWriter(const std::string &file_path, const OutputLogModelInfo &model_info);
+    OutputLogWriter(const OutputLogWriter &) = delete;
+    OutputLogWriter &operator=(const OutputLogWriter &) = delete;
+    // Writes index
+    ~OutputLogWriter();
+
+    void Write(const std::map<std::string, OutputBlob::Ptr> &blobs, const std::vector<OutputLogFrameId> &frames);
+    uint64_t GetRecordsNumber() const;
+
+  private:
+    void WritePadding(size_t size);
+
+    std::string file_path;
+    std::ofstream file;
+    uint64_t offset = 0;
+    std::vector<OutputLogIndexEntry> index;
+    std::vector<char> record_header; // reused between records
+    mutable std::mutex mutex;
+};
+
+/**
+ * Read-only view of log file mapped into memory. Blobs of records reference the mapping and keep it alive.
+ */
+class OutputLogReader {
+  public:
+    struct Record {
+        std::vector<OutputLogFrameId> frames;
+        std::map<std::string, OutputBlob::Ptr> blobs;
+    };
+
+    explicit OutputLogReader(const std::string &file_path);
+
+    const OutputLogModelInfo &GetModelInfo() const {
+        return model_info;
+    }
+    size_t GetRecordsNumber() const {
+        return index.size();
+    }
+    // True if index was rebuilt because log has no index (recording was interrupted)
+    bool IsIndexRebuilt() const {
+        return index_rebuilt;
+    }
+    Record GetRecord(size_t record_index) const;
+    // Timestamp of first frame of record, read from index without accessing record
+    uint64_t GetRecordTimestamp(size_t record_index) const {
+        return index.at(record_index).timestamp;
+    }
+
+  private:
+    struct Mapping;
+
+    const uint8_t *At(uint64_t offset, uint64_t size) const;
+    void ReadModelInfo(uint64_t offset, uint64_t size);
+    bool ReadIndex();
+    void RebuildIndex();
+
+    std::string file_path;
+    std::shared_ptr<Mapping> mapping;
+    uint64_t records_offset = 0;
+    OutputLogModelInfo model_info;
+    std::vector<OutputLogIndexEntry> index;
+    bool index_rebuilt = false;
+};
+
+} // namespace InferenceBackend
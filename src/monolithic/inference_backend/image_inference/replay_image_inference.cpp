@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "replay_image_inference.h"
+
+#include "inference_backend/logger.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace InferenceBackend;
+
+namespace {
+
+bool IsSameFrame(const OutputLogFrameId &left, const OutputLogFrameId &right) {
+    return left.timestamp == right.timestamp && left.roi_index == right.roi_index;
+}
+
+// Frames of partial batch (on flush) match beginning of record
+bool IsRecordOf(const std::vector<OutputLogFrameId> &frames, const std::vector<OutputLogFrameId> &recorded) {
+    return frames.size() <= recorded.size() && std::equal(frames.begin(), frames.end(), recorded.begin(), IsSameFrame);
+}
+
+} // namespace
+
+ReplayImageInference::ReplayImageInference(const std::string &log_path, CallbackFunc callback,
+                                           ErrorHandlingFunc error_handler, FrameIdFunc frame_id)
+    : reader(log_path), callback(std::move(callback)), handle_error(std::move(error_handler)),
+      frame_id(std::move(frame_id)) {
+    if (reader.IsIndexRebuilt())
+        GVA_WARNING("Output log '%s' has no index (recording was interrupted), %lu complete records found",
+                    log_path.c_str(), reader.GetRecordsNumber());
+    GVA_INFO("Replaying %lu records of model '%s' outputs from '%s'", reader.GetRecordsNumber(),
+             reader.GetModelInfo().name.c_str(), log_path.c_str());
+    // Records are checked once here, so replay doesn't fail in the middle. Blob data isn't read
+    for (size_t i = 1; i < reader.GetRecordsNumber(); i++)
+        reader.GetRecord(i);
+    record = reader.GetRecord(0);
+    for (size_t i = 0; i < reader.GetRecordsNumber(); i++)
+        records_by_timestamp.emplace(reader.GetRecordTimestamp(i), i);
+}
+
+ReplayImageInference::~ReplayImageInference() {
+    Close();
+    GVA_INFO("Replayed %lu records of model '%s' outputs", replayed_records, reader.GetModelInfo().name.c_str());
+    if (mismatched_batches || resynced_batches)
+        GVA_WARNING("%lu of replayed records were found by frame ids out of order, %lu were replayed for other frames",
+                    resynced_batches, mismatched_batches);
+}
+
+void ReplayImageInference::SubmitImage(IFrameBase::Ptr frame, const std::map<std::string, InputLayerDesc::Ptr> &) {
+    std::vector<IFrameBase::Ptr> frames;
+    Record batch_record;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_frames.push_back(std::move(frame));
+        if (!TakeBatch(false, frames, batch_record))
+            return;
+    }
+    callback(batch_record.blobs, frames);
+}
+
+bool ReplayImageInference::TakeBatch(bool partial, std::vector<IFrameBase::Ptr> &frames, Record &batch_record) {
+    if (pending_frames.empty())
+        return false;
+    if (!partial && pending_frames.size() < std::max<size_t>(record.frames.size(), 1))
+        return false;
+
+    frames.swap(pending_frames);
+    MatchRecord(frames);
+    batch_record = std::move(record);
+    record_index = (record_index + 1) % reader.GetRecordsNumber();
+    record = reader.GetRecord(record_index);
+    replayed_records++;
+    return true;
+}
+
+void ReplayImageInference::MatchRecord(const std::vector<IFrameBase::Ptr> &frames) {
+    if (!frame_id)
+        return;
+    frame_ids.clear();
+    for (const auto &frame : frames)
+        frame_ids.push_back(frame_id(*frame));
+    if (IsRecordOf(frame_ids, record.frames))
+        return;
+
+    // Frames without PTS can't be looked up. Nearest record after current one is taken if log has several records of
+    // the same frames (e.g. input was looped during recording)
+    const uint64_t timestamp = frame_ids.front().timestamp;
+    const size_t records_number = reader.GetRecordsNumber();
+    size_t found = records_number;
+    size_t found_distance = records_number;
+    if (timestamp != std::numeric_limits<uint64_t>::max()) {
+        auto range = records_by_timestamp.equal_range(timestamp);
+        for (auto it = range.first; it != range.second; ++it) {
+            const size_t distance = (it->second + records_number - record_index) % records_number;
+            if (distance < found_distance && IsRecordOf(frame_ids, reader.GetRecord(it->second).frames)) {
+                found = it->second;
+                found_distance = distance;
+            }
+        }
+    }
+
+    if (found == records_number) {
+        if (!mismatched_batches++)
+            GVA_WARNING("Output log has no record of frame with PTS %lu and region %d, records are replayed in "
+                        "submission order for such frames",
+                        timestamp, frame_ids.front().roi_index);
+        return;
+    }
+    if (!resynced_batches++)
+        GVA_WARNING("Record %lu of output log doesn't match submitted frames, replay continues from record %lu with "
+                    "their frame ids",
+                    record_index, found);
+    record_index = found;
+    record = reader.GetRecord(record_index);
+}
+
+uint64_t ReplayImageInference::GetMismatchedBatches() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return mismatched_batches;
+}
+
+uint64_t ReplayImageInference::GetResyncedBatches() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return resynced_batches;
+}
+
+const std::string &ReplayImageInference::GetModelName() const {
+    return reader.GetModelInfo().name;
+}
+
+size_t ReplayImageInference::GetNireq() const {
+    return 1;
+}
+
+void ReplayImageInference::GetModelImageInputInfo(size_t &width, size_t &height, size_t &batch_size, int &format,
+                                                  int &memory_type) const {
+    const OutputLogModelInfo &info = reader.GetModelInfo();
+    width = info.width;
+    height = info.height;
+    batch_size = info.batch_size;
+    format = info.format;
+    memory_type = info.memory_type;
+}
+
+std::map<std::string, std::vector<size_t>> ReplayImageInference::GetModelInputsInfo() const {
+    return reader.GetModelInfo().inputs;
+}
+
+std::map<std::string, std::vector<size_t>> ReplayImageInference::GetModelOutputsInfo() const {
+    return reader.GetModelInfo().outputs;
+}
+
+bool ReplayImageInference::IsQueueFull() {
+    return false;
+}
+
+void ReplayImageInference::Flush() {
+    std::vector<IFrameBase::Ptr> frames;
+    Record batch_record;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!TakeBatch(true, frames, batch_record))
+            return;
+    }
+    callback(batch_record.blobs, frames);
+}
+
+void ReplayImageInference::Close() {
+    Flush();
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "inference_backend/image_inference.h"
+#include "output_log.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Inference backend without model: submitted frames complete with output blobs recorded in output log, so
+ * post-processing gets the same blobs as in recorded run at rate not limited by inference. Records are replayed in
+ * order, one record per batch of frames (as many frames as record has), and log is replayed again from beginning
+ * when it ends. Batch is checked against frame ids (PTS and region position) of record. On mismatch (frames skipped by
+ * pipeline, records written in completion order different from submission order) record with frame ids of batch is
+ * looked up by PTS and replay continues from it. If there is no such record, batch gets record in submission order
+ * and mismatch is counted. Completion callback is called on the thread submitting last frame of batch.
+ */
+class ReplayImageInference : public InferenceBackend::ImageInference {
+  public:
+    // Returns id of submitted frame as it would be recorded into output log
+    using FrameIdFunc = std::function<InferenceBackend::OutputLogFrameId(const IFrameBase &frame)>;
+
+    ReplayImageInference(const std::string &log_path, CallbackFunc callback, ErrorHandlingFunc error_handler,
+                         FrameIdFunc frame_id);
+    ~ReplayImageInference() override;
+
+    void SubmitImage(IFrameBase::Ptr frame,
+                     const std::map<std::string, InferenceBackend::InputLayerDesc::Ptr> &input_preprocessors) override;
+
+    const std::string &GetModelName() const override;
+    size_t GetNireq() const override;
+    void GetModelImageInputInfo(size_t &width, size_t &height, size_t &batch_size, int &format,
+                                int &memory_type) const override;
+    std::map<std::string, std::vector<size_t>> GetModelInputsInfo() const override;
+    std::map<std::string, std::vector<size_t>> GetModelOutputsInfo() const override;
+
+    bool IsQueueFull() override;
+    void Flush() override;
+    void Close() override;
+
+    // Batches which got record with other frame ids, because record with their frame ids was not found
+    uint64_t GetMismatchedBatches() const;
+    // Batches for which replay continued from record found by frame ids instead of next record
+    uint64_t GetResyncedBatches() const;
+
+  private:
+    using Record = InferenceBackend::OutputLogReader::Record;
+
+    // Takes pending frames with record for them if batch is complete (or 'partial' is set), with mutex locked
+    bool TakeBatch(bool partial, std::vector<IFrameBase::Ptr> &frames, Record &record);
+    // Makes current record the one with frame ids of frames if it isn't, with mutex locked
+    void MatchRecord(const std::vector<IFrameBase::Ptr> &frames);
+
+    InferenceBackend::OutputLogReader reader;
+    CallbackFunc callback;
+    ErrorHandlingFunc handle_error;
+    FrameIdFunc frame_id;
+    std::unordered_multimap<uint64_t, size_t> records_by_timestamp;
+
+    mutable std::mutex mutex;
+    size_t record_index = 0;
+    Record record; // for pending frames
+    std::vector<IFrameBase::Ptr> pending_frames;
+    std::vector<InferenceBackend::OutputLogFrameId> frame_ids; // reused between batches
+    uint64_t replayed_records = 0;
+    uint64_t mismatched_batches = 0;
+    uint64_t resynced_batches = 0;
+};
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -14,6 +14,7 @@
 
 #include "image.h"
 #include "input_image_layer_descriptor.h"
+#include "pre_proc_cache.h"
 
 namespace InferenceBackend {
 
@@ -42,10 +43,40 @@ class ImageInference {
         virtual ImageTransformationParams::Ptr GetImageTransformationParams() {
             return image_trans_params;
         }
+        // Cache of pre-processed regions shared with other inferences on the same frame, nullptr if not used
+        virtual PreProcCache::Ptr GetPreProcCache() const {
+            return nullptr;
+        }
+        // If false, regions are only loaded from pre-processing cache, because no other inference may load them later
+        virtual bool IsPreProcCacheStoreNeeded() const {
+            return true;
+        }
+        // Frames with higher priority get free inference requests first
+        virtual int GetPriority() const {
+            return 0;
+        }
 
         virtual ~IFrameBase() = default;
     };
 
+    // Counters accumulated since creation, may be queried from any thread while inference is running
+    struct Stats {
+        uint64_t pre_proc_cache_hits = 0;   // regions copied from pre-processing cache of the frame
+        uint64_t pre_proc_cache_misses = 0; // regions pre-processed because not found in the cache
+        uint64_t pre_proc_cache_stores = 0; // pre-processed regions added to the cache
+        uint64_t pre_proc_cache_full = 0;   // pre-processed regions not added because cache reached its size limit
+
+        // Per frame priority (see IFrameBase::GetPriority), for priorities of completed frames
+        struct Priority {
+            uint64_t frames = 0;         // frames with completed inference
+            uint64_t wait_avg_us = 0;    // time waiting for free inference request
+            uint64_t wait_max_us = 0;
+            uint64_t latency_avg_us = 0; // time from submission to inference completion
+            uint64_t latency_max_us = 0;
+        };
+        std::map<int, Priority> priorities;
+    };
+
     typedef std::function<void(std::map<std::string, std::shared_ptr<OutputBlob>> blobs,
                                std::vector<IFrameBase::Ptr> frames)>
         CallbackFunc;
@@ -68,6 +99,9 @@ class ImageInference {
     virtual std::map<std::string, std::vector<size_t>> GetModelOutputsInfo() const = 0;
 
     virtual bool IsQueueFull() = 0;
+    virtual Stats GetStats() const {
+        return Stats();
+    }
     virtual void Flush() = 0;
     virtual void Close() = 0;
 
@@ -172,6 +206,9 @@ __DECLARE_CONFIG_KEY(image);
 __DECLARE_CONFIG_KEY(CAPS_FEATURE);
 __DECLARE_CONFIG_KEY(VAAPI_THREAD_POOL_SIZE);
 __DECLARE_CONFIG_KEY(VAAPI_FAST_SCALE_LOAD_FACTOR);
+__DECLARE_CONFIG_KEY(VAAPI_IMAGE_POOL_MIN_SIZE);
+__DECLARE_CONFIG_KEY(VAAPI_IMAGE_POOL_MAX_SIZE);
+__DECLARE_CONFIG_KEY(VAAPI_IMAGE_POOL_GROW_WAIT_MS);
 #undef __DECLARE_CONFIG_KEY
 #undef __CONFIG_KEY
 
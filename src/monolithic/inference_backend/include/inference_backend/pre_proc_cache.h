@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "image.h"
+#include "input_image_layer_descriptor.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace InferenceBackend {
+
+/**
+ * Pre-processed (cropped, color converted, resized and normalized) regions of one frame. Shared by inference elements
+ * processing the same frame one after another, so region prepared for one model is copied into input of next model
+ * with the same input specification instead of being pre-processed again. Total size of cached data is limited, regions
+ * are not stored once the limit is reached. Thread-safe.
+ */
+class PreProcCache {
+  public:
+    using Ptr = std::shared_ptr<PreProcCache>;
+
+    // Enough for ~100 regions of 224x224 BGR U8 or ~25 of 224x224 FP32 per frame
+    static constexpr size_t DEFAULT_MAX_SIZE = 16 * 1024 * 1024;
+
+    explicit PreProcCache(size_t max_size = DEFAULT_MAX_SIZE) : max_size(max_size) {
+    }
+
+    // Key identifies source region, destination image and all parameters pre-processing result depends on
+    static std::string MakeKey(const Image &src, const Image &dst, const InputImageLayerDesc::Ptr &pre_proc_info,
+                               const std::string &pre_processor) {
+        std::string key = pre_processor;
+        auto append = [&key](auto value) {
+            if constexpr (std::is_floating_point<decltype(value)>::value) {
+                // raw bits, as std::to_string keeps only 6 decimals and close values would share the key
+                const double d = value;
+                uint64_t bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                key += ':' + std::to_string(bits);
+            } else {
+                key += ':' + std::to_string(value);
+            }
+        };
+        for (auto value : {src.format, dst.format})
+            append(value);
+        for (auto value : {src.width, src.height, src.rect.x, src.rect.y, src.rect.width, src.rect.height, dst.width,
+                           dst.height})
+            append(value);
+        if (!pre_proc_info)
+            return key;
+        append(static_cast<int>(pre_proc_info->getResizeType()));
+        append(static_cast<int>(pre_proc_info->getCropType()));
+        append(static_cast<int>(pre_proc_info->getTargetColorSpace()));
+        if (pre_proc_info->doNeedRangeNormalization()) {
+            append(pre_proc_info->getRangeNormalization().min);
+            append(pre_proc_info->getRangeNormalization().max);
+        }
+        if (pre_proc_info->doNeedDistribNormalization()) {
+            for (double value : pre_proc_info->getDistribNormalization().mean)
+                append(value);
+            for (double value : pre_proc_info->getDistribNormalization().std)
+                append(value);
+        }
+        if (pre_proc_info->doNeedPadding()) {
+            const auto &padding = pre_proc_info->getPadding();
+            append(padding.stride_x);
+            append(padding.stride_y);
+            for (double value : padding.fill_value)
+                append(value);
+        }
+        return key;
+    }
+
+    // Copies cached data into dst and transformation done by pre-processing into transform. Returns false if region
+    // was not pre-processed with the same key or cached data has different size
+    bool Load(const std::string &key, void *dst, size_t size, ImageTransformationParams &transform) {
+        std::shared_ptr<const Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(key);
+            if (it != entries.end())
+                entry = it->second;
+        }
+        if (!entry || entry->data.size() != size)
+            return false;
+        std::memcpy(dst, entry->data.data(), size);
+        transform = entry->transform;
+        return true;
+    }
+
+    // Returns false if region wasn't stored because cache would exceed its size limit. Region already stored with the
+    // same key (pre-processed concurrently by other inference) is kept
+    bool Store(const std::string &key, const void *src, size_t size, const ImageTransformationParams &transform) {
+        {
+            // Space is reserved before copying, so data isn't copied only to be dropped
+            std::lock_guard<std::mutex> lock(mutex);
+            if (entries.count(key))
+                return true;
+            if (total_size + size > max_size)
+                return false;
+            total_size += size;
+        }
+        auto entry = std::make_shared<Entry>();
+        entry->data.assign(static_cast<const uint8_t *>(src), static_cast<const uint8_t *>(src) + size);
+        entry->transform = transform;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!entries.emplace(key, std::move(entry)).second)
+            total_size -= size;
+        return true;
+    }
+
+  private:
+    struct Entry {
+        std::vector<uint8_t> data;
+        ImageTransformationParams transform;
+    };
+
+    const size_t max_size;
+    std::mutex mutex;
+    size_t total_size = 0;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> entries;
+};
+
+} // namespace InferenceBackend
@@ -9,6 +9,7 @@
 #include "opencv_find_contours.h"
 #include "opencv_meta_overlay.h"
 #include "opencv_object_association.h"
+#include "opencv_preproc.h"
 #include "opencv_remove_background.h"
 #include "opencv_tensor_normalize.h"
 #include "opencv_warp_affine.h"
@@ -21,6 +22,7 @@ DLS_EXPORT const dlstreamer::ElementDesc *dlstreamer_elements[] = { //
     &opencv_barcode_detector,
     &opencv_object_association,
     &opencv_tensor_normalize,
+    &opencv_preproc,
     &opencv_cropscale,
     &opencv_meta_overlay,
     &opencv_remove_background,
@@ -12,15 +12,23 @@
 #include "dlstreamer/opencv/context.h"
 #include "dlstreamer_logger.h"
 #include <opencv2/barcode.hpp>
+#include <opencv2/core/utility.hpp>
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace dlstreamer {
 namespace param {
 static constexpr auto allow_undecoded = "allow_undecoded";
 static constexpr auto undecoded_label = "undecoded_label";
 static constexpr auto add_type = "add_type";
+static constexpr auto threads = "threads";
+static constexpr auto prefilter_size = "prefilter_size";
+static constexpr auto object_cache = "object_cache";
 
 static constexpr auto default_undecoded_label = "<undecodable>";
 }; // namespace param
@@ -29,23 +37,37 @@ static ParamDescVector params_desc = {
     {param::allow_undecoded, "Allow undecoded barcodes to be added as ROI", false},
     {param::add_type, "Adds Barcode type to the label", false},
     {param::undecoded_label, "Label for undecoded barcodes", param::default_undecoded_label},
+    {param::threads, "Number of threads decoding ROIs of frame in parallel, 0 - number of threads of OpenCV", 0, 0,
+     std::numeric_limits<int>::max()},
+    {param::prefilter_size,
+     "If not 0, ROI with longer side above this size is first searched for barcodes downscaled to this size, and "
+     "decoded in full resolution only if barcode candidate is found",
+     0, 0, std::numeric_limits<int>::max()},
+    {param::object_cache,
+     "Reuse barcodes decoded for tracked object (ROI with object id) instead of decoding its ROI in every frame",
+     false},
 };
 
 class OpencvBarcodeDetector : public BaseTransformInplace {
   public:
+    // Cached barcodes of object not seen for this number of frames are removed
+    static constexpr uint64_t cache_max_age = 300;
+
     OpencvBarcodeDetector(DictionaryCPtr params, const ContextPtr &app_context)
         : BaseTransformInplace(app_context),
           _logger(log::get_or_nullsink(params->get(param::logger_name, std::string()))) {
         _allow_undecoded = params->get<bool>(param::allow_undecoded, false);
         _add_barcode_type = params->get<bool>(param::add_type, false);
         _undecoded_label = params->get<std::string>(param::undecoded_label, param::default_undecoded_label);
+        _threads = params->get<int>(param::threads, 0);
+        _prefilter_size = params->get<int>(param::prefilter_size, 0);
+        _object_cache = params->get<bool>(param::object_cache, false);
     }
 
     bool init_once() override {
         auto cpu_context = std::make_shared<CPUContext>();
         auto opencv_context = std::make_shared<OpenCVContext>();
         _opencv_mapper = create_mapper({_app_context, cpu_context, opencv_context});
-        _bardet = cv::makePtr<cv::barcode::BarcodeDetector>();
         return true;
     }
 
@@ -59,6 +81,12 @@ class OpencvBarcodeDetector : public BaseTransformInplace {
         auto cv_tensor = ptr_cast<OpenCVTensor>(_opencv_mapper->map(frame->tensor(0), AccessMode::Read));
         cv::Mat cv_mat = *cv_tensor;
         const ImageInfo &frame_info = frame->tensor(0)->info();
+        const cv::Rect frame_rect(0, 0, cv_mat.cols, cv_mat.rows);
+        _frame_number++;
+
+        // Collect ROIs to decode, barcodes of tracked objects decoded in previous frames are taken from cache
+        _rois.clear();
+        std::vector<size_t> decode_indices;
         for (auto &region : frame->regions()) {
             auto detection_meta = find_metadata<DetectionMetadata>(*region);
             if (!detection_meta) {
@@ -68,55 +96,161 @@ class OpencvBarcodeDetector : public BaseTransformInplace {
             auto y = std::lround(detection_meta->y_min() * static_cast<double>(frame_info.height()));
             auto w = std::lround(detection_meta->x_max() * static_cast<double>(frame_info.width())) - x;
             auto h = std::lround(detection_meta->y_max() * static_cast<double>(frame_info.height())) - y;
-            cv::Rect rect(x, y, w, h);
-            cv::Mat croppedImage = cv_mat(rect);
-            std::vector<cv::String> decode_info;
-            std::vector<cv::barcode::BarcodeType> decoded_type;
-            std::vector<cv::Point> corners;
-            bool result_detection;
-            try {
-                result_detection = _bardet->detectAndDecode(croppedImage, decode_info, decoded_type, corners);
-            } catch (const std::exception &e) {
-                SPDLOG_LOGGER_ERROR(_logger, "Exception during Barcode Detection: {}", e.what());
-                return false;
-            }
-            if (!result_detection || corners.empty()) {
+            Roi roi;
+            roi.rect = cv::Rect(x, y, w, h) & frame_rect;
+            if (roi.rect.empty())
                 continue;
-            }
-            for (size_t i = 0; i < corners.size(); i += 4) {
-                size_t bar_idx = i / 4;
-                const bool decoded = bar_idx < decode_info.size() && !decode_info[bar_idx].empty();
-                if (!decoded && !_allow_undecoded)
+            if (_object_cache) {
+                auto object_id_meta = find_metadata<ObjectIdMetadata>(*region);
+                roi.object_id = object_id_meta ? object_id_meta->id() : -1;
+                auto it = roi.object_id >= 0 ? _cache.find(roi.object_id) : _cache.end();
+                if (it != _cache.end()) {
+                    it->second.last_seen = _frame_number;
+                    roi.barcodes = it->second.barcodes;
+                    _rois.push_back(std::move(roi));
                     continue;
-                DetectionMetadata dmeta(frame->metadata().add(DetectionMetadata::name));
+                }
+            }
+            decode_indices.push_back(_rois.size());
+            _rois.push_back(std::move(roi));
+        }
 
-                std::string label;
-                cv::Rect box = cv::boundingRect(corners);
-                if (decoded) {
-                    std::ostringstream oss;
-                    if (_add_barcode_type && bar_idx < decoded_type.size())
-                        oss << '[' << decoded_type[bar_idx] << ']';
-                    oss << decode_info[bar_idx];
-                    label = oss.str();
-                } else {
-                    label = _undecoded_label;
+        // Decode ROIs in parallel, every worker uses own detector for ROIs i, i + workers, i + 2 * workers, ...
+        const int threads = _threads ? _threads : std::max(cv::getNumThreads(), 1);
+        const size_t workers = std::min(decode_indices.size(), static_cast<size_t>(threads));
+        while (_detectors.size() < workers)
+            _detectors.push_back(cv::makePtr<cv::barcode::BarcodeDetector>());
+        auto decode_body = [&](const cv::Range &range) {
+            for (int worker = range.start; worker < range.end; worker++) {
+                for (size_t i = worker; i < decode_indices.size(); i += workers) {
+                    Roi &roi = _rois[decode_indices[i]];
+                    try {
+                        decode(*_detectors[worker], cv_mat(roi.rect), roi.barcodes);
+                    } catch (const std::exception &e) {
+                        roi.error = e.what();
+                    }
                 }
-                dmeta.init((x + box.x) / static_cast<double>(frame_info.width()),
-                           (y + box.y) / static_cast<double>(frame_info.height()),
-                           (x + box.br().x) / static_cast<double>(frame_info.width()),
-                           (y + box.br().y) / static_cast<double>(frame_info.height()), 1.0, -1, label);
+            }
+        };
+        if (workers > 1)
+            cv::parallel_for_(cv::Range(0, static_cast<int>(workers)), decode_body, static_cast<double>(workers));
+        else if (workers == 1)
+            decode_body(cv::Range(0, 1));
+
+        // Attach results in order of ROIs
+        for (auto &roi : _rois) {
+            if (!roi.error.empty()) {
+                SPDLOG_LOGGER_ERROR(_logger, "Exception during Barcode Detection: {}", roi.error);
+                return false;
+            }
+            for (auto &barcode : roi.barcodes) {
+                DetectionMetadata dmeta(frame->metadata().add(DetectionMetadata::name));
+                const double x_min = roi.rect.x + barcode.box.x * roi.rect.width;
+                const double y_min = roi.rect.y + barcode.box.y * roi.rect.height;
+                const double x_max = roi.rect.x + barcode.box.br().x * roi.rect.width;
+                const double y_max = roi.rect.y + barcode.box.br().y * roi.rect.height;
+                dmeta.init(x_min / frame_info.width(), y_min / frame_info.height(), x_max / frame_info.width(),
+                           y_max / frame_info.height(), 1.0, -1, barcode.label);
             }
         }
+
+        if (_object_cache)
+            update_cache();
         return true;
     }
 
   private:
-    cv::Ptr<cv::barcode::BarcodeDetector> _bardet;
+    struct Barcode {
+        std::string label;
+        bool decoded;
+        cv::Rect2d box; // relative to ROI, in fractions of ROI size
+    };
+
+    struct Roi {
+        cv::Rect rect;
+        int object_id = -1;
+        std::vector<Barcode> barcodes;
+        std::string error;
+    };
+
+    struct CacheEntry {
+        std::vector<Barcode> barcodes;
+        uint64_t last_seen;
+    };
+
+    // Called from worker threads, must not modify state shared between ROIs
+    void decode(const cv::barcode::BarcodeDetector &detector, const cv::Mat &image,
+                std::vector<Barcode> &barcodes) const {
+        const int size = std::max(image.cols, image.rows);
+        if (_prefilter_size > 0 && size > _prefilter_size) {
+            const double scale = static_cast<double>(_prefilter_size) / size;
+            cv::Mat downscaled;
+            cv::resize(image, downscaled, cv::Size(), scale, scale, cv::INTER_AREA);
+            std::vector<cv::Point> candidates;
+            if (!detector.detect(downscaled, candidates) || candidates.empty())
+                return;
+        }
+
+        std::vector<cv::String> decode_info;
+        std::vector<cv::barcode::BarcodeType> decoded_type;
+        std::vector<cv::Point> corners;
+        if (!detector.detectAndDecode(image, decode_info, decoded_type, corners) || corners.empty())
+            return;
+        for (size_t i = 0; i + 4 <= corners.size(); i += 4) {
+            size_t bar_idx = i / 4;
+            const bool decoded = bar_idx < decode_info.size() && !decode_info[bar_idx].empty();
+            if (!decoded && !_allow_undecoded)
+                continue;
+
+            std::string label;
+            if (decoded) {
+                std::ostringstream oss;
+                if (_add_barcode_type && bar_idx < decoded_type.size())
+                    oss << '[' << decoded_type[bar_idx] << ']';
+                oss << decode_info[bar_idx];
+                label = oss.str();
+            } else {
+                label = _undecoded_label;
+            }
+            cv::Rect box = cv::boundingRect(std::vector<cv::Point>(corners.begin() + i, corners.begin() + i + 4));
+            barcodes.push_back({std::move(label), decoded,
+                                cv::Rect2d(static_cast<double>(box.x) / image.cols,
+                                           static_cast<double>(box.y) / image.rows,
+                                           static_cast<double>(box.width) / image.cols,
+                                           static_cast<double>(box.height) / image.rows)});
+        }
+    }
+
+    // Only tracked objects with successfully decoded barcode are cached, others are decoded again in next frame
+    void update_cache() {
+        for (auto &roi : _rois) {
+            if (roi.object_id < 0 || _cache.count(roi.object_id))
+                continue;
+            bool decoded = std::any_of(roi.barcodes.begin(), roi.barcodes.end(),
+                                       [](const Barcode &barcode) { return barcode.decoded; });
+            if (decoded)
+                _cache[roi.object_id] = {std::move(roi.barcodes), _frame_number};
+        }
+        for (auto it = _cache.begin(); it != _cache.end();) {
+            if (_frame_number - it->second.last_seen > cache_max_age)
+                it = _cache.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::vector<cv::Ptr<cv::barcode::BarcodeDetector>> _detectors; // one per worker, detector is not thread-safe
     MemoryMapperPtr _opencv_mapper;
     std::shared_ptr<spdlog::logger> _logger;
     bool _allow_undecoded;
     bool _add_barcode_type;
     std::string _undecoded_label;
+    int _threads;
+    int _prefilter_size;
+    bool _object_cache;
+    std::vector<Roi> _rois;
+    std::unordered_map<int, CacheEntry> _cache;
+    uint64_t _frame_number = 0;
 };
 
 extern "C" {
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -9,6 +9,7 @@
 #include "dlstreamer/cpu/tensor.h"
 #include "dlstreamer/image_metadata.h"
 #include "dlstreamer/utils.h"
+#include "mask_kernel.h"
 #include "opencv2/imgproc.hpp"
 
 using namespace cv;
@@ -59,12 +60,12 @@ class OpencvFindContours : public BaseTransformInplace {
             int mask_width = mask_info.width();
             int mask_height = mask_info.height();
 
-            cv::Mat bitmask(mask_height, mask_width, CV_8UC1);
-            uint8_t *bitmask_data = (uint8_t *)(bitmask.data);
-            for (int i = 0; i < mask_height * mask_width; i++)
-                bitmask_data[i] = (mask_data[i] >= _mask_threshold) ? 1 : 0;
+            // findContours modifies source image, so bitmask is rewritten for every region
+            _bitmask.create(mask_height, mask_width, CV_8UC1);
+            _mask_kernel.threshold(mask_data, mask_width, mask_height, _mask_threshold, 1, _bitmask.data,
+                                   _bitmask.step, mask_width, mask_height);
             vector<vector<Point>> contours;
-            findContours(bitmask, contours, RETR_TREE, CHAIN_APPROX_SIMPLE);
+            findContours(_bitmask, contours, RETR_TREE, CHAIN_APPROX_SIMPLE);
             for (auto &contour : contours) {
                 size_t num_points = contour.size();
                 float normalized_points[num_points][2];
@@ -84,6 +85,8 @@ class OpencvFindContours : public BaseTransformInplace {
     std::string _mask_metadata_name;
     std::string _contour_metadata_name;
     float _mask_threshold;
+    MaskKernel _mask_kernel;
+    cv::Mat _bitmask;
 };
 
 extern "C" {
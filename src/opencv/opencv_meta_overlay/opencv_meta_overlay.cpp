@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2018-2022 Intel Corporation
+ * Copyright (C) 2018-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -10,6 +10,10 @@
 #include "dlstreamer/cpu/frame_alloc.h"
 #include "dlstreamer/memory_mapper_factory.h"
 #include "dlstreamer/opencv/context.h"
+#include "overlay_renderer.h"
+
+#include <limits>
+#include <memory>
 
 namespace dlstreamer {
 
@@ -19,11 +23,13 @@ class OpencvMetaOverlay : public MetaOverlayBase {
         static constexpr auto font_thickness = "font-thickness";
         static constexpr auto font_scale = "font-scale";
         static constexpr auto attach_label_mask = "attach-label-mask";
+        static constexpr auto bands = "bands";
     };
     struct dflt {
         static constexpr auto font_thickness = 1;
         static constexpr auto font_scale = 1.0;
         static constexpr auto attach_label_mask = false;
+        static constexpr auto bands = 0;
     };
 
     static ParamDescVector params_desc;
@@ -35,6 +41,13 @@ class OpencvMetaOverlay : public MetaOverlayBase {
 
         int baseline = 0;
         _font_height = cv::getTextSize(" ", _font_face, _font_scale, _font_thickness, &baseline).height;
+
+        overlay::OpencvOverlayRenderer::Font font;
+        font.face = _font_face;
+        font.scale = _font_scale;
+        font.thickness = _font_thickness;
+        font.line_type = _line_type;
+        _renderer = std::make_unique<overlay::OpencvOverlayRenderer>(font, params->get<int>(param::bands, dflt::bands));
     }
 
     bool init_once() override {
@@ -81,21 +94,8 @@ class OpencvMetaOverlay : public MetaOverlayBase {
         FramePtr mapped_frame = _opencv_mapper->map(frame, AccessMode::ReadWrite);
         cv::Mat mat = *ptr_cast<OpenCVTensor>(mapped_frame->tensor());
 
-        // render
-        for (auto &rect : rects) {
-            cv::rectangle(mat, {rect.x, rect.y}, {rect.x + rect.width, rect.y + rect.height}, color_to_cv(rect.color),
-                          rect.thickness, _line_type);
-        }
-        for (auto &text : texts) {
-            cv::putText(mat, text.str, {text.x, text.y}, _font_face, _font_scale, color_to_cv(text.color),
-                        _font_thickness, _line_type);
-        }
-        for (auto &circle : keypoints) {
-            cv::circle(mat, {circle.x, circle.y}, circle.radius, color_to_cv(circle.color), cv::FILLED);
-        }
-        for (auto &line : lines) {
-            cv::line(mat, {line.x1, line.y1}, {line.x2, line.y2}, color_to_cv(line.color), line.thickness);
-        }
+        // render, in parallel horizontal bands
+        _renderer->render(mat, rects, texts, keypoints, lines);
 
         return true;
     }
@@ -107,17 +107,13 @@ class OpencvMetaOverlay : public MetaOverlayBase {
     cv::HersheyFonts _font_face = cv::FONT_HERSHEY_TRIPLEX;
     double _font_scale;
     int _font_thickness;
+    std::unique_ptr<overlay::OpencvOverlayRenderer> _renderer;
 
     void append(std::ostringstream &ss, const std::string &str) {
         if (!ss.str().empty())
             ss << " ";
         ss << str;
     }
-
-    static cv::Scalar color_to_cv(uint32_t color) {
-        auto c = overlay::Color(color).get_array();
-        return {double(c[0]), double(c[1]), double(c[2])};
-    }
 };
 
 ParamDescVector OpencvMetaOverlay::params_desc = {
@@ -126,6 +122,10 @@ ParamDescVector OpencvMetaOverlay::params_desc = {
     {param::font_thickness, "Font thickness", dflt::font_thickness},
     {param::font_scale, "Font scale", dflt::font_scale},
     {param::attach_label_mask, "Attach label mask as metadata, image not changed", false},
+    {param::bands,
+     "Number of horizontal bands of image drawn in parallel, 0 - by number of CPU threads, 1 - draw on streaming "
+     "thread",
+     dflt::bands, 0, std::numeric_limits<int>::max()},
 };
 
 extern "C" {
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "overlay_renderer.h"
+
+#include <opencv2/core/utility.hpp>
+
+#include <algorithm>
+
+namespace dlstreamer {
+namespace overlay {
+
+void OpencvOverlayRenderer::render(cv::Mat &mat, const std::vector<prims::Rect> &rects,
+                                   const std::vector<prims::Text> &texts, const std::vector<prims::Circle> &circles,
+                                   const std::vector<prims::Line> &lines) {
+    // Rasters of texts are looked up before drawing, bands only read them
+    if (_text_cache.size() > max_cached_texts)
+        _text_cache.clear();
+    _rasters.clear();
+    _text_rows.clear();
+    for (auto &text : texts) {
+        const TextRaster &raster = text_raster(text.str);
+        _rasters.push_back(&raster);
+        const int top = text.y - raster.origin.y;
+        _text_rows.push_back({top, top + raster.mask.rows - 1});
+    }
+
+    _rect_rows.clear();
+    for (auto &rect : rects) {
+        const int margin = static_cast<int>(rect.thickness) + 1;
+        _rect_rows.push_back({std::min(rect.y, rect.y + rect.height) - margin,
+                              std::max(rect.y, rect.y + rect.height) + margin});
+    }
+    _circle_rows.clear();
+    for (auto &circle : circles) {
+        const int margin = static_cast<int>(circle.radius) + 1;
+        _circle_rows.push_back({circle.y - margin, circle.y + margin});
+    }
+    _line_rows.clear();
+    for (auto &line : lines) {
+        const int margin = static_cast<int>(line.thickness) + 1;
+        _line_rows.push_back({std::min(line.y1, line.y2) - margin, std::max(line.y1, line.y2) + margin});
+    }
+
+    int bands = _bands ? _bands : cv::getNumThreads();
+    bands = std::max(1, std::min(bands, mat.rows / min_band_height));
+    if (bands == 1) {
+        render_band(mat, 0, mat.rows - 1, rects, texts, circles, lines);
+        return;
+    }
+    cv::parallel_for_(
+        cv::Range(0, bands),
+        [&](const cv::Range &range) {
+            for (int band = range.start; band < range.end; band++)
+                render_band(mat, band * mat.rows / bands, (band + 1) * mat.rows / bands - 1, rects, texts, circles,
+                            lines);
+        },
+        bands);
+}
+
+void OpencvOverlayRenderer::render_band(cv::Mat &mat, int band_first, int band_last,
+                                        const std::vector<prims::Rect> &rects, const std::vector<prims::Text> &texts,
+                                        const std::vector<prims::Circle> &circles,
+                                        const std::vector<prims::Line> &lines) {
+    cv::Mat band = mat.rowRange(band_first, band_last + 1);
+    const cv::Rect band_rect(0, band_first, mat.cols, band.rows);
+    const cv::Point shift(0, -band_first);
+    auto visible = [&](const RowRange &rows) { return rows.last >= band_first && rows.first <= band_last; };
+
+    for (size_t i = 0; i < rects.size(); i++) {
+        auto &rect = rects[i];
+        if (!visible(_rect_rows[i]))
+            continue;
+        cv::rectangle(band, cv::Point(rect.x, rect.y) + shift,
+                      cv::Point(rect.x + rect.width, rect.y + rect.height) + shift, color_to_cv(rect.color),
+                      rect.thickness, _font.line_type);
+    }
+    for (size_t i = 0; i < texts.size(); i++) {
+        auto &text = texts[i];
+        if (!visible(_text_rows[i]))
+            continue;
+        if (_font.line_type == cv::LINE_AA) {
+            // Antialiased text is blended with image, so it can't be copied from raster
+            cv::putText(band, text.str, cv::Point(text.x, text.y) + shift, _font.face, _font.scale,
+                        color_to_cv(text.color), _font.thickness, _font.line_type);
+            continue;
+        }
+        const TextRaster &raster = *_rasters[i];
+        const cv::Rect text_rect(text.x - raster.origin.x, text.y - raster.origin.y, raster.mask.cols,
+                                 raster.mask.rows);
+        const cv::Rect visible_rect = text_rect & band_rect;
+        if (visible_rect.empty())
+            continue;
+        band(visible_rect + shift).setTo(color_to_cv(text.color), raster.mask(visible_rect - text_rect.tl()));
+    }
+    for (size_t i = 0; i < circles.size(); i++) {
+        auto &circle = circles[i];
+        if (!visible(_circle_rows[i]))
+            continue;
+        cv::circle(band, cv::Point(circle.x, circle.y) + shift, circle.radius, color_to_cv(circle.color), cv::FILLED);
+    }
+    for (size_t i = 0; i < lines.size(); i++) {
+        auto &line = lines[i];
+        if (!visible(_line_rows[i]))
+            continue;
+        cv::line(band, cv::Point(line.x1, line.y1) + shift, cv::Point(line.x2, line.y2) + shift,
+                 color_to_cv(line.color), line.thickness);
+    }
+}
+
+const OpencvOverlayRenderer::TextRaster &OpencvOverlayRenderer::text_raster(const std::string &str) {
+    auto it = _text_cache.find(str);
+    if (it != _text_cache.end())
+        return it->second;
+
+    int baseline = 0;
+    const cv::Size size = cv::getTextSize(str, _font.face, _font.scale, _font.thickness, &baseline);
+    // Strokes of some glyphs go out of text box returned by getTextSize
+    const int pad = _font.thickness + size.height / 2;
+    TextRaster raster;
+    raster.origin = cv::Point(pad, pad + size.height);
+    raster.mask = cv::Mat::zeros(size.height + baseline + 2 * pad, size.width + 2 * pad, CV_8UC1);
+    cv::putText(raster.mask, str, raster.origin, _font.face, _font.scale, cv::Scalar(255), _font.thickness,
+                _font.line_type);
+    return _text_cache.emplace(str, std::move(raster)).first->second;
+}
+
+} // namespace overlay
+} // namespace dlstreamer
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "overlay_prims.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dlstreamer {
+namespace overlay {
+
+/**
+ * Draws overlay primitives on image with OpenCV. Image is split into horizontal bands drawn in parallel, every band
+ * draws only primitives whose bounding box overlaps it, clipped to the band, in the same order as serial drawing.
+ * Text is rasterized once into cached mask and then copied with color, which gives the same pixels as cv::putText
+ * for non-antialiased lines.
+ */
+class OpencvOverlayRenderer {
+  public:
+    static constexpr int min_band_height = 64;
+    static constexpr size_t max_cached_texts = 1024;
+
+    struct Font {
+        cv::HersheyFonts face = cv::FONT_HERSHEY_TRIPLEX;
+        double scale = 1.0;
+        int thickness = 1;
+        int line_type = cv::LINE_8;
+    };
+
+    // bands = 0 selects number of bands by number of OpenCV threads, 1 draws whole image on calling thread
+    OpencvOverlayRenderer(const Font &font, int bands) : _font(font), _bands(bands) {
+    }
+
+    void render(cv::Mat &mat, const std::vector<prims::Rect> &rects, const std::vector<prims::Text> &texts,
+                const std::vector<prims::Circle> &circles, const std::vector<prims::Line> &lines);
+
+    static cv::Scalar color_to_cv(uint32_t color) {
+        auto c = Color(color).get_array();
+        return {double(c[0]), double(c[1]), double(c[2])};
+    }
+
+  private:
+    struct TextRaster {
+        cv::Mat mask;     // 255 where text is drawn
+        cv::Point origin; // text origin (bottom-left of first character) in mask
+    };
+
+    // Vertical extent of primitive in image rows [first, last], used for band culling
+    struct RowRange {
+        int first;
+        int last;
+    };
+
+    const TextRaster &text_raster(const std::string &str);
+    void render_band(cv::Mat &mat, int band_first, int band_last, const std::vector<prims::Rect> &rects,
+                     const std::vector<prims::Text> &texts, const std::vector<prims::Circle> &circles,
+                     const std::vector<prims::Line> &lines);
+
+    Font _font;
+    int _bands;
+    std::unordered_map<std::string, TextRaster> _text_cache;
+    // Per-frame data reused between frames
+    std::vector<const TextRaster *> _rasters;
+    std::vector<RowRange> _rect_rows, _text_rows, _circle_rows, _line_rows;
+};
+
+} // namespace overlay
+} // namespace dlstreamer
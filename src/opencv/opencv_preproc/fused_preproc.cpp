@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "fused_preproc.h"
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace dlstreamer {
+
+namespace {
+
+inline float clamp_u8(float value) {
+    return std::min(std::max(value, 0.f), 255.f);
+}
+
+// dst[x] = row0[x] * a0 + row1[x] * a1 + b
+void blend_rows(const float *row0, const float *row1, float a0, float a1, float b, float *dst, int width) {
+    int x = 0;
+#if CV_SIMD
+    constexpr int lanes = CV_SIMD_WIDTH / sizeof(float);
+    const cv::v_float32 va0 = cv::vx_setall_f32(a0);
+    const cv::v_float32 va1 = cv::vx_setall_f32(a1);
+    const cv::v_float32 vb = cv::vx_setall_f32(b);
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_float32 v = cv::v_fma(cv::vx_load(row1 + x), va1, vb);
+        cv::v_store(dst + x, cv::v_fma(cv::vx_load(row0 + x), va0, v));
+    }
+#endif
+    for (; x < width; x++)
+        dst[x] = row0[x] * a0 + row1[x] * a1 + b;
+}
+
+} // namespace
+
+FusedPreproc::FusedPreproc(bool rgb_output, const std::vector<double> &range, const std::vector<double> &mean,
+                           const std::vector<double> &std)
+    : _rgb_output(rgb_output) {
+    if (!range.empty() && range.size() != 2)
+        throw std::invalid_argument("Normalization range expects two values");
+    for (int c = 0; c < channels; c++) {
+        double alpha = 1;
+        double beta = 0;
+        if (!range.empty()) {
+            alpha *= (range[1] - range[0]) / 255.f;
+            beta += range[0];
+        }
+        if (!std.empty()) {
+            alpha *= std.at(c);
+        }
+        if (!mean.empty()) {
+            beta += mean.at(c);
+        }
+        _alpha[c] = static_cast<float>(alpha);
+        _beta[c] = static_cast<float>(beta);
+    }
+}
+
+FusedPreproc::AxisMap FusedPreproc::build_axis_map(int src_size, int dst_size) {
+    // Same pixel-center alignment as cv::resize with INTER_LINEAR
+    AxisMap map;
+    map.index0.resize(dst_size);
+    map.index1.resize(dst_size);
+    map.weight1.resize(dst_size);
+    const double scale = static_cast<double>(src_size) / dst_size;
+    for (int d = 0; d < dst_size; d++) {
+        float s = static_cast<float>((d + 0.5) * scale - 0.5);
+        int i0 = static_cast<int>(std::floor(s));
+        float w1 = s - i0;
+        if (i0 < 0) {
+            i0 = 0;
+            w1 = 0;
+        }
+        if (i0 >= src_size - 1) {
+            i0 = src_size - 1;
+            w1 = 0;
+        }
+        map.index0[d] = i0;
+        map.index1[d] = std::min(i0 + 1, src_size - 1);
+        map.weight1[d] = w1;
+    }
+    return map;
+}
+
+// Resamples source row 'src_y' horizontally into 'channels' planar float rows stored one after another in 'out'
+void FusedPreproc::resample_row(const Image &src, int src_y, const AxisMap &xmap, float *out) const {
+    const int width = static_cast<int>(xmap.index0.size());
+    const int *index0 = xmap.index0.data();
+    const int *index1 = xmap.index1.data();
+    const float *weight1 = xmap.weight1.data();
+
+    if (src.format == ImageFormat::NV12) {
+        const uint8_t *y_row = src.planes[0] + src_y * src.strides[0];
+        const uint8_t *uv_row = src.planes[1] + (src_y / 2) * src.strides[1];
+        float *r_out = out + (_rgb_output ? 0 : 2) * width;
+        float *g_out = out + width;
+        float *b_out = out + (_rgb_output ? 2 : 0) * width;
+        for (int x = 0; x < width; x++) {
+            const int i0 = index0[x];
+            const int i1 = index1[x];
+            const float w1 = weight1[x];
+            // U and V of pixel 'i' are located at byte offset (i & ~1) and (i & ~1) + 1 of UV row
+            const uint8_t *uv0 = uv_row + (i0 & ~1);
+            const uint8_t *uv1 = uv_row + (i1 & ~1);
+            const float y = y_row[i0] + (y_row[i1] - y_row[i0]) * w1;
+            const float u = uv0[0] + (uv1[0] - uv0[0]) * w1 - 128.f;
+            const float v = uv0[1] + (uv1[1] - uv0[1]) * w1 - 128.f;
+            // BT.601 limited range, same coefficients as cv::COLOR_YUV2BGR_NV12
+            const float luma = 1.164f * (y - 16.f);
+            r_out[x] = clamp_u8(luma + 1.596f * v);
+            g_out[x] = clamp_u8(luma - 0.813f * v - 0.391f * u);
+            b_out[x] = clamp_u8(luma + 2.018f * u);
+        }
+        return;
+    }
+
+    int pixel_stride;
+    bool bgr_input;
+    switch (src.format) {
+    case ImageFormat::BGR:
+        pixel_stride = 3;
+        bgr_input = true;
+        break;
+    case ImageFormat::RGB:
+        pixel_stride = 3;
+        bgr_input = false;
+        break;
+    case ImageFormat::BGRX:
+        pixel_stride = 4;
+        bgr_input = true;
+        break;
+    case ImageFormat::RGBX:
+        pixel_stride = 4;
+        bgr_input = false;
+        break;
+    default:
+        throw std::runtime_error("Unsupported image format: " + image_format_to_string(src.format));
+    }
+
+    const uint8_t *row = src.planes[0] + src_y * src.strides[0];
+    for (int c = 0; c < channels; c++) {
+        // swap first and third channel if input and output channel orders differ
+        const int src_channel = (bgr_input == !_rgb_output) ? c : channels - 1 - c;
+        const uint8_t *p = row + src_channel;
+        float *o = out + c * width;
+        for (int x = 0; x < width; x++) {
+            const int i0 = index0[x] * pixel_stride;
+            const int i1 = index1[x] * pixel_stride;
+            o[x] = p[i0] + (p[i1] - p[i0]) * weight1[x];
+        }
+    }
+}
+
+cv::Rect FusedPreproc::run(const Image &src, const PlanarTensor &dst, bool keep_aspect_ratio) const {
+    if (src.width <= 0 || src.height <= 0 || dst.width <= 0 || dst.height <= 0)
+        throw std::runtime_error("Invalid image or tensor size");
+    if (dst.dtype != DataType::Float32 && dst.dtype != DataType::Float16)
+        throw std::runtime_error("Only Float32 and Float16 output supported");
+
+    cv::Rect rect(0, 0, dst.width, dst.height);
+    if (keep_aspect_ratio) {
+        double scale_x = static_cast<double>(dst.width) / src.width;
+        double scale_y = static_cast<double>(dst.height) / src.height;
+        double scale = std::min(scale_x, scale_y);
+        rect.width = std::max(1, static_cast<int>(src.width * scale));
+        rect.height = std::max(1, static_cast<int>(src.height * scale));
+    }
+    const AxisMap xmap = build_axis_map(src.width, rect.width);
+    const AxisMap ymap = build_axis_map(src.height, rect.height);
+
+    const bool fp16 = (dst.dtype == DataType::Float16);
+    auto dst_row = [&dst](int c, int y) {
+        return static_cast<uint8_t *>(dst.data) + c * dst.channel_stride + y * dst.row_stride;
+    };
+
+    cv::parallel_for_(cv::Range(0, dst.height), [&](const cv::Range &range) {
+        // Two horizontally resampled source rows, each holding 'channels' planar rows
+        std::vector<float> rows(2 * channels * rect.width);
+        std::array<float *, 2> buf = {rows.data(), rows.data() + channels * rect.width};
+        std::array<int, 2> cached = {-1, -1};
+        std::vector<float> line(fp16 ? dst.width : 0);
+
+        for (int y = range.start; y < range.end; y++) {
+            const bool padding_row = (y >= rect.height);
+            if (!padding_row) {
+                const int y0 = ymap.index0[y];
+                const int y1 = ymap.index1[y];
+                if (cached[0] != y0) {
+                    if (cached[1] == y0) {
+                        std::swap(buf[0], buf[1]);
+                        std::swap(cached[0], cached[1]);
+                    } else {
+                        resample_row(src, y0, xmap, buf[0]);
+                        cached[0] = y0;
+                    }
+                }
+                if (cached[1] != y1) {
+                    resample_row(src, y1, xmap, buf[1]);
+                    cached[1] = y1;
+                }
+            }
+
+            for (int c = 0; c < channels; c++) {
+                float *out = fp16 ? line.data() : reinterpret_cast<float *>(dst_row(c, y));
+                int filled = 0;
+                if (!padding_row) {
+                    const float w1 = ymap.weight1[y];
+                    const float *row0 = buf[0] + c * rect.width;
+                    const float *row1 = buf[1] + c * rect.width;
+                    blend_rows(row0, row1, (1.f - w1) * _alpha[c], w1 * _alpha[c], _beta[c], out, rect.width);
+                    filled = rect.width;
+                }
+                // borders get normalized zero
+                std::fill(out + filled, out + dst.width, _beta[c]);
+                if (fp16) {
+                    cv::Mat f32(1, dst.width, CV_32FC1, line.data());
+                    cv::Mat f16(1, dst.width, CV_16FC1, dst_row(c, y));
+                    f32.convertTo(f16, CV_16F);
+                }
+            }
+        }
+    });
+
+    return rect;
+}
+
+} // namespace dlstreamer
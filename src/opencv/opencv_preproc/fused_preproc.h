@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include "dlstreamer/image_info.h"
+#include "dlstreamer/tensor_info.h"
+
+#include <opencv2/core.hpp>
+
+#include <array>
+#include <vector>
+
+namespace dlstreamer {
+
+/**
+ * @brief Single-pass image pre-processing: bilinear resize, color conversion, normalization and HWC to CHW layout
+ * conversion from U8 image (BGR, RGB, BGRX, RGBX or NV12) directly into planar F32 or F16 tensor. Every source pixel
+ * is read once per output row pair and every output value written once. Output rows are processed in parallel.
+ */
+class FusedPreproc {
+  public:
+    struct Image {
+        ImageFormat format;
+        int width;
+        int height;
+        // NV12 uses two planes (Y and interleaved UV), packed RGB formats use only first plane
+        std::array<const uint8_t *, 2> planes;
+        std::array<size_t, 2> strides;
+    };
+
+    struct PlanarTensor {
+        void *data;
+        DataType dtype;
+        int width;
+        int height;
+        size_t channel_stride; // in bytes
+        size_t row_stride;     // in bytes
+    };
+
+    /**
+     * @brief Normalization parameters follow opencv_tensor_normalize semantics:
+     *   out = in * (range[1] - range[0]) / 255 * std[c] + range[0] + mean[c]
+     */
+    FusedPreproc(bool rgb_output, const std::vector<double> &range, const std::vector<double> &mean,
+                 const std::vector<double> &std);
+
+    /**
+     * @brief Runs pre-processing. If keep_aspect_ratio is set, image is placed at top-left corner and the rest of
+     * tensor is filled with normalized zero. Returns rectangle of tensor filled with image data.
+     */
+    cv::Rect run(const Image &src, const PlanarTensor &dst, bool keep_aspect_ratio) const;
+
+    static constexpr int channels = 3;
+
+  private:
+    bool _rgb_output;
+    std::array<float, channels> _alpha;
+    std::array<float, channels> _beta;
+
+    struct AxisMap {
+        std::vector<int> index0;
+        std::vector<int> index1;
+        std::vector<float> weight1;
+    };
+    static AxisMap build_axis_map(int src_size, int dst_size);
+
+    void resample_row(const Image &src, int src_y, const AxisMap &xmap, float *out) const;
+};
+
+} // namespace dlstreamer
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "dlstreamer/opencv/elements/opencv_preproc.h"
+#include "dlstreamer/base/transform.h"
+#include "dlstreamer/cpu/context.h"
+#include "dlstreamer/cpu/frame_alloc.h"
+#include "dlstreamer/image_metadata.h"
+#include "dlstreamer/memory_mapper_factory.h"
+#include "dlstreamer/utils.h"
+#include "fused_preproc.h"
+
+namespace dlstreamer {
+
+namespace param {
+static constexpr auto color_space = "color-space";
+static constexpr auto add_borders = "add-borders";
+static constexpr auto range = "range";
+static constexpr auto mean = "mean";
+static constexpr auto std = "std";
+}; // namespace param
+
+static ParamDescVector params_desc = {
+    {param::color_space, "Channel order in output tensor, BGR or RGB", std::string("BGR")},
+    {param::add_borders, "Add borders if necessary to keep the aspect ratio", false},
+    {param::range, "Normalization range MIN, MAX. Example: <0,1>", std::vector<double>()},
+    {param::mean, "Mean values per channel. Example: <0.485,0.456,0.406>", std::vector<double>()},
+    {param::std, "Standard deviation values per channel. Example: <0.229,0.224,0.225>", std::vector<double>()},
+};
+
+class OpencvPreproc : public BaseTransform {
+  public:
+    OpencvPreproc(DictionaryCPtr params, const ContextPtr &app_context) : BaseTransform(app_context) {
+        auto color_space = params->get<std::string>(param::color_space, "BGR");
+        if (color_space != "BGR" && color_space != "RGB")
+            throw std::invalid_argument("Unsupported color-space: " + color_space);
+        _aspect_ratio = params->get<bool>(param::add_borders, false);
+        _kernel = std::make_unique<FusedPreproc>(color_space == "RGB",
+                                                 params->get<std::vector<double>>(param::range, {}),
+                                                 params->get<std::vector<double>>(param::mean, {}),
+                                                 params->get<std::vector<double>>(param::std, {}));
+    }
+
+    FrameInfoVector get_input_info() override {
+        if (_output_info.tensors.empty()) {
+            return opencv_preproc.input_info;
+        } else {
+            FrameInfoVector ret;
+            for (auto &info : opencv_preproc.input_info) // any image size
+                ret.push_back(FrameInfo(static_cast<ImageFormat>(info.format), MemoryType::CPU));
+            return ret;
+        }
+    }
+
+    FrameInfoVector get_output_info() override {
+        // tensor shape is defined by downstream element (model input)
+        return opencv_preproc.output_info;
+    }
+
+    bool init_once() override {
+        auto cpu_context = std::make_shared<CPUContext>();
+        _cpu_mapper = create_mapper({_app_context, cpu_context});
+        return true;
+    }
+
+    std::function<FramePtr()> get_output_allocator() override {
+        return [this]() { return std::make_shared<CPUFrameAlloc>(_output_info); };
+    }
+
+    bool process(FramePtr src, FramePtr dst) override {
+        DLS_CHECK(init());
+        auto src_frame = _cpu_mapper->map(src, AccessMode::Read);
+        auto dst_tensor = dst->tensor();
+
+        FusedPreproc::Image image = {};
+        image.format = static_cast<ImageFormat>(_input_info.format);
+        ImageInfo src_info(src_frame->tensor(0)->info());
+        image.width = src_info.width();
+        image.height = src_info.height();
+        if (image.format == ImageFormat::NV12) {
+            DLS_CHECK(src_frame->num_tensors() == 2);
+            ImageInfo uv_info(src_frame->tensor(1)->info());
+            image.planes = {static_cast<uint8_t *>(src_frame->tensor(0)->data()),
+                            static_cast<uint8_t *>(src_frame->tensor(1)->data())};
+            image.strides = {src_info.width_stride(), uv_info.width_stride()};
+        } else {
+            image.planes = {static_cast<uint8_t *>(src_frame->tensor(0)->data()), nullptr};
+            image.strides = {src_info.width_stride(), 0};
+        }
+
+        const TensorInfo &dst_info = dst_tensor->info();
+        ImageInfo dst_image_info(dst_info);
+        ImageLayout layout = dst_image_info.layout();
+        if (layout != ImageLayout::NCHW && layout != ImageLayout::CHW)
+            throw std::runtime_error("Expect planar (NCHW or CHW) output tensor, got " + layout.to_string());
+        DLS_CHECK(dst_image_info.batch() == 1);
+        DLS_CHECK(dst_image_info.channels() == FusedPreproc::channels);
+
+        FusedPreproc::PlanarTensor tensor;
+        tensor.data = dst_tensor->data();
+        tensor.dtype = dst_info.dtype;
+        tensor.width = dst_image_info.width();
+        tensor.height = dst_image_info.height();
+        tensor.channel_stride = dst_info.stride.at(layout.c_position());
+        tensor.row_stride = dst_info.stride.at(layout.h_position());
+
+        cv::Rect dst_rect = _kernel->run(image, tensor, _aspect_ratio);
+
+        // Store metadata with coefficients for src<>dst coordinates conversion
+        cv::Rect src_rect = {0, 0, image.width, image.height};
+        auto affine_meta = dst->metadata().add(AffineTransformInfoMetadata::name);
+        AffineTransformInfoMetadata(affine_meta)
+            .set_rect(image.width, image.height, tensor.width, tensor.height, src_rect, dst_rect);
+
+        return true;
+    }
+
+  private:
+    MemoryMapperPtr _cpu_mapper;
+    std::unique_ptr<FusedPreproc> _kernel;
+    bool _aspect_ratio = false;
+};
+
+extern "C" {
+ElementDesc opencv_preproc = {
+    .name = "opencv_preproc",
+    .description = "Fused resize, color conversion, normalization and layout conversion of U8 video frame into planar "
+                   "F32/F16 tensor in single pass on CPU",
+    .author = "Intel Corporation",
+    .params = &params_desc,
+    .input_info =
+        {
+            {ImageFormat::BGR},
+            {ImageFormat::RGB},
+            {ImageFormat::BGRX},
+            {ImageFormat::RGBX},
+            {ImageFormat::NV12},
+        },
+    .output_info = {FrameInfo(MediaType::Tensors, MemoryType::CPU, {{{}, DataType::Float32}}),
+                    FrameInfo(MediaType::Tensors, MemoryType::CPU, {{{}, DataType::Float16}})},
+    .create = create_element<OpencvPreproc>,
+    .flags = 0};
+}
+
+} // namespace dlstreamer
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2022 Intel Corporation
+ * Copyright (C) 2022-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -14,7 +14,8 @@
 #include "dlstreamer/opencv/mappers/cpu_to_opencv.h"
 #include "dlstreamer/opencv/tensor.h"
 #include "dlstreamer/utils.h"
-#include "opencv2/imgproc.hpp"
+#include "mask_kernel.h"
+#include "opencv2/core.hpp"
 
 using namespace cv;
 using namespace std;
@@ -63,17 +64,20 @@ class OpencvRemoveBackground : public BaseTransformInplace {
             throw std::runtime_error("SourceIdentifierMetadata not found");
         int roi_id = source_id_meta->roi_id();
 
-        // find mask tensor by roi_id
+        // find mask tensor by roi_id. Frames of ROIs come in order of regions, so search starts after region found
+        // for previous frame and typically finishes on first region
         TensorPtr mask_tensor;
-        for (auto &region : frame->regions()) {
-            auto detection_meta = find_metadata<DetectionMetadata>(*region);
+        auto regions = frame->regions();
+        for (size_t i = 0; i < regions.size() && !mask_tensor; i++) {
+            size_t index = (_region_hint + i) % regions.size();
+            auto detection_meta = find_metadata<DetectionMetadata>(*regions[index]);
             if (!detection_meta || detection_meta->id() != roi_id)
                 continue;
-            auto mask_meta = find_metadata<InferenceResultMetadata>(*region, _mask_metadata_name, mask_format);
+            auto mask_meta = find_metadata<InferenceResultMetadata>(*regions[index], _mask_metadata_name, mask_format);
             if (!mask_meta)
                 continue;
             mask_tensor = mask_meta->tensor();
-            break;
+            _region_hint = index + 1;
         }
         if (!mask_tensor)
             throw std::runtime_error("mask metadata not found");
@@ -84,21 +88,14 @@ class OpencvRemoveBackground : public BaseTransformInplace {
         int mask_width = mask_info.width();
         int mask_height = mask_info.height();
 
-        cv::Mat bitmask(mask_height, mask_width, CV_8UC1);
-        uint8_t *bitmask_data = (uint8_t *)(bitmask.data);
-        for (int i = 0; i < mask_height * mask_width; i++)
-            bitmask_data[i] = (mask_data[i] >= _mask_threshold) ? 255 : 0;
-
-        Mat resized_mask;
-        resize(bitmask, resized_mask, cv_mat.size(), 0, 0, INTER_NEAREST);
-        if (cv_mat.channels() == 3)
-            cvtColor(resized_mask, resized_mask, COLOR_GRAY2RGB);
-        else if (cv_mat.channels() == 4)
-            cvtColor(resized_mask, resized_mask, COLOR_GRAY2RGBA);
-        else
+        if (cv_mat.channels() != 3 && cv_mat.channels() != 4)
             throw std::runtime_error("Unsupported number channels");
+        if (cv_mat.depth() != CV_8U)
+            throw std::runtime_error("Unsupported data type");
 
-        cv::bitwise_and(cv_mat, resized_mask, cv_mat);
+        // Threshold, scale to image size and apply mask in one pass without intermediate images
+        _mask_kernel.apply(mask_data, mask_width, mask_height, _mask_threshold, cv_mat.data, cv_mat.step,
+                           cv_mat.channels(), 0, 0, cv_mat.cols, cv_mat.rows);
         return true;
     }
 
@@ -106,6 +103,8 @@ class OpencvRemoveBackground : public BaseTransformInplace {
     MemoryMapperPtr _opencv_mapper;
     std::string _mask_metadata_name;
     float _mask_threshold;
+    MaskKernel _mask_kernel;
+    size_t _region_hint = 0;
 };
 
 extern "C" {
@@ -35,50 +35,59 @@ void FindPeaksBody::operator()(const cv::Range &range) const {
     }
 }
 
+PafMap::PafMap(const cv::Mat &mat) : data(mat.ptr<float>()), step(mat.step1()) {
+    CV_Assert(mat.type() == CV_32FC1);
+}
+
 std::vector<TwoJointsConnection> ComputeLineIntegralAndWeightedBipartiteGraph(
     const std::vector<Peak> &candidate_a, const std::vector<Peak> &candidate_b, const float mid_points_score_threshold,
-    const std::pair<cv::Mat, cv::Mat> &score_mid, const std::vector<cv::Mat> &pafs,
-    const float found_mid_points_ratio_threshold) {
+    const PafMap &paf_x, const PafMap &paf_y, const int paf_height, const float found_mid_points_ratio_threshold,
+    const float mid_point_prune_threshold) {
+    constexpr int mid_num = 10;
+    const int height_n = paf_height / 2;
     std::vector<TwoJointsConnection> temp_joint_connections;
+    float pred_x[mid_num];
+    float pred_y[mid_num];
     for (size_t i = 0; i < candidate_a.size(); ++i) {
+        const cv::Point2f &pos_a = candidate_a[i].pos;
         for (size_t j = 0; j < candidate_b.size(); ++j) {
+            const cv::Point2f &pos_b = candidate_b[j].pos;
             // building vectors
-            cv::Point2f pt = candidate_a[i].pos * 0.5 + candidate_b[j].pos * 0.5;
-            cv::Point mid = cv::Point(cvRound(pt.x), cvRound(pt.y));
-            cv::Point2f vec = candidate_b[j].pos - candidate_a[i].pos;
+            cv::Point2f vec = pos_b - pos_a;
             double norm_vec = cv::norm(vec);
             if (norm_vec == 0) {
                 continue;
             }
             vec /= norm_vec;
-            // sampling
-            float score = vec.x * score_mid.first.at<float>(mid) + vec.y * score_mid.second.at<float>(mid);
-            int height_n = pafs[0].rows / 2;
-            float suc_ratio = 0.0f;
-            float mid_score = 0.0f;
-            const int mid_num = 10;
-            const float score_threshold = -100.0f;
-            if (score > score_threshold) {
-                float p_sum = 0;
-                int p_count = 0;
-                cv::Size2f step((candidate_b[j].pos.x - candidate_a[i].pos.x) / (mid_num - 1),
-                                (candidate_b[j].pos.y - candidate_a[i].pos.y) / (mid_num - 1));
-                // evaluating on the fields
-                for (int n = 0; n < mid_num; n++) {
-                    cv::Point mid_point(cvRound(candidate_a[i].pos.x + n * step.width),
-                                        cvRound(candidate_a[i].pos.y + n * step.height));
-                    cv::Point2f pred(score_mid.first.at<float>(mid_point), score_mid.second.at<float>(mid_point));
-                    // integral step
-                    score = vec.x * pred.x + vec.y * pred.y;
-                    if (score > mid_points_score_threshold) {
-                        p_sum += score;
-                        p_count++;
-                    }
-                }
-                suc_ratio = static_cast<float>(p_count / mid_num);
-                float ratio = p_count > 0 ? p_sum / p_count : 0.0f;
-                mid_score = ratio + static_cast<float>(std::min(height_n / norm_vec - 1, 0.0));
+            // early pruning by PAF projection at middle point
+            cv::Point2f pt = pos_a * 0.5 + pos_b * 0.5;
+            int mid_x = cvRound(pt.x);
+            int mid_y = cvRound(pt.y);
+            float score = vec.x * paf_x.at(mid_x, mid_y) + vec.y * paf_y.at(mid_x, mid_y);
+            if (score <= mid_point_prune_threshold) {
+                continue;
+            }
+            // sampling, gather PAF values into contiguous arrays
+            const float step_x = (pos_b.x - pos_a.x) / (mid_num - 1);
+            const float step_y = (pos_b.y - pos_a.y) / (mid_num - 1);
+            for (int n = 0; n < mid_num; n++) {
+                int x = cvRound(pos_a.x + n * step_x);
+                int y = cvRound(pos_a.y + n * step_y);
+                pred_x[n] = paf_x.at(x, y);
+                pred_y[n] = paf_y.at(x, y);
+            }
+            // evaluating on the fields, integral step
+            float p_sum = 0;
+            int p_count = 0;
+            for (int n = 0; n < mid_num; n++) {
+                float s = vec.x * pred_x[n] + vec.y * pred_y[n];
+                bool passed = s > mid_points_score_threshold;
+                p_sum += passed ? s : 0.0f;
+                p_count += passed;
             }
+            float suc_ratio = static_cast<float>(p_count / mid_num);
+            float ratio = p_count > 0 ? p_sum / p_count : 0.0f;
+            float mid_score = ratio + static_cast<float>(std::min(height_n / norm_vec - 1, 0.0));
             // weighted bipartite graph
             if (mid_score > 0 && suc_ratio > found_mid_points_ratio_threshold) {
                 temp_joint_connections.push_back(TwoJointsConnection(i, j, mid_score));
@@ -88,6 +97,36 @@ std::vector<TwoJointsConnection> ComputeLineIntegralAndWeightedBipartiteGraph(
     return temp_joint_connections;
 }
 
+LimbConnectionsBody::LimbConnectionsBody(const std::vector<std::vector<Peak>> &all_peaks,
+                                         const std::vector<cv::Mat> &pafs,
+                                         const std::pair<int, int> *limb_ids_heatmap,
+                                         const std::pair<int, int> *limb_ids_paf, float mid_points_score_threshold,
+                                         float found_mid_points_ratio_threshold, float mid_point_prune_threshold,
+                                         std::vector<std::vector<TwoJointsConnection>> &connections)
+    : all_peaks(all_peaks), pafs(pafs), limb_ids_heatmap(limb_ids_heatmap), limb_ids_paf(limb_ids_paf),
+      mid_points_score_threshold(mid_points_score_threshold),
+      found_mid_points_ratio_threshold(found_mid_points_ratio_threshold),
+      mid_point_prune_threshold(mid_point_prune_threshold), connections(connections) {
+}
+
+void LimbConnectionsBody::operator()(const cv::Range &range) const {
+    for (int k = range.start; k < range.end; k++) {
+        const std::vector<Peak> &candidate_a = all_peaks[limb_ids_heatmap[k].first];
+        const std::vector<Peak> &candidate_b = all_peaks[limb_ids_heatmap[k].second];
+        if (candidate_a.empty() || candidate_b.empty()) {
+            continue;
+        }
+        PafMap paf_x(pafs[limb_ids_paf[k].first]);
+        PafMap paf_y(pafs[limb_ids_paf[k].second]);
+        std::vector<TwoJointsConnection> temp_joint_connections = ComputeLineIntegralAndWeightedBipartiteGraph(
+            candidate_a, candidate_b, mid_points_score_threshold, paf_x, paf_y, pafs[0].rows,
+            found_mid_points_ratio_threshold, mid_point_prune_threshold);
+        if (!temp_joint_connections.empty()) {
+            AssignmentAlgoritm(temp_joint_connections, connections[k], candidate_a, candidate_b);
+        }
+    }
+}
+
 void AssignmentAlgoritm(std::vector<TwoJointsConnection> &temp_joint_connections,
                         std::vector<TwoJointsConnection> &connections, const std::vector<Peak> &candidate_a,
                         const std::vector<Peak> &candidate_b) {
@@ -259,7 +298,7 @@ void MergingTwoHumanPose(const std::vector<Peak> &candidates, const std::vector<
 HumanPoses GroupPeaksToPoses(const std::vector<std::vector<Peak>> &all_peaks, const std::vector<cv::Mat> &pafs,
                              const size_t keypoints_number, const float mid_points_score_threshold,
                              const float found_mid_points_ratio_threshold, const int min_peak_degree,
-                             const float min_pose_by_peak_indices_set_score) {
+                             const float min_pose_by_peak_indices_set_score, const float mid_point_prune_threshold) {
     static const std::pair<int, int> limb_ids_heatmap[] = {{1, 2}, {1, 5},  {2, 3},   {3, 4},  {5, 6},   {6, 7},
                                                            {1, 8}, {8, 9},  {9, 10},  {1, 11}, {11, 12}, {12, 13},
                                                            {1, 0}, {0, 14}, {14, 16}, {0, 15}, {15, 17}};
@@ -270,10 +309,18 @@ HumanPoses GroupPeaksToPoses(const std::vector<std::vector<Peak>> &all_peaks, co
     for (const auto &peaks : all_peaks) {
         candidates.insert(candidates.end(), peaks.begin(), peaks.end());
     }
+    constexpr size_t limbs_number = sizeof(limb_ids_heatmap) / sizeof(limb_ids_heatmap[0]);
+
+    // limb scoring doesn't depend on grouping results and runs in parallel across limb types
+    std::vector<std::vector<TwoJointsConnection>> limb_connections(limbs_number);
+    LimbConnectionsBody limb_connections_body(all_peaks, pafs, limb_ids_heatmap, limb_ids_paf,
+                                              mid_points_score_threshold, found_mid_points_ratio_threshold,
+                                              mid_point_prune_threshold, limb_connections);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(limbs_number)), limb_connections_body);
+
+    // grouping depends on order of limbs
     std::vector<HumanPoseByPeaksIndices> pose_by_peak_indices_set;
-    for (size_t k = 0; k < 17; k++) {
-        std::vector<TwoJointsConnection> connections;
-        std::pair<cv::Mat, cv::Mat> score_mid = {pafs[limb_ids_paf[k].first], pafs[limb_ids_paf[k].second]};
+    for (size_t k = 0; k < limbs_number; k++) {
         const int idx_joint_a = limb_ids_heatmap[k].first;
         const int idx_joint_b = limb_ids_heatmap[k].second;
         const std::vector<Peak> &candidate_b = all_peaks[idx_joint_b]; // vector limbs, witch connect with
@@ -292,11 +339,7 @@ HumanPoses GroupPeaksToPoses(const std::vector<std::vector<Peak>> &all_peaks, co
             FillingSubSetForExistPeak(n_joints_a, keypoints_number, candidate_a, idx_joint_a, pose_by_peak_indices_set);
             continue;
         }
-        std::vector<TwoJointsConnection> temp_joint_connections = ComputeLineIntegralAndWeightedBipartiteGraph(
-            candidate_a, candidate_b, mid_points_score_threshold, score_mid, pafs, found_mid_points_ratio_threshold);
-        if (!temp_joint_connections.empty()) {
-            AssignmentAlgoritm(temp_joint_connections, connections, candidate_a, candidate_b);
-        }
+        const std::vector<TwoJointsConnection> &connections = limb_connections[k];
         if (connections.empty()) {
             continue;
         }
@@ -1,5 +1,5 @@
 /*******************************************************************************
- * Copyright (C) 2020-2021 Intel Corporation
+ * Copyright (C) 2020-2023 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  ******************************************************************************/
@@ -44,10 +44,14 @@ struct TwoJointsConnection {
     float score;
 };
 
+// Legacy value of PAF score at limb middle point below which candidate pair is not evaluated (effectively disabled)
+constexpr float DEFAULT_MID_POINT_PRUNE_THRESHOLD = -100.0f;
+
 HumanPoses GroupPeaksToPoses(const std::vector<std::vector<Peak>> &all_peaks, const std::vector<cv::Mat> &pafs,
                              const size_t keypoints_number, const float mid_points_score_threshold,
                              const float found_mid_points_ratio_threshold, const int min_joints_number,
-                             const float min_subset_score);
+                             const float min_subset_score,
+                             const float mid_point_prune_threshold = DEFAULT_MID_POINT_PRUNE_THRESHOLD);
 
 void MergingTwoHumanPose(const std::vector<Peak> &candidates, const std::vector<TwoJointsConnection> &connections,
                          std::vector<HumanPoseByPeaksIndices> &pose_by_peak_indices_set, const size_t idx_heatmap_limb,
@@ -61,10 +65,43 @@ void AssignmentAlgoritm(std::vector<TwoJointsConnection> &temp_joint_connections
                         std::vector<TwoJointsConnection> &connections, const std::vector<Peak> &candidate_a,
                         const std::vector<Peak> &candidate_b);
 
+// Read-only view on contiguous float buffer of single PAF channel
+struct PafMap {
+    explicit PafMap(const cv::Mat &mat);
+
+    float at(int x, int y) const {
+        return data[y * step + x];
+    }
+
+    const float *data;
+    size_t step; // in elements
+};
+
 std::vector<TwoJointsConnection> ComputeLineIntegralAndWeightedBipartiteGraph(
     const std::vector<Peak> &candidate_a, const std::vector<Peak> &candidate_b, const float mid_points_score_threshold,
-    const std::pair<cv::Mat, cv::Mat> &score_mid, const std::vector<cv::Mat> &pafs,
-    const float found_mid_points_ratio_threshold);
+    const PafMap &paf_x, const PafMap &paf_y, const int paf_height, const float found_mid_points_ratio_threshold,
+    const float mid_point_prune_threshold);
+
+// Scores and assigns candidate pairs for each limb type. Limb types are independent and processed in parallel.
+class LimbConnectionsBody : public cv::ParallelLoopBody {
+  public:
+    LimbConnectionsBody(const std::vector<std::vector<Peak>> &all_peaks, const std::vector<cv::Mat> &pafs,
+                        const std::pair<int, int> *limb_ids_heatmap, const std::pair<int, int> *limb_ids_paf,
+                        float mid_points_score_threshold, float found_mid_points_ratio_threshold,
+                        float mid_point_prune_threshold, std::vector<std::vector<TwoJointsConnection>> &connections);
+
+    void operator()(const cv::Range &range) const override;
+
+  private:
+    const std::vector<std::vector<Peak>> &all_peaks;
+    const std::vector<cv::Mat> &pafs;
+    const std::pair<int, int> *limb_ids_heatmap;
+    const std::pair<int, int> *limb_ids_paf;
+    float mid_points_score_threshold;
+    float found_mid_points_ratio_threshold;
+    float mid_point_prune_threshold;
+    std::vector<std::vector<TwoJointsConnection>> &connections;
+};
 
 class FindPeaksBody : public cv::ParallelLoopBody {
   public:
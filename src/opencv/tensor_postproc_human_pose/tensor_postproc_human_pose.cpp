@@ -18,12 +18,19 @@ namespace dlstreamer {
 namespace param {
 static constexpr auto point_names = "point-names";
 static constexpr auto point_connections = "point-connections";
+static constexpr auto mid_point_prune_threshold = "mid-point-prune-threshold";
 } // namespace param
 
 static ParamDescVector params_desc = {{param::point_names, "Array of key point names", std::vector<std::string>()},
                                       {param::point_connections,
                                        "Array of point connections {name-A0, name-B0, name-A1, name-B1, ...}",
-                                       std::vector<std::string>()}};
+                                       std::vector<std::string>()},
+                                      {param::mid_point_prune_threshold,
+                                       "Early pruning of candidate limb connections: skip PAF line integral if PAF "
+                                       "projection at limb middle point is not above this value. Default value "
+                                       "effectively disables pruning, values around 0 skip most false pairs in "
+                                       "crowded scenes",
+                                       static_cast<double>(DEFAULT_MID_POINT_PRUNE_THRESHOLD), -100.0, 1.0}};
 
 namespace dflt { // TODO add to parameters?
 static constexpr int upsample_ratio = 4;
@@ -41,6 +48,8 @@ class TensorPostProcHumanPose : public BaseTransformInplace {
         _point_names = params->get(param::point_names, std::vector<std::string>());
         _point_connections = params->get(param::point_connections, std::vector<std::string>());
         _keypoints_number = _point_names.size();
+        _mid_point_prune_threshold =
+            params->get<double>(param::mid_point_prune_threshold, DEFAULT_MID_POINT_PRUNE_THRESHOLD);
     }
 
     bool process(FramePtr src) override {
@@ -134,7 +143,7 @@ class TensorPostProcHumanPose : public BaseTransformInplace {
 
         return GroupPeaksToPoses(peaks_from_heat_map, pafs, _keypoints_number, dflt::mid_points_score_threshold,
                                  dflt::found_mid_points_ratio_threshold, dflt::min_joints_number,
-                                 dflt::min_subset_score);
+                                 dflt::min_subset_score, _mid_point_prune_threshold);
     }
 
     void correct_coordinates(HumanPoses &poses, cv::Size output_feature_map_size) const {
@@ -160,6 +169,7 @@ class TensorPostProcHumanPose : public BaseTransformInplace {
     std::string _model_name;
     std::string _layer_name;
     cv::Size _feature_size;
+    float _mid_point_prune_threshold = DEFAULT_MID_POINT_PRUNE_THRESHOLD;
     MemoryMapperCPUToOpenCV _opencv_mapper;
 };
 
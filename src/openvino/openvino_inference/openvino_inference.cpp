@@ -55,7 +55,7 @@ class OpenVinoTensorInference : public BaseTransform {
 
     FrameInfoVector get_input_info() override {
         auto infos = info_variations(_model_input_info, {MemoryType::OpenCL, MemoryType::CPU},
-                                     {DataType::UInt8, DataType::Float32});
+                                     {DataType::UInt8, DataType::Float32, DataType::Float16});
         return infos;
     }
 
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "box_batch.h"
+
+#include <algorithm>
+
+// Loops below are kept free of branches and calls so the compiler vectorizes them
+
+namespace {
+
+inline double clip(double v) {
+    return std::min(std::max(v, 0.0), 1.0);
+}
+
+} // namespace
+
+size_t transform_and_clip(BoxBatch &boxes, const BoxTransform &transform) {
+    const size_t n = boxes.size();
+    double *x_min = boxes.x_min.data();
+    double *y_min = boxes.y_min.data();
+    double *x_max = boxes.x_max.data();
+    double *y_max = boxes.y_max.data();
+
+    if (!transform.is_identity()) {
+        const double m0 = transform.m[0], m1 = transform.m[1], m2 = transform.m[2];
+        const double m3 = transform.m[3], m4 = transform.m[4], m5 = transform.m[5];
+        for (size_t i = 0; i < n; i++) {
+            const double x0 = m0 * x_min[i] + m1 * y_min[i] + m2;
+            const double y0 = m3 * x_min[i] + m4 * y_min[i] + m5;
+            const double x1 = m0 * x_max[i] + m1 * y_max[i] + m2;
+            const double y1 = m3 * x_max[i] + m4 * y_max[i] + m5;
+            x_min[i] = x0;
+            y_min[i] = y0;
+            x_max[i] = x1;
+            y_max[i] = y1;
+        }
+    }
+
+    // Counting doesn't vectorize together with the transformation on SSE2, and clipping is rarely needed
+    size_t clipped = 0;
+    for (size_t i = 0; i < n; i++)
+        clipped += !((x_min[i] >= 0) && (y_min[i] >= 0) && (x_max[i] <= 1) && (y_max[i] <= 1));
+    if (clipped) {
+        for (double *v : {x_min, y_min, x_max, y_max})
+            for (size_t i = 0; i < n; i++)
+                v[i] = clip(v[i]);
+    }
+    return clipped;
+}
+
+void to_absolute(BoxBatch &boxes, double width, double height, uint32_t offset_x, uint32_t offset_y) {
+    const size_t n = boxes.size();
+    const double *x_min = boxes.x_min.data();
+    const double *y_min = boxes.y_min.data();
+    const double *x_max = boxes.x_max.data();
+    const double *y_max = boxes.y_max.data();
+    uint32_t *x = boxes.x.data();
+    uint32_t *y = boxes.y.data();
+    uint32_t *w = boxes.w.data();
+    uint32_t *h = boxes.h.data();
+
+    for (size_t i = 0; i < n; i++) {
+        x[i] = static_cast<uint32_t>(std::max(x_min[i] * width + 0.5, 0.0)) + offset_x;
+        y[i] = static_cast<uint32_t>(std::max(y_min[i] * height + 0.5, 0.0)) + offset_y;
+        w[i] = static_cast<uint32_t>(std::max((x_max[i] - x_min[i]) * width + 0.5, 0.0));
+        h[i] = static_cast<uint32_t>(std::max((y_max[i] - y_min[i]) * height + 0.5, 0.0));
+    }
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Bounding boxes stored as structure of arrays, so coordinate transformations run over contiguous memory in one pass
+ * instead of one GstStructure or meta at a time. Normalized corners are doubles, as they are stored in metadata.
+ * Absolute coordinates are filled by to_absolute().
+ */
+struct BoxBatch {
+    std::vector<double> x_min, y_min, x_max, y_max;
+    std::vector<uint32_t> x, y, w, h;
+
+    size_t size() const {
+        return x_min.size();
+    }
+
+    void resize(size_t n) {
+        for (auto *v : {&x_min, &y_min, &x_max, &y_max})
+            v->resize(n);
+        for (auto *v : {&x, &y, &w, &h})
+            v->resize(n);
+    }
+
+    // Keeps capacity, so batch reused between frames doesn't allocate
+    void clear() {
+        resize(0);
+    }
+};
+
+/**
+ * Affine transformation of point (x, y):
+ *     x' = m[0] * x + m[1] * y + m[2]
+ *     y' = m[3] * x + m[4] * y + m[5]
+ */
+struct BoxTransform {
+    std::array<double, 6> m = {1, 0, 0, 0, 1, 0};
+
+    static BoxTransform scale(double scale_x, double scale_y, double offset_x = 0, double offset_y = 0) {
+        BoxTransform t;
+        t.m = {scale_x, 0, offset_x, 0, scale_y, offset_y};
+        return t;
+    }
+
+    // Transformation equal to applying this one and then next
+    BoxTransform then(const BoxTransform &next) const {
+        const auto &a = next.m;
+        BoxTransform t;
+        t.m = {a[0] * m[0] + a[1] * m[3], a[0] * m[1] + a[1] * m[4], a[0] * m[2] + a[1] * m[5] + a[2],
+               a[3] * m[0] + a[4] * m[3], a[3] * m[1] + a[4] * m[4], a[3] * m[2] + a[4] * m[5] + a[5]};
+        return t;
+    }
+
+    bool is_identity() const {
+        return m == BoxTransform().m;
+    }
+};
+
+/**
+ * Applies transformation to both corners of every box and clips normalized coordinates to [0, 1].
+ *
+ * @return number of boxes which had at least one coordinate out of [0, 1] before clipping
+ */
+size_t transform_and_clip(BoxBatch &boxes, const BoxTransform &transform);
+
+/**
+ * Fills x, y, w, h of every box with pixel coordinates in image of given size, rounded to nearest, and shifted by
+ * offset. Width and height of boxes with max corner less than min corner are set to 0.
+ */
+void to_absolute(BoxBatch &boxes, double width, double height, uint32_t offset_x = 0, uint32_t offset_y = 0);
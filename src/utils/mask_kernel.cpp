@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#include "mask_kernel.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Loops over rows are kept free of branches and calls, so compiler vectorizes them
+
+void MaskKernel::prepare(int mask_width, int width, int channels) {
+    _src_row.resize(mask_width);
+    // Thresholded source row is used as is if no scaling needed
+    const size_t row_size = (width == mask_width && channels == 1) ? 0 : static_cast<size_t>(width) * channels;
+    _dst_row.resize(row_size);
+    _columns.resize(row_size);
+    if (!row_size)
+        return;
+    const double scale = static_cast<double>(mask_width) / width;
+    for (int i = 0; i < width; i++) {
+        const int column = std::min(static_cast<int>(i * scale), mask_width - 1);
+        for (int c = 0; c < channels; c++)
+            _columns[i * channels + c] = column;
+    }
+}
+
+const uint8_t *MaskKernel::scaled_row(const float *mask_row, int mask_width, float threshold, uint8_t value) {
+    uint8_t *src = _src_row.data();
+    for (int i = 0; i < mask_width; i++)
+        src[i] = mask_row[i] >= threshold ? value : 0;
+    if (_dst_row.empty())
+        return src;
+
+    uint8_t *dst = _dst_row.data();
+    const int *columns = _columns.data();
+    const size_t size = _dst_row.size();
+    for (size_t i = 0; i < size; i++)
+        dst[i] = src[columns[i]];
+    return dst;
+}
+
+void MaskKernel::threshold(const float *mask, int mask_width, int mask_height, float threshold, uint8_t value,
+                           uint8_t *dst, size_t dst_stride, int dst_width, int dst_height) {
+    if (mask_width <= 0 || mask_height <= 0 || dst_width <= 0 || dst_height <= 0)
+        return;
+    prepare(mask_width, dst_width, 1);
+    const double scale = static_cast<double>(mask_height) / dst_height;
+    int prev_src_y = -1;
+    const uint8_t *row = nullptr;
+    for (int y = 0; y < dst_height; y++) {
+        const int src_y = std::min(static_cast<int>(y * scale), mask_height - 1);
+        if (src_y != prev_src_y) {
+            row = scaled_row(mask + static_cast<size_t>(src_y) * mask_width, mask_width, threshold, value);
+            prev_src_y = src_y;
+        }
+        memcpy(dst + y * dst_stride, row, dst_width);
+    }
+}
+
+void MaskKernel::apply(const float *mask, int mask_width, int mask_height, float threshold, uint8_t *image,
+                       size_t image_stride, int channels, int x, int y, int width, int height) {
+    if (mask_width <= 0 || mask_height <= 0 || width <= 0 || height <= 0 || channels <= 0)
+        return;
+    // Scaled row has mask value repeated for every channel of pixel, so it is applied with byte-wise AND
+    prepare(mask_width, width, channels);
+    const size_t row_size = static_cast<size_t>(width) * channels;
+    const double scale = static_cast<double>(mask_height) / height;
+    int prev_src_y = -1;
+    const uint8_t *row = nullptr;
+    for (int i = 0; i < height; i++) {
+        const int src_y = std::min(static_cast<int>(i * scale), mask_height - 1);
+        if (src_y != prev_src_y) {
+            row = scaled_row(mask + static_cast<size_t>(src_y) * mask_width, mask_width, threshold, 0xFF);
+            prev_src_y = src_y;
+        }
+        uint8_t *pixels = image + (y + i) * image_stride + static_cast<size_t>(x) * channels;
+        for (size_t j = 0; j < row_size; j++)
+            pixels[j] &= row[j];
+    }
+}
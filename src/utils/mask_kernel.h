@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Segmentation mask post-processing: thresholding of mask probabilities combined with nearest-neighbour scaling to
+ * target size (same source pixel selection as cv::resize with INTER_NEAREST). Mask is processed row by row, source row
+ * is thresholded once however many target rows it is scaled to, so no full-size mask or float image is created.
+ * Row buffers are kept between calls, object is expected to be owned by one element and not shared between threads.
+ */
+class MaskKernel {
+  public:
+    /**
+     * Writes thresholded mask scaled to dst_width x dst_height into dst: 'value' where mask >= threshold, 0 elsewhere.
+     * @param mask row-major mask of mask_width x mask_height probabilities
+     * @param dst_stride distance in bytes between rows of dst
+     */
+    void threshold(const float *mask, int mask_width, int mask_height, float threshold, uint8_t value, uint8_t *dst,
+                   size_t dst_stride, int dst_width, int dst_height);
+
+    /**
+     * Zeroes pixels of image rectangle (x, y, width, height) where mask scaled to rectangle size is below threshold.
+     * Pixels outside rectangle are not accessed.
+     * @param image interleaved 8-bit image with 'channels' bytes per pixel
+     * @param image_stride distance in bytes between rows of image
+     */
+    void apply(const float *mask, int mask_width, int mask_height, float threshold, uint8_t *image, size_t image_stride,
+               int channels, int x, int y, int width, int height);
+
+  private:
+    // Prepares column map for scaling mask row of mask_width to width pixels of given number of channels
+    void prepare(int mask_width, int width, int channels);
+    // Returns mask row scaled to prepared width, thresholded to 'value' or 0
+    const uint8_t *scaled_row(const float *mask_row, int mask_width, float threshold, uint8_t value);
+
+    std::vector<int> _columns;     // source column of every byte of target row
+    std::vector<uint8_t> _src_row; // thresholded source row
+    std::vector<uint8_t> _dst_row; // thresholded row scaled to target width
+};
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ ******************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ * Thread-safe free list of equally sized memory blocks. Block size is defined by the first allocation, requests of
+ * other sizes are passed to global operator new/delete. Released blocks are kept for reuse until the pool is destroyed.
+ */
+class BlockPool {
+  public:
+    BlockPool() = default;
+    BlockPool(const BlockPool &) = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    ~BlockPool() {
+        for (void *block : free_blocks)
+            ::operator delete(block);
+    }
+
+    void *allocate(size_t size) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!block_size)
+                block_size = size;
+            if (size == block_size && !free_blocks.empty()) {
+                void *block = free_blocks.back();
+                free_blocks.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void deallocate(void *block, size_t size) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (size == block_size) {
+                free_blocks.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+  private:
+    std::mutex mutex;
+    size_t block_size = 0;
+    std::vector<void *> free_blocks;
+};
+
+/**
+ * Allocator taking single-object allocations from BlockPool. Intended for std::allocate_shared, so object and
+ * shared_ptr control block are placed in one reused block. Allocator keeps the pool alive while any object exists.
+ */
+template <typename T>
+class PoolAllocator {
+  public:
+    using value_type = T;
+
+    explicit PoolAllocator(std::shared_ptr<BlockPool> pool) : pool(std::move(pool)) {
+    }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {
+    }
+
+    T *allocate(size_t n) {
+        if (n != 1)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(pool->allocate(sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        pool->deallocate(p, sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &other) const {
+        return pool == other.pool;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &other) const {
+        return pool != other.pool;
+    }
+
+  private:
+    template <typename U>
+    friend class PoolAllocator;
+
+    std::shared_ptr<BlockPool> pool;
+};